@@ -0,0 +1,262 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace atframe_utils_benchmark {
+
+using clock_type = std::chrono::steady_clock;
+
+enum class output_format_t : int32_t {
+  kText = 0,
+  kCsv,
+  kJson,  // one JSON object per line
+};
+
+struct options_t {
+  size_t records;                 // records per thread
+  size_t max_threads;             // thread steps are 1, 2, 4, ... max_threads
+  bool quick;                     // only check that every case still runs
+  std::string filter;             // run cases whose name contains filter
+  output_format_t output_format;  // format of results
+};
+
+struct result_t {
+  std::string name;
+  size_t threads;
+  size_t records;
+  double ns_per_record;
+  int64_t p50;
+  int64_t p99;
+  int64_t p999;
+  int64_t max;
+};
+
+inline void print_usage(const char *program) {
+  printf("Usage: %s [options...]\n", program);
+  printf("  --records <N>    records per thread\n");
+  printf("  --threads <N>    max producer threads, thread steps are 1, 2, 4, ... N\n");
+  printf("  --filter <TEXT>  only run cases whose name contains TEXT\n");
+  printf("  --format <TYPE>  output format: text, csv or json(one object per line)\n");
+  printf("  --quick          run a few records per case, used by ctest\n");
+  printf("  --help           show this help message\n");
+}
+
+/**
+ * @brief Parse command line options
+ * @return false if the program should exit
+ */
+inline bool parse_options(int argc, char *argv[], options_t &out, size_t default_records) {
+  out.records = default_records;
+  out.max_threads = std::thread::hardware_concurrency();
+  if (out.max_threads < 1) {
+    out.max_threads = 1;
+  } else if (out.max_threads > 8) {
+    out.max_threads = 8;
+  }
+  out.quick = false;
+  out.filter.clear();
+  out.output_format = output_format_t::kText;
+
+  bool has_records = false;
+  bool has_threads = false;
+  for (int i = 1; i < argc; ++i) {
+    if (0 == strcmp(argv[i], "--records") && i + 1 < argc) {
+      out.records = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+      has_records = true;
+    } else if (0 == strcmp(argv[i], "--threads") && i + 1 < argc) {
+      out.max_threads = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+      has_threads = true;
+    } else if (0 == strcmp(argv[i], "--filter") && i + 1 < argc) {
+      out.filter = argv[++i];
+    } else if (0 == strcmp(argv[i], "--format") && i + 1 < argc) {
+      ++i;
+      if (0 == strcmp(argv[i], "csv")) {
+        out.output_format = output_format_t::kCsv;
+      } else if (0 == strcmp(argv[i], "json")) {
+        out.output_format = output_format_t::kJson;
+      } else if (0 == strcmp(argv[i], "text")) {
+        out.output_format = output_format_t::kText;
+      } else {
+        print_usage(argv[0]);
+        return false;
+      }
+    } else if (0 == strcmp(argv[i], "--quick")) {
+      out.quick = true;
+    } else {
+      print_usage(argv[0]);
+      return false;
+    }
+  }
+
+  if (out.quick) {
+    if (!has_records) {
+      out.records = 1000;
+    }
+    if (!has_threads && out.max_threads > 2) {
+      out.max_threads = 2;
+    }
+  }
+  if (out.records < 1) {
+    out.records = 1;
+  }
+  if (out.max_threads < 1) {
+    out.max_threads = 1;
+  }
+  return true;
+}
+
+inline bool match_filter(const options_t &options, const std::string &name) {
+  return options.filter.empty() || std::string::npos != name.find(options.filter);
+}
+
+inline std::vector<size_t> get_thread_steps(const options_t &options) {
+  std::vector<size_t> ret;
+  for (size_t threads = 1; threads < options.max_threads; threads <<= 1) {
+    ret.push_back(threads);
+  }
+  ret.push_back(options.max_threads);
+  return ret;
+}
+
+inline void print_header(const options_t &options) {
+  switch (options.output_format) {
+    case output_format_t::kCsv:
+      printf("case,threads,records,ns_per_record,p50_ns,p99_ns,p999_ns,max_ns\n");
+      break;
+    case output_format_t::kJson:
+      break;
+    default:
+      printf("%-48s %8s %10s %12s %10s %10s %10s %10s\n", "case", "threads", "records", "ns/record", "p50(ns)",
+             "p99(ns)", "p999(ns)", "max(ns)");
+      break;
+  }
+}
+
+inline void print_result(const options_t &options, const result_t &result) {
+  switch (options.output_format) {
+    case output_format_t::kCsv:
+      // Case names never contain comma or quote
+      printf("%s,%llu,%llu,%.1f,%lld,%lld,%lld,%lld\n", result.name.c_str(),
+             static_cast<unsigned long long>(result.threads), static_cast<unsigned long long>(result.records),
+             result.ns_per_record, static_cast<long long>(result.p50), static_cast<long long>(result.p99),
+             static_cast<long long>(result.p999), static_cast<long long>(result.max));
+      break;
+    case output_format_t::kJson:
+      printf(
+          "{\"case\":\"%s\",\"threads\":%llu,\"records\":%llu,\"ns_per_record\":%.1f,\"p50_ns\":%lld,"
+          "\"p99_ns\":%lld,\"p999_ns\":%lld,\"max_ns\":%lld}\n",
+          result.name.c_str(), static_cast<unsigned long long>(result.threads),
+          static_cast<unsigned long long>(result.records), result.ns_per_record, static_cast<long long>(result.p50),
+          static_cast<long long>(result.p99), static_cast<long long>(result.p999), static_cast<long long>(result.max));
+      break;
+    default:
+      printf("%-48s %8llu %10llu %12.1f %10lld %10lld %10lld %10lld\n", result.name.c_str(),
+             static_cast<unsigned long long>(result.threads), static_cast<unsigned long long>(result.records),
+             result.ns_per_record, static_cast<long long>(result.p50), static_cast<long long>(result.p99),
+             static_cast<long long>(result.p999), static_cast<long long>(result.max));
+      break;
+  }
+  fflush(stdout);
+}
+
+/**
+ * @brief Prevent the compiler from optimizing away the computation of value
+ */
+template <class T>
+inline void do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  __asm__ __volatile__("" : : "r"(&value) : "memory");
+#else
+  static thread_local const void *volatile sink = nullptr;
+  sink = &value;
+#endif
+}
+
+inline int64_t pick_percentile(const std::vector<int64_t> &sorted_samples, double percentile) {
+  if (sorted_samples.empty()) {
+    return 0;
+  }
+  size_t index = static_cast<size_t>(percentile * static_cast<double>(sorted_samples.size() - 1));
+  return sorted_samples[index];
+}
+
+/**
+ * @brief Run fn(thread_index, record_index) records times on each of threads producer threads
+ * @note ns/record is wall time of all threads divided by the total records, which is the cost of one record when the
+ *       producers are saturated. Percentiles are the latency of every single call.
+ */
+template <class TFN>
+result_t run_case(const std::string &name, size_t threads, size_t records, TFN &&fn) {
+  std::vector<std::vector<int64_t>> samples;
+  samples.resize(threads);
+  for (auto &thread_samples : samples) {
+    thread_samples.resize(records);
+  }
+
+  std::atomic<size_t> ready_threads{0};
+  std::atomic<bool> start{false};
+  std::vector<std::thread> producers;
+  producers.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    producers.emplace_back([&samples, &ready_threads, &start, &fn, i, records]() {
+      std::vector<int64_t> &thread_samples = samples[i];
+      ready_threads.fetch_add(1, std::memory_order_release);
+      while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+
+      for (size_t j = 0; j < records; ++j) {
+        clock_type::time_point begin = clock_type::now();
+        fn(i, j);
+        clock_type::time_point end = clock_type::now();
+        thread_samples[j] =
+            static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+      }
+    });
+  }
+
+  while (ready_threads.load(std::memory_order_acquire) < threads) {
+    std::this_thread::yield();
+  }
+  clock_type::time_point begin = clock_type::now();
+  start.store(true, std::memory_order_release);
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  clock_type::time_point end = clock_type::now();
+
+  std::vector<int64_t> all_samples;
+  all_samples.reserve(threads * records);
+  for (auto &thread_samples : samples) {
+    all_samples.insert(all_samples.end(), thread_samples.begin(), thread_samples.end());
+  }
+  std::sort(all_samples.begin(), all_samples.end());
+
+  result_t ret;
+  ret.name = name;
+  ret.threads = threads;
+  ret.records = threads * records;
+  ret.ns_per_record = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) /
+                      static_cast<double>(ret.records);
+  ret.p50 = pick_percentile(all_samples, 0.5);
+  ret.p99 = pick_percentile(all_samples, 0.99);
+  ret.p999 = pick_percentile(all_samples, 0.999);
+  ret.max = all_samples.empty() ? 0 : all_samples.back();
+  return ret;
+}
+
+}  // namespace atframe_utils_benchmark
@@ -0,0 +1,210 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/file_system.h"
+#include "log/log_sink_file_backend.h"
+#include "log/log_wrapper.h"
+#include "time/time_utility.h"
+
+#include "benchmark_utility.h"
+
+namespace {
+
+enum class benchmark_api_t {
+  kPrintf = 0,
+  kFormat,
+};
+
+enum class benchmark_sink_t {
+  kNull = 0,
+  kFile,
+  kAsyncNull,
+};
+
+struct benchmark_prefix_t {
+  const char *name;
+  const char *pattern;
+};
+
+static const benchmark_prefix_t kPrefixNone = {"none", ""};
+static const benchmark_prefix_t kPrefixDefault = {"default", "[%F %T.%f][%L](%k:%n): "};
+static const benchmark_prefix_t kPrefixFull = {"full", "[%Y-%m-%d %H:%M:%S.%f][%L(%l)][%s:%n(%C)][%N]: "};
+
+static const char *kBenchmarkLogDir = "benchmark_log";
+static const uint32_t kBenchmarkLogRotateSize = 2;
+
+static const char *get_api_name(benchmark_api_t api) {
+  switch (api) {
+    case benchmark_api_t::kPrintf:
+      return "printf";
+    case benchmark_api_t::kFormat:
+      return "format";
+    default:
+      return "unknown";
+  }
+}
+
+static const char *get_sink_name(benchmark_sink_t sink) {
+  switch (sink) {
+    case benchmark_sink_t::kNull:
+      return "null";
+    case benchmark_sink_t::kFile:
+      return "file";
+    case benchmark_sink_t::kAsyncNull:
+      return "async-null";
+    default:
+      return "unknown";
+  }
+}
+
+static std::string get_log_file_path(uint32_t index) {
+  return std::string(kBenchmarkLogDir) + "/log_benchmark." + std::to_string(index) + ".log";
+}
+
+static void cleanup_log_files() {
+  for (uint32_t i = 0; i < kBenchmarkLogRotateSize; ++i) {
+    atfw::util::file_system::remove(get_log_file_path(i).c_str());
+  }
+  atfw::util::file_system::remove(kBenchmarkLogDir);
+}
+
+static atfw::util::log::log_wrapper::ptr_t create_logger(const benchmark_prefix_t &prefix, benchmark_sink_t sink) {
+  atfw::util::log::log_wrapper::ptr_t logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+  logger->set_prefix_format(prefix.pattern);
+
+  switch (sink) {
+    case benchmark_sink_t::kFile: {
+      atfw::util::file_system::mkdir(kBenchmarkLogDir, true);
+      atfw::util::log::log_sink_file_backend backend(std::string(kBenchmarkLogDir) + "/log_benchmark.%N.log");
+      backend.set_rotate_size(kBenchmarkLogRotateSize).set_max_file_size(64 * 1024 * 1024);
+      logger->add_sink(backend);
+      break;
+    }
+    case benchmark_sink_t::kAsyncNull:
+      logger->add_sink([](const atfw::util::log::log_wrapper::caller_info_t &, atfw::util::nostd::string_view) {});
+      logger->enable_async();
+      break;
+    default:
+      logger->add_sink([](const atfw::util::log::log_wrapper::caller_info_t &, atfw::util::nostd::string_view) {});
+      break;
+  }
+
+  return logger;
+}
+
+static void run_log_case(const atframe_utils_benchmark::options_t &options, benchmark_api_t api,
+                         const benchmark_prefix_t &prefix, benchmark_sink_t sink, size_t threads) {
+  std::string name = std::string(get_api_name(api)) + "/" + get_sink_name(sink) + "/" + prefix.name;
+  if (!atframe_utils_benchmark::match_filter(options, name)) {
+    return;
+  }
+#if !(defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI)
+  if (benchmark_api_t::kFormat == api) {
+    return;
+  }
+#endif
+
+  atfw::util::log::log_wrapper::ptr_t logger = create_logger(prefix, sink);
+  atfw::util::log::log_wrapper *raw_logger = logger.get();
+
+  atframe_utils_benchmark::result_t result;
+  if (benchmark_api_t::kPrintf == api) {
+    result = atframe_utils_benchmark::run_case(name, threads, options.records, [raw_logger](size_t, size_t i) {
+      WINSTLOGINFO(*raw_logger, "benchmark record %d, name: %s, value: %.3f", static_cast<int>(i), "log_benchmark",
+                   3.14159);
+    });
+  } else {
+#if defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI
+    result = atframe_utils_benchmark::run_case(name, threads, options.records, [raw_logger](size_t, size_t i) {
+      FWINSTLOGINFO(*raw_logger, "benchmark record {}, name: {}, value: {:.3f}", i, "log_benchmark", 3.14159);
+    });
+#endif
+  }
+
+  if (logger->is_async_enabled()) {
+    logger->flush_async();
+  }
+  atframe_utils_benchmark::print_result(options, result);
+
+  logger.reset();
+  if (benchmark_sink_t::kFile == sink) {
+    cleanup_log_files();
+  }
+}
+
+static void run_stacktrace_case(const atframe_utils_benchmark::options_t &options, size_t threads,
+                                bool raw_address) {
+  std::string name = raw_address ? "printf/null/default/stacktrace-raw" : "printf/null/default/stacktrace";
+  if (!atframe_utils_benchmark::match_filter(options, name)) {
+    return;
+  }
+
+  atfw::util::log::log_wrapper::ptr_t logger = create_logger(kPrefixDefault, benchmark_sink_t::kNull);
+  logger->set_stacktrace_level(atfw::util::log::log_level::kError, atfw::util::log::log_level::kFatal);
+  logger->set_option(atfw::util::log::log_wrapper::options_t::OPT_STACKTRACE_RAW_ADDRESS, raw_address);
+  atfw::util::log::log_wrapper *raw_logger = logger.get();
+
+  // Resolving symbols is much slower than the other cases
+  size_t records = raw_address ? options.records : options.records / 100;
+  if (records < 10) {
+    records = 10;
+  }
+  atframe_utils_benchmark::result_t result =
+      atframe_utils_benchmark::run_case(name, threads, records, [raw_logger](size_t, size_t i) {
+        WINSTLOGERROR(*raw_logger, "benchmark record %d, name: %s", static_cast<int>(i), "log_benchmark");
+      });
+  atframe_utils_benchmark::print_result(options, result);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  atframe_utils_benchmark::options_t options;
+  if (!atframe_utils_benchmark::parse_options(argc, argv, options, 200000)) {
+    return 0;
+  }
+
+  atfw::util::time::time_utility::update();
+  cleanup_log_files();
+
+  atframe_utils_benchmark::print_header(options);
+
+  // Cost of prefix patterns, single producer
+  const benchmark_prefix_t *prefixes[] = {&kPrefixNone, &kPrefixDefault, &kPrefixFull};
+  const benchmark_api_t apis[] = {benchmark_api_t::kPrintf, benchmark_api_t::kFormat};
+  for (auto &api : apis) {
+    for (auto &prefix : prefixes) {
+      run_log_case(options, api, *prefix, benchmark_sink_t::kNull, 1);
+    }
+  }
+
+  // Scalability of producers
+  const benchmark_sink_t sinks[] = {benchmark_sink_t::kNull, benchmark_sink_t::kFile, benchmark_sink_t::kAsyncNull};
+  std::vector<size_t> thread_steps = atframe_utils_benchmark::get_thread_steps(options);
+  for (auto &api : apis) {
+    for (auto &sink : sinks) {
+      for (auto &threads : thread_steps) {
+        run_log_case(options, api, kPrefixDefault, sink, threads);
+      }
+    }
+  }
+
+  for (auto &threads : thread_steps) {
+    run_stacktrace_case(options, threads, false);
+  }
+  for (auto &threads : thread_steps) {
+    run_stacktrace_case(options, threads, true);
+  }
+
+  return 0;
+}
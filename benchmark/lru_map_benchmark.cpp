@@ -0,0 +1,121 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "memory/concurrent_lru_map.h"
+#include "memory/lru_map.h"
+#include "memory/pooled_lru_map.h"
+
+#include "benchmark_utility.h"
+
+namespace {
+
+// Keys of real caches are not sequential, scramble them so buckets of std::unordered_map are not visited in order
+static inline uint64_t make_key(uint64_t i) { return i * 0xD6E8FEB86659FD93ULL; }
+
+template <class TMAP>
+static void run_lru_map_cases(const atframe_utils_benchmark::options_t &options, const char *map_name) {
+  size_t records = options.records;
+  uint64_t keys = static_cast<uint64_t>(records);
+
+  TMAP lru;
+  lru.reserve(records);
+
+  std::string name = std::string(map_name) + "/insert";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&lru](size_t, size_t i) {
+          lru.insert_key_value(make_key(static_cast<uint64_t>(i)), i);
+        }));
+  }
+
+  // Random keys, every hit moves the element to the back
+  name = std::string(map_name) + "/find-update";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    uint64_t seed = 20261016;
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&lru, &seed, keys](size_t, size_t) {
+          seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+          lru.find(make_key((seed >> 16) % keys), true);
+        }));
+  }
+
+  // Insert new keys and evict the least recently used ones
+  name = std::string(map_name) + "/insert-evict";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&lru, keys](size_t, size_t i) {
+          lru.insert_key_value(make_key(keys + static_cast<uint64_t>(i)), i);
+          lru.pop_front();
+        }));
+  }
+}
+
+// Global mutex + lru_map, compared with concurrent_lru_map
+class locked_lru_map {
+ public:
+  using lru_map_type = atfw::util::memory::lru_map<uint64_t, size_t>;
+
+  lru_map_type::store_type get_or_insert(const uint64_t &key, size_t value) {
+    std::lock_guard<std::mutex> guard(lock_);
+    lru_map_type::iterator it = data_.find(key, true);
+    if (it != data_.end()) {
+      return it->second;
+    }
+    return data_.insert_key_value(key, value).first->second;
+  }
+
+ private:
+  std::mutex lock_;
+  lru_map_type data_;
+};
+
+static void run_concurrent_cases(const atframe_utils_benchmark::options_t &options) {
+  uint64_t keys = static_cast<uint64_t>(options.records);
+  std::vector<size_t> thread_steps = atframe_utils_benchmark::get_thread_steps(options);
+  for (auto &threads : thread_steps) {
+    std::string name = "locked_lru_map/get";
+    if (atframe_utils_benchmark::match_filter(options, name)) {
+      locked_lru_map lru;
+      atframe_utils_benchmark::print_result(
+          options, atframe_utils_benchmark::run_case(name, threads, options.records, [&lru, keys](size_t t, size_t i) {
+            lru.get_or_insert(make_key((i * 31 + t) % keys), i);
+          }));
+    }
+
+    name = "concurrent_lru_map/get";
+    if (atframe_utils_benchmark::match_filter(options, name)) {
+      atfw::util::memory::concurrent_lru_map<uint64_t, size_t> lru(0, 0);
+      atframe_utils_benchmark::print_result(
+          options, atframe_utils_benchmark::run_case(name, threads, options.records, [&lru, keys](size_t t, size_t i) {
+            lru.get_or_insert(make_key((i * 31 + t) % keys),
+                              [i](const uint64_t &) { return std::make_shared<size_t>(i); });
+          }));
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  atframe_utils_benchmark::options_t options;
+  if (!atframe_utils_benchmark::parse_options(argc, argv, options, 1000000)) {
+    return 0;
+  }
+
+  atframe_utils_benchmark::print_header(options);
+
+  run_lru_map_cases<atfw::util::memory::lru_map<uint64_t, size_t>>(options, "lru_map");
+  run_lru_map_cases<atfw::util::memory::pooled_lru_map<uint64_t, size_t>>(options, "pooled_lru_map");
+  run_concurrent_cases(options);
+
+  return 0;
+}
@@ -0,0 +1,261 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <std/intrusive_ptr.h>
+
+#include "memory/rc_ptr.h"
+
+#include "benchmark_utility.h"
+
+namespace {
+
+// Operations of cheap cases are repeated in one record, or the cost of clock will be the most part of it
+static constexpr const size_t kOperationsPerRecord = 16;
+static constexpr const size_t kTraverseElements = 1024;
+
+struct benchmark_object {
+  explicit benchmark_object(int64_t v) : value(v) {}
+
+  int64_t value;
+};
+
+struct benchmark_intrusive_object : public benchmark_object {
+  explicit benchmark_intrusive_object(int64_t v) : benchmark_object(v), ref_count(0) {}
+
+  size_t ref_count;
+
+  friend void intrusive_ptr_add_ref(benchmark_intrusive_object *p) { ++p->ref_count; }
+
+  friend void intrusive_ptr_release(benchmark_intrusive_object *p) {
+    if (0 == --p->ref_count) {
+      delete p;
+    }
+  }
+};
+
+struct benchmark_atomic_intrusive_object : public benchmark_object {
+  explicit benchmark_atomic_intrusive_object(int64_t v) : benchmark_object(v), ref_count(0) {}
+
+  std::atomic<size_t> ref_count;
+
+  friend void intrusive_ptr_add_ref(benchmark_atomic_intrusive_object *p) {
+    p->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  friend void intrusive_ptr_release(benchmark_atomic_intrusive_object *p) {
+    if (1 == p->ref_count.fetch_sub(1, std::memory_order_acq_rel)) {
+      delete p;
+    }
+  }
+};
+
+struct strong_rc_ptr_traits {
+  using ptr_type = atfw::util::memory::strong_rc_ptr<benchmark_object>;
+  using weak_type = atfw::util::memory::weak_rc_ptr<benchmark_object>;
+  using has_weak = std::true_type;
+
+  static const char *name() { return "strong_rc_ptr"; }
+  static ptr_type make(int64_t v) { return atfw::util::memory::make_strong_rc<benchmark_object>(v); }
+};
+
+struct atomic_rc_ptr_traits {
+  using ptr_type = atfw::util::memory::atomic_rc_ptr<benchmark_object>;
+  using weak_type = atfw::util::memory::atomic_weak_rc_ptr<benchmark_object>;
+  using has_weak = std::true_type;
+
+  static const char *name() { return "atomic_rc_ptr"; }
+  static ptr_type make(int64_t v) { return atfw::util::memory::make_atomic_rc<benchmark_object>(v); }
+};
+
+struct shared_ptr_traits {
+  using ptr_type = std::shared_ptr<benchmark_object>;
+  using weak_type = std::weak_ptr<benchmark_object>;
+  using has_weak = std::true_type;
+
+  static const char *name() { return "shared_ptr"; }
+  static ptr_type make(int64_t v) { return std::make_shared<benchmark_object>(v); }
+};
+
+struct intrusive_ptr_traits {
+  using ptr_type = std::intrusive_ptr<benchmark_intrusive_object>;
+  using weak_type = ptr_type;
+  using has_weak = std::false_type;
+
+  static const char *name() { return "intrusive_ptr"; }
+  static ptr_type make(int64_t v) { return ptr_type(new benchmark_intrusive_object(v)); }
+};
+
+struct atomic_intrusive_ptr_traits {
+  using ptr_type = std::intrusive_ptr<benchmark_atomic_intrusive_object>;
+  using weak_type = ptr_type;
+  using has_weak = std::false_type;
+
+  static const char *name() { return "atomic_intrusive_ptr"; }
+  static ptr_type make(int64_t v) { return ptr_type(new benchmark_atomic_intrusive_object(v)); }
+};
+
+static std::string make_case_name(const char *ptr_name, const char *case_name) {
+  return std::string(ptr_name) + "/" + case_name;
+}
+
+template <class TTRAITS>
+static void run_weak_lock_case(const atframe_utils_benchmark::options_t &options, const std::string &name,
+                               size_t threads, std::true_type) {
+  typename TTRAITS::ptr_type source = TTRAITS::make(1);
+  typename TTRAITS::weak_type weak = source;
+  atframe_utils_benchmark::print_result(
+      options, atframe_utils_benchmark::run_case(name, threads, options.records, [&weak](size_t, size_t) {
+        for (size_t k = 0; k < kOperationsPerRecord; ++k) {
+          typename TTRAITS::ptr_type locked = weak.lock();
+          atframe_utils_benchmark::do_not_optimize(locked);
+        }
+      }));
+}
+
+template <class TTRAITS>
+static void run_weak_lock_case(const atframe_utils_benchmark::options_t &, const std::string &, size_t,
+                               std::false_type) {}
+
+template <class TTRAITS>
+static void run_single_thread_cases(const atframe_utils_benchmark::options_t &options) {
+  using ptr_type = typename TTRAITS::ptr_type;
+
+  std::string name = make_case_name(TTRAITS::name(), "make-destroy");
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, options.records, [](size_t, size_t i) {
+          ptr_type p = TTRAITS::make(static_cast<int64_t>(i));
+          atframe_utils_benchmark::do_not_optimize(p);
+        }));
+  }
+
+  name = make_case_name(TTRAITS::name(), "copy-destroy(x16)");
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    ptr_type source = TTRAITS::make(1);
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, options.records, [&source](size_t, size_t) {
+          ptr_type copies[kOperationsPerRecord];
+          for (size_t k = 0; k < kOperationsPerRecord; ++k) {
+            copies[k] = source;
+          }
+          atframe_utils_benchmark::do_not_optimize(copies);
+        }));
+  }
+
+  name = make_case_name(TTRAITS::name(), "move(x16)");
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    ptr_type slots[2] = {TTRAITS::make(1), ptr_type()};
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, options.records, [&slots](size_t, size_t) {
+          for (size_t k = 0; k < kOperationsPerRecord; ++k) {
+            slots[(k + 1) & 1] = std::move(slots[k & 1]);
+          }
+          atframe_utils_benchmark::do_not_optimize(slots);
+        }));
+  }
+
+  name = make_case_name(TTRAITS::name(), "weak-lock(x16)");
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    run_weak_lock_case<TTRAITS>(options, name, 1, typename TTRAITS::has_weak());
+  }
+
+  // Traversal of a container of pointers, the cost of one record is visiting all kTraverseElements elements
+  size_t traverse_records = options.records / 100;
+  if (traverse_records < 10) {
+    traverse_records = 10;
+  }
+  std::vector<ptr_type> elements;
+  elements.reserve(kTraverseElements);
+  for (size_t i = 0; i < kTraverseElements; ++i) {
+    elements.push_back(TTRAITS::make(static_cast<int64_t>(i)));
+  }
+
+  name = make_case_name(TTRAITS::name(), "traverse-1024");
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, traverse_records, [&elements](size_t, size_t) {
+          int64_t sum = 0;
+          for (const ptr_type &element : elements) {
+            sum += element->value;
+          }
+          atframe_utils_benchmark::do_not_optimize(sum);
+        }));
+  }
+
+  // Pointers passed by value, like callbacks holding their owners
+  name = make_case_name(TTRAITS::name(), "traverse-copy-1024");
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, traverse_records, [&elements](size_t, size_t) {
+          int64_t sum = 0;
+          for (ptr_type element : elements) {
+            sum += element->value;
+            atframe_utils_benchmark::do_not_optimize(element);
+          }
+          atframe_utils_benchmark::do_not_optimize(sum);
+        }));
+  }
+}
+
+// All threads copy the same pointer, so every operation contends on one counter
+template <class TTRAITS>
+static void run_contended_cases(const atframe_utils_benchmark::options_t &options) {
+  using ptr_type = typename TTRAITS::ptr_type;
+
+  std::vector<size_t> thread_steps = atframe_utils_benchmark::get_thread_steps(options);
+  for (auto &threads : thread_steps) {
+    std::string name = make_case_name(TTRAITS::name(), "contended-copy-destroy(x16)");
+    if (atframe_utils_benchmark::match_filter(options, name)) {
+      ptr_type source = TTRAITS::make(1);
+      atframe_utils_benchmark::print_result(
+          options, atframe_utils_benchmark::run_case(name, threads, options.records, [&source](size_t, size_t) {
+            ptr_type copies[kOperationsPerRecord];
+            for (size_t k = 0; k < kOperationsPerRecord; ++k) {
+              copies[k] = source;
+            }
+            atframe_utils_benchmark::do_not_optimize(copies);
+          }));
+    }
+
+    name = make_case_name(TTRAITS::name(), "contended-weak-lock(x16)");
+    if (atframe_utils_benchmark::match_filter(options, name)) {
+      run_weak_lock_case<TTRAITS>(options, name, threads, typename TTRAITS::has_weak());
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  atframe_utils_benchmark::options_t options;
+  if (!atframe_utils_benchmark::parse_options(argc, argv, options, 1000000)) {
+    return 0;
+  }
+
+  atframe_utils_benchmark::print_header(options);
+
+  run_single_thread_cases<strong_rc_ptr_traits>(options);
+  run_single_thread_cases<atomic_rc_ptr_traits>(options);
+  run_single_thread_cases<shared_ptr_traits>(options);
+  run_single_thread_cases<intrusive_ptr_traits>(options);
+  run_single_thread_cases<atomic_intrusive_ptr_traits>(options);
+
+  // strong_rc_ptr and intrusive_ptr with plain counters can not be shared by threads
+  run_contended_cases<atomic_rc_ptr_traits>(options);
+  run_contended_cases<shared_ptr_traits>(options);
+  run_contended_cases<atomic_intrusive_ptr_traits>(options);
+
+  return 0;
+}
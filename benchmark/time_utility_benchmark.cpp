@@ -0,0 +1,145 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "time/time_utility.h"
+
+#include "benchmark_utility.h"
+
+namespace {
+
+// The cost of one record is visiting all kTimestamps timestamps, like a daily reset sweep of players
+static constexpr const size_t kTimestamps = 1024;
+
+static std::vector<time_t> make_timestamps() {
+  std::vector<time_t> ret;
+  ret.reserve(kTimestamps);
+  uint64_t seed = 20261016;
+  for (size_t i = 0; i < kTimestamps; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    // 2020-01-01 - 2030-01-01
+    ret.push_back(static_cast<time_t>(1577836800 + (seed >> 24) % 315619200ULL));
+  }
+  return ret;
+}
+
+static void run_calendar_cases(const atframe_utils_benchmark::options_t &options) {
+  using time_utility = atfw::util::time::time_utility;
+
+  size_t records = options.records / 100;
+  if (records < 10) {
+    records = 10;
+  }
+
+  std::vector<time_t> timestamps = make_timestamps();
+  std::vector<time_t> out_time;
+  out_time.resize(kTimestamps);
+  std::vector<std::tm> out_tm;
+  out_tm.resize(kTimestamps);
+  std::unique_ptr<bool[]> out_bool(new bool[kTimestamps]);
+  time_t right = timestamps[0];
+
+  std::string name = "scalar/is_same_day-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          for (size_t i = 0; i < kTimestamps; ++i) {
+            out_bool[i] = time_utility::is_same_day(timestamps[i], right);
+          }
+          atframe_utils_benchmark::do_not_optimize(out_bool);
+        }));
+  }
+
+  name = "batch/is_same_day-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          time_utility::batch_is_same_day(timestamps.data(), kTimestamps, right, out_bool.get());
+          atframe_utils_benchmark::do_not_optimize(out_bool);
+        }));
+  }
+
+  name = "scalar/get_week_start_time-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          for (size_t i = 0; i < kTimestamps; ++i) {
+            out_time[i] = time_utility::get_week_start_time(timestamps[i], 1);
+          }
+          atframe_utils_benchmark::do_not_optimize(out_time);
+        }));
+  }
+
+  name = "batch/get_week_start_time-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          time_utility::batch_get_week_start_time(timestamps.data(), kTimestamps, out_time.data(), 1);
+          atframe_utils_benchmark::do_not_optimize(out_time);
+        }));
+  }
+
+  name = "scalar/get_month_start_time-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          for (size_t i = 0; i < kTimestamps; ++i) {
+            out_time[i] = time_utility::get_month_start_time(timestamps[i]);
+          }
+          atframe_utils_benchmark::do_not_optimize(out_time);
+        }));
+  }
+
+  name = "batch/get_month_start_time-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          time_utility::batch_get_month_start_time(timestamps.data(), kTimestamps, out_time.data());
+          atframe_utils_benchmark::do_not_optimize(out_time);
+        }));
+  }
+
+  name = "scalar/get_local_tm-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          for (size_t i = 0; i < kTimestamps; ++i) {
+            out_tm[i] = time_utility::get_local_tm(timestamps[i]);
+          }
+          atframe_utils_benchmark::do_not_optimize(out_tm);
+        }));
+  }
+
+  name = "batch/get_local_tm-1024";
+  if (atframe_utils_benchmark::match_filter(options, name)) {
+    atframe_utils_benchmark::print_result(
+        options, atframe_utils_benchmark::run_case(name, 1, records, [&](size_t, size_t) {
+          time_utility::batch_get_local_tm(timestamps.data(), kTimestamps, out_tm.data());
+          atframe_utils_benchmark::do_not_optimize(out_tm);
+        }));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  atframe_utils_benchmark::options_t options;
+  if (!atframe_utils_benchmark::parse_options(argc, argv, options, 100000)) {
+    return 0;
+  }
+
+  atframe_utils_benchmark::print_header(options);
+
+  run_calendar_cases(options);
+
+  return 0;
+}
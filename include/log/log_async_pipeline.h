@@ -0,0 +1,162 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "design_pattern/noncopyable.h"
+#include "design_pattern/nomovable.h"
+#include "lock/spin_lock.h"
+
+#include "log/log_formatter.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace log {
+
+/**
+ * @brief What a producer does when its ring buffer is full
+ */
+enum class log_async_overflow_policy : int32_t {
+  kBlock = 0,           // Wait until the consumer frees enough space
+  kDropNewest = 1,      // Drop the record being written
+  kDropBelowLevel = 2,  // Drop records below log_async_options::drop_level and block for the others
+};
+
+struct ATFW_UTIL_SYMBOL_VISIBLE log_async_options {
+  // Size in bytes of each producer thread's ring buffer, rounded up to a power of 2
+  size_t ring_buffer_size;
+  log_async_overflow_policy overflow_policy;
+  // Only used by log_async_overflow_policy::kDropBelowLevel
+  log_level drop_level;
+  // Max time the consumer thread sleeps when all ring buffers are empty
+  std::chrono::microseconds idle_wait;
+
+  inline log_async_options() noexcept
+      : ring_buffer_size(static_cast<size_t>(ATFRAMEWORK_UTILS_LOG_MAX_SIZE_PER_LINE) * 16),
+        overflow_policy(log_async_overflow_policy::kBlock),
+        drop_level(log_level::kWarning),
+        idle_wait(std::chrono::milliseconds{10}) {}
+};
+
+struct ATFW_UTIL_SYMBOL_VISIBLE log_async_statistics {
+  uint64_t pushed;      // Records accepted by ring buffers
+  uint64_t dispatched;  // Records delivered to the dispatcher by the consumer thread
+  uint64_t dropped;     // Records dropped by the overflow policy
+  uint64_t blocked;     // Times a producer waited for free space
+
+  inline log_async_statistics() noexcept : pushed(0), dispatched(0), dropped(0), blocked(0) {}
+};
+
+class log_async_ring;
+
+/**
+ * @brief Asynchronous log pipeline.
+ * @note Every producer thread owns a SPSC ring buffer, a formatted record is copied into it by push() and a dedicated
+ *       consumer thread drains all rings and calls the dispatcher.
+ *       Records from the same thread keep their order, records from different threads are not globally ordered.
+ */
+class log_async_pipeline {
+ public:
+  using caller_info_t = log_formatter::caller_info_t;
+  using dispatcher_t = std::function<void(const caller_info_t &caller, const char *content, size_t content_size)>;
+  /**
+   * @brief Render binary data of a deferred record into text on the consumer thread
+   * @return written size, the output is not terminated by '\0'
+   */
+  using deferred_renderer_t = size_t (*)(char *out, size_t out_size, const unsigned char *data, size_t data_size);
+
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(log_async_pipeline)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(log_async_pipeline)
+
+ public:
+  ATFRAMEWORK_UTILS_API log_async_pipeline(const log_async_options &options, dispatcher_t dispatcher);
+  ATFRAMEWORK_UTILS_API ~log_async_pipeline();
+
+  /**
+   * @brief Start the consumer thread
+   * @return false if it's already started or stopped
+   */
+  ATFRAMEWORK_UTILS_API bool start();
+
+  /**
+   * @brief Dispatch all pending records and join the consumer thread
+   * @note push() will always return false after stop()
+   */
+  ATFRAMEWORK_UTILS_API void stop();
+
+  /**
+   * @brief Copy a record into the ring buffer of current thread
+   * @return false if the caller should write this record synchronously(pipeline not running, record too large or
+   *         called from the consumer thread). true if the record is queued or dropped by the overflow policy.
+   */
+  ATFRAMEWORK_UTILS_API bool push(const caller_info_t &caller, const char *content, size_t content_size);
+
+  /**
+   * @brief Copy a deferred record into the ring buffer of current thread
+   * @note The consumer thread calls renderer to append the text of data after content, and then calls the dispatcher
+   *       with the whole text. renderer and everything data refers to must be valid until it's dispatched.
+   * @return the same as push()
+   */
+  ATFRAMEWORK_UTILS_API bool push(const caller_info_t &caller, const char *content, size_t content_size,
+                                  deferred_renderer_t renderer, const void *data, size_t data_size);
+
+  /**
+   * @brief Wait until all records pushed before this call are dispatched
+   */
+  ATFRAMEWORK_UTILS_API void flush();
+
+  ATFRAMEWORK_UTILS_API log_async_statistics get_statistics() const noexcept;
+
+  UTIL_FORCEINLINE const log_async_options &get_options() const noexcept { return options_; }
+
+  UTIL_FORCEINLINE bool is_running() const noexcept { return running_.load(std::memory_order_acquire); }
+
+ private:
+  log_async_ring *mutable_ring();
+  size_t dispatch_ring(log_async_ring &ring, size_t max_records, std::unique_ptr<char[]> &render_buffer);
+  bool has_pending_records(const std::vector<std::shared_ptr<log_async_ring>> &rings) const;
+  void wakeup_consumer();
+  void consumer_main();
+
+ private:
+  log_async_options options_;
+  dispatcher_t dispatcher_;
+  uint64_t pipeline_id_;
+
+  std::atomic<bool> running_;
+  std::atomic<bool> stop_requested_;
+  std::thread consumer_thread_;
+  std::thread::id consumer_thread_id_;
+
+  mutable lock::spin_lock rings_lock_;
+  std::vector<std::shared_ptr<log_async_ring>> rings_;
+  std::atomic<uint64_t> rings_version_;
+
+  std::mutex wait_lock_;
+  std::condition_variable consumer_cond_;
+  std::condition_variable flush_cond_;
+  std::atomic<bool> consumer_sleeping_;
+  std::atomic<int32_t> flush_waiters_;
+
+  std::atomic<uint64_t> stat_dispatched_;
+  // Counters of rings already removed, the others are summed from alive rings
+  std::atomic<uint64_t> stat_retired_pushed_;
+  std::atomic<uint64_t> stat_retired_dropped_;
+  std::atomic<uint64_t> stat_retired_blocked_;
+};
+}  // namespace log
+ATFRAMEWORK_UTILS_NAMESPACE_END
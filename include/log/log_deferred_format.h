@@ -0,0 +1,340 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "nostd/string_view.h"
+#include "nostd/type_traits.h"
+#include "nostd/utility_sequence.h"
+#include "string/string_format.h"
+
+#if defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace log {
+namespace details {
+
+enum class log_deferred_arg_kind : int32_t {
+  kValue = 0,   // Trivially copyable values which are formatted by value
+  kString = 1,  // Characters are copied, the argument may be destroyed before rendering
+  kOther = 2,   // Formatted into a string on the calling thread
+};
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg_kind_of
+    : public std::integral_constant<
+          log_deferred_arg_kind,
+          (std::is_arithmetic<T>::value || std::is_same<T, const void *>::value || std::is_same<T, void *>::value ||
+           std::is_same<T, std::nullptr_t>::value)
+              ? log_deferred_arg_kind::kValue
+              : log_deferred_arg_kind::kOther> {};
+
+template <>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg_kind_of<const char *>
+    : public std::integral_constant<log_deferred_arg_kind, log_deferred_arg_kind::kString> {};
+
+template <>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg_kind_of<char *>
+    : public std::integral_constant<log_deferred_arg_kind, log_deferred_arg_kind::kString> {};
+
+template <size_t N>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg_kind_of<char[N]>
+    : public std::integral_constant<log_deferred_arg_kind, log_deferred_arg_kind::kString> {};
+
+template <class Traits, class Allocator>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg_kind_of<std::basic_string<char, Traits, Allocator>>
+    : public std::integral_constant<log_deferred_arg_kind, log_deferred_arg_kind::kString> {};
+
+template <class Traits>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg_kind_of<nostd::basic_string_view<char, Traits>>
+    : public std::integral_constant<log_deferred_arg_kind, log_deferred_arg_kind::kString> {};
+
+#  if defined(__cpp_lib_string_view) || ((defined(__cplusplus) && __cplusplus >= 201703L) || \
+                                         (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+template <class Traits>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg_kind_of<std::basic_string_view<char, Traits>>
+    : public std::integral_constant<log_deferred_arg_kind, log_deferred_arg_kind::kString> {};
+#  endif
+
+using log_deferred_string_view = ATFRAMEWORK_UTILS_STRING_FWAPI_NAMESPACE_ID::basic_string_view<char>;
+
+inline unsigned char *log_deferred_write_string(unsigned char *out, unsigned char *end, const char *str, size_t sz) {
+  uint32_t len = static_cast<uint32_t>(sz);
+  if (nullptr == out || static_cast<size_t>(end - out) < sizeof(len) + sz) {
+    return nullptr;
+  }
+  memcpy(out, &len, sizeof(len));
+  if (sz > 0) {
+    memcpy(out + sizeof(len), str, sz);
+  }
+  return out + sizeof(len) + sz;
+}
+
+inline log_deferred_string_view log_deferred_read_string(const unsigned char *&in) {
+  uint32_t len;
+  memcpy(&len, in, sizeof(len));
+  log_deferred_string_view ret{reinterpret_cast<const char *>(in + sizeof(len)), static_cast<size_t>(len)};
+  in += sizeof(len) + len;
+  return ret;
+}
+
+/**
+ * @brief Check if the format spec of any replacement field can not be applied to a pre-rendered argument
+ * @param is_other is_other[i] is true if the i-th argument is formatted into a string on the calling thread
+ * @return true if a pre-rendered argument has a format spec, or the arguments of a field can not be known(named
+ *         arguments and nested replacement fields)
+ */
+inline bool log_deferred_has_other_arg_spec(log_deferred_string_view fmt_text, const bool *is_other,
+                                            size_t arg_count) {
+  const char *p = fmt_text.data();
+  const char *end = p + fmt_text.size();
+  size_t auto_index = 0;
+  while (p < end) {
+    if ('{' != *p) {
+      ++p;
+      continue;
+    }
+
+    ++p;
+    // Escaped "{{"
+    if (p < end && '{' == *p) {
+      ++p;
+      continue;
+    }
+
+    size_t index = 0;
+    if (p < end && *p >= '0' && *p <= '9') {
+      while (p < end && *p >= '0' && *p <= '9') {
+        index = index * 10 + static_cast<size_t>(*p - '0');
+        ++p;
+      }
+    } else if (p < end && (':' == *p || '}' == *p)) {
+      index = auto_index++;
+    } else {
+      return true;
+    }
+
+    bool has_spec = p < end && '}' != *p;
+    bool closed = false;
+    while (p < end && !closed) {
+      // Dynamic width or precision, which uses other arguments
+      if ('{' == *p) {
+        return true;
+      }
+      closed = '}' == *p;
+      ++p;
+    }
+    if (!closed) {
+      return true;
+    }
+
+    if (has_spec && index < arg_count && is_other[index]) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+template <class T, log_deferred_arg_kind = log_deferred_arg_kind_of<T>::value>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg;
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg<T, log_deferred_arg_kind::kValue> {
+  using decoded_type = T;
+
+  UTIL_FORCEINLINE static unsigned char *encode(unsigned char *out, unsigned char *end, const T &value) {
+    if (nullptr == out || static_cast<size_t>(end - out) < sizeof(T)) {
+      return nullptr;
+    }
+    memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+  }
+
+  UTIL_FORCEINLINE static decoded_type decode(const unsigned char *&in) {
+    T ret;
+    memcpy(&ret, in, sizeof(T));
+    in += sizeof(T);
+    return ret;
+  }
+};
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg<T, log_deferred_arg_kind::kString> {
+  using decoded_type = log_deferred_string_view;
+
+  UTIL_FORCEINLINE static unsigned char *encode(unsigned char *out, unsigned char *end, const char *value) {
+    // Let the synchronous path report the null string
+    if (nullptr == value) {
+      return nullptr;
+    }
+    return log_deferred_write_string(out, end, value, strlen(value));
+  }
+
+  template <class U>
+  UTIL_FORCEINLINE static unsigned char *encode(unsigned char *out, unsigned char *end, const U &value) {
+    return log_deferred_write_string(out, end, value.data(), value.size());
+  }
+
+  UTIL_FORCEINLINE static decoded_type decode(const unsigned char *&in) { return log_deferred_read_string(in); }
+};
+
+template <class T>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_arg<T, log_deferred_arg_kind::kOther> {
+  using decoded_type = log_deferred_string_view;
+
+  UTIL_FORCEINLINE static unsigned char *encode(unsigned char *out, unsigned char *end, const T &value) {
+    if (nullptr == out) {
+      return nullptr;
+    }
+
+    // Reserve the length and format in place
+    uint32_t len = 0;
+    if (static_cast<size_t>(end - out) < sizeof(len)) {
+      return nullptr;
+    }
+    char *text = reinterpret_cast<char *>(out + sizeof(len));
+    size_t text_capacity = static_cast<size_t>(end - out) - sizeof(len);
+    auto result = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::format_to_n(text, text_capacity, "{}", value);
+    if (static_cast<size_t>(result.size) > text_capacity) {
+      return nullptr;
+    }
+    len = static_cast<uint32_t>(result.size);
+    memcpy(out, &len, sizeof(len));
+    return out + sizeof(len) + len;
+  }
+
+  UTIL_FORCEINLINE static decoded_type decode(const unsigned char *&in) { return log_deferred_read_string(in); }
+};
+
+}  // namespace details
+
+/**
+ * @brief Serialize arguments of a format call into compact binary data, and render it into text later
+ * @note Data layout: [pointer of format string][size of format string][arg0][arg1]...
+ *       Arithmetic values and void pointers are copied by value, characters of strings are copied, and other types
+ *       are formatted into strings with "{}" when encoding.
+ * @note The format string is referenced by pointer, it must have static storage duration(a string literal).
+ * @note encode() fails, so the caller formats synchronously, when the result may differ from formatting synchronously:
+ *       a format spec is used by an argument of other types, or a null C string is passed.
+ */
+template <class... TARGS>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY log_deferred_codec {
+ public:
+  /**
+   * @brief Encode format string and arguments into [out, end)
+   * @return the end of encoded data, or nullptr if there is not enough space
+   */
+  UTIL_FORCEINLINE static unsigned char *encode(unsigned char *out, unsigned char *end,
+                                                details::log_deferred_string_view fmt_text, const TARGS &...args) {
+    const char *fmt_data = fmt_text.data();
+    size_t fmt_size = fmt_text.size();
+    if (nullptr == out || static_cast<size_t>(end - out) < sizeof(fmt_data) + sizeof(fmt_size)) {
+      return nullptr;
+    }
+    if (has_other_arg_spec(fmt_text)) {
+      return nullptr;
+    }
+
+    memcpy(out, &fmt_data, sizeof(fmt_data));
+    out += sizeof(fmt_data);
+    memcpy(out, &fmt_size, sizeof(fmt_size));
+    out += sizeof(fmt_size);
+
+    return encode_args(out, end, args...);
+  }
+
+  /**
+   * @brief Render encoded data into text, the output is truncated to out_size and not terminated by '\0'
+   * @return written size
+   */
+  static size_t render(char *out, size_t out_size, const unsigned char *data, size_t data_size) {
+    const char *fmt_data;
+    size_t fmt_size;
+    if (nullptr == out || 0 == out_size || nullptr == data || data_size < sizeof(fmt_data) + sizeof(fmt_size)) {
+      return 0;
+    }
+    memcpy(&fmt_data, data, sizeof(fmt_data));
+    data += sizeof(fmt_data);
+    memcpy(&fmt_size, data, sizeof(fmt_size));
+    data += sizeof(fmt_size);
+
+    // Elements of braced-init-list are evaluated in order
+    std::tuple<typename details::log_deferred_arg<TARGS>::decoded_type...> values{
+        details::log_deferred_arg<TARGS>::decode(data)...};
+    return render_values(out, out_size, details::log_deferred_string_view{fmt_data, fmt_size}, values,
+                         nostd::index_sequence_for<TARGS...>{});
+  }
+
+ private:
+  UTIL_FORCEINLINE static bool has_other_arg_spec(details::log_deferred_string_view fmt_text) {
+    // The format string is scanned only when there are arguments of other types
+    const bool is_other[] = {
+        (details::log_deferred_arg_kind_of<TARGS>::value == details::log_deferred_arg_kind::kOther)..., false};
+    bool has_other = false;
+    for (size_t i = 0; i < sizeof...(TARGS); ++i) {
+      has_other = has_other || is_other[i];
+    }
+    return has_other && details::log_deferred_has_other_arg_spec(fmt_text, is_other, sizeof...(TARGS));
+  }
+
+  UTIL_FORCEINLINE static unsigned char *encode_args(unsigned char *out, unsigned char *) { return out; }
+
+  template <class TARG, class... TREST>
+  UTIL_FORCEINLINE static unsigned char *encode_args(unsigned char *out, unsigned char *end, const TARG &arg,
+                                                     const TREST &...rest) {
+    out = details::log_deferred_arg<TARG>::encode(out, end, arg);
+    return encode_args(out, end, rest...);
+  }
+
+  template <class TVALUES, size_t... INDEXES>
+  static size_t render_values(char *out, size_t out_size, details::log_deferred_string_view fmt_text,
+                              TVALUES &values, nostd::index_sequence<INDEXES...>) {
+    using truncating_iterator_t = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::details::truncating_iterator<char *>;
+    using truncating_iterator_size_type = typename truncating_iterator_t::size_type;
+    truncating_iterator_t begin{out, static_cast<truncating_iterator_size_type>(out_size)};
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    try {
+#  endif
+      truncating_iterator_t res = ATFRAMEWORK_UTILS_STRING_FWAPI_NAMESPACE_ID::vformat_to(
+          begin, fmt_text,
+          ATFRAMEWORK_UTILS_NAMESPACE_ID::string::details::make_format_args_helper<char>::make(
+              std::get<INDEXES>(values)...));
+      return static_cast<size_t>(res.base() - out);
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    } catch (const ATFRAMEWORK_UTILS_STRING_FWAPI_NAMESPACE_ID::format_error &e) {
+      return copy_error(out, out_size, e.what());
+    } catch (const std::runtime_error &e) {
+      return copy_error(out, out_size, e.what());
+    } catch (...) {
+      return copy_error(out, out_size, "format got unknown exception");
+    }
+#  endif
+  }
+
+  static size_t copy_error(char *out, size_t out_size, const char *message) {
+    size_t ret = strlen(message);
+    if (ret > out_size) {
+      ret = out_size;
+    }
+    memcpy(out, message, ret);
+    return ret;
+  }
+};
+
+}  // namespace log
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
@@ -17,6 +17,7 @@
 #include <cstring>
 #include <ctime>
 #include <string>
+#include <vector>
 #include "config/compile_optimize.h"
 
 #if defined(ATFRAMEWORK_UTILS_ENABLE_SOURCE_LOCATION) && ATFRAMEWORK_UTILS_ENABLE_SOURCE_LOCATION
@@ -52,6 +53,49 @@ class log_formatter {
     };
   };
 
+  /**
+   * @brief 预编译格式的操作类型，每个类型对应一个格式规则
+   */
+  enum class format_op_type : uint8_t {
+    kLiteral = 0,  // 原样输出的字符串
+    kYear,         // %Y
+    kYearShort,    // %y
+    kMonth,        // %m
+    kYearDay,      // %j
+    kMonthDay,     // %d
+    kWeekDay,      // %w
+    kHour,         // %H
+    kHour12,       // %I
+    kMinute,       // %M
+    kSecond,       // %S
+    kDate,         // %F
+    kTime,         // %T
+    kHourMinute,   // %R
+    kSubSecond,    // %f
+    kLevelName,    // %L
+    kLevelId,      // %l
+    kFilePath,     // %s
+    kFileName,     // %k
+    kLineNumber,   // %n
+    kFuncName,     // %C
+    kRotateIndex,  // %N
+  };
+
+  struct ATFW_UTIL_SYMBOL_VISIBLE format_op_t {
+    format_op_type type;
+    // kLiteral时为字符串在compiled_format_t::pattern中的位置和长度
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  /**
+   * @brief 预编译的格式，相邻的普通字符会被合并成一个kLiteral操作
+   */
+  struct ATFW_UTIL_SYMBOL_VISIBLE compiled_format_t {
+    std::string pattern;
+    std::vector<format_op_t> ops;
+  };
+
   struct ATFW_UTIL_SYMBOL_VISIBLE caller_info_t {
     log_level level_id;
     nostd::string_view level_name;
@@ -131,6 +175,20 @@ class log_formatter {
   ATFRAMEWORK_UTILS_API static size_t format(char *buff, size_t bufz, const char *fmt, size_t fmtz,
                                              const caller_info_t &caller);
 
+  /**
+   * @brief 预编译格式，格式规则和format一致
+   * @note 高频使用的固定格式(比如日志前缀)可以预编译后使用，以减少每次格式化时的解析开销
+   * @param out 输出的预编译格式
+   */
+  ATFRAMEWORK_UTILS_API static void compile(compiled_format_t &out, const char *fmt, size_t fmtz);
+
+  /**
+   * @brief 使用预编译格式格式化到缓冲区，输出和使用原始格式调用format完全一致
+   * @return 返回消耗的缓存区长度
+   */
+  ATFRAMEWORK_UTILS_API static size_t format(char *buff, size_t bufz, const compiled_format_t &fmt,
+                                             const caller_info_t &caller);
+
   ATFRAMEWORK_UTILS_API static bool check_rotation_var(const char *fmt, size_t fmtz);
 
   ATFRAMEWORK_UTILS_API static bool has_format(const char *fmt, size_t fmtz);
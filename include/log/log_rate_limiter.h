@@ -0,0 +1,374 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+
+#if defined(__linux__)
+#  include <time.h>
+#endif
+
+#include "config/compile_optimize.h"
+#include "design_pattern/nomovable.h"
+#include "design_pattern/noncopyable.h"
+#include "lock/lock_holder.h"
+#include "lock/spin_lock.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace log {
+
+/**
+ * @brief Counter of suppressed records of a log callsite, the number is reported at most once per summary interval
+ * @note Suppressed records are reported by the next written record of the callsite, or by log_wrapper::update() if the
+ *       callsite has been registered by log_wrapper::register_callsite_summary().
+ * @note Records counted by a thread_state_t only write the thread_state_t, all thread states are folded into the count
+ *       when a summary is taken.
+ * @note It's trivially destructible, so registered counters in static storage are still valid during exit.
+ */
+class log_callsite_suppressed_counter {
+ public:
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(log_callsite_suppressed_counter)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(log_callsite_suppressed_counter)
+
+ public:
+  /**
+   * @brief Suppressed records counted by one thread, it's linked to the counter by the first add()
+   * @note Only the owner thread writes the count. The count is moved into the counter when the state is destroyed, so
+   *       it must be destroyed before the counter.
+   */
+  class thread_state_t {
+   public:
+    ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(thread_state_t)
+    ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(thread_state_t)
+
+   public:
+    inline thread_state_t() noexcept : owner_(nullptr), suppressed_(0), prev_(nullptr), next_(nullptr) {}
+
+    inline ~thread_state_t() {
+      if (nullptr != owner_) {
+        owner_->unlink(*this);
+      }
+    }
+
+   private:
+    friend class log_callsite_suppressed_counter;
+
+    log_callsite_suppressed_counter *owner_;
+    std::atomic<uint64_t> suppressed_;
+    thread_state_t *prev_;
+    thread_state_t *next_;
+  };
+
+ public:
+  explicit log_callsite_suppressed_counter(std::chrono::nanoseconds summary_interval) noexcept
+      : summary_interval_ns_(static_cast<int64_t>(summary_interval.count())),
+        // The first summary can be reported at any time
+        last_summary_ns_(now_ns() - summary_interval_ns_),
+        suppressed_(0),
+        reported_(0),
+        thread_states_(nullptr),
+        report_owner_(nullptr) {}
+
+  UTIL_FORCEINLINE void add(uint64_t count = 1) noexcept { suppressed_.fetch_add(count, std::memory_order_relaxed); }
+
+  /**
+   * @brief Count suppressed records of the current thread, there is no write to shared cache lines after the first call
+   */
+  UTIL_FORCEINLINE void add(thread_state_t &state, uint64_t count = 1) noexcept {
+    if (nullptr == state.owner_) {
+      link(state);
+    }
+    // Only the owner thread writes it, so there is no RMW
+    state.suppressed_.store(state.suppressed_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Take the suppressed count if it's time to report a summary
+   * @return suppressed count since last summary, or 0 if there is nothing to report now
+   * @note Thread states are folded at most once per summary interval, if there is nothing new then, the next summary is
+   *       reported one interval later.
+   */
+  UTIL_FORCEINLINE uint64_t take(int64_t now_ns) noexcept {
+    uint64_t reported = reported_.load(std::memory_order_relaxed);
+    if (nullptr == thread_states_.load(std::memory_order_relaxed) &&
+        reported == suppressed_.load(std::memory_order_relaxed)) {
+      return 0;
+    }
+
+    int64_t last_summary_ns = last_summary_ns_.load(std::memory_order_relaxed);
+    if (now_ns - last_summary_ns < summary_interval_ns_) {
+      return 0;
+    }
+    if (!last_summary_ns_.compare_exchange_strong(last_summary_ns, now_ns, std::memory_order_relaxed)) {
+      return 0;
+    }
+
+    // Counts only grow, a slower taker with a smaller total reports nothing
+    uint64_t total = get_total();
+    while (total > reported && !reported_.compare_exchange_weak(reported, total, std::memory_order_relaxed)) {
+    }
+    return total > reported ? total - reported : 0;
+  }
+
+  inline uint64_t get_suppressed() const noexcept {
+    uint64_t total = get_total();
+    uint64_t reported = reported_.load(std::memory_order_relaxed);
+    return total > reported ? total - reported : 0;
+  }
+
+  UTIL_FORCEINLINE int64_t get_summary_interval_ns() const noexcept { return summary_interval_ns_; }
+
+  /**
+   * @brief The logger which reports this counter periodically, nullptr if it's not registered
+   */
+  UTIL_FORCEINLINE const void *get_report_owner() const noexcept {
+    return report_owner_.load(std::memory_order_relaxed);
+  }
+
+  UTIL_FORCEINLINE void set_report_owner(const void *owner) noexcept {
+    report_owner_.store(owner, std::memory_order_relaxed);
+  }
+
+  UTIL_FORCEINLINE static int64_t now_ns() noexcept {
+    return static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /**
+   * @brief Read the coarse monotonic clock, it's much cheaper than now_ns() but only updated every few milliseconds
+   */
+  UTIL_FORCEINLINE static int64_t coarse_now_ns() noexcept {
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    struct timespec ts;
+    if (0 == clock_gettime(CLOCK_MONOTONIC_COARSE, &ts)) {
+      return static_cast<int64_t>(ts.tv_sec) * 1000000000 + static_cast<int64_t>(ts.tv_nsec);
+    }
+#endif
+    return now_ns();
+  }
+
+ private:
+  void link(thread_state_t &state) noexcept {
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock> holder(
+        thread_states_lock_);
+    thread_state_t *head = thread_states_.load(std::memory_order_relaxed);
+    state.owner_ = this;
+    state.prev_ = nullptr;
+    state.next_ = head;
+    if (nullptr != head) {
+      head->prev_ = &state;
+    }
+    thread_states_.store(&state, std::memory_order_relaxed);
+  }
+
+  void unlink(thread_state_t &state) noexcept {
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock> holder(
+        thread_states_lock_);
+    if (nullptr != state.prev_) {
+      state.prev_->next_ = state.next_;
+    } else {
+      thread_states_.store(state.next_, std::memory_order_relaxed);
+    }
+    if (nullptr != state.next_) {
+      state.next_->prev_ = state.prev_;
+    }
+    state.owner_ = nullptr;
+
+    // Move the count under the lock, so get_total() never misses or double counts it
+    suppressed_.fetch_add(state.suppressed_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  uint64_t get_total() const noexcept {
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock> holder(
+        thread_states_lock_);
+    uint64_t ret = suppressed_.load(std::memory_order_relaxed);
+    for (const thread_state_t *state = thread_states_.load(std::memory_order_relaxed); nullptr != state;
+         state = state->next_) {
+      ret += state->suppressed_.load(std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+ private:
+  const int64_t summary_interval_ns_;
+  std::atomic<int64_t> last_summary_ns_;
+  // Count of records suppressed without a thread state, or moved from destroyed thread states
+  std::atomic<uint64_t> suppressed_;
+  std::atomic<uint64_t> reported_;
+  mutable ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock thread_states_lock_;
+  std::atomic<thread_state_t *> thread_states_;
+  std::atomic<const void *> report_owner_;
+};
+
+/**
+ * @brief Token bucket rate limiter of a log callsite, allow rate_per_second records per second and burst records at
+ *        most at the same time.
+ * @note It's implemented by GCRA(generic cell rate algorithm), the state is only one atomic timepoint on the coarse
+ *       clock. With a thread_state_t, suppressed records cost a relaxed load, a coarse clock read and a write to the
+ *       thread state, only records which pass CAS the timepoint and read the precise clock for the summary. The limit
+ *       is as precise as the coarse clock, which is a few milliseconds on Linux.
+ */
+class log_rate_limiter {
+ public:
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(log_rate_limiter)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(log_rate_limiter)
+
+ public:
+  /**
+   * @param rate_per_second records allowed per second, 0 means unlimited
+   * @param burst records allowed at the same time, at least 1
+   * @param summary_interval min interval between two summaries of suppressed records
+   */
+  explicit log_rate_limiter(uint32_t rate_per_second, uint32_t burst = 1,
+                            std::chrono::nanoseconds summary_interval = std::chrono::seconds{1}) noexcept
+      : interval_ns_(0 == rate_per_second ? 0 : 1000000000 / static_cast<int64_t>(rate_per_second)),
+        tolerance_ns_(interval_ns_ * static_cast<int64_t>(burst > 1 ? burst - 1 : 0)),
+        theoretical_arrival_ns_(0),
+        suppressed_(summary_interval) {}
+
+  // Per thread state of a callsite, the limit is shared by all threads so only suppressed records are counted in it
+  using thread_state_t = log_callsite_suppressed_counter::thread_state_t;
+
+  /**
+   * @brief Check if a record can be written now
+   * @param suppressed output the count of suppressed records to report, 0 if there is nothing to report now
+   * @return true if the record can be written
+   */
+  UTIL_FORCEINLINE bool check(uint64_t &suppressed) noexcept { return check(suppressed, nullptr); }
+
+  /**
+   * @brief Check if a record can be written now, suppressed records are counted in the thread state
+   * @param suppressed output the count of suppressed records to report, 0 if there is nothing to report now
+   * @param state thread local state of this limiter
+   * @return true if the record can be written
+   */
+  UTIL_FORCEINLINE bool check(uint64_t &suppressed, thread_state_t &state) noexcept {
+    return check(suppressed, &state);
+  }
+
+  UTIL_FORCEINLINE uint64_t get_suppressed() const noexcept { return suppressed_.get_suppressed(); }
+
+  UTIL_FORCEINLINE log_callsite_suppressed_counter &get_suppressed_counter() noexcept { return suppressed_; }
+
+ private:
+  UTIL_FORCEINLINE bool check(uint64_t &suppressed, thread_state_t *state) noexcept {
+    suppressed = 0;
+    if (0 == interval_ns_) {
+      return true;
+    }
+
+    // Records over the limit return in the first round without a CAS or a precise clock read
+    int64_t now = log_callsite_suppressed_counter::coarse_now_ns();
+    int64_t tat = theoretical_arrival_ns_.load(std::memory_order_relaxed);
+    while (true) {
+      int64_t base = tat > now ? tat : now;
+      if (base - now > tolerance_ns_) {
+        if (nullptr != state) {
+          suppressed_.add(*state);
+        } else {
+          suppressed_.add();
+        }
+        return false;
+      }
+
+      if (theoretical_arrival_ns_.compare_exchange_weak(tat, base + interval_ns_, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+
+    suppressed = suppressed_.take(log_callsite_suppressed_counter::now_ns());
+    return true;
+  }
+
+ private:
+  const int64_t interval_ns_;
+  const int64_t tolerance_ns_;
+  std::atomic<int64_t> theoretical_arrival_ns_;
+  log_callsite_suppressed_counter suppressed_;
+};
+
+/**
+ * @brief 1-in-N sampler of a log callsite, the first record and every N-th record after it are written
+ */
+class log_sampler {
+ public:
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(log_sampler)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(log_sampler)
+
+ public:
+  /**
+   * @param n write 1 record in every n records, 0 and 1 mean writing all records
+   * @param summary_interval min interval between two summaries of suppressed records
+   */
+  explicit log_sampler(uint32_t n, std::chrono::nanoseconds summary_interval = std::chrono::seconds{1}) noexcept
+      : sample_rate_(0 == n ? 1 : n), counter_(0), suppressed_(summary_interval) {}
+
+  // Per thread state of a callsite, used to sample without touching any shared cache line for suppressed records
+  struct thread_state_t {
+    uint64_t counter;
+    log_callsite_suppressed_counter::thread_state_t suppressed;
+
+    inline thread_state_t() noexcept : counter(0) {}
+  };
+
+  /**
+   * @brief Check if a record can be written now, 1 in every n records of all threads is written
+   * @param suppressed output the count of suppressed records to report, 0 if there is nothing to report now
+   * @return true if the record can be written
+   */
+  UTIL_FORCEINLINE bool check(uint64_t &suppressed) noexcept {
+    suppressed = 0;
+    if (1 == sample_rate_) {
+      return true;
+    }
+
+    if (0 != counter_.fetch_add(1, std::memory_order_relaxed) % sample_rate_) {
+      suppressed_.add();
+      return false;
+    }
+
+    suppressed = suppressed_.take(log_callsite_suppressed_counter::now_ns());
+    return true;
+  }
+
+  /**
+   * @brief Check if a record can be written now, 1 in every n records of each thread is written
+   * @param suppressed output the count of suppressed records to report, 0 if there is nothing to report now
+   * @param state thread local state of this sampler
+   * @return true if the record can be written
+   */
+  UTIL_FORCEINLINE bool check(uint64_t &suppressed, thread_state_t &state) noexcept {
+    suppressed = 0;
+    if (1 == sample_rate_) {
+      return true;
+    }
+
+    if (0 != state.counter++ % sample_rate_) {
+      suppressed_.add(state.suppressed);
+      return false;
+    }
+
+    suppressed = suppressed_.take(log_callsite_suppressed_counter::now_ns());
+    return true;
+  }
+
+  UTIL_FORCEINLINE uint64_t get_suppressed() const noexcept { return suppressed_.get_suppressed(); }
+
+  UTIL_FORCEINLINE log_callsite_suppressed_counter &get_suppressed_counter() noexcept { return suppressed_; }
+
+ private:
+  const uint64_t sample_rate_;
+  std::atomic<uint64_t> counter_;
+  log_callsite_suppressed_counter suppressed_;
+};
+
+}  // namespace log
+ATFRAMEWORK_UTILS_NAMESPACE_END
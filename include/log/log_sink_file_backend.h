@@ -9,6 +9,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -16,6 +17,7 @@
 #include <string>
 #include <vector>
 
+#include "algorithm/compression.h"
 #include "lock/spin_lock.h"
 #include "lock/spin_rw_lock.h"
 #include "log/log_formatter.h"
@@ -97,6 +99,74 @@ class log_sink_file_backend {
 
   ATFRAMEWORK_UTILS_API log_sink_file_backend &set_rotate_size(uint32_t sz);
 
+  /**
+   * @brief 获取写缓冲区大小
+   * @return 写缓冲区大小，0表示未开启缓冲写出
+   */
+  ATFRAMEWORK_UTILS_API size_t get_write_buffer_size() const;
+
+  /**
+   * @brief 设置写缓冲区大小，开启后日志先写入用户态缓冲区，在缓冲区满、超时、日志级别触发auto_flush、
+   *        定期刷入或切换文件时一次性通过writev写出，减少stdio的锁和系统调用开销
+   * @param sz 写缓冲区大小，设为0则关闭缓冲写出
+   */
+  ATFRAMEWORK_UTILS_API log_sink_file_backend &set_write_buffer_size(size_t sz);
+
+  /**
+   * @brief 获取缓冲区中日志的最大停留时间
+   */
+  ATFRAMEWORK_UTILS_API std::chrono::milliseconds get_write_buffer_timeout() const;
+
+  /**
+   * @brief 设置缓冲区中日志的最大停留时间，超时后下一条日志会触发写出
+   * @param timeout 最大停留时间，设为0则仅按缓冲区大小写出
+   * @note 没有新日志时不会触发超时写出，可以定期调用flush()
+   */
+  ATFRAMEWORK_UTILS_API log_sink_file_backend &set_write_buffer_timeout(std::chrono::milliseconds timeout);
+
+  /**
+   * @brief 写出缓冲区中的日志并刷入文件系统
+   */
+  ATFRAMEWORK_UTILS_API void flush();
+
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  /**
+   * @brief 获取滚动后压缩日志文件使用的算法
+   * @return 压缩算法，kNone表示未开启压缩
+   */
+  ATFRAMEWORK_UTILS_API compression::algorithm_t get_rotate_compression() const;
+
+  /**
+   * @brief 获取滚动后压缩日志文件使用的压缩级别
+   */
+  ATFRAMEWORK_UTILS_API compression::level_t get_rotate_compression_level() const;
+
+  /**
+   * @brief 设置滚动或按时间切换文件后，压缩已写完的日志文件。压缩在后台线程中执行，不会阻塞写日志的线程
+   * @param algorithm 压缩算法，设为kNone或当前构建不支持的算法则关闭压缩
+   * @param level 压缩级别
+   * @note 压缩后的文件名为原文件名加上 get_compression_suffix() 的后缀，压缩完成后删除原文件
+   * @note LZ4的压缩数据不包含原始长度，所以LZ4文件的开头是8字节小端序的原始长度
+   * @note 文件被所有引用释放(关闭)以后才会开始压缩
+   */
+  ATFRAMEWORK_UTILS_API log_sink_file_backend &set_rotate_compression(
+      compression::algorithm_t algorithm, compression::level_t level = compression::level_t::kDefault);
+
+  /**
+   * @brief 等待后台的压缩任务完成
+   * @param timeout 最长等待时间
+   * @return 所有压缩任务都已完成返回true
+   */
+  ATFRAMEWORK_UTILS_API bool wait_rotate_compression(std::chrono::milliseconds timeout);
+
+  /**
+   * @brief 获取压缩后的日志文件后缀
+   * @param algorithm 压缩算法
+   * @return 文件后缀，kNone返回空字符串
+   */
+  ATFRAMEWORK_UTILS_API static const char *get_compression_suffix(compression::algorithm_t algorithm);
+#endif
+
  private:
   ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void init();
 
@@ -108,10 +178,26 @@ class log_sink_file_backend {
 
   ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void after_write_log(const log_formatter::caller_info_t &caller,
                                                                            FILE &f, size_t content_size);
+  ATFRAMEWORK_UTILS_API void write_buffered_log(const log_formatter::caller_info_t &caller, FILE &f,
+                                                nostd::string_view content);
+
+  ATFRAMEWORK_UTILS_API void flush_write_buffer(FILE &f, nostd::string_view content);
+
   ATFRAMEWORK_UTILS_API void check_update();
 
   ATFRAMEWORK_UTILS_API void reset_log_file();
 
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  ATFRAMEWORK_UTILS_API bool is_compressed_segment_exist(const char *file_path) const;
+
+  ATFRAMEWORK_UTILS_API void remove_compressed_segment(const char *file_path) const;
+
+  ATFRAMEWORK_UTILS_API void compress_finished_log_file(const std::string &file_path,
+                                                        std::weak_ptr<std::FILE> opened_file);
+
+  ATFRAMEWORK_UTILS_API void cancel_finished_log_file_compression(const std::string &file_path);
+#endif
+
  private:
   // 第一个first表示是否需要format
   std::string path_pattern_;
@@ -127,6 +213,12 @@ class log_sink_file_backend {
   lock::spin_rw_lock fs_lock_;
   lock::spin_lock init_lock_;
 
+  size_t write_buffer_size_;                       // 写缓冲区大小，0表示关闭
+  std::chrono::milliseconds write_buffer_timeout_;  // 缓冲区中日志的最大停留时间
+  std::chrono::system_clock::time_point write_buffer_first_timepoint_;
+  std::string write_buffer_;
+  lock::spin_lock write_buffer_lock_;
+
   struct file_impl_t {
     log_level auto_flush;  // 当日记级别高于或等于这个时，将会强制执行一次flush
     uint32_t rotation_index;
@@ -137,6 +229,15 @@ class log_sink_file_backend {
     std::string file_path;
   };
   file_impl_t log_file_;
+
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  struct compression_worker_t;
+
+  compression::algorithm_t rotate_compression_;     // 滚动后压缩文件的算法
+  compression::level_t rotate_compression_level_;  // 滚动后压缩文件的压缩级别
+  std::unique_ptr<compression_worker_t> compression_worker_;
+  lock::spin_lock compression_worker_lock_;
+#endif
 };
 }  // namespace log
 ATFRAMEWORK_UTILS_NAMESPACE_END
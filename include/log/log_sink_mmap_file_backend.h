@@ -0,0 +1,144 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#ifndef UTIL_LOG_LOG_SINK_MMAP_FILE_BACKEND_H
+#define UTIL_LOG_LOG_SINK_MMAP_FILE_BACKEND_H
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <stdint.h>
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <string>
+
+#include "lock/spin_lock.h"
+#include "lock/spin_rw_lock.h"
+#include "log/log_formatter.h"
+
+#if defined(ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT) && ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace log {
+
+/**
+ * @brief File sink which writes records into memory mapped files
+ * @note Every rotation file is preallocated to max_file_size and mapped into memory, writers reserve space with an
+ *       atomic cursor and copy records without lock. The file is truncated to the real size when it's closed.
+ *       File name pattern and rotation rules are the same as log_sink_file_backend.
+ * @note Records in page cache survive process crash but not system crash, use set_auto_flush() or flush() to msync.
+ */
+class log_sink_mmap_file_backend {
+ public:
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend();
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend(const std::string &file_name_pattern);
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend(const log_sink_mmap_file_backend &other);
+  ATFRAMEWORK_UTILS_API ~log_sink_mmap_file_backend();
+
+ public:
+  /**
+   * @brief Set file name pattern
+   * @param file_name_pattern file name pattern, the same as log_sink_file_backend::set_file_pattern
+   * @see log_formatter::format
+   */
+  ATFRAMEWORK_UTILS_API void set_file_pattern(const std::string &file_name_pattern);
+
+  ATFRAMEWORK_UTILS_API void operator()(const log_formatter::caller_info_t &caller, nostd::string_view content);
+
+  ATFRAMEWORK_UTILS_API time_t get_check_interval() const;
+
+  /**
+   * @brief Change the period to check file path, it's calculated by set_file_pattern automatically
+   */
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &set_check_interval(time_t check_interval);
+
+  ATFRAMEWORK_UTILS_API time_t get_flush_interval() const;
+
+  /**
+   * @brief Set the interval(in seconds) to msync mapped file asynchronously, 0 to disable
+   */
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &set_flush_interval(time_t v);
+
+  ATFRAMEWORK_UTILS_API log_level get_auto_flush() const;
+
+  /**
+   * @brief Records with level greater than or equal to flush_level will msync the pages it's written into
+   */
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &set_auto_flush(log_level flush_level);
+
+  ATFRAMEWORK_UTILS_API size_t get_max_file_size() const;
+
+  /**
+   * @brief Set max size of each file, which is also the preallocated and mapped size
+   * @note Only take effect on files opened later
+   */
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &set_max_file_size(size_t max_file_size);
+
+  ATFRAMEWORK_UTILS_API uint32_t get_rotate_size() const;
+
+  ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &set_rotate_size(uint32_t sz);
+
+  /**
+   * @brief msync all written data of current file synchronously
+   */
+  ATFRAMEWORK_UTILS_API void flush();
+
+  /**
+   * @brief Path of the file being written
+   */
+  ATFRAMEWORK_UTILS_API std::string get_current_file_path() const;
+
+ private:
+  struct segment_t;
+
+  ATFRAMEWORK_UTILS_API void init();
+
+  ATFRAMEWORK_UTILS_API std::shared_ptr<segment_t> get_segment() const;
+
+  ATFRAMEWORK_UTILS_API std::shared_ptr<segment_t> open_segment(uint32_t rotation_index, bool destroy_content);
+
+  ATFRAMEWORK_UTILS_API void rotate_segment(const std::shared_ptr<segment_t> &full_segment);
+
+  ATFRAMEWORK_UTILS_API void check_update(const std::shared_ptr<segment_t> &segment, time_t now);
+
+  // rotate_lock_ must be held
+  ATFRAMEWORK_UTILS_API void switch_segment(uint32_t rotation_index, bool destroy_content);
+
+  ATFRAMEWORK_UTILS_API void retry_open_segment(time_t now);
+
+  ATFRAMEWORK_UTILS_API void reset_segment(std::shared_ptr<segment_t> segment);
+
+ private:
+  std::string path_pattern_;
+
+  uint32_t rotation_size_;
+  size_t max_file_size_;
+
+  time_t check_interval_;
+  time_t flush_interval_;
+  log_level auto_flush_;
+  std::atomic<time_t> last_flush_timepoint_;
+  std::atomic<bool> inited_;
+
+  // Protect current_segment_ pointer only, writers copy it and append without lock
+  mutable lock::spin_rw_lock segment_lock_;
+  // Serialize init, rotation and file switching
+  lock::spin_lock rotate_lock_;
+  std::shared_ptr<segment_t> current_segment_;
+  // Keep the last path even if it's closed, to check directory change
+  std::string last_file_path_;
+  // The file to open again after open_segment() failed, protected by rotate_lock_
+  uint32_t reopen_rotation_index_;
+  bool reopen_destroy_content_;
+  time_t reopen_failed_timepoint_;
+};
+}  // namespace log
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
+
+#endif
@@ -146,6 +146,35 @@ ATFRAMEWORK_UTILS_API void stacktrace_parse_symbols(gsl::span<stacktrace_handle>
 
 ATFRAMEWORK_UTILS_API size_t stacktrace_write(char *buf, size_t bufsz, const stacktrace_options *options = nullptr);
 
+/**
+ * @brief 只获取调用栈的返回地址，不解析符号也不访问符号缓存，用于在热路径上记录调用栈
+ * @param addresses 输出地址的缓冲区
+ * @param max_frames 缓冲区能容纳的最大帧数
+ * @param options 跳过的帧数等选项，和 stacktrace_get_context 相同
+ * @return 写入的帧数
+ */
+ATFRAMEWORK_UTILS_API size_t stacktrace_get_addresses(uintptr_t *addresses, size_t max_frames,
+                                                      const stacktrace_options *options = nullptr) noexcept;
+
+/**
+ * @brief 解析 stacktrace_get_addresses 获取的地址并写出调用栈，输出格式和 stacktrace_write 相同
+ * @note 使用libunwind时不支持通过地址解析符号，会和 stacktrace_write_raw 一样只输出地址
+ */
+ATFRAMEWORK_UTILS_API size_t stacktrace_write_addresses(char *buf, size_t bufsz,
+                                                        gsl::span<const uintptr_t> addresses);
+
+/**
+ * @brief 只写出调用栈地址，不解析符号。可以配合 stacktrace_write_module_map 的输出离线解析
+ */
+ATFRAMEWORK_UTILS_API size_t stacktrace_write_raw(char *buf, size_t bufsz, gsl::span<const uintptr_t> addresses);
+
+/**
+ * @brief 写出已加载模块的映射，每行格式为: 加载偏移 起始地址 结束地址 模块路径
+ * @note 离线解析示例: addr2line -Cfpe <模块路径> <地址 - 加载偏移>
+ * @note 目前仅支持Linux(dl_iterate_phdr)，其他平台返回0
+ */
+ATFRAMEWORK_UTILS_API size_t stacktrace_write_module_map(char *buf, size_t bufsz);
+
 ATFRAMEWORK_UTILS_API std::shared_ptr<stacktrace_symbol> stacktrace_find_symbol(
     stacktrace_handle stack_handle) noexcept;
 
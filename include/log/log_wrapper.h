@@ -8,20 +8,24 @@
 #include <config/atframe_utils_build_feature.h>
 
 #include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <functional>
-#include <list>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "config/compiler/template_prefix.h"
 
 #include "cli/shell_font.h"
 
-#include "lock/spin_rw_lock.h"
+#include "lock/spin_lock.h"
 
+#include "log/log_async_pipeline.h"
+#include "log/log_deferred_format.h"
 #include "log/log_formatter.h"
+#include "log/log_rate_limiter.h"
 #include "nostd/string_view.h"
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
@@ -46,9 +50,10 @@ class log_wrapper {
 
   struct ATFRAMEWORK_UTILS_API options_t {
     enum type {
-      OPT_AUTO_UPDATE_TIME = 0,  // 是否自动更新时间（会降低性能）
-      OPT_USER_MAX,              // 允许外部接口修改的flag范围
-      OPT_IS_GLOBAL,             // 是否是全局log的tag
+      OPT_AUTO_UPDATE_TIME = 0,        // 是否自动更新时间（会降低性能）
+      OPT_STACKTRACE_RAW_ADDRESS = 1,  // 调用栈只记录地址，异步模式下由异步线程解析符号，否则只输出地址供离线解析
+      OPT_USER_MAX,                    // 允许外部接口修改的flag范围
+      OPT_IS_GLOBAL,                   // 是否是全局log的tag
       OPT_MAX
     };
   };
@@ -83,6 +88,19 @@ class log_wrapper {
 
   static ATFRAMEWORK_UTILS_API void update();
 
+  /**
+   * @brief 登记限流/采样调用点，之后即使该调用点不再有日志通过，被抑制的日志数也会由update()定期输出
+   * @note 由WDTLOGCALLSITEDEF在调用点抑制日志时调用，logger析构时自动取消登记
+   */
+  static ATFRAMEWORK_UTILS_API void register_callsite_summary(log_wrapper *logger,
+                                                              log_callsite_suppressed_counter &counter,
+                                                              const caller_info_t &caller);
+
+  /**
+   * @brief 输出所有已登记调用点中到期的被抑制日志数，update()会调用这个接口
+   */
+  static ATFRAMEWORK_UTILS_API void flush_callsite_summary();
+
 #ifdef _MSC_VER
   ATFRAMEWORK_UTILS_API void log(const caller_info_t &caller, _In_z_ _Printf_format_string_ const char *fmt_text, ...);
 #elif (defined(__clang__) && __clang_major__ >= 3)
@@ -109,38 +127,46 @@ class log_wrapper {
       TARGS &&...args) {
     log_operation_t writer;
     start_log(caller, writer);
-    if (!log_sinks_.empty()) {
+    if (has_sink()) {
+      __format_log_content<CharT>(writer, fmt_text, std::forward<TARGS>(args)...);
+    }
+    finish_log(caller, writer);
+  }
+
+  template <class CharT, class... TARGS>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY void __format_log_content(
+      log_operation_t &writer,
+      const ATFRAMEWORK_UTILS_NAMESPACE_ID::string::details::fmtapi_format_string_t<CharT, TARGS...> &fmt_text,
+      TARGS &&...args) {
 #  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
-      try {
+    try {
 #  endif
-        auto result = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::__internal_format_to_n<CharT *, CharT>(
-            reinterpret_cast<CharT *>(writer.buffer + writer.writen_size),
-            (writer.total_size - writer.writen_size - 1) / sizeof(CharT), fmt_text, std::forward<TARGS>(args)...);
-
-        // Do not use result.size here, it's the total (not truncated) output size and may not be the real written size.
-        if (result.out > reinterpret_cast<CharT *>(writer.buffer + writer.writen_size)) {
-          writer.writen_size +=
-              static_cast<size_t>(result.out - reinterpret_cast<CharT *>(writer.buffer + writer.writen_size));
-        }
-        if (writer.writen_size < writer.total_size) {
-          *(writer.buffer + writer.writen_size) = 0;
-        } else {
-          writer.writen_size = writer.total_size - 1;
-          *(writer.buffer + writer.total_size - 1) = 0;
-        }
-#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
-      } catch (const ATFRAMEWORK_UTILS_STRING_FWAPI_NAMESPACE_ID::format_error &e) {
-        append_log(writer, "\r\nGot format error:\r\n", 0);
-        append_log(writer, e.what(), 0);
-      } catch (const std::runtime_error &e) {
-        append_log(writer, "\r\nGot runtime error:\r\n", 0);
-        append_log(writer, e.what(), 0);
-      } catch (...) {
-        append_log(writer, "\r\nGot unknown exception", 0);
+      auto result = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::__internal_format_to_n<CharT *, CharT>(
+          reinterpret_cast<CharT *>(writer.buffer + writer.writen_size),
+          (writer.total_size - writer.writen_size - 1) / sizeof(CharT), fmt_text, std::forward<TARGS>(args)...);
+
+      // Do not use result.size here, it's the total (not truncated) output size and may not be the real written size.
+      if (result.out > reinterpret_cast<CharT *>(writer.buffer + writer.writen_size)) {
+        writer.writen_size +=
+            static_cast<size_t>(result.out - reinterpret_cast<CharT *>(writer.buffer + writer.writen_size));
       }
-#  endif
+      if (writer.writen_size < writer.total_size) {
+        *(writer.buffer + writer.writen_size) = 0;
+      } else {
+        writer.writen_size = writer.total_size - 1;
+        *(writer.buffer + writer.total_size - 1) = 0;
+      }
+#  if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    } catch (const ATFRAMEWORK_UTILS_STRING_FWAPI_NAMESPACE_ID::format_error &e) {
+      append_log(writer, "\r\nGot format error:\r\n", 0);
+      append_log(writer, e.what(), 0);
+    } catch (const std::runtime_error &e) {
+      append_log(writer, "\r\nGot runtime error:\r\n", 0);
+      append_log(writer, e.what(), 0);
+    } catch (...) {
+      append_log(writer, "\r\nGot unknown exception", 0);
     }
-    finish_log(caller, writer);
+#  endif
   }
 
   template <class... TARGS>
@@ -186,6 +212,43 @@ class log_wrapper {
   }
 #    endif
 #  endif
+
+  /**
+   * @brief 延迟格式化的日志接口，开启异步日志后，调用线程只序列化参数，由异步日志线程格式化成文本
+   * @note 格式字符串只保存指针，必须是字符串字面量等静态存储期的字符串
+   * @note 未开启异步日志、需要输出调用栈或参数过大时，退化为和format_log一样的同步格式化
+   * @see log_deferred_codec
+   */
+  template <class... TARGS>
+  ATFW_UTIL_NOINLINE_NOCLONE ATFRAMEWORK_UTILS_API_HEAD_ONLY void format_log_deferred(
+      const caller_info_t &caller,
+      ATFRAMEWORK_UTILS_NAMESPACE_ID::string::details::fmtapi_format_string_t<char, TARGS...> fmt_text,
+      TARGS &&...args) {
+    if (!is_async_enabled()) {
+      __format_log<char>(caller, fmt_text, std::forward<TARGS>(args)...);
+      return;
+    }
+
+    log_operation_t writer;
+    start_log(caller, writer);
+    if (!has_sink() || nullptr == writer.buffer) {
+      return;
+    }
+
+    // 前缀包含时间，在调用线程格式化，参数序列化到前缀后面
+    using codec_type = log_deferred_codec<nostd::remove_cvref_t<TARGS>...>;
+    unsigned char *data_begin = reinterpret_cast<unsigned char *>(writer.buffer + writer.writen_size);
+    unsigned char *data_end = codec_type::encode(
+        data_begin, reinterpret_cast<unsigned char *>(writer.buffer + writer.total_size),
+        ATFRAMEWORK_UTILS_NAMESPACE_ID::string::details::fmtapi_to_string_view<char>(fmt_text), args...);
+    if (nullptr != data_end && push_deferred_log(caller, writer, &codec_type::render, data_begin,
+                                                 static_cast<size_t>(data_end - data_begin))) {
+      return;
+    }
+
+    __format_log_content<char>(writer, fmt_text, std::forward<TARGS>(args)...);
+    finish_log(caller, writer);
+  }
 #endif
 
   // 一般日志级别检查
@@ -235,7 +298,14 @@ class log_wrapper {
 
   UTIL_FORCEINLINE const std::string &get_prefix_format() const { return prefix_format_; }
 
-  UTIL_FORCEINLINE void set_prefix_format(const std::string &prefix) { prefix_format_ = prefix; }
+  /**
+   * @brief 设置日志前缀格式，设置时会预编译，写日志时不再解析格式串
+   * @see log_formatter::format
+   */
+  UTIL_FORCEINLINE void set_prefix_format(const std::string &prefix) {
+    prefix_format_ = prefix;
+    log_formatter::compile(prefix_compiled_, prefix_format_.c_str(), prefix_format_.size());
+  }
 
   UTIL_FORCEINLINE bool get_option(options_t::type t) const {
     if (t < 0 || t >= options_t::OPT_MAX) {
@@ -257,6 +327,32 @@ class log_wrapper {
                                                   log_level level_max = level_t::kDisabled);
   UTIL_FORCEINLINE const std::pair<log_level, log_level> &get_stacktrace_level() const { return stacktrace_level_; }
 
+  /**
+   * @brief 开启异步日志，finish_log只把日志拷贝到当前线程的ring buffer，由独立线程写出到落地接口
+   * @param options 异步日志选项
+   * @note 此接口非线程安全，请在没有其他线程写日志时调用。再次调用会先写出并停止之前的异步管线
+   * @return 成功返回true
+   */
+  ATFRAMEWORK_UTILS_API bool enable_async(const log_async_options &options = log_async_options());
+
+  /**
+   * @brief 关闭异步日志，会先写出所有未处理的日志
+   * @note 此接口非线程安全，请在没有其他线程写日志时调用
+   */
+  ATFRAMEWORK_UTILS_API void disable_async();
+
+  /**
+   * @brief 等待调用前已提交的异步日志全部写出到落地接口
+   */
+  ATFRAMEWORK_UTILS_API void flush_async();
+
+  UTIL_FORCEINLINE bool is_async_enabled() const { return !!async_pipeline_; }
+
+  /**
+   * @brief 获取异步日志统计（包含丢弃的日志数量）
+   */
+  ATFRAMEWORK_UTILS_API log_async_statistics get_async_statistics() const;
+
   /**
    * @brief 实际写出到落地接口
    */
@@ -272,13 +368,36 @@ class log_wrapper {
   ATFRAMEWORK_UTILS_API void finish_log(const caller_info_t &caller, log_operation_t &);
   ATFRAMEWORK_UTILS_API void append_log(log_operation_t &, const char *str, size_t strsz);
 
+  /**
+   * @brief 把前缀和序列化后的参数写入异步队列
+   * @return 返回false时需要调用者同步格式化并输出
+   */
+  ATFRAMEWORK_UTILS_API bool push_deferred_log(const caller_info_t &caller, log_operation_t &writer,
+                                               log_async_pipeline::deferred_renderer_t renderer,
+                                               const unsigned char *data, size_t data_size);
+
+  UTIL_FORCEINLINE bool has_sink() const { return nullptr != log_sinks_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 发布新的后端列表快照，旧快照在所有可能读到它的读者退出后释放
+   * @note 调用者需要持有log_sinks_lock_
+   */
+  ATFRAMEWORK_UTILS_API void publish_sinks(std::unique_ptr<std::vector<log_router_t>> sinks);
+
  private:
   log_level log_level_;
   std::pair<log_level, log_level> stacktrace_level_;
   std::string prefix_format_;
+  log_formatter::compiled_format_t prefix_compiled_;
   std::bitset<options_t::OPT_MAX> options_;
-  std::list<log_router_t> log_sinks_;
-  mutable ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_rw_lock log_sinks_lock_;
+  // 后端列表的只读快照(RCU)，空列表时为nullptr。修改时整体替换，写日志时先在本线程的读者槽位记录纪元再读取这个指针
+  std::atomic<const std::vector<log_router_t> *> log_sinks_;
+  std::unique_ptr<std::vector<log_router_t>> log_sinks_holder_;
+  // 被替换的快照和替换时的纪元，所有读者线程都在这个纪元之后进入读取时才释放
+  std::vector<std::pair<uint64_t, std::unique_ptr<std::vector<log_router_t>>>> log_sinks_retired_;
+  // 串行化后端列表的修改
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock log_sinks_lock_;
+  std::unique_ptr<log_async_pipeline> async_pipeline_;
 };  // NOLINT: readability/braces
 }  // namespace log
 ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -469,6 +588,54 @@ ATFRAMEWORK_UTILS_NAMESPACE_END
     FWCLOGERROR(ATFRAMEWORK_UTILS_NAMESPACE_ID::log::log_wrapper::categorize_t::DEFAULT, __VA_ARGS__)
 #  define FWLOGFATAL(...) \
     FWCLOGFATAL(ATFRAMEWORK_UTILS_NAMESPACE_ID::log::log_wrapper::categorize_t::DEFAULT, __VA_ARGS__)
+
+// 延迟格式化，开启异步日志后由异步日志线程格式化。格式字符串必须是字面量
+#  define FWCLOGDEFERRED(lv, cat, ...)                                                        \
+    if (ATFRAMEWORK_UTILS_NAMESPACE_ID::log::log_wrapper::check_level(WDTLOGGETCAT(cat), lv)) \
+      WDTLOGGETCAT(cat)->format_log_deferred(WDTLOGFILENF(lv, {}), __VA_ARGS__);
+#  define FWINSTLOGDEFERRED(lv, __inst, ...) \
+    if ((__inst).check_level(lv)) (__inst).format_log_deferred(WDTLOGFILENF(lv, {}), __VA_ARGS__);
+#endif
+
+// 按调用点限流/采样的日志输出工具，每个调用点有独立的静态状态，被抑制的日志数会定期(默认每秒最多一次)汇总输出
+// 调用点第一次抑制日志时会登记到logger，之后没有日志通过时也会由log_wrapper::update()汇总输出
+#define WDTLOGCALLSITEDEF(logger, lv, limiter_type, limiter_args, log_fn, ...)                                     \
+  if (ATFRAMEWORK_UTILS_NAMESPACE_ID::log::log_wrapper::check_level(logger, lv)) {                                 \
+    static ATFRAMEWORK_UTILS_NAMESPACE_ID::log::limiter_type log_wrapper_callsite_limiter limiter_args;            \
+    static thread_local ATFRAMEWORK_UTILS_NAMESPACE_ID::log::limiter_type::thread_state_t                          \
+        log_wrapper_callsite_thread_state{};                                                                       \
+    uint64_t log_wrapper_callsite_suppressed = 0;                                                                  \
+    if (log_wrapper_callsite_limiter.check(log_wrapper_callsite_suppressed, log_wrapper_callsite_thread_state)) {  \
+      if (0 != log_wrapper_callsite_suppressed) {                                                                  \
+        (logger)->log(WDTLOGFILENF(lv, {}), "suppressed %llu messages",                                            \
+                      static_cast<unsigned long long>(log_wrapper_callsite_suppressed));                           \
+      }                                                                                                            \
+      (logger)->log_fn(WDTLOGFILENF(lv, {}), __VA_ARGS__);                                                         \
+    } else if (log_wrapper_callsite_limiter.get_suppressed_counter().get_report_owner() !=                         \
+               static_cast<const void *>(logger)) {                                                                \
+      ATFRAMEWORK_UTILS_NAMESPACE_ID::log::log_wrapper::register_callsite_summary(                                 \
+          logger, log_wrapper_callsite_limiter.get_suppressed_counter(), WDTLOGFILENF(lv, {}));                    \
+    }                                                                                                              \
+  }
+
+// 令牌桶限流，每秒最多输出rate条，最多同时输出burst条
+#define WCLOGRATELIMIT(lv, cat, rate, burst, ...) \
+  WDTLOGCALLSITEDEF(WDTLOGGETCAT(cat), lv, log_rate_limiter, (rate, burst), log, __VA_ARGS__)
+#define WINSTLOGRATELIMIT(lv, __inst, rate, burst, ...) \
+  WDTLOGCALLSITEDEF(&(__inst), lv, log_rate_limiter, (rate, burst), log, __VA_ARGS__)
+// 采样，每n条输出1条
+#define WCLOGSAMPLE(lv, cat, n, ...) WDTLOGCALLSITEDEF(WDTLOGGETCAT(cat), lv, log_sampler, (n), log, __VA_ARGS__)
+#define WINSTLOGSAMPLE(lv, __inst, n, ...) WDTLOGCALLSITEDEF(&(__inst), lv, log_sampler, (n), log, __VA_ARGS__)
+
+#if defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI
+#  define FWCLOGRATELIMIT(lv, cat, rate, burst, ...) \
+    WDTLOGCALLSITEDEF(WDTLOGGETCAT(cat), lv, log_rate_limiter, (rate, burst), format_log, __VA_ARGS__)
+#  define FWINSTLOGRATELIMIT(lv, __inst, rate, burst, ...) \
+    WDTLOGCALLSITEDEF(&(__inst), lv, log_rate_limiter, (rate, burst), format_log, __VA_ARGS__)
+#  define FWCLOGSAMPLE(lv, cat, n, ...) \
+    WDTLOGCALLSITEDEF(WDTLOGGETCAT(cat), lv, log_sampler, (n), format_log, __VA_ARGS__)
+#  define FWINSTLOGSAMPLE(lv, __inst, n, ...) \
+    WDTLOGCALLSITEDEF(&(__inst), lv, log_sampler, (n), format_log, __VA_ARGS__)
 #endif
 
 // 控制台输出工具
@@ -0,0 +1,195 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compiler_features.h>
+#include <design_pattern/nomovable.h>
+#include <design_pattern/noncopyable.h>
+
+#include <memory/allocator_traits.h>
+
+#include <stdint.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+/**
+ * @brief Monotonic memory resource, blocks are carved from chunks and are released all together by reset()
+ * @note deallocate() does nothing, so it's suitable for containers which are built, used and dropped as a whole, such as
+ *       the temporary containers of one frame or one request.
+ * @note arena_resource is not thread safe.
+ */
+class arena_resource {
+ public:
+  using ptr_t = std::shared_ptr<arena_resource>;
+
+  struct options_t {
+    // Bytes of one chunk, allocations larger than a quarter of chunk_size get a chunk of their own
+    size_t chunk_size;
+    // Max bytes of chunks kept by reset() for reuse, 0 means release all chunks when reset
+    size_t max_reserved_bytes;
+
+    inline options_t() noexcept : chunk_size(64 * 1024), max_reserved_bytes(1024 * 1024) {}
+  };
+
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(arena_resource)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(arena_resource)
+
+ public:
+  ATFRAMEWORK_UTILS_API ~arena_resource();
+
+  static ATFRAMEWORK_UTILS_API ptr_t create(const options_t &options = options_t());
+
+  /**
+   * @brief Allocate a block
+   * @param alignment must be power of 2
+   * @return nullptr if failed to allocate a new chunk
+   */
+  ATFRAMEWORK_UTILS_API void *allocate(size_t bytes, size_t alignment) noexcept;
+
+  /**
+   * @brief Invalidate all blocks allocated before, chunks are kept for reuse up to max_reserved_bytes
+   */
+  ATFRAMEWORK_UTILS_API void reset() noexcept;
+
+  /**
+   * @brief Invalidate all blocks allocated before and release all chunks
+   */
+  ATFRAMEWORK_UTILS_API void release() noexcept;
+
+  inline const options_t &get_options() const noexcept { return options_; }
+
+  inline size_t get_chunk_count() const noexcept { return chunk_count_; }
+
+  /**
+   * @brief Bytes of blocks allocated since last reset(), including the padding for alignment
+   */
+  inline size_t get_used_bytes() const noexcept { return used_bytes_; }
+
+ private:
+  struct chunk_t {
+    chunk_t *next;
+    size_t size;
+  };
+
+  chunk_t *allocate_chunk(size_t size) noexcept;
+
+  explicit arena_resource(const options_t &options);
+
+ private:
+  options_t options_;
+  // Chunks in use, the head one is the current chunk
+  chunk_t *chunks_;
+  // Chunks kept by reset()
+  chunk_t *free_chunks_;
+  char *current_begin_;
+  char *current_end_;
+  size_t chunk_count_;
+  size_t used_bytes_;
+};
+
+/**
+ * @brief Allocator which allocates blocks from arena_resource, deallocate() is a no-op
+ * @note Blocks are invalid after arena_resource::reset(), so the containers using arena_allocator must be cleared or
+ *       destroyed before it.
+ * @note Default constructed arena_allocator has no arena_resource and just forwards to BackendAllocator, so it still
+ *       works where containers default construct their allocators, like TAlloc of lru_map.
+ */
+template <class T, class BackendAllocator = ::std::allocator<T>>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY arena_allocator
+    : public allocator_adapter<arena_allocator, T, BackendAllocator> {
+ public:
+  using base_type = allocator_adapter<arena_allocator, T, BackendAllocator>;
+  using value_type = typename base_type::value_type;
+  using pointer = typename base_type::pointer;
+  using size_type = typename base_type::size_type;
+  using const_void_pointer = typename base_type::const_void_pointer;
+
+  // Allocators with different arena_resource can not deallocate blocks of each other
+  using is_always_equal = ::std::false_type;
+  using propagate_on_container_copy_assignment = ::std::true_type;
+  using propagate_on_container_move_assignment = ::std::true_type;
+  using propagate_on_container_swap = ::std::true_type;
+
+  template <class, class>
+  friend class arena_allocator;
+
+ public:
+  inline arena_allocator() : base_type(), resource_() {}
+
+  inline explicit arena_allocator(arena_resource::ptr_t resource) : base_type(), resource_(std::move(resource)) {}
+
+  inline arena_allocator(arena_resource::ptr_t resource, const BackendAllocator &backend)
+      : base_type(backend), resource_(std::move(resource)) {}
+
+  template <class U, class UBackendAllocator>
+  inline arena_allocator(const arena_allocator<U, UBackendAllocator> &other) noexcept(  // NOLINT: runtime/explicit
+      ::std::is_nothrow_constructible<BackendAllocator, const UBackendAllocator &>::value)
+      : base_type(static_cast<const typename arena_allocator<U, UBackendAllocator>::base_type &>(other)),
+        resource_(other.resource_) {}
+
+  ATFW_EXPLICIT_NODISCARD_ATTR
+  inline pointer allocate(size_type n) {
+    if (!resource_ || n > base_type::max_size()) {
+      return base_type::allocate(n);
+    }
+
+    void *ret = resource_->allocate(n * sizeof(value_type), alignof(value_type));
+    if (nullptr == ret) {
+      // Do not fallback to the backend allocator, deallocate() will not give the block back to it
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+      throw ::std::bad_alloc();
+#else
+      return nullptr;
+#endif
+    }
+    return static_cast<pointer>(ret);
+  }
+
+  ATFW_EXPLICIT_NODISCARD_ATTR
+  inline pointer allocate(size_type n, const_void_pointer) { return allocate(n); }
+
+#if ((defined(__cplusplus) && __cplusplus >= 202302L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 202302L)) && \
+    defined(__cpp_lib_allocate_at_least) && __cpp_lib_allocate_at_least >= 202302L
+  // Blocks must come from the same place as allocate(n), or deallocate() can not tell where to give them back
+  ATFW_EXPLICIT_NODISCARD_ATTR
+  inline ::std::allocation_result<pointer, size_type> allocate_at_least(size_type n) { return {allocate(n), n}; }
+#endif
+
+  inline void deallocate(pointer p, size_type n) {
+    if (!resource_) {
+      base_type::deallocate(p, n);
+    }
+  }
+
+  inline const arena_resource::ptr_t &resource() const noexcept { return resource_; }
+
+ private:
+  arena_resource::ptr_t resource_;
+};
+
+template <class T, class BackendAllocator, class U, class UBackendAllocator>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(const arena_allocator<T, BackendAllocator> &left,
+                                                       const arena_allocator<U, UBackendAllocator> &right) noexcept {
+  return left.resource() == right.resource() &&
+         __util_memory_allocator_adapter_backend_equal<BackendAllocator, UBackendAllocator>::equal(
+             left.backend_allocator(), right.backend_allocator());
+}
+
+template <class T, class BackendAllocator, class U, class UBackendAllocator>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(const arena_allocator<T, BackendAllocator> &left,
+                                                       const arena_allocator<U, UBackendAllocator> &right) noexcept {
+  return !(left == right);
+}
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
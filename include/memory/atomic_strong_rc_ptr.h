@@ -0,0 +1,182 @@
+// Copyright 2026 atframework
+//
+// Licenses under the MIT License
+// @note A std::atomic<std::shared_ptr<T>> replacement for atomic_rc_ptr, it's used to publish snapshots to other
+//       threads(RCU style). Writers build a new object and store() it, readers load() and keep using their own snapshot.
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <config/compile_optimize.h>
+#include <config/compiler_features.h>
+#include <lock/spin_lock.h>
+#include <memory/rc_ptr.h>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+/**
+ * @brief Atomic holder of atomic_rc_ptr<T>
+ * @note The lowest bit of the counter pointer is used as a spin lock. It's held only to copy the two pointers and
+ *       increase the use count, so there is no extra memory, no global lock table and no object is released while
+ *       holding it.
+ * @note load() always has acquire semantic and store()/exchange() always have release semantic, the memory_order
+ *       parameters are kept for compatibility with std::atomic.
+ */
+template <class T>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY atomic_strong_rc_ptr {
+ public:
+  using value_type = atomic_rc_ptr<T>;
+  using element_type = typename value_type::element_type;
+
+ private:
+  using counted_data_base = typename rc_ptr_atomic_policy::counted_data_base;
+
+  enum : uintptr_t {
+    kLockBit = 1,
+  };
+
+ public:
+  UTIL_CONFIG_CONSTEXPR atomic_strong_rc_ptr() noexcept : counter_(0), ptr_(nullptr) {}
+
+  UTIL_CONFIG_CONSTEXPR atomic_strong_rc_ptr(std::nullptr_t) noexcept  // NOLINT(runtime/explicit)
+      : counter_(0), ptr_(nullptr) {}
+
+  atomic_strong_rc_ptr(value_type desired) noexcept  // NOLINT(runtime/explicit)
+      : counter_(reinterpret_cast<uintptr_t>(desired.ref_counter_.pi_)), ptr_(desired.ptr_) {
+    desired.ref_counter_.pi_ = nullptr;
+    desired.ptr_ = nullptr;
+  }
+
+  ~atomic_strong_rc_ptr() {
+    counted_data_base* pi = reinterpret_cast<counted_data_base*>(counter_.load(std::memory_order_relaxed));
+    if (nullptr != pi) {
+      pi->release();
+    }
+  }
+
+  atomic_strong_rc_ptr(const atomic_strong_rc_ptr&) = delete;
+  atomic_strong_rc_ptr& operator=(const atomic_strong_rc_ptr&) = delete;
+
+  inline atomic_strong_rc_ptr& operator=(value_type desired) noexcept {
+    store(std::move(desired));
+    return *this;
+  }
+
+  inline atomic_strong_rc_ptr& operator=(std::nullptr_t) noexcept {
+    store(value_type());
+    return *this;
+  }
+
+  inline operator value_type() const noexcept { return load(); }  // NOLINT(runtime/explicit)
+
+  ATFW_UTIL_MACRO_INLINE_VARIABLE static constexpr const bool is_always_lock_free = false;
+
+  inline bool is_lock_free() const noexcept { return false; }
+
+  value_type load(std::memory_order = std::memory_order_seq_cst) const noexcept {
+    value_type ret;
+    uintptr_t counter = lock();
+    ret.ptr_ = ptr_;
+    ret.ref_counter_.pi_ = reinterpret_cast<counted_data_base*>(counter);
+    if (nullptr != ret.ref_counter_.pi_) {
+      ret.ref_counter_.pi_->add_ref_copy();
+    }
+    unlock(counter);
+    return ret;
+  }
+
+  inline void store(value_type desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+    // Old value is released out of the lock
+    exchange(std::move(desired), order);
+  }
+
+  value_type exchange(value_type desired, std::memory_order = std::memory_order_seq_cst) noexcept {
+    value_type ret;
+    uintptr_t counter = lock();
+    ret.ptr_ = ptr_;
+    ret.ref_counter_.pi_ = reinterpret_cast<counted_data_base*>(counter);
+
+    ptr_ = desired.ptr_;
+    uintptr_t new_counter = reinterpret_cast<uintptr_t>(desired.ref_counter_.pi_);
+    desired.ptr_ = nullptr;
+    desired.ref_counter_.pi_ = nullptr;
+    unlock(new_counter);
+    return ret;
+  }
+
+  /**
+   * @brief Replace with desired if the stored pointer and owner are the same as expected, or load the stored one into
+   *        expected
+   */
+  bool compare_exchange_strong(value_type& expected, value_type desired,
+                               std::memory_order = std::memory_order_seq_cst) noexcept {
+    value_type old_value;
+    uintptr_t counter = lock();
+    if (ptr_ != expected.ptr_ || counter != reinterpret_cast<uintptr_t>(expected.ref_counter_.pi_)) {
+      // Keep old value of expected and release it out of the lock
+      old_value.ptr_ = expected.ptr_;
+      old_value.ref_counter_.pi_ = expected.ref_counter_.pi_;
+
+      expected.ptr_ = ptr_;
+      expected.ref_counter_.pi_ = reinterpret_cast<counted_data_base*>(counter);
+      if (nullptr != expected.ref_counter_.pi_) {
+        expected.ref_counter_.pi_->add_ref_copy();
+      }
+      unlock(counter);
+      return false;
+    }
+
+    // The reference held by this is released after unlock
+    old_value.ptr_ = ptr_;
+    old_value.ref_counter_.pi_ = reinterpret_cast<counted_data_base*>(counter);
+
+    ptr_ = desired.ptr_;
+    uintptr_t new_counter = reinterpret_cast<uintptr_t>(desired.ref_counter_.pi_);
+    desired.ptr_ = nullptr;
+    desired.ref_counter_.pi_ = nullptr;
+    unlock(new_counter);
+    return true;
+  }
+
+  inline bool compare_exchange_strong(value_type& expected, value_type desired, std::memory_order success,
+                                      std::memory_order) noexcept {
+    return compare_exchange_strong(expected, std::move(desired), success);
+  }
+
+  inline bool compare_exchange_weak(value_type& expected, value_type desired,
+                                    std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return compare_exchange_strong(expected, std::move(desired), order);
+  }
+
+  inline bool compare_exchange_weak(value_type& expected, value_type desired, std::memory_order success,
+                                    std::memory_order) noexcept {
+    return compare_exchange_strong(expected, std::move(desired), success);
+  }
+
+ private:
+  // Return the counter pointer without lock bit
+  uintptr_t lock() const noexcept {
+    unsigned int try_times = 0;
+    uintptr_t counter = counter_.fetch_or(kLockBit, std::memory_order_acquire);
+    while (0 != (counter & kLockBit)) {
+      ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::detail::spin_wait(try_times++);
+      counter = counter_.fetch_or(kLockBit, std::memory_order_acquire);
+    }
+    return counter;
+  }
+
+  inline void unlock(uintptr_t counter) const noexcept { counter_.store(counter, std::memory_order_release); }
+
+ private:
+  mutable std::atomic<uintptr_t> counter_;
+  element_type* ptr_;
+};
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
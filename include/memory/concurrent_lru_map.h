@@ -0,0 +1,280 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compiler_features.h>
+#include <design_pattern/nomovable.h>
+#include <design_pattern/noncopyable.h>
+#include <memory/lru_map.h>
+#include <memory/rc_ptr.h>
+#include <std/explicit_declare.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+/**
+ * @brief Thread-safe LRU cache, keys are hashed into shards and every shard is a lru_map with its own lock.
+ * @note Every shard evicts its elements by the eviction policy of TOption when its size exceeds the capacity of one
+ *       shard, so the eviction order is an approximation of the global one.
+ * @note Values are returned as store_type(shared_ptr), so they are still valid after being evicted.
+ */
+template <class TKEY, class TVALUE, class THasher = std::hash<TKEY>, class TKeyEQ = std::equal_to<TKEY>,
+          class TOption = lru_map_option<compat_strong_ptr_mode::kStl>, class TLock = std::mutex>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY concurrent_lru_map {
+ public:
+  using lru_map_type = lru_map<TKEY, TVALUE, THasher, TKeyEQ, TOption>;
+  using key_type = typename lru_map_type::key_type;
+  using mapped_type = typename lru_map_type::mapped_type;
+  using value_type = typename lru_map_type::value_type;
+  using size_type = typename lru_map_type::size_type;
+  using store_type = typename lru_map_type::store_type;
+  using option_type = typename lru_map_type::option_type;
+  using hasher = THasher;
+  using lock_type = TLock;
+  using self_type = concurrent_lru_map<TKEY, TVALUE, THasher, TKeyEQ, TOption, TLock>;
+
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(concurrent_lru_map)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(concurrent_lru_map)
+
+ private:
+  // Shared by the loading thread and the threads waiting for the same key
+  struct loading_type {
+    std::mutex lock;
+    std::condition_variable cond;
+    bool finished;
+    store_type value;
+
+    loading_type() : finished(false) {}
+  };
+
+  using loading_map_type = std::unordered_map<key_type, std::shared_ptr<loading_type>, THasher, TKeyEQ>;
+
+  struct shard_type {
+    lock_type lock;
+    lru_map_type data;
+    loading_map_type loading;
+  };
+
+  // Insert the loaded value, remove the loading record and wake up the waiting threads
+  struct loading_finisher {
+    shard_type &shard;
+    const key_type &key;
+    loading_type &loading;
+    bool finished;
+
+    loading_finisher(shard_type &s, const key_type &k, loading_type &l)
+        : shard(s), key(k), loading(l), finished(false) {}
+
+    // Called when loader throws
+    ~loading_finisher() {
+      if (!finished) {
+        finish(store_type());
+      }
+    }
+
+    store_type finish(store_type value) {
+      finished = true;
+      {
+        std::lock_guard<lock_type> guard(shard.lock);
+        if (value) {
+          // Values set by insert_or_assign() during loading are newer, keep them
+          typename lru_map_type::iterator it = shard.data.find(key, true);
+          if (it != shard.data.end()) {
+            value = it->second;
+          } else {
+            shard.data.insert(value_type(key, value));
+          }
+        }
+        shard.loading.erase(key);
+      }
+
+      {
+        std::lock_guard<std::mutex> guard(loading.lock);
+        loading.finished = true;
+        loading.value = value;
+      }
+      loading.cond.notify_all();
+      return value;
+    }
+  };
+
+ public:
+  /**
+   * @param shard_count count of shards, 0 means the hardware concurrency
+   * @param capacity_per_shard max elements of one shard, 0 means unlimited
+   */
+  explicit concurrent_lru_map(size_type shard_count = 0, size_type capacity_per_shard = 0)
+      : capacity_per_shard_(capacity_per_shard) {
+    if (0 == shard_count) {
+      shard_count = static_cast<size_type>(std::thread::hardware_concurrency());
+      if (0 == shard_count) {
+        shard_count = 1;
+      }
+    }
+
+    shards_.reserve(shard_count);
+    for (size_type i = 0; i < shard_count; ++i) {
+      shards_.emplace_back(new shard_type());
+      if (capacity_per_shard_ > 0) {
+        shards_.back()->data.reserve(capacity_per_shard_);
+        shards_.back()->data.set_max_size(capacity_per_shard_);
+      }
+    }
+  }
+
+  inline size_type shard_count() const noexcept { return static_cast<size_type>(shards_.size()); }
+  inline size_type capacity_per_shard() const noexcept { return capacity_per_shard_; }
+
+  /**
+   * @brief Count of elements, it's only a snapshot when other threads are modifying the map
+   */
+  size_type size() const {
+    size_type ret = 0;
+    for (auto &shard : shards_) {
+      std::lock_guard<lock_type> guard(shard->lock);
+      ret += shard->data.size();
+    }
+    return ret;
+  }
+
+  ATFW_EXPLICIT_NODISCARD_ATTR bool empty() const { return 0 == size(); }
+
+  /**
+   * @brief Sum of counters of all shards
+   */
+  lru_map_stats get_stats() const {
+    lru_map_stats ret{0, 0, 0, 0};
+    for (auto &shard : shards_) {
+      std::lock_guard<lock_type> guard(shard->lock);
+      const lru_map_stats &stats = shard->data.get_stats();
+      ret.hit_count += stats.hit_count;
+      ret.miss_count += stats.miss_count;
+      ret.eviction_count += stats.eviction_count;
+      ret.expiration_count += stats.expiration_count;
+    }
+    return ret;
+  }
+
+  void clear() {
+    for (auto &shard : shards_) {
+      std::lock_guard<lock_type> guard(shard->lock);
+      shard->data.clear();
+    }
+  }
+
+  /**
+   * @brief Find a value
+   * @param update_visit move the element to the most recently used position of its shard
+   * @return the value, or nullptr if not found
+   */
+  store_type get(const key_type &key, bool update_visit = true) {
+    shard_type &shard = select_shard(key);
+    std::lock_guard<lock_type> guard(shard.lock);
+    typename lru_map_type::iterator it = shard.data.find(key, update_visit);
+    if (it == shard.data.end()) {
+      return store_type();
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Insert a value if the key does not exist
+   * @return true if the value is inserted
+   */
+  bool insert(const key_type &key, store_type value) {
+    shard_type &shard = select_shard(key);
+    std::lock_guard<lock_type> guard(shard.lock);
+    return shard.data.insert(value_type(key, std::move(value))).second;
+  }
+
+  /**
+   * @brief Insert a value or replace the value of an existing key, the element becomes the most recently used one
+   */
+  void insert_or_assign(const key_type &key, store_type value) {
+    shard_type &shard = select_shard(key);
+    std::lock_guard<lock_type> guard(shard.lock);
+    typename lru_map_type::iterator it = shard.data.find(key, true);
+    if (it != shard.data.end()) {
+      it->second = std::move(value);
+      return;
+    }
+
+    shard.data.insert(value_type(key, std::move(value)));
+  }
+
+  size_type erase(const key_type &key) {
+    shard_type &shard = select_shard(key);
+    std::lock_guard<lock_type> guard(shard.lock);
+    return shard.data.erase(key);
+  }
+
+  /**
+   * @brief Find a value, or load and insert it if not found
+   * @param loader store_type(const key_type&), it's called without any lock held. Returning nullptr means the key is
+   *        not found and nothing is inserted.
+   * @note Concurrent misses of the same key call loader only once, the other threads wait for its result.
+   *       If loader throws, the exception is passed to the caller and the waiting threads get nullptr.
+   * @return the value, or nullptr if loader returns nullptr
+   */
+  template <class TLOADER>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY store_type get_or_insert(const key_type &key, TLOADER &&loader) {
+    shard_type &shard = select_shard(key);
+    std::shared_ptr<loading_type> loading;
+    bool is_loader = false;
+    {
+      std::lock_guard<lock_type> guard(shard.lock);
+      typename lru_map_type::iterator it = shard.data.find(key, true);
+      if (it != shard.data.end()) {
+        return it->second;
+      }
+
+      typename loading_map_type::iterator loading_it = shard.loading.find(key);
+      if (loading_it != shard.loading.end()) {
+        loading = loading_it->second;
+      } else {
+        loading = std::make_shared<loading_type>();
+        shard.loading[key] = loading;
+        is_loader = true;
+      }
+    }
+
+    if (!is_loader) {
+      std::unique_lock<std::mutex> loading_guard(loading->lock);
+      loading->cond.wait(loading_guard, [&loading]() { return loading->finished; });
+      return loading->value;
+    }
+
+    // Waiting threads are also woken up by the destructor of finisher if loader throws
+    loading_finisher finisher(shard, key, *loading);
+    return finisher.finish(loader(key));
+  }
+
+ private:
+  inline shard_type &select_shard(const key_type &key) {
+    size_t hash = static_cast<size_t>(hasher_(key));
+    // Mix high bits, so keys with the same low bits are not placed into the same shard
+    hash ^= hash >> 16;
+    return *shards_[hash % shards_.size()];
+  }
+
+ private:
+  hasher hasher_;
+  size_type capacity_per_shard_;
+  std::vector<std::unique_ptr<shard_type>> shards_;
+};
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
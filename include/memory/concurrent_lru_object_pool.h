@@ -0,0 +1,531 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compiler_features.h>
+#include <design_pattern/nomovable.h>
+#include <design_pattern/noncopyable.h>
+#include <lock/spin_lock.h>
+#include <memory/lru_object_pool.h>
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+/**
+ * @brief Thread-safe object pool, every thread caches objects in its own magazines and exchanges full or empty
+ *        magazines with a shared depot(Bonwick's magazine layer).
+ * @note push() and pull() only lock the cache of the current thread, which is not contended, and lock the depot only
+ *       once per magazine_size objects. proc() and gc() only reclaim objects in the depot, so workers are not stopped.
+ * @note Every thread keeps at most two magazines for every key, call clear() to reclaim them.
+ * @note All push() and pull() must finish before the pool is destroyed.
+ */
+template <class TKey, class TObj, class TAction = lru_default_action<TObj>, class THasher = std::hash<TKey>,
+          class TKeyEQ = std::equal_to<TKey>>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY concurrent_lru_pool {
+ public:
+  using key_t = TKey;
+  using value_type = TObj;
+  using action_type = TAction;
+  using self_type = concurrent_lru_pool<TKey, TObj, TAction, THasher, TKeyEQ>;
+
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(concurrent_lru_pool)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(concurrent_lru_pool)
+
+ private:
+  struct depot_key_type;
+
+  struct magazine_type {
+    // Links of the full magazines of the same key in depot, or the empty magazines
+    magazine_type *prev;
+    magazine_type *next;
+    // Links of all full magazines in depot, the oldest one is the first
+    magazine_type *age_prev;
+    magazine_type *age_next;
+    depot_key_type *owner;
+    time_t push_tick;
+    size_t size;
+    std::unique_ptr<TObj *[]> objects;
+
+    explicit magazine_type(size_t capacity)
+        : prev(nullptr),
+          next(nullptr),
+          age_prev(nullptr),
+          age_next(nullptr),
+          owner(nullptr),
+          push_tick(0),
+          size(0),
+          objects(new TObj *[capacity]) {}
+  };
+
+  struct depot_key_type {
+    // The newest one is the first
+    magazine_type *head;
+    magazine_type *tail;
+  };
+
+  struct thread_cache_type;
+
+  struct depot_type {
+    std::mutex lock;
+    std::unordered_map<key_t, depot_key_type, THasher, TKeyEQ> full;
+    magazine_type *age_head;
+    magazine_type *age_tail;
+    std::vector<magazine_type *> empty;
+    std::vector<std::weak_ptr<thread_cache_type>> thread_caches;
+    size_t magazine_size;
+    size_t item_count;
+    size_t item_max_bound;
+    time_t list_tick_timeout;
+    time_t last_proc_tick;
+
+    explicit depot_type(size_t mag_size)
+        : age_head(nullptr),
+          age_tail(nullptr),
+          magazine_size(mag_size),
+          item_count(0),
+          item_max_bound(0),
+          list_tick_timeout(0),
+          last_proc_tick(0) {}
+
+    // A thread may exit and return its magazines after clear() of a destroying pool, so the depot may still own
+    // full magazines here
+    ~depot_type() {
+      std::vector<magazine_type *> magazines;
+      for (magazine_type *mag = age_head; nullptr != mag; mag = mag->age_next) {
+        magazines.push_back(mag);
+      }
+      magazines.insert(magazines.end(), empty.begin(), empty.end());
+      destroy_magazines(magazines);
+    }
+  };
+
+  // Bonwick's design, previous is always full or empty
+  struct thread_slot_type {
+    magazine_type *loaded;
+    magazine_type *previous;
+  };
+
+  struct thread_cache_type {
+    lock::spin_lock lock;
+    std::weak_ptr<depot_type> depot;
+    std::unordered_map<key_t, thread_slot_type, THasher, TKeyEQ> slots;
+
+    // Called when thread exits, return magazines to depot
+    ~thread_cache_type() {
+      std::shared_ptr<depot_type> depot_ptr = depot.lock();
+      if (!depot_ptr) {
+        // The pool is already destroyed and all magazines are already reclaimed by clear()
+        return;
+      }
+
+      // The depot may be released here, the magazines are destroyed by ~depot_type() then
+
+      std::lock_guard<lock::spin_lock> cache_guard(lock);
+      std::lock_guard<std::mutex> depot_guard(depot_ptr->lock);
+      for (auto &slot : slots) {
+        if (nullptr != slot.second.loaded) {
+          put_magazine(*depot_ptr, slot.first, slot.second.loaded);
+        }
+        if (nullptr != slot.second.previous) {
+          put_magazine(*depot_ptr, slot.first, slot.second.previous);
+        }
+      }
+      slots.clear();
+    }
+  };
+
+  using thread_cache_map_type = std::unordered_map<uint64_t, std::shared_ptr<thread_cache_type>>;
+
+ public:
+  /**
+   * @param magazine_size count of objects in one magazine, which is also the count of objects exchanged with depot
+   *        every time
+   */
+  explicit concurrent_lru_pool(size_t magazine_size = 32)
+      : id_(allocate_pool_id()), depot_(std::make_shared<depot_type>(magazine_size > 0 ? magazine_size : 1)) {}
+
+  ~concurrent_lru_pool() { clear(); }
+
+  inline size_t get_magazine_size() const noexcept { return depot_->magazine_size; }
+
+  /**
+   * @brief Max count of objects in depot, objects in the oldest magazines are destroyed by proc() when exceeded
+   * @param v 0 means unlimited(default)
+   */
+  void set_item_max_bound(size_t v) {
+    std::lock_guard<std::mutex> guard(depot_->lock);
+    depot_->item_max_bound = v;
+  }
+
+  size_t get_item_max_bound() const {
+    std::lock_guard<std::mutex> guard(depot_->lock);
+    return depot_->item_max_bound;
+  }
+
+  /**
+   * @brief Magazines in depot are destroyed by proc() after timeout, the same as lru_pool_manager
+   * @param v 0 means never timeout(default)
+   */
+  void set_list_tick_timeout(time_t v) {
+    std::lock_guard<std::mutex> guard(depot_->lock);
+    depot_->list_tick_timeout = v;
+  }
+
+  time_t get_list_tick_timeout() const {
+    std::lock_guard<std::mutex> guard(depot_->lock);
+    return depot_->list_tick_timeout;
+  }
+
+  bool push(const key_t &id, TObj *obj) {
+    if (nullptr == obj) {
+      return false;
+    }
+
+    TAction act;
+    act.push(obj);
+
+    thread_cache_type &cache = get_thread_cache();
+    std::lock_guard<lock::spin_lock> cache_guard(cache.lock);
+    thread_slot_type &slot = cache.slots[id];
+    if (nullptr == slot.loaded || slot.loaded->size >= depot_->magazine_size) {
+      if (nullptr != slot.previous && 0 == slot.previous->size) {
+        std::swap(slot.loaded, slot.previous);
+      } else {
+        // Give the full previous magazine to depot and get an empty one
+        magazine_type *empty_magazine = nullptr;
+        {
+          std::lock_guard<std::mutex> depot_guard(depot_->lock);
+          if (nullptr != slot.previous) {
+            put_magazine(*depot_, id, slot.previous);
+          }
+          if (!depot_->empty.empty()) {
+            empty_magazine = depot_->empty.back();
+            depot_->empty.pop_back();
+          }
+        }
+
+        if (nullptr == empty_magazine) {
+          empty_magazine = new magazine_type(depot_->magazine_size);
+        }
+        slot.previous = slot.loaded;
+        slot.loaded = empty_magazine;
+      }
+    }
+
+    slot.loaded->objects[slot.loaded->size++] = obj;
+    return true;
+  }
+
+  TObj *pull(const key_t &id) {
+    TObj *ret = nullptr;
+    {
+      thread_cache_type &cache = get_thread_cache();
+      std::lock_guard<lock::spin_lock> cache_guard(cache.lock);
+      typename std::unordered_map<key_t, thread_slot_type, THasher, TKeyEQ>::iterator iter = cache.slots.find(id);
+      thread_slot_type *slot = iter == cache.slots.end() ? nullptr : &iter->second;
+      if (nullptr == slot || nullptr == slot->loaded || 0 == slot->loaded->size) {
+        if (nullptr != slot && nullptr != slot->previous && slot->previous->size > 0) {
+          std::swap(slot->loaded, slot->previous);
+        } else {
+          // Get a full magazine from depot and give the empty previous one to depot
+          std::lock_guard<std::mutex> depot_guard(depot_->lock);
+          magazine_type *full_magazine = take_full_magazine(*depot_, id);
+          if (nullptr == full_magazine) {
+            return nullptr;
+          }
+
+          if (nullptr == slot) {
+            slot = &cache.slots[id];
+          }
+          if (nullptr != slot->previous) {
+            put_magazine(*depot_, id, slot->previous);
+          }
+          slot->previous = slot->loaded;
+          slot->loaded = full_magazine;
+        }
+      }
+
+      ret = slot->loaded->objects[--slot->loaded->size];
+    }
+
+    TAction act;
+    act.pull(ret);
+    act.reset(ret);
+    return ret;
+  }
+
+  /**
+   * @brief Destroy objects in depot which are timeout or exceed the item max bound
+   * @param tick tick used to check timeout, the unit is decided by caller
+   * @return count of destroyed objects
+   */
+  size_t proc(time_t tick) {
+    std::vector<magazine_type *> magazines;
+    {
+      std::lock_guard<std::mutex> guard(depot_->lock);
+      depot_->last_proc_tick = tick;
+      while (nullptr != depot_->age_head) {
+        magazine_type *mag = depot_->age_head;
+        bool timeout = depot_->list_tick_timeout > 0 && tick - mag->push_tick > depot_->list_tick_timeout;
+        bool exceeded = depot_->item_max_bound > 0 && depot_->item_count > depot_->item_max_bound;
+        if (!timeout && !exceeded) {
+          break;
+        }
+
+        remove_full_magazine(*depot_, mag);
+        magazines.push_back(mag);
+      }
+    }
+
+    return destroy_magazines(magazines);
+  }
+
+  /**
+   * @brief Destroy all objects in depot, objects in magazines of threads are not affected
+   * @return count of destroyed objects
+   */
+  size_t gc() {
+    std::vector<magazine_type *> magazines;
+    take_depot_magazines(magazines);
+    return destroy_magazines(magazines);
+  }
+
+  /**
+   * @brief Destroy all objects, including the ones in magazines of threads
+   */
+  void clear() {
+    std::vector<std::shared_ptr<thread_cache_type>> caches;
+    {
+      std::lock_guard<std::mutex> guard(depot_->lock);
+      for (auto &cache : depot_->thread_caches) {
+        std::shared_ptr<thread_cache_type> cache_ptr = cache.lock();
+        if (cache_ptr) {
+          caches.emplace_back(std::move(cache_ptr));
+        }
+      }
+    }
+
+    // Never lock the cache of a thread when holding the lock of depot
+    std::vector<magazine_type *> magazines;
+    for (auto &cache : caches) {
+      take_all_magazines(*cache, magazines);
+    }
+    take_depot_magazines(magazines);
+    destroy_magazines(magazines);
+  }
+
+  /**
+   * @brief Count of objects in depot
+   */
+  size_t get_depot_item_count() const {
+    std::lock_guard<std::mutex> guard(depot_->lock);
+    return depot_->item_count;
+  }
+
+  /**
+   * @brief Count of all objects, including the ones in magazines of threads
+   * @note High cost, do not use it frequently
+   */
+  size_t size() const {
+    std::vector<std::shared_ptr<thread_cache_type>> caches;
+    size_t ret = 0;
+    {
+      std::lock_guard<std::mutex> guard(depot_->lock);
+      ret = depot_->item_count;
+      for (auto &cache : depot_->thread_caches) {
+        std::shared_ptr<thread_cache_type> cache_ptr = cache.lock();
+        if (cache_ptr) {
+          caches.emplace_back(std::move(cache_ptr));
+        }
+      }
+    }
+
+    for (auto &cache : caches) {
+      std::lock_guard<lock::spin_lock> cache_guard(cache->lock);
+      for (auto &slot : cache->slots) {
+        ret += nullptr == slot.second.loaded ? 0 : slot.second.loaded->size;
+        ret += nullptr == slot.second.previous ? 0 : slot.second.previous->size;
+      }
+    }
+    return ret;
+  }
+
+ private:
+  static uint64_t allocate_pool_id() {
+    static std::atomic<uint64_t> id_alloc{0};
+    return ++id_alloc;
+  }
+
+  thread_cache_type &get_thread_cache() {
+    static thread_local thread_cache_map_type caches;
+    typename thread_cache_map_type::iterator iter = caches.find(id_);
+    if (iter != caches.end()) {
+      return *iter->second;
+    }
+
+    // Remove caches of destroyed pools
+    for (iter = caches.begin(); iter != caches.end();) {
+      if (iter->second->depot.expired()) {
+        iter = caches.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+
+    std::shared_ptr<thread_cache_type> cache = std::make_shared<thread_cache_type>();
+    cache->depot = depot_;
+    {
+      std::lock_guard<std::mutex> guard(depot_->lock);
+      for (size_t i = 0; i < depot_->thread_caches.size();) {
+        if (depot_->thread_caches[i].expired()) {
+          depot_->thread_caches[i] = depot_->thread_caches.back();
+          depot_->thread_caches.pop_back();
+        } else {
+          ++i;
+        }
+      }
+      depot_->thread_caches.push_back(cache);
+    }
+    caches[id_] = cache;
+    return *cache;
+  }
+
+  // Depot must be locked
+  static void put_magazine(depot_type &depot, const key_t &id, magazine_type *mag) {
+    if (0 == mag->size) {
+      depot.empty.push_back(mag);
+      return;
+    }
+
+    depot_key_type &owner = depot.full[id];
+    mag->owner = &owner;
+    mag->prev = nullptr;
+    mag->next = owner.head;
+    if (nullptr != owner.head) {
+      owner.head->prev = mag;
+    } else {
+      owner.tail = mag;
+    }
+    owner.head = mag;
+
+    mag->push_tick = depot.last_proc_tick;
+    mag->age_next = nullptr;
+    mag->age_prev = depot.age_tail;
+    if (nullptr != depot.age_tail) {
+      depot.age_tail->age_next = mag;
+    } else {
+      depot.age_head = mag;
+    }
+    depot.age_tail = mag;
+
+    depot.item_count += mag->size;
+  }
+
+  // Depot must be locked
+  static void remove_full_magazine(depot_type &depot, magazine_type *mag) {
+    depot_key_type &owner = *mag->owner;
+    if (nullptr != mag->prev) {
+      mag->prev->next = mag->next;
+    } else {
+      owner.head = mag->next;
+    }
+    if (nullptr != mag->next) {
+      mag->next->prev = mag->prev;
+    } else {
+      owner.tail = mag->prev;
+    }
+
+    if (nullptr != mag->age_prev) {
+      mag->age_prev->age_next = mag->age_next;
+    } else {
+      depot.age_head = mag->age_next;
+    }
+    if (nullptr != mag->age_next) {
+      mag->age_next->age_prev = mag->age_prev;
+    } else {
+      depot.age_tail = mag->age_prev;
+    }
+
+    mag->prev = nullptr;
+    mag->next = nullptr;
+    mag->age_prev = nullptr;
+    mag->age_next = nullptr;
+    mag->owner = nullptr;
+    depot.item_count -= mag->size;
+  }
+
+  // Depot must be locked, the newest full magazine is reused first
+  static magazine_type *take_full_magazine(depot_type &depot, const key_t &id) {
+    typename std::unordered_map<key_t, depot_key_type, THasher, TKeyEQ>::iterator iter = depot.full.find(id);
+    if (iter == depot.full.end() || nullptr == iter->second.head) {
+      return nullptr;
+    }
+
+    magazine_type *ret = iter->second.head;
+    remove_full_magazine(depot, ret);
+    return ret;
+  }
+
+  static void take_all_magazines(thread_cache_type &cache, std::vector<magazine_type *> &output) {
+    std::lock_guard<lock::spin_lock> cache_guard(cache.lock);
+    for (auto &slot : cache.slots) {
+      if (nullptr != slot.second.loaded) {
+        output.push_back(slot.second.loaded);
+      }
+      if (nullptr != slot.second.previous) {
+        output.push_back(slot.second.previous);
+      }
+    }
+    cache.slots.clear();
+  }
+
+  void take_depot_magazines(std::vector<magazine_type *> &output) {
+    std::lock_guard<std::mutex> guard(depot_->lock);
+    while (nullptr != depot_->age_head) {
+      magazine_type *mag = depot_->age_head;
+      remove_full_magazine(*depot_, mag);
+      output.push_back(mag);
+    }
+    depot_->full.clear();
+
+    output.insert(output.end(), depot_->empty.begin(), depot_->empty.end());
+    depot_->empty.clear();
+  }
+
+  // Objects are destroyed without any lock held
+  static size_t destroy_magazines(std::vector<magazine_type *> &magazines) {
+    size_t ret = 0;
+    TAction act;
+    for (auto &mag : magazines) {
+      for (size_t i = 0; i < mag->size; ++i) {
+        act.gc(mag->objects[i]);
+      }
+      ret += mag->size;
+      delete mag;
+    }
+    magazines.clear();
+    return ret;
+  }
+
+ private:
+  uint64_t id_;
+  std::shared_ptr<depot_type> depot_;
+};
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -0,0 +1,159 @@
+// Copyright 2026 atframework
+//
+// Licenses under the MIT License
+// @note deferred_rc_ptr is a strong_rc_ptr which do not destroy the object when the last owner is released. The counter
+//       is pushed into a queue of the releasing thread instead, and objects are destroyed by
+//       deferred_rc_release::drain(max_objects) later, so destruction of large object graphs can be spread across
+//       frames of a tick loop.
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <config/compile_optimize.h>
+#include <config/compiler_features.h>
+#include <memory/rc_ptr.h>
+
+#include <cstddef>
+#include <utility>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_deferred_base;
+
+/**
+ * @brief Single thread reference counting policy, the object is destroyed by deferred_rc_release::drain()
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY rc_ptr_deferred_policy {
+  using counted_data_base = __rc_ptr_counted_data_deferred_base;
+};
+
+/**
+ * @brief Deferred-release queue of current thread
+ * @note Objects released in drain() may release other deferred_rc_ptr, they are appended to the end of queue and will
+ *       be destroyed by the next drain(). Pending objects are destroyed when the thread exits.
+ */
+class ATFW_UTIL_SYMBOL_VISIBLE deferred_rc_release {
+ public:
+  /**
+   * @brief Destroy at most max_objects pending objects of current thread
+   * @return Count of destroyed objects
+   */
+  static ATFRAMEWORK_UTILS_API size_t drain(size_t max_objects) noexcept;
+
+  /**
+   * @brief Destroy all pending objects of current thread, include objects released during draining
+   * @return Count of destroyed objects
+   */
+  static ATFRAMEWORK_UTILS_API size_t drain_all() noexcept;
+
+  /**
+   * @brief Count of pending objects of current thread
+   */
+  static ATFRAMEWORK_UTILS_API size_t size() noexcept;
+
+ private:
+  friend class __rc_ptr_counted_data_deferred_base;
+
+  static ATFRAMEWORK_UTILS_API void push(__rc_ptr_counted_data_deferred_base* counter) noexcept;
+};
+
+class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_deferred_base {
+ public:
+  UTIL_CONFIG_CONSTEXPR __rc_ptr_counted_data_deferred_base() noexcept
+      : use_count_(1), weak_count_(1), deferred_next_(nullptr) {}
+
+  ATFRAMEWORK_UTILS_API virtual ~__rc_ptr_counted_data_deferred_base() noexcept;
+
+  // Called by deferred_rc_release::drain(), to release the resources managed by *this.
+  virtual void dispose() noexcept = 0;
+
+  // Called when weak_count_ drops to zero.
+  virtual void destroy() noexcept = 0;
+
+  // Increment the use count if it is non-zero, throw otherwise.
+  UTIL_FORCEINLINE void add_ref() {
+    if (!add_ref_nothrow()) {
+      __rc_ptr_counted_data_base::throw_bad_weak_ptr();
+    }
+  }
+
+  // Increment the use count if it is non-zero.
+  UTIL_FORCEINLINE bool add_ref_nothrow() noexcept {
+    if (use_count_ == 0) {
+      return false;
+    }
+
+    ++use_count_;
+    return true;
+  }
+
+  // Increment the use count, the caller must already own a strong reference.
+  UTIL_FORCEINLINE void add_ref_copy() noexcept { ++use_count_; }
+
+  // Decrement the use count, weak_rc_ptr is already expired when it's pending.
+  UTIL_FORCEINLINE void release() noexcept {
+    if (--use_count_ == 0) {
+      deferred_rc_release::push(this);
+    }
+  }
+
+  // Increment the weak count.
+  UTIL_FORCEINLINE void weak_add_ref() noexcept { ++weak_count_; }
+
+  // Decrement the weak count.
+  UTIL_FORCEINLINE void weak_release() noexcept {
+    if (--weak_count_ == 0) {
+      destroy();
+    }
+  }
+
+  UTIL_FORCEINLINE std::size_t use_count() const noexcept { return use_count_; }
+
+ private:
+  __rc_ptr_counted_data_deferred_base(const __rc_ptr_counted_data_deferred_base&) = delete;
+  __rc_ptr_counted_data_deferred_base& operator=(const __rc_ptr_counted_data_deferred_base&) = delete;
+
+  friend class deferred_rc_release;
+
+ private:
+  std::size_t use_count_;
+  std::size_t weak_count_;
+  __rc_ptr_counted_data_deferred_base* deferred_next_;
+};
+
+/**
+ * @brief strong_rc_ptr which destroys the object in deferred_rc_release::drain() of the releasing thread.
+ */
+template <class T>
+using deferred_rc_ptr = strong_rc_ptr<T, rc_ptr_deferred_policy>;
+
+template <class T>
+using deferred_weak_rc_ptr = weak_rc_ptr<T, rc_ptr_deferred_policy>;
+
+template <class T>
+using enable_shared_deferred_rc_from_this = enable_shared_rc_from_this<T, rc_ptr_deferred_policy>;
+
+/**
+ * @brief A std::make_shared replacement for deferred_rc_ptr(non-array and bounded array).
+ * @param args Arguments to construct the object.
+ */
+template <class T, class... TArgs>
+nostd::enable_if_t<!nostd::is_unbounded_array<T>::value, deferred_rc_ptr<T>> make_deferred_rc(TArgs&&... args) {
+  return deferred_rc_ptr<T>(__strong_rc_default_alloc_shared_tag<T>{}, std::forward<TArgs>(args)...);
+}
+
+/**
+ * @brief A std::allocate_shared (C++20) replacement for deferred_rc_ptr(non-array and bounded array).
+ * @param alloc The custom allocator.
+ * @param args Arguments to construct the object.
+ */
+template <class T, class Alloc, class... TArgs>
+nostd::enable_if_t<!nostd::is_unbounded_array<T>::value, deferred_rc_ptr<T>> allocate_deferred_rc(const Alloc& alloc,
+                                                                                                   TArgs&&... args) {
+  return deferred_rc_ptr<T>(__strong_rc_with_alloc_shared_tag<T>{}, alloc, std::forward<TArgs>(args)...);
+}
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
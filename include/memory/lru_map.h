@@ -15,9 +15,12 @@
 
 #include <config/atframe_utils_build_feature.h>
 #include <config/compiler_features.h>
+#include <memory/lru_map_expiry.h>
+#include <memory/lru_map_policy.h>
 #include <memory/rc_ptr.h>
 #include <std/explicit_declare.h>
 
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <list>
@@ -29,9 +32,15 @@
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace memory {
 
-template <compat_strong_ptr_mode PtrMode>
+/**
+ * @brief 选项
+ * @note TEvictionPolicy 为淘汰策略: lru_map_policy_lru(默认), lru_map_policy_2q, lru_map_policy_arc,
+ *       lru_map_policy_w_tinylfu ，仅在设置了 set_max_size() 后自动淘汰时生效
+ */
+template <compat_strong_ptr_mode PtrMode, class TEvictionPolicy = lru_map_policy_lru>
 struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_option {
   static UTIL_CONFIG_CONSTEXPR const compat_strong_ptr_mode ptr_mode = PtrMode;
+  using eviction_policy = TEvictionPolicy;
 };
 
 template <class TKEY, class TVALUE, class TOption = lru_map_option<compat_strong_ptr_mode::kStl>>
@@ -74,31 +83,45 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
   using const_reverse_iterator = typename lru_map_type_traits<TKEY, TVALUE, TOption>::const_reverse_iterator;
 
   using lru_key_value_map_type = std::unordered_map<TKEY, iterator, THasher, TKeyEQ, TAlloc>;
+  using eviction_policy_type = typename details::lru_map_option_policy<option_type>::type::template policy_type<
+      TKEY, THasher, TKeyEQ, iterator>;
   using self_type = lru_map<TKEY, TVALUE, THasher, TKeyEQ, TOption, TAlloc>;
+  using duration_type = details::lru_map_clock_type::duration;
+  using weigher_type = std::function<size_type(const value_type &)>;
 
   lru_map() noexcept(std::is_nothrow_constructible<lru_history_list_type>::value &&
-                     std::is_nothrow_constructible<lru_key_value_map_type>::value) {}
+                     std::is_nothrow_constructible<lru_key_value_map_type>::value &&
+                     std::is_nothrow_constructible<eviction_policy_type>::value)
+      : max_size_(0), stats_{0, 0, 0, 0} {}
   ~lru_map() = default;
 
   template <class TCONTAINER>
-  ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map(const TCONTAINER &other) {
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map(const TCONTAINER &other) : max_size_(0), stats_{0, 0, 0, 0} {
     reserve(static_cast<size_type>(other.size()));
     insert(other.begin(), other.end());
   }
 
-  lru_map(const lru_map &other) {
+  lru_map(const lru_map &other) : max_size_(0), stats_{0, 0, 0, 0} {
+    copy_limits(other);
     reserve(static_cast<size_type>(other.size()));
     insert(other.cbegin(), other.cend());
   }
 
   lru_map(lru_map &&other) noexcept(
       std::is_nothrow_constructible<lru_history_list_type, lru_history_list_type &&>::value &&
-      std::is_nothrow_constructible<lru_key_value_map_type, lru_key_value_map_type &&>::value) {
+      std::is_nothrow_constructible<lru_key_value_map_type, lru_key_value_map_type &&>::value &&
+      std::is_nothrow_constructible<eviction_policy_type>::value)
+      : max_size_(0), stats_{0, 0, 0, 0} {
     swap(other);
   }
 
   lru_map &operator=(const lru_map &other) {
+    if (this == &other) {
+      return *this;
+    }
+
     clear();
+    copy_limits(other);
     reserve(static_cast<size_type>(other.size()));
     insert(other.cbegin(), other.cend());
     return *this;
@@ -106,7 +129,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
 
   lru_map &operator=(lru_map &&other) noexcept(
       std::is_nothrow_constructible<lru_history_list_type, lru_history_list_type &&>::value &&
-      std::is_nothrow_constructible<lru_key_value_map_type, lru_key_value_map_type &&>::value) {
+      std::is_nothrow_constructible<lru_key_value_map_type, lru_key_value_map_type &&>::value &&
+      std::is_nothrow_constructible<eviction_policy_type>::value) {
     swap(other);
     other.clear();
     return *this;
@@ -154,11 +178,156 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
   void swap(self_type &other) noexcept {
     other.visit_history_.swap(visit_history_);
     other.kv_data_.swap(kv_data_);
+    other.policy_.swap(policy_);
+    std::swap(other.max_size_, max_size_);
+    std::swap(other.stats_, stats_);
+    other.meta_.swap(meta_);
   }
 
   void clear() {
     kv_data_.clear();
     visit_history_.clear();
+    policy_.clear();
+    if (meta_) {
+      meta_->clear();
+    }
+  }
+
+  /**
+   * @brief 设置最大元素数量，插入新元素时按淘汰策略自动淘汰
+   * @param max_size 最大元素数量，0 表示不限制(默认)
+   */
+  void set_max_size(size_type max_size) {
+    max_size_ = max_size;
+    policy_.set_capacity(max_size);
+    evict_for(0, 0, nullptr);
+  }
+
+  inline size_type get_max_size() const noexcept { return max_size_; }
+
+  /**
+   * @brief 设置最大总权重(比如字节数)，插入新元素时按淘汰策略自动淘汰，直到总权重不超过上限
+   * @param max_weight 最大总权重，0 表示不限制(默认)
+   * @note 单个元素的权重超过上限时，会淘汰其他所有元素后保留它
+   */
+  void set_max_weight(size_type max_weight) {
+    if (0 == max_weight && !meta_) {
+      return;
+    }
+
+    mutable_meta().max_weight = max_weight;
+    evict_for(0, 0, nullptr);
+  }
+
+  inline size_type get_max_weight() const noexcept { return meta_ ? meta_->max_weight : 0; }
+
+  /**
+   * @brief 所有元素的总权重，未设置 weigher 时每个元素权重为 1
+   */
+  inline size_type get_total_weight() const noexcept { return meta_ ? meta_->total_weight : size(); }
+
+  /**
+   * @brief 设置元素权重的计算函数，权重在插入时计算，已有的元素会重新计算
+   * @note 插入后修改了值的内容时，可以调用 update_weight() 重新计算
+   */
+  void set_weigher(weigher_type weigher) {
+    meta_store_type &meta = mutable_meta();
+    meta.weigher = std::move(weigher);
+    meta.total_weight = 0;
+    for (auto &entry : meta.entries) {
+      entry.second.weight = meta.weigh(*entry.second.iter);
+      meta.total_weight += entry.second.weight;
+    }
+    evict_for(0, 0, nullptr);
+  }
+
+  /**
+   * @brief 重新计算一个元素的权重
+   * @return 元素不存在时返回 false
+   */
+  bool update_weight(const key_type &key) {
+    if (!meta_) {
+      return kv_data_.end() != kv_data_.find(key);
+    }
+
+    typename meta_store_type::meta_map_type::iterator it = meta_->entries.find(key);
+    if (it == meta_->entries.end()) {
+      return false;
+    }
+
+    meta_->total_weight -= it->second.weight;
+    it->second.weight = meta_->weigh(*it->second.iter);
+    meta_->total_weight += it->second.weight;
+    evict_for(0, 0, nullptr);
+    return true;
+  }
+
+  /**
+   * @brief 设置新插入元素的默认过期时间
+   * @param ttl 过期时间，精度为毫秒，0 表示不过期(默认)
+   */
+  void set_default_ttl(duration_type ttl) {
+    int64_t ticks = details::lru_map_ttl_ticks(ttl);
+    if (0 == ticks && !meta_) {
+      return;
+    }
+    mutable_meta().default_ttl_ticks = ticks;
+  }
+
+  inline duration_type get_default_ttl() const noexcept {
+    return meta_ ? std::chrono::duration_cast<duration_type>(std::chrono::milliseconds(meta_->default_ttl_ticks))
+                 : duration_type::zero();
+  }
+
+  /**
+   * @brief 设置单个元素的过期时间，从现在开始计算
+   * @param ttl 过期时间，精度为毫秒，0 表示不过期
+   * @return 元素不存在时返回 false
+   */
+  bool set_ttl(const key_type &key, duration_type ttl) {
+    expire_entries();
+    if (kv_data_.end() == kv_data_.find(key)) {
+      return false;
+    }
+
+    meta_store_type &meta = mutable_meta();
+    typename meta_store_type::meta_type &entry = meta.entries[key];
+    meta.wheel.remove(&entry);
+
+    int64_t ticks = details::lru_map_ttl_ticks(ttl);
+    if (ticks > 0) {
+      int64_t now_tick = details::lru_map_now_tick();
+      meta.wheel.advance(now_tick);
+      entry.expire_tick = now_tick + ticks;
+      meta.wheel.add(&entry);
+    } else {
+      entry.expire_tick = -1;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 移除所有已过期的元素
+   * @note 查找和插入时也会移除已过期的元素，每个元素在时间轮里最多移动固定次数，所以均摊开销为 O(1)。
+   *       长时间没有操作时，已过期的元素仍计算在 size() 里，可以定期调用这个接口主动释放。
+   * @return 移除的元素数量
+   */
+  size_type remove_expired() {
+    size_type before = size();
+    expire_entries();
+    return before - size();
+  }
+
+  /**
+   * @brief 命中、未命中和淘汰计数，用于对比不同淘汰策略的命中率
+   */
+  inline const lru_map_stats &get_stats() const noexcept { return stats_; }
+
+  inline void reset_stats() noexcept {
+    stats_.hit_count = 0;
+    stats_.miss_count = 0;
+    stats_.eviction_count = 0;
+    stats_.expiration_count = 0;
   }
 
   template <class TPARAMKEY, class TPARAMVALUE>
@@ -174,17 +343,13 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
   ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<iterator, bool> insert_key_value(
       const TPARAMKEY &key,
       const typename compat_strong_ptr_function_trait<option_type::ptr_mode>::template shared_ptr<TPARAMVALUE> &value) {
+    expire_entries();
     typename lru_key_value_map_type::iterator it = kv_data_.find(key);
     if (it != kv_data_.end()) {
       return std::pair<iterator, bool>(visit_history_.end(), false);
     }
 
-    typename lru_history_list_type::iterator res = visit_history_.insert(visit_history_.end(), value_type(key, value));
-    if (res == visit_history_.end()) {
-      return std::pair<iterator, bool>(res, false);
-    }
-    kv_data_[key] = res;
-    return std::pair<iterator, bool>(res, true);
+    return insert_new(value_type(key, value));
   }
 
   template <class TCKEY, class TCVALUE>
@@ -193,18 +358,13 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
   }
 
   std::pair<iterator, bool> insert(value_type &&value) {
-    key_type key = value.first;
-    typename lru_key_value_map_type::iterator it = kv_data_.find(key);
+    expire_entries();
+    typename lru_key_value_map_type::iterator it = kv_data_.find(value.first);
     if (it != kv_data_.end()) {
       return std::pair<iterator, bool>(visit_history_.end(), false);
     }
 
-    typename lru_history_list_type::iterator res = visit_history_.insert(visit_history_.end(), value);
-    if (res == visit_history_.end()) {
-      return std::pair<iterator, bool>(res, false);
-    }
-    kv_data_[key] = res;
-    return std::pair<iterator, bool>(res, true);
+    return insert_new(std::move(value));
   }
 
   template <class TPARAMKEY, class TPARAMVALUE>
@@ -250,6 +410,10 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
     }
 
     kv_data_.erase(it);
+    policy_.on_erase(pos);
+    if (meta_) {
+      meta_->remove(key);
+    }
     return visit_history_.erase(pos);
   }
 
@@ -267,21 +431,29 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
       return 0;
     }
 
+    policy_.on_erase(it->second);
+    if (meta_) {
+      meta_->remove(key);
+    }
     visit_history_.erase(it->second);
     kv_data_.erase(it);
     return 1;
   }
 
   iterator find(const key_type &key, bool update_visit = true) {
+    expire_entries();
     typename lru_key_value_map_type::iterator it = kv_data_.find(key);
     if (it == kv_data_.end()) {
+      ++stats_.miss_count;
+      policy_.on_miss(key);
       return visit_history_.end();
     }
 
+    ++stats_.hit_count;
     if (update_visit) {
-      value_type move_out = *it->second;
-      visit_history_.erase(it->second);
-      it->second = visit_history_.insert(visit_history_.end(), move_out);
+      // splice keeps the iterator valid and does not copy or reallocate the element
+      visit_history_.splice(visit_history_.end(), visit_history_, it->second);
+      policy_.on_hit(it->second);
     }
 
     return it->second;
@@ -301,9 +473,90 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map {
     return *(*it).second;
   }
 
+ private:
+  using meta_store_type = details::lru_map_entry_meta_store<TKEY, THasher, TKeyEQ, iterator, value_type>;
+
+  std::pair<iterator, bool> insert_new(value_type &&value) {
+    policy_.prepare_insert(value.first);
+    size_type weight = 0;
+    if (meta_) {
+      weight = meta_->weigh(value);
+    }
+    evict_for(1, weight, &value.first);
+
+    iterator res = visit_history_.insert(visit_history_.end(), std::move(value));
+    kv_data_[res->first] = res;
+    if (meta_) {
+      meta_->add(res, weight);
+    }
+    policy_.on_insert(res);
+    return std::pair<iterator, bool>(res, true);
+  }
+
+  inline bool is_over_limit(size_type incoming_count, size_type incoming_weight) const noexcept {
+    if (max_size_ > 0 && size() + incoming_count > max_size_) {
+      return true;
+    }
+
+    return meta_ && meta_->max_weight > 0 && meta_->total_weight + incoming_weight > meta_->max_weight;
+  }
+
+  // Evict elements until the incoming one fits both max size and max weight
+  void evict_for(size_type incoming_count, size_type incoming_weight, const key_type *incoming) {
+    while (!empty() && is_over_limit(incoming_count, incoming_weight)) {
+      size_type before = size();
+      erase(policy_.select_victim(visit_history_.begin(), incoming));
+      if (size() >= before) {
+        break;
+      }
+      ++stats_.eviction_count;
+    }
+  }
+
+  // The time wheel moves every element at most once per level, so this is amortized O(1) for every operation
+  void expire_entries() {
+    if (!meta_ || 0 == meta_->wheel.size()) {
+      return;
+    }
+
+    meta_->wheel.advance(details::lru_map_now_tick());
+    while (meta_->wheel.has_expired()) {
+      typename meta_store_type::meta_type *entry = meta_->wheel.pop_expired();
+      erase(entry->iter);
+      ++stats_.expiration_count;
+    }
+  }
+
+  // Weights and TTL are stored only after they are used, other lru_map are not affected
+  meta_store_type &mutable_meta() {
+    if (meta_) {
+      return *meta_;
+    }
+
+    meta_.reset(new meta_store_type());
+    for (iterator it = visit_history_.begin(); it != visit_history_.end(); ++it) {
+      meta_->add(it, 1);
+    }
+    return *meta_;
+  }
+
+  void copy_limits(const lru_map &other) {
+    set_max_size(other.max_size_);
+    if (other.meta_) {
+      // TTL of elements is not copied, copied elements use the default TTL
+      set_weigher(other.meta_->weigher);
+      set_max_weight(other.meta_->max_weight);
+      mutable_meta().default_ttl_ticks = other.meta_->default_ttl_ticks;
+    }
+  }
+
  private:
   lru_history_list_type visit_history_;
   lru_key_value_map_type kv_data_;
+  eviction_policy_type policy_;
+  size_type max_size_;
+  lru_map_stats stats_;
+  std::unique_ptr<meta_store_type> meta_;
 };
 }  // namespace memory
 ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -0,0 +1,323 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compiler_features.h>
+#include <design_pattern/noncopyable.h>
+
+#include <algorithm/bit.h>
+
+#include <stdint.h>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+namespace details {
+
+/**
+ * @brief Clock of TTL in lru_map, one tick is one millisecond
+ */
+using lru_map_clock_type = std::chrono::steady_clock;
+
+static inline int64_t lru_map_now_tick() {
+  return static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(lru_map_clock_type::now().time_since_epoch()).count());
+}
+
+// Round up to ticks, 0 means never expire
+static inline int64_t lru_map_ttl_ticks(lru_map_clock_type::duration ttl) {
+  if (ttl <= lru_map_clock_type::duration::zero()) {
+    return 0;
+  }
+
+  int64_t ret = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(ttl).count());
+  if (std::chrono::milliseconds(ret) < ttl) {
+    ++ret;
+  }
+  return ret;
+}
+
+/**
+ * @brief Hierarchical timing wheel for expiry of lru_map elements
+ * @note TNODE must have members: TNODE *prev, TNODE *next, int64_t expire_tick, int32_t wheel_slot
+ * @note There are 6 levels of 64 slots, which covers 2^36 ticks. Every node is moved at most once per level before
+ *       it expires, and empty slots are skipped by the occupancy bitmap of each level, so advance() costs amortized
+ *       O(1) for every node, no matter how long the wheel is idle.
+ */
+template <class TNODE>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_expiry_wheel {
+ public:
+  enum : int32_t {
+    kLevelBits = 6,
+    kLevelCount = 6,
+    kSlotCount = 1 << kLevelBits,
+    kSlotMask = kSlotCount - 1,
+    // Nodes which are already expired and are waiting for pop_expired()
+    kExpiredSlot = kLevelCount * kSlotCount,
+  };
+
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(lru_map_expiry_wheel)
+
+ public:
+  explicit lru_map_expiry_wheel(int64_t now_tick) : current_tick_(now_tick), size_(0) {
+    for (auto &slot : slots_) {
+      slot.head = nullptr;
+      slot.tail = nullptr;
+    }
+    for (auto &occupied : occupied_) {
+      occupied = 0;
+    }
+  }
+
+  /**
+   * @brief Ticks before current_tick() are already processed
+   */
+  inline int64_t current_tick() const noexcept { return current_tick_; }
+
+  /**
+   * @brief Count of nodes in wheel, including the expired ones which are not popped
+   */
+  inline size_t size() const noexcept { return size_; }
+
+  inline bool has_expired() const noexcept { return nullptr != slots_[kExpiredSlot].head; }
+
+  void add(TNODE *node) {
+    int32_t slot = -1;
+    if (node->expire_tick < current_tick_) {
+      slot = kExpiredSlot;
+    } else {
+      for (int32_t level = 0; level < kLevelCount; ++level) {
+        int32_t shift = level * kLevelBits;
+        if ((node->expire_tick >> shift) - (current_tick_ >> shift) < kSlotCount) {
+          slot = level * kSlotCount + static_cast<int32_t>((node->expire_tick >> shift) & kSlotMask);
+          break;
+        }
+      }
+
+      if (slot < 0) {
+        // Out of range, put it into the last slot of the top level and place it again when it's cascaded
+        int32_t shift = (kLevelCount - 1) * kLevelBits;
+        slot = (kLevelCount - 1) * kSlotCount +
+               static_cast<int32_t>(((current_tick_ >> shift) + kSlotCount - 1) & kSlotMask);
+      }
+    }
+
+    push_back(slot, node);
+  }
+
+  void remove(TNODE *node) {
+    if (node->wheel_slot < 0) {
+      return;
+    }
+
+    slot_type &slot = slots_[node->wheel_slot];
+    if (nullptr != node->prev) {
+      node->prev->next = node->next;
+    } else {
+      slot.head = node->next;
+    }
+    if (nullptr != node->next) {
+      node->next->prev = node->prev;
+    } else {
+      slot.tail = node->prev;
+    }
+
+    if (nullptr == slot.head && node->wheel_slot < kExpiredSlot) {
+      occupied_[node->wheel_slot / kSlotCount] &= ~(static_cast<uint64_t>(1) << (node->wheel_slot & kSlotMask));
+    }
+
+    node->prev = nullptr;
+    node->next = nullptr;
+    node->wheel_slot = -1;
+    --size_;
+  }
+
+  /**
+   * @brief Move all nodes whose expire_tick <= now_tick into the expired list
+   */
+  void advance(int64_t now_tick) {
+    while (current_tick_ <= now_tick) {
+      int64_t tick = next_event_tick();
+      if (tick > now_tick) {
+        current_tick_ = now_tick + 1;
+        break;
+      }
+
+      current_tick_ = tick;
+      // Cascade higher levels first, nodes expired at this tick are moved into level 0 and then processed below
+      for (int32_t level = kLevelCount - 1; level > 0; --level) {
+        int32_t shift = level * kLevelBits;
+        if (0 != (tick & ((static_cast<int64_t>(1) << shift) - 1))) {
+          continue;
+        }
+
+        int32_t slot = level * kSlotCount + static_cast<int32_t>((tick >> shift) & kSlotMask);
+        while (nullptr != slots_[slot].head) {
+          TNODE *node = slots_[slot].head;
+          remove(node);
+          add(node);
+        }
+      }
+
+      int32_t slot = static_cast<int32_t>(tick & kSlotMask);
+      while (nullptr != slots_[slot].head) {
+        TNODE *node = slots_[slot].head;
+        remove(node);
+        push_back(kExpiredSlot, node);
+      }
+
+      current_tick_ = tick + 1;
+    }
+  }
+
+  TNODE *pop_expired() {
+    TNODE *ret = slots_[kExpiredSlot].head;
+    if (nullptr != ret) {
+      remove(ret);
+    }
+    return ret;
+  }
+
+  void clear() {
+    for (auto &slot : slots_) {
+      slot.head = nullptr;
+      slot.tail = nullptr;
+    }
+    for (auto &occupied : occupied_) {
+      occupied = 0;
+    }
+    size_ = 0;
+  }
+
+ private:
+  struct slot_type {
+    TNODE *head;
+    TNODE *tail;
+  };
+
+  void push_back(int32_t slot_index, TNODE *node) {
+    slot_type &slot = slots_[slot_index];
+    node->wheel_slot = slot_index;
+    node->next = nullptr;
+    node->prev = slot.tail;
+    if (nullptr != slot.tail) {
+      slot.tail->next = node;
+    } else {
+      slot.head = node;
+    }
+    slot.tail = node;
+
+    if (slot_index < kExpiredSlot) {
+      occupied_[slot_index / kSlotCount] |= static_cast<uint64_t>(1) << (slot_index & kSlotMask);
+    }
+    ++size_;
+  }
+
+  // Slots of level N are processed at ticks which are multiples of 2^(6N), find the first occupied one
+  int64_t next_event_tick() const noexcept {
+    int64_t ret = (std::numeric_limits<int64_t>::max)();
+    for (int32_t level = 0; level < kLevelCount; ++level) {
+      if (0 == occupied_[level]) {
+        continue;
+      }
+
+      int32_t shift = level * kLevelBits;
+      int64_t unit = (current_tick_ + ((static_cast<int64_t>(1) << shift) - 1)) >> shift;
+      int start = static_cast<int>(unit & kSlotMask);
+      int distance = ATFRAMEWORK_UTILS_NAMESPACE_ID::bit::countr_zero(
+          ATFRAMEWORK_UTILS_NAMESPACE_ID::bit::rotr(occupied_[level], start));
+      int64_t tick = (unit + distance) << shift;
+      if (tick < ret) {
+        ret = tick;
+      }
+    }
+    return ret;
+  }
+
+ private:
+  int64_t current_tick_;
+  size_t size_;
+  slot_type slots_[kExpiredSlot + 1];
+  uint64_t occupied_[kLevelCount];
+};
+
+/**
+ * @brief Weight and expiry of one lru_map element
+ */
+template <class TIterator>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_entry_meta {
+  lru_map_entry_meta *prev;
+  lru_map_entry_meta *next;
+  // -1 means never expire
+  int64_t expire_tick;
+  int32_t wheel_slot;
+  size_t weight;
+  TIterator iter;
+
+  lru_map_entry_meta() : prev(nullptr), next(nullptr), expire_tick(-1), wheel_slot(-1), weight(0), iter() {}
+};
+
+/**
+ * @brief Weights and expiry of all elements of one lru_map, it's created only when weight or TTL is used
+ */
+template <class TKEY, class THasher, class TKeyEQ, class TIterator, class TValue>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_entry_meta_store {
+  using meta_type = lru_map_entry_meta<TIterator>;
+  using meta_map_type = std::unordered_map<TKEY, meta_type, THasher, TKeyEQ>;
+  using weigher_type = std::function<size_t(const TValue &)>;
+
+  meta_map_type entries;
+  lru_map_expiry_wheel<meta_type> wheel;
+  weigher_type weigher;
+  size_t max_weight;
+  size_t total_weight;
+  // 0 means never expire
+  int64_t default_ttl_ticks;
+
+  lru_map_entry_meta_store() : wheel(lru_map_now_tick()), max_weight(0), total_weight(0), default_ttl_ticks(0) {}
+
+  inline size_t weigh(const TValue &value) const { return weigher ? weigher(value) : 1; }
+
+  void add(TIterator iter, size_t weight) {
+    meta_type &meta = entries[iter->first];
+    meta.iter = iter;
+    meta.weight = weight;
+    total_weight += weight;
+    if (default_ttl_ticks > 0) {
+      int64_t now_tick = lru_map_now_tick();
+      wheel.advance(now_tick);
+      meta.expire_tick = now_tick + default_ttl_ticks;
+      wheel.add(&meta);
+    }
+  }
+
+  void remove(const TKEY &key) {
+    typename meta_map_type::iterator it = entries.find(key);
+    if (it == entries.end()) {
+      return;
+    }
+
+    wheel.remove(&it->second);
+    total_weight -= it->second.weight;
+    entries.erase(it);
+  }
+
+  void clear() {
+    wheel.clear();
+    entries.clear();
+    total_weight = 0;
+  }
+};
+
+}  // namespace details
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
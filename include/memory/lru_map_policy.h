@@ -0,0 +1,731 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compiler_features.h>
+#include <design_pattern/noncopyable.h>
+#include <nostd/type_traits.h>
+
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+/**
+ * @brief Counters of lru_map, used to compare hit ratios of eviction policies
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_stats {
+  uint64_t hit_count;
+  uint64_t miss_count;
+  uint64_t eviction_count;
+  uint64_t expiration_count;
+};
+
+namespace details {
+
+/**
+ * @brief Hooks of eviction policies, all operations are O(1)
+ *   - on_hit(iterator)          : find(key, true) hits an element
+ *   - on_miss(key)              : find(key) misses
+ *   - prepare_insert(key)       : a new key will be inserted, called before select_victim()
+ *   - select_victim(first, key) : return the element to evict, key is nullptr when shrinking the capacity
+ *   - on_insert(iterator)       : a new element is inserted
+ *   - on_erase(iterator)        : an element is erased or evicted
+ */
+template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_lru_policy {
+ public:
+  inline void set_capacity(size_t) noexcept {}
+  inline void on_hit(TIterator) noexcept {}
+  inline void on_miss(const TKEY &) noexcept {}
+  inline void prepare_insert(const TKEY &) noexcept {}
+  // The first element of visit history is the least recently used one
+  inline TIterator select_victim(TIterator first, const TKEY *) noexcept { return first; }
+  inline void on_insert(TIterator) noexcept {}
+  inline void on_erase(TIterator) noexcept {}
+  inline void clear() noexcept {}
+  inline void swap(lru_map_lru_policy &) noexcept {}
+};
+
+template <class TKEY, class TIterator>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_policy_entry {
+  lru_map_policy_entry *prev;
+  lru_map_policy_entry *next;
+  const TKEY *key;
+  // Ghost entries only keep the key, iter is not valid
+  TIterator iter;
+  int32_t segment;
+};
+
+/**
+ * @brief Intrusive list of policy entries, the front is the least recently used one
+ */
+template <class TEntry>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_policy_segment {
+ public:
+  lru_map_policy_segment() noexcept : head_(nullptr), tail_(nullptr), size_(0) {}
+
+  inline TEntry *front() const noexcept { return head_; }
+  inline size_t size() const noexcept { return size_; }
+  inline bool empty() const noexcept { return 0 == size_; }
+
+  inline void push_back(TEntry *entry) noexcept {
+    entry->prev = tail_;
+    entry->next = nullptr;
+    if (nullptr != tail_) {
+      tail_->next = entry;
+    } else {
+      head_ = entry;
+    }
+    tail_ = entry;
+    ++size_;
+  }
+
+  inline void remove(TEntry *entry) noexcept {
+    if (nullptr != entry->prev) {
+      entry->prev->next = entry->next;
+    } else {
+      head_ = entry->next;
+    }
+    if (nullptr != entry->next) {
+      entry->next->prev = entry->prev;
+    } else {
+      tail_ = entry->prev;
+    }
+    entry->prev = nullptr;
+    entry->next = nullptr;
+    --size_;
+  }
+
+  inline void reset() noexcept {
+    head_ = nullptr;
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
+ private:
+  TEntry *head_;
+  TEntry *tail_;
+  size_t size_;
+};
+
+/**
+ * @brief Base of policies with several segments, entries are stored in nodes of an unordered_map and linked into
+ *        segments intrusively, so one entry costs one allocation.
+ */
+template <class TKEY, class THasher, class TKeyEQ, class TIterator, int32_t SegmentCount>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_segmented_policy {
+ public:
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(lru_map_segmented_policy)
+
+ protected:
+  using entry_type = lru_map_policy_entry<TKEY, TIterator>;
+  using segment_type = lru_map_policy_segment<entry_type>;
+  using entry_map_type = std::unordered_map<TKEY, entry_type, THasher, TKeyEQ>;
+
+ public:
+  lru_map_segmented_policy() : capacity_(0) {}
+
+  void clear() {
+    entries_.clear();
+    for (int32_t i = 0; i < SegmentCount; ++i) {
+      segments_[i].reset();
+    }
+  }
+
+  void swap(lru_map_segmented_policy &other) noexcept {
+    // Nodes of unordered_map are not moved when swapping, so pointers in segments are still valid
+    entries_.swap(other.entries_);
+    for (int32_t i = 0; i < SegmentCount; ++i) {
+      std::swap(segments_[i], other.segments_[i]);
+    }
+    std::swap(capacity_, other.capacity_);
+  }
+
+ protected:
+  inline entry_type *find_entry(const TKEY &key) {
+    typename entry_map_type::iterator it = entries_.find(key);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  entry_type *add_entry(TIterator iter, int32_t segment) {
+    std::pair<typename entry_map_type::iterator, bool> res = entries_.insert(
+        typename entry_map_type::value_type(iter->first, entry_type{nullptr, nullptr, nullptr, iter, segment}));
+    entry_type *ret = &res.first->second;
+    if (!res.second) {
+      segments_[ret->segment].remove(ret);
+    }
+    ret->key = &res.first->first;
+    ret->iter = iter;
+    ret->segment = segment;
+    segments_[segment].push_back(ret);
+    return ret;
+  }
+
+  inline void remove_entry(entry_type *entry) {
+    segments_[entry->segment].remove(entry);
+    // The key is owned by the node, do not erase by the reference of itself
+    entries_.erase(entries_.find(*entry->key));
+  }
+
+  inline void move_entry(entry_type *entry, int32_t segment) {
+    segments_[entry->segment].remove(entry);
+    entry->segment = segment;
+    segments_[segment].push_back(entry);
+  }
+
+  // Keep the key of an evicted element to detect re-reference
+  inline TIterator make_ghost(entry_type *entry, int32_t segment) {
+    TIterator ret = entry->iter;
+    entry->iter = TIterator();
+    move_entry(entry, segment);
+    return ret;
+  }
+
+  inline TIterator evict_entry(entry_type *entry) {
+    TIterator ret = entry->iter;
+    remove_entry(entry);
+    return ret;
+  }
+
+ protected:
+  size_t capacity_;
+  entry_map_type entries_;
+  segment_type segments_[SegmentCount];
+};
+
+/**
+ * @brief 2Q, new elements are put into A1in(FIFO), evicted elements of A1in are remembered by A1out, and elements
+ *        re-referenced by A1out are put into Am(LRU). Elements only visited once by a scan never enter Am.
+ * @see Johnson T, Shasha D. 2Q: A Low Overhead High Performance Buffer Management Replacement Algorithm. VLDB 1994.
+ */
+template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_2q_policy
+    : public lru_map_segmented_policy<TKEY, THasher, TKeyEQ, TIterator, 3> {
+ public:
+  using base_type = lru_map_segmented_policy<TKEY, THasher, TKeyEQ, TIterator, 3>;
+  using entry_type = typename base_type::entry_type;
+
+  enum segment_t : int32_t {
+    kA1in = 0,
+    kAm = 1,
+    kA1out = 2,
+  };
+
+  lru_map_2q_policy() : kin_(0), kout_(0), pending_hot_(false) {}
+
+  void set_capacity(size_t capacity) {
+    this->capacity_ = capacity;
+    // Recommended by the paper, Kin is 25% of the capacity and Kout is 50%
+    kin_ = capacity / 4 > 0 ? capacity / 4 : 1;
+    kout_ = capacity / 2 > 0 ? capacity / 2 : 1;
+    trim_ghosts();
+  }
+
+  void on_hit(TIterator iter) {
+    entry_type *entry = this->find_entry(iter->first);
+    if (nullptr != entry && kAm == entry->segment) {
+      this->move_entry(entry, kAm);
+    }
+  }
+
+  inline void on_miss(const TKEY &) noexcept {}
+
+  void prepare_insert(const TKEY &key) {
+    entry_type *entry = this->find_entry(key);
+    pending_hot_ = nullptr != entry && kA1out == entry->segment;
+    if (pending_hot_) {
+      this->remove_entry(entry);
+    }
+  }
+
+  TIterator select_victim(TIterator first, const TKEY *) {
+    if (!this->segments_[kA1in].empty() &&
+        (this->segments_[kA1in].size() > kin_ || this->segments_[kAm].empty())) {
+      TIterator ret = this->make_ghost(this->segments_[kA1in].front(), kA1out);
+      trim_ghosts();
+      return ret;
+    }
+
+    if (!this->segments_[kAm].empty()) {
+      return this->evict_entry(this->segments_[kAm].front());
+    }
+    return first;
+  }
+
+  void on_insert(TIterator iter) {
+    this->add_entry(iter, pending_hot_ ? kAm : kA1in);
+    pending_hot_ = false;
+  }
+
+  void on_erase(TIterator iter) {
+    entry_type *entry = this->find_entry(iter->first);
+    if (nullptr != entry && kA1out != entry->segment) {
+      this->remove_entry(entry);
+    }
+  }
+
+  void swap(lru_map_2q_policy &other) noexcept {
+    base_type::swap(other);
+    std::swap(kin_, other.kin_);
+    std::swap(kout_, other.kout_);
+    std::swap(pending_hot_, other.pending_hot_);
+  }
+
+ private:
+  void trim_ghosts() {
+    while (this->segments_[kA1out].size() > kout_) {
+      this->remove_entry(this->segments_[kA1out].front());
+    }
+  }
+
+ private:
+  size_t kin_;
+  size_t kout_;
+  bool pending_hot_;
+};
+
+/**
+ * @brief ARC, T1 keeps elements seen once and T2 keeps elements seen at least twice. The ghost lists B1 and B2
+ *        remember keys evicted from T1 and T2, hits on them adapt the target size of T1.
+ * @see Megiddo N, Modha D S. ARC: A Self-Tuning, Low Overhead Replacement Cache. FAST 2003.
+ */
+template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_arc_policy
+    : public lru_map_segmented_policy<TKEY, THasher, TKeyEQ, TIterator, 4> {
+ public:
+  using base_type = lru_map_segmented_policy<TKEY, THasher, TKeyEQ, TIterator, 4>;
+  using entry_type = typename base_type::entry_type;
+
+  enum segment_t : int32_t {
+    kT1 = 0,
+    kT2 = 1,
+    kB1 = 2,
+    kB2 = 3,
+  };
+
+  lru_map_arc_policy() : target_t1_(0), pending_segment_(kT1), pending_from_b2_(false), evict_t1_directly_(false) {}
+
+  void set_capacity(size_t capacity) {
+    this->capacity_ = capacity;
+    if (target_t1_ > capacity) {
+      target_t1_ = capacity;
+    }
+    trim_ghosts();
+  }
+
+  void on_hit(TIterator iter) {
+    entry_type *entry = this->find_entry(iter->first);
+    if (nullptr != entry && (kT1 == entry->segment || kT2 == entry->segment)) {
+      this->move_entry(entry, kT2);
+    }
+  }
+
+  inline void on_miss(const TKEY &) noexcept {}
+
+  void prepare_insert(const TKEY &key) {
+    pending_segment_ = kT1;
+    pending_from_b2_ = false;
+    evict_t1_directly_ = false;
+    if (0 == this->capacity_) {
+      return;
+    }
+
+    size_t b1 = this->segments_[kB1].size();
+    size_t b2 = this->segments_[kB2].size();
+    entry_type *entry = this->find_entry(key);
+    if (nullptr != entry && kB1 == entry->segment) {
+      size_t delta = b2 > b1 ? b2 / b1 : 1;
+      target_t1_ = target_t1_ + delta < this->capacity_ ? target_t1_ + delta : this->capacity_;
+      this->remove_entry(entry);
+      pending_segment_ = kT2;
+      return;
+    }
+
+    if (nullptr != entry && kB2 == entry->segment) {
+      size_t delta = b1 > b2 ? b1 / b2 : 1;
+      target_t1_ = target_t1_ > delta ? target_t1_ - delta : 0;
+      this->remove_entry(entry);
+      pending_segment_ = kT2;
+      pending_from_b2_ = true;
+      return;
+    }
+
+    size_t t1 = this->segments_[kT1].size();
+    size_t t2 = this->segments_[kT2].size();
+    if (t1 + b1 >= this->capacity_) {
+      if (t1 < this->capacity_) {
+        if (b1 > 0) {
+          this->remove_entry(this->segments_[kB1].front());
+        }
+      } else {
+        evict_t1_directly_ = true;
+      }
+    } else if (t1 + t2 + b1 + b2 >= 2 * this->capacity_ && b2 > 0) {
+      this->remove_entry(this->segments_[kB2].front());
+    }
+  }
+
+  TIterator select_victim(TIterator first, const TKEY *) {
+    size_t t1 = this->segments_[kT1].size();
+    if (t1 > 0 && (evict_t1_directly_ || this->segments_[kT2].empty() || t1 > target_t1_ ||
+                   (pending_from_b2_ && t1 == target_t1_))) {
+      if (evict_t1_directly_) {
+        evict_t1_directly_ = false;
+        return this->evict_entry(this->segments_[kT1].front());
+      }
+      TIterator ret = this->make_ghost(this->segments_[kT1].front(), kB1);
+      trim_ghosts();
+      return ret;
+    }
+
+    if (!this->segments_[kT2].empty()) {
+      TIterator ret = this->make_ghost(this->segments_[kT2].front(), kB2);
+      trim_ghosts();
+      return ret;
+    }
+    return first;
+  }
+
+  void on_insert(TIterator iter) {
+    this->add_entry(iter, pending_segment_);
+    pending_segment_ = kT1;
+    pending_from_b2_ = false;
+  }
+
+  void on_erase(TIterator iter) {
+    entry_type *entry = this->find_entry(iter->first);
+    if (nullptr != entry && (kT1 == entry->segment || kT2 == entry->segment)) {
+      this->remove_entry(entry);
+    }
+  }
+
+  void swap(lru_map_arc_policy &other) noexcept {
+    base_type::swap(other);
+    std::swap(target_t1_, other.target_t1_);
+    std::swap(pending_segment_, other.pending_segment_);
+    std::swap(pending_from_b2_, other.pending_from_b2_);
+    std::swap(evict_t1_directly_, other.evict_t1_directly_);
+  }
+
+ private:
+  // Ghost lists never hold more keys than the capacity
+  void trim_ghosts() {
+    while (this->segments_[kB1].size() + this->segments_[kB2].size() > this->capacity_) {
+      if (this->segments_[kB1].size() >= this->segments_[kB2].size()) {
+        this->remove_entry(this->segments_[kB1].front());
+      } else {
+        this->remove_entry(this->segments_[kB2].front());
+      }
+    }
+  }
+
+ private:
+  size_t target_t1_;
+  int32_t pending_segment_;
+  bool pending_from_b2_;
+  bool evict_t1_directly_;
+};
+
+/**
+ * @brief Count-min sketch with 4 rows of 4-bit counters, all counters are halved after sampling 10 times of the
+ *        capacity, so the frequency of old visits decays.
+ */
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_frequency_sketch {
+ public:
+  lru_map_frequency_sketch() noexcept : width_mask_(0), words_per_row_(0), sample_size_(0), additions_(0) {}
+
+  void resize(size_t capacity) {
+    // 4 counters per element in every row, it costs 8 bytes per element
+    size_t width = 64;
+    while (width < capacity * 4 && width < (static_cast<size_t>(1) << 30)) {
+      width <<= 1;
+    }
+
+    width_mask_ = width - 1;
+    words_per_row_ = width / kCountersPerWord;
+    sample_size_ = capacity > 0 ? capacity * 10 : width * 10;
+    additions_ = 0;
+    table_.assign(words_per_row_ * kRowCount, 0);
+  }
+
+  void increment(size_t hash) {
+    if (table_.empty()) {
+      return;
+    }
+
+    bool added = false;
+    for (size_t row = 0; row < kRowCount; ++row) {
+      size_t index = index_of(hash, row);
+      uint64_t &word = table_[row * words_per_row_ + index / kCountersPerWord];
+      size_t offset = (index % kCountersPerWord) * 4;
+      if (((word >> offset) & 0xF) < 0xF) {
+        word += static_cast<uint64_t>(1) << offset;
+        added = true;
+      }
+    }
+
+    if (added && ++additions_ >= sample_size_) {
+      reset();
+    }
+  }
+
+  uint32_t frequency(size_t hash) const {
+    if (table_.empty()) {
+      return 0;
+    }
+
+    uint32_t ret = 0xF;
+    for (size_t row = 0; row < kRowCount; ++row) {
+      size_t index = index_of(hash, row);
+      uint64_t word = table_[row * words_per_row_ + index / kCountersPerWord];
+      uint32_t count = static_cast<uint32_t>((word >> ((index % kCountersPerWord) * 4)) & 0xF);
+      if (count < ret) {
+        ret = count;
+      }
+    }
+    return ret;
+  }
+
+  void clear() {
+    for (auto &word : table_) {
+      word = 0;
+    }
+    additions_ = 0;
+  }
+
+  void swap(lru_map_frequency_sketch &other) noexcept {
+    table_.swap(other.table_);
+    std::swap(width_mask_, other.width_mask_);
+    std::swap(words_per_row_, other.words_per_row_);
+    std::swap(sample_size_, other.sample_size_);
+    std::swap(additions_, other.additions_);
+  }
+
+ private:
+  static UTIL_CONFIG_CONSTEXPR const size_t kRowCount = 4;
+  static UTIL_CONFIG_CONSTEXPR const size_t kCountersPerWord = 16;
+
+  inline size_t index_of(size_t hash, size_t row) const noexcept {
+    static const uint64_t seeds[kRowCount] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+                                              0xcbf29ce484222325ULL};
+    uint64_t ret = (static_cast<uint64_t>(hash) + seeds[row]) * 0x9E3779B97F4A7C15ULL;
+    ret ^= ret >> 32;
+    return static_cast<size_t>(ret) & width_mask_;
+  }
+
+  void reset() {
+    // Halve all counters
+    for (auto &word : table_) {
+      word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    additions_ /= 2;
+  }
+
+ private:
+  std::vector<uint64_t> table_;
+  size_t width_mask_;
+  size_t words_per_row_;
+  size_t sample_size_;
+  size_t additions_;
+};
+
+/**
+ * @brief W-TinyLFU, new elements are put into a small LRU window(1% of the capacity), elements evicted from the
+ *        window must be more frequent than the victim of the main SLRU(probation 20%, protected 80%) to be admitted.
+ *        Frequencies are estimated by a count-min sketch.
+ * @see Einziger G, Friedman R, Manes B. TinyLFU: A Highly Efficient Cache Admission Policy. ACM TOS 2017.
+ */
+template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_w_tinylfu_policy
+    : public lru_map_segmented_policy<TKEY, THasher, TKeyEQ, TIterator, 3> {
+ public:
+  using base_type = lru_map_segmented_policy<TKEY, THasher, TKeyEQ, TIterator, 3>;
+  using entry_type = typename base_type::entry_type;
+
+  enum segment_t : int32_t {
+    kWindow = 0,
+    kProbation = 1,
+    kProtected = 2,
+  };
+
+  lru_map_w_tinylfu_policy() : window_capacity_(0), protected_capacity_(0) {}
+
+  void set_capacity(size_t capacity) {
+    this->capacity_ = capacity;
+    if (0 == capacity) {
+      window_capacity_ = 0;
+      protected_capacity_ = 0;
+      sketch_.resize(0);
+      return;
+    }
+
+    window_capacity_ = capacity / 100 > 0 ? capacity / 100 : 1;
+    protected_capacity_ = (capacity - window_capacity_) * 4 / 5;
+    sketch_.resize(capacity);
+    while (this->segments_[kWindow].size() > window_capacity_) {
+      this->move_entry(this->segments_[kWindow].front(), kProbation);
+    }
+    demote_protected();
+  }
+
+  void on_hit(TIterator iter) {
+    sketch_.increment(hash_of(iter->first));
+    entry_type *entry = this->find_entry(iter->first);
+    if (nullptr == entry) {
+      return;
+    }
+
+    if (kProbation == entry->segment) {
+      this->move_entry(entry, kProtected);
+      demote_protected();
+    } else {
+      this->move_entry(entry, entry->segment);
+    }
+  }
+
+  inline void on_miss(const TKEY &key) { sketch_.increment(hash_of(key)); }
+
+  inline void prepare_insert(const TKEY &key) { sketch_.increment(hash_of(key)); }
+
+  TIterator select_victim(TIterator first, const TKEY *) {
+    entry_type *main_victim = main_front();
+    entry_type *candidate = this->segments_[kWindow].front();
+    if (nullptr != candidate && this->segments_[kWindow].size() >= window_capacity_) {
+      // The candidate evicted from window competes with the victim of main space
+      if (nullptr == main_victim) {
+        return this->evict_entry(candidate);
+      }
+
+      if (sketch_.frequency(hash_of(*candidate->key)) > sketch_.frequency(hash_of(*main_victim->key))) {
+        this->move_entry(candidate, kProbation);
+        return this->evict_entry(main_victim);
+      }
+      return this->evict_entry(candidate);
+    }
+
+    if (nullptr != main_victim) {
+      return this->evict_entry(main_victim);
+    }
+    if (nullptr != candidate) {
+      return this->evict_entry(candidate);
+    }
+    return first;
+  }
+
+  void on_insert(TIterator iter) {
+    this->add_entry(iter, kWindow);
+    // Not full, move the candidate into main space directly
+    if (this->capacity_ > 0 && this->segments_[kWindow].size() > window_capacity_) {
+      this->move_entry(this->segments_[kWindow].front(), kProbation);
+    }
+  }
+
+  void on_erase(TIterator iter) {
+    entry_type *entry = this->find_entry(iter->first);
+    if (nullptr != entry) {
+      this->remove_entry(entry);
+    }
+  }
+
+  void clear() {
+    base_type::clear();
+    sketch_.clear();
+  }
+
+  void swap(lru_map_w_tinylfu_policy &other) noexcept {
+    base_type::swap(other);
+    std::swap(hasher_, other.hasher_);
+    sketch_.swap(other.sketch_);
+    std::swap(window_capacity_, other.window_capacity_);
+    std::swap(protected_capacity_, other.protected_capacity_);
+  }
+
+ private:
+  inline size_t hash_of(const TKEY &key) const { return static_cast<size_t>(hasher_(key)); }
+
+  inline entry_type *main_front() const noexcept {
+    if (!this->segments_[kProbation].empty()) {
+      return this->segments_[kProbation].front();
+    }
+    return this->segments_[kProtected].front();
+  }
+
+  void demote_protected() {
+    while (this->segments_[kProtected].size() > protected_capacity_) {
+      this->move_entry(this->segments_[kProtected].front(), kProbation);
+    }
+  }
+
+ private:
+  THasher hasher_;
+  lru_map_frequency_sketch sketch_;
+  size_t window_capacity_;
+  size_t protected_capacity_;
+};
+
+template <class TOption, class = void>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_option_policy;
+
+}  // namespace details
+
+/**
+ * @brief Evict the least recently used element, it's the default policy
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_policy_lru {
+  template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+  using policy_type = details::lru_map_lru_policy<TKEY, THasher, TKeyEQ, TIterator>;
+};
+
+/**
+ * @brief 2Q policy, scan resistant and cheap
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_policy_2q {
+  template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+  using policy_type = details::lru_map_2q_policy<TKEY, THasher, TKeyEQ, TIterator>;
+};
+
+/**
+ * @brief ARC policy, balances recency and frequency adaptively
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_policy_arc {
+  template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+  using policy_type = details::lru_map_arc_policy<TKEY, THasher, TKeyEQ, TIterator>;
+};
+
+/**
+ * @brief W-TinyLFU policy, admission by estimated frequency
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_policy_w_tinylfu {
+  template <class TKEY, class THasher, class TKeyEQ, class TIterator>
+  using policy_type = details::lru_map_w_tinylfu_policy<TKEY, THasher, TKeyEQ, TIterator>;
+};
+
+namespace details {
+// Options without eviction_policy use LRU
+template <class TOption, class>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_map_option_policy {
+  using type = lru_map_policy_lru;
+};
+
+template <class TOption>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY
+    lru_map_option_policy<TOption, nostd::void_t<typename TOption::eviction_policy>> {
+  using type = typename TOption::eviction_policy;
+};
+}  // namespace details
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
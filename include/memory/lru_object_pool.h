@@ -20,6 +20,9 @@
 //
 //     2019-09-30: 优化内部实现
 //                 尽快清理无效的检查列表
+//
+//     2026-10-16: 缓存列表改为环形缓冲区，检查列表改为复用节点的侵入式链表，稳定状态下push和pull不再分配内存
+//                 空的缓存列表延迟清理
 
 #pragma once
 
@@ -32,9 +35,9 @@
 #include <cstddef>
 #include <ctime>
 #include <limits>
-#include <list>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 // 开启这个宏在包含此文件会开启对象重复push进同一个池的检测，同时也会导致push、pull和gc的复杂度由O(1)变为O(log(n))
 #ifdef UTIL_MEMPOOL_LRUOBJECTPOOL_CHECK_REPUSH
@@ -74,9 +77,13 @@ class lru_pool_manager {
   struct check_item_t {
     time_t push_tick;
     weak_rc_ptr<lru_pool_base::list_type_base> list_;
+    // 检查列表是按下标链接的双向链表，删除的节点放入空闲链表复用
+    size_t prev;
+    size_t next;
   };
 
-  using check_list_t = std::list<check_item_t>;
+  using check_list_t = std::vector<check_item_t>;
+  using check_handle_t = size_t;
 
  public:
   static ATFRAMEWORK_UTILS_API ptr_t create();
@@ -124,15 +131,13 @@ class lru_pool_manager {
 
   /**
    * @brief 添加检查列表
+   * @return 检查列表节点的句柄，节点删除前一直有效
    */
-  ATFRAMEWORK_UTILS_API check_list_t::iterator push_check_list(weak_rc_ptr<lru_pool_base::list_type_base> list_);
-
-  ATFRAMEWORK_UTILS_API bool erase_check_list(check_list_t::iterator iter);
+  ATFRAMEWORK_UTILS_API check_handle_t push_check_list(const weak_rc_ptr<lru_pool_base::list_type_base> &list_);
 
-  // GCC 4.4 don't support erase(const_iterator)
-  // ATFRAMEWORK_UTILS_API bool erase_check_list(check_list_t::const_iterator iter);
+  ATFRAMEWORK_UTILS_API bool erase_check_list(check_handle_t handle);
 
-  ATFRAMEWORK_UTILS_API check_list_t::iterator end_check_list();
+  ATFRAMEWORK_UTILS_API check_handle_t end_check_list() const;
 
  private:
   ATFRAMEWORK_UTILS_API lru_pool_manager();
@@ -144,6 +149,8 @@ class lru_pool_manager {
 
   ATFRAMEWORK_UTILS_API bool check_tick(time_t tp);
 
+  ATFRAMEWORK_UTILS_API check_handle_t allocate_check_item();
+
  private:
   size_t item_min_bound_;
   size_t item_max_bound_;
@@ -151,6 +158,9 @@ class lru_pool_manager {
   size_t proc_item_count_;
   size_t gc_item_;
   check_list_t checked_list_;
+  check_handle_t checked_head_;
+  check_handle_t checked_tail_;
+  check_handle_t checked_free_;
 
   // 自适应下限
   size_t item_adjust_min_;
@@ -183,24 +193,32 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
    public:
     struct wrapper {
       value_type *object;
-      typename lru_pool_manager::check_list_t::iterator refer_iterator;
+      lru_pool_manager::check_handle_t refer_handle;
     };
 
-    list_type(lru_pool<TKey, TObj, TAction> &owner, key_t id) : owner_(&owner), id_(id) {}
+    list_type(lru_pool<TKey, TObj, TAction> &owner, key_t id)
+        : owner_(&owner), id_(id), cache_head_(0), cache_size_(0) {
+      ++owner_->empty_list_count_;
+    }
     virtual ~list_type() { clear_manager(); }
 
-    virtual size_t size() const { return cache_.size(); }
+    virtual size_t size() const { return cache_size_; }
 
     virtual bool gc() {
-      if (cache_.empty()) {
+      if (0 == cache_size_) {
         return false;
       }
 
-      wrapper obj = cache_.back();
-      cache_.pop_back();
+      // gc, the oldest one
+      wrapper obj = cache_[cache_head_];
+      cache_head_ = (cache_head_ + 1) & (cache_.size() - 1);
+      --cache_size_;
+      if (0 == cache_size_ && owner_) {
+        ++owner_->empty_list_count_;
+      }
 
       if (owner_ && owner_->mgr_) {
-        owner_->mgr_->erase_check_list(obj.refer_iterator);
+        owner_->mgr_->erase_check_list(obj.refer_handle);
       }
 
 #ifdef UTIL_MEMPOOL_LRUOBJECTPOOL_CHECK_REPUSH
@@ -215,17 +233,18 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
       return true;
     }
 
-    virtual bool empty() const { return cache_.empty(); }
+    virtual bool empty() const { return 0 == cache_size_; }
 
     void clear_manager() {
       if (!owner_->mgr_) {
         return;
       }
 
-      typename lru_pool_manager::check_list_t::iterator end_iter = owner_->mgr_->end_check_list();
-      for (typename std::list<wrapper>::iterator iter = cache_.begin(); iter != cache_.end(); ++iter) {
-        if (owner_->mgr_->erase_check_list((*iter).refer_iterator)) {
-          (*iter).refer_iterator = end_iter;
+      lru_pool_manager::check_handle_t end_handle = owner_->mgr_->end_check_list();
+      for (size_t i = 0; i < cache_size_; ++i) {
+        wrapper &obj = cache_at(i);
+        if (owner_->mgr_->erase_check_list(obj.refer_handle)) {
+          obj.refer_handle = end_handle;
         }
       }
     }
@@ -235,33 +254,28 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
         return;
       }
 
-      for (typename std::list<wrapper>::iterator iter = cache_.begin(); iter != cache_.end(); ++iter) {
-#if defined(ATFRAMEWORK_UTILS_ENABLE_RTTI) && ATFRAMEWORK_UTILS_ENABLE_RTTI
-        (*iter).refer_iterator = owner_->mgr_->push_check_list(
-            ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::dynamic_pointer_cast<lru_pool_base::list_type_base>(self));
-#else
-        (*iter).refer_iterator = owner_->mgr_->push_check_list(
-            ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::static_pointer_cast<lru_pool_base::list_type_base>(self));
-#endif
+      weak_rc_ptr<lru_pool_base::list_type_base> self_base = to_base(self);
+      for (size_t i = 0; i < cache_size_; ++i) {
+        cache_at(i).refer_handle = owner_->mgr_->push_check_list(self_base);
       }
     }
 
     bool push(value_type *obj, list_ptr_type &self) {
       // push, FILO
-      typename std::list<wrapper>::iterator iter = cache_.insert(cache_.begin(), wrapper());
-      if (iter == cache_.end()) {
-        return false;
+      if (cache_size_ >= cache_.size()) {
+        expand_cache();
+      }
+
+      wrapper &res = cache_at(cache_size_);
+      res.object = obj;
+      res.refer_handle = (std::numeric_limits<lru_pool_manager::check_handle_t>::max)();
+      if (0 == cache_size_) {
+        --owner_->empty_list_count_;
       }
+      ++cache_size_;
 
-      (*iter).object = obj;
       if (owner_->mgr_) {
-#if defined(ATFRAMEWORK_UTILS_ENABLE_RTTI) && ATFRAMEWORK_UTILS_ENABLE_RTTI
-        (*iter).refer_iterator = owner_->mgr_->push_check_list(
-            ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::dynamic_pointer_cast<lru_pool_base::list_type_base>(self));
-#else
-        (*iter).refer_iterator = owner_->mgr_->push_check_list(
-            ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::static_pointer_cast<lru_pool_base::list_type_base>(self));
-#endif
+        res.refer_handle = owner_->mgr_->push_check_list(to_base(self));
       }
 
       return true;
@@ -269,24 +283,52 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
 
     value_type *pull() {
       // pull, FILO
-      if (cache_.empty()) {
+      if (0 == cache_size_) {
         return nullptr;
       }
 
-      wrapper res = cache_.front();
-      cache_.pop_front();
+      wrapper res = cache_at(cache_size_ - 1);
+      --cache_size_;
+      if (0 == cache_size_) {
+        ++owner_->empty_list_count_;
+      }
 
       if (owner_->mgr_) {
-        owner_->mgr_->erase_check_list(res.refer_iterator);
+        owner_->mgr_->erase_check_list(res.refer_handle);
       }
 
       return res.object;
     }
 
+   private:
+    static weak_rc_ptr<lru_pool_base::list_type_base> to_base(list_ptr_type &self) {
+#if defined(ATFRAMEWORK_UTILS_ENABLE_RTTI) && ATFRAMEWORK_UTILS_ENABLE_RTTI
+      return ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::dynamic_pointer_cast<lru_pool_base::list_type_base>(self);
+#else
+      return ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::static_pointer_cast<lru_pool_base::list_type_base>(self);
+#endif
+    }
+
+    // Size of cache_ is always power of 2
+    inline wrapper &cache_at(size_t index) { return cache_[(cache_head_ + index) & (cache_.size() - 1)]; }
+
+    void expand_cache() {
+      std::vector<wrapper> new_cache;
+      new_cache.resize(cache_.empty() ? 4 : cache_.size() * 2);
+      for (size_t i = 0; i < cache_size_; ++i) {
+        new_cache[i] = cache_at(i);
+      }
+      cache_.swap(new_cache);
+      cache_head_ = 0;
+    }
+
    private:
     lru_pool<TKey, TObj, TAction> *owner_;
     key_t id_;
-    std::list<wrapper> cache_;
+    // 环形缓冲区，cache_head_ 是最早push的对象，cache_head_ + cache_size_ - 1 是最后push的对象
+    std::vector<wrapper> cache_;
+    size_t cache_head_;
+    size_t cache_size_;
   };
 
   struct flag_t {
@@ -315,7 +357,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
   };
 
  public:
-  lru_pool() : flags_(0) {}
+  lru_pool() : flags_(0), empty_list_count_(0) {}
 
   virtual ~lru_pool() {
     set_manager(lru_pool_manager::ptr_t());
@@ -370,7 +412,16 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
       return false;
     }
 
-    list_ptr_type &list_ = data_[id];
+    typename cat_map_type::iterator iter = data_.find(id);
+    if (iter == data_.end()) {
+      // 只在添加新的列表时清理空列表，使空列表的数量和非空列表数量同级
+      if (empty_list_count_ > 16 && empty_list_count_ * 2 > data_.size()) {
+        remove_empty_lists();
+      }
+      iter = data_.insert(typename cat_map_type::value_type(id, list_ptr_type())).first;
+    }
+
+    list_ptr_type &list_ = iter->second;
     if (!list_) {
       list_ = make_strong_rc<list_type>(*this, id);
       if (!list_) {
@@ -398,17 +449,13 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
       return nullptr;
     }
 
-    if (!iter->second || iter->second->empty()) {
+    if (!iter->second) {
       data_.erase(iter);
       return nullptr;
     }
 
+    // 空列表保留到下一次push，避免重复创建列表和缓冲区
     TObj *ret = iter->second->pull();
-
-    if (iter->second->empty()) {
-      data_.erase(iter);
-    }
-
     if (nullptr == ret) {
       return ret;
     }
@@ -439,6 +486,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
     }
 
     data_.clear();
+    empty_list_count_ = 0;
   }
 
   bool empty() const {
@@ -469,10 +517,24 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY lru_pool : public lru_pool_base {
 
   const cat_map_type &data() const { return data_; }
 
+ private:
+  void remove_empty_lists() {
+    for (typename cat_map_type::iterator iter = data_.begin(); iter != data_.end();) {
+      if (!iter->second || iter->second->empty()) {
+        iter = data_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    empty_list_count_ = 0;
+  }
+
  private:
   cat_map_type data_;
   lru_pool_manager::ptr_t mgr_;
   uint32_t flags_;
+  // 没有缓存对象的列表数量
+  size_t empty_list_count_;
 #ifdef UTIL_MEMPOOL_LRUOBJECTPOOL_CHECK_REPUSH
   std::set<value_type *> check_pushed_;
 #endif
@@ -0,0 +1,581 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compiler_features.h>
+#include <memory/lru_map.h>
+#include <memory/rc_ptr.h>
+#include <std/explicit_declare.h>
+
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+/**
+ * @brief LRU map with the same API as lru_map, but key, value and LRU links are stored in one pooled node.
+ * @note Nodes are allocated in chunks and reused by a free list, and the index is an open-addressing table of node
+ *       pointers(linear probing with backward shift deletion). So inserting into a reserved map, erasing and
+ *       find(key, true) never allocate except the value created by insert_key_value(key, copy_value).
+ * @note Iterators and references are only invalidated when the element is erased, rehashing does not move nodes.
+ */
+template <class TKEY, class TVALUE, class THasher = std::hash<TKEY>, class TKeyEQ = std::equal_to<TKEY>,
+          class TOption = lru_map_option<compat_strong_ptr_mode::kStl>,
+          class TAlloc = std::allocator<typename lru_map_type_traits<TKEY, TVALUE, TOption>::value_type>>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY pooled_lru_map {
+ public:
+  using key_type = typename lru_map_type_traits<TKEY, TVALUE, TOption>::key_type;
+  using mapped_type = typename lru_map_type_traits<TKEY, TVALUE, TOption>::mapped_type;
+  using value_type = typename lru_map_type_traits<TKEY, TVALUE, TOption>::value_type;
+  using size_type = typename lru_map_type_traits<TKEY, TVALUE, TOption>::size_type;
+  using store_type = typename lru_map_type_traits<TKEY, TVALUE, TOption>::store_type;
+  using option_type = typename lru_map_type_traits<TKEY, TVALUE, TOption>::option_type;
+  using hasher = THasher;
+  using key_equal = TKeyEQ;
+  using allocator_type = TAlloc;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using pointer = value_type *;
+  using const_pointer = const value_type *;
+  using self_type = pooled_lru_map<TKEY, TVALUE, THasher, TKeyEQ, TOption, TAlloc>;
+
+ private:
+  struct node_type {
+    node_type *prev;
+    node_type *next;
+    size_t hash;
+    alignas(value_type) unsigned char storage[sizeof(value_type)];
+
+    inline value_type *get() noexcept { return reinterpret_cast<value_type *>(&storage[0]); }
+    inline const value_type *get() const noexcept { return reinterpret_cast<const value_type *>(&storage[0]); }
+  };
+
+  struct chunk_type {
+    node_type *nodes;
+    size_type count;
+  };
+
+  using node_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_type>;
+  using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+  using bucket_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_type *>;
+  using chunk_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<chunk_type>;
+  using bucket_list_type = std::vector<node_type *, bucket_allocator_type>;
+  using chunk_list_type = std::vector<chunk_type, chunk_allocator_type>;
+
+  static UTIL_CONFIG_CONSTEXPR const size_type kMinChunkNodes = 16;
+  static UTIL_CONFIG_CONSTEXPR const size_type kMaxChunkNodes = 65536;
+  static UTIL_CONFIG_CONSTEXPR const size_t kMinBucketBits = 4;
+  static UTIL_CONFIG_CONSTEXPR const size_type kMinBucketCount = static_cast<size_type>(1) << kMinBucketBits;
+
+  template <class TNODE, class TREF>
+  class ATFRAMEWORK_UTILS_API_HEAD_ONLY iterator_base {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename std::remove_const<TREF>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = TREF *;
+    using reference = TREF &;
+
+    iterator_base() noexcept : node_(nullptr) {}
+    explicit iterator_base(TNODE *node) noexcept : node_(node) {}
+
+    // iterator -> const_iterator
+    template <class TONODE, class TOREF,
+              class = typename std::enable_if<std::is_convertible<TONODE *, TNODE *>::value>::type>
+    iterator_base(const iterator_base<TONODE, TOREF> &other) noexcept : node_(other.node_) {}
+
+    inline reference operator*() const noexcept { return *node_->get(); }
+    inline pointer operator->() const noexcept { return node_->get(); }
+
+    inline iterator_base &operator++() noexcept {
+      node_ = node_->next;
+      return *this;
+    }
+
+    inline iterator_base operator++(int) noexcept {
+      iterator_base ret = *this;
+      node_ = node_->next;
+      return ret;
+    }
+
+    inline iterator_base &operator--() noexcept {
+      node_ = node_->prev;
+      return *this;
+    }
+
+    inline iterator_base operator--(int) noexcept {
+      iterator_base ret = *this;
+      node_ = node_->prev;
+      return ret;
+    }
+
+    template <class TONODE, class TOREF>
+    inline bool operator==(const iterator_base<TONODE, TOREF> &other) const noexcept {
+      return node_ == other.node_;
+    }
+
+    template <class TONODE, class TOREF>
+    inline bool operator!=(const iterator_base<TONODE, TOREF> &other) const noexcept {
+      return node_ != other.node_;
+    }
+
+   private:
+    template <class, class>
+    friend class iterator_base;
+    friend class pooled_lru_map;
+
+    TNODE *node_;
+  };
+
+ public:
+  using iterator = iterator_base<node_type, value_type>;
+  using const_iterator = iterator_base<const node_type, const value_type>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  pooled_lru_map() noexcept(std::is_nothrow_default_constructible<node_allocator_type>::value &&
+                            std::is_nothrow_default_constructible<hasher>::value &&
+                            std::is_nothrow_default_constructible<key_equal>::value)
+      : free_list_(nullptr), pool_capacity_(0), size_(0), bucket_shift_(0) {
+    reset_history();
+  }
+
+  ~pooled_lru_map() {
+    clear();
+    release_chunks();
+  }
+
+  template <class TCONTAINER>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY pooled_lru_map(const TCONTAINER &other)
+      : free_list_(nullptr), pool_capacity_(0), size_(0), bucket_shift_(0) {
+    reset_history();
+    reserve(static_cast<size_type>(other.size()));
+    insert(other.begin(), other.end());
+  }
+
+  pooled_lru_map(const pooled_lru_map &other)
+      : hasher_(other.hasher_),
+        key_equal_(other.key_equal_),
+        node_allocator_(node_allocator_traits::select_on_container_copy_construction(other.node_allocator_)),
+        free_list_(nullptr),
+        pool_capacity_(0),
+        size_(0),
+        bucket_shift_(0) {
+    reset_history();
+    reserve(other.size());
+    insert(other.cbegin(), other.cend());
+  }
+
+  pooled_lru_map(pooled_lru_map &&other) noexcept
+      : free_list_(nullptr), pool_capacity_(0), size_(0), bucket_shift_(0) {
+    reset_history();
+    swap(other);
+  }
+
+  pooled_lru_map &operator=(const pooled_lru_map &other) {
+    if (this == &other) {
+      return *this;
+    }
+
+    clear();
+    reserve(other.size());
+    insert(other.cbegin(), other.cend());
+    return *this;
+  }
+
+  pooled_lru_map &operator=(pooled_lru_map &&other) noexcept {
+    swap(other);
+    other.clear();
+    return *this;
+  }
+
+  inline iterator begin() noexcept { return iterator(head_.next); }
+  inline const_iterator cbegin() const noexcept { return const_iterator(head_.next); }
+  inline iterator end() noexcept { return iterator(&head_); }
+  inline const_iterator cend() const noexcept { return const_iterator(&head_); }
+
+  inline reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  inline const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+  inline reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  inline const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+  inline value_type &front() noexcept { return *head_.next->get(); }
+  inline const value_type &front() const noexcept { return *head_.next->get(); }
+  inline value_type &back() noexcept { return *head_.prev->get(); }
+  inline const value_type &back() const noexcept { return *head_.prev->get(); }
+
+  void pop_front() {
+    if (empty()) {
+      return;
+    }
+    erase_node(head_.next);
+  }
+
+  void pop_back() {
+    if (empty()) {
+      return;
+    }
+    erase_node(head_.prev);
+  }
+
+  ATFW_EXPLICIT_NODISCARD_ATTR inline bool empty() const noexcept { return 0 == size_; }
+  inline size_type size() const noexcept { return size_; }
+
+  /**
+   * @brief Count of nodes in the pool, inserting does not allocate nodes until size() reaches it
+   */
+  inline size_type capacity() const noexcept { return pool_capacity_; }
+
+  /**
+   * @brief Preallocate nodes and index for s elements
+   */
+  void reserve(size_type s) {
+    if (s > pool_capacity_) {
+      allocate_chunk(s - pool_capacity_);
+    }
+    rehash_for(s);
+  }
+
+  void swap(self_type &other) noexcept {
+    if (this == &other) {
+      return;
+    }
+
+    bool self_empty = empty();
+    bool other_empty = other.empty();
+    std::swap(head_.prev, other.head_.prev);
+    std::swap(head_.next, other.head_.next);
+    if (other_empty) {
+      reset_history();
+    } else {
+      head_.next->prev = &head_;
+      head_.prev->next = &head_;
+    }
+    if (self_empty) {
+      other.reset_history();
+    } else {
+      other.head_.next->prev = &other.head_;
+      other.head_.prev->next = &other.head_;
+    }
+
+    using std::swap;
+    swap(hasher_, other.hasher_);
+    swap(key_equal_, other.key_equal_);
+    swap(node_allocator_, other.node_allocator_);
+    buckets_.swap(other.buckets_);
+    chunks_.swap(other.chunks_);
+    swap(free_list_, other.free_list_);
+    swap(pool_capacity_, other.pool_capacity_);
+    swap(size_, other.size_);
+    swap(bucket_shift_, other.bucket_shift_);
+  }
+
+  /**
+   * @brief Remove all elements, nodes are kept in the pool and the index keeps its size
+   */
+  void clear() {
+    node_type *node = head_.next;
+    while (node != &head_) {
+      node_type *next = node->next;
+      destroy_node(node);
+      node = next;
+    }
+
+    reset_history();
+    size_ = 0;
+    for (auto &bucket : buckets_) {
+      bucket = nullptr;
+    }
+  }
+
+  template <class TPARAMKEY, class TPARAMVALUE>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<iterator, bool> insert_key_value(const TPARAMKEY &key,
+                                                                             const TPARAMVALUE &copy_value) {
+    using alloc_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<mapped_type>;
+    return insert_key_value(
+        key, compat_strong_ptr_function_trait<option_type::ptr_mode>::template allocate_shared<mapped_type>(
+                 alloc_type(), copy_value));
+  }
+
+  template <class TPARAMKEY, class TPARAMVALUE>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<iterator, bool> insert_key_value(
+      const TPARAMKEY &key,
+      const typename compat_strong_ptr_function_trait<option_type::ptr_mode>::template shared_ptr<TPARAMVALUE> &value) {
+    return insert(value_type(key, value));
+  }
+
+  template <class TCKEY, class TCVALUE>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<iterator, bool> insert(const std::pair<TCKEY, TCVALUE> &value) {
+    return insert_key_value(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type &&value) {
+    size_t hash = hash_of(value.first);
+    if (nullptr != find_node(value.first, hash)) {
+      return std::pair<iterator, bool>(end(), false);
+    }
+
+    node_type *node = construct_node(hash, std::move(value));
+    return std::pair<iterator, bool>(iterator(node), true);
+  }
+
+  template <class TPARAMKEY, class TPARAMVALUE>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<iterator, bool> insert_key_value(
+      TPARAMKEY &&key,
+      typename compat_strong_ptr_function_trait<option_type::ptr_mode>::template shared_ptr<TPARAMVALUE> &&value) {
+    return insert(value_type(std::forward<TPARAMKEY>(key), std::move(value)));
+  }
+
+  template <class TPARAMKEY, class TPARAMVALUE>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<iterator, bool> insert_key_value(
+      TPARAMKEY &&key,
+      typename compat_strong_ptr_function_trait<option_type::ptr_mode>::template shared_ptr<TPARAMVALUE> &value) {
+    return insert(value_type(std::forward<TPARAMKEY>(key), value));
+  }
+
+  template <class TPARAMKEY, class TPARAMVALUE>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY std::pair<iterator, bool> insert_key_value(TPARAMKEY &&key,
+                                                                             TPARAMVALUE &&copy_value) {
+    using alloc_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<mapped_type>;
+    return insert(
+        value_type(std::forward<TPARAMKEY>(key),
+                   compat_strong_ptr_function_trait<option_type::ptr_mode>::template allocate_shared<mapped_type>(
+                       alloc_type(), std::forward<TPARAMVALUE>(copy_value))));
+  }
+
+  template <class InputIt>
+  ATFRAMEWORK_UTILS_API_HEAD_ONLY void insert(InputIt first, InputIt last) {
+    while (first != last) {
+      insert(*(first++));
+    }
+  }
+
+  iterator erase(iterator pos) {
+    if (pos == end() || nullptr == pos.node_) {
+      return end();
+    }
+
+    iterator ret(pos.node_->next);
+    erase_node(pos.node_);
+    return ret;
+  }
+
+  iterator erase(iterator first, iterator last) {
+    iterator ret = end();
+    while (first != last) {
+      ret = erase(first++);
+    }
+    return ret;
+  }
+
+  size_type erase(const key_type &key) {
+    node_type *node = find_node(key, hash_of(key));
+    if (nullptr == node) {
+      return 0;
+    }
+
+    erase_node(node);
+    return 1;
+  }
+
+  iterator find(const key_type &key, bool update_visit = true) {
+    node_type *node = find_node(key, hash_of(key));
+    if (nullptr == node) {
+      return end();
+    }
+
+    if (update_visit && node != head_.prev) {
+      unlink_node(node);
+      link_back(node);
+    }
+
+    return iterator(node);
+  }
+
+  mapped_type &operator[](const key_type &key) {
+    using alloc_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<mapped_type>;
+
+    iterator it = find(key);
+    if (it == end()) {
+      std::pair<iterator, bool> res = insert(value_type(
+          key, compat_strong_ptr_function_trait<option_type::ptr_mode>::template allocate_shared<mapped_type>(
+                   alloc_type())));
+      return *(*res.first).second;
+    }
+
+    return *(*it).second;
+  }
+
+ private:
+  // Fibonacci hashing, the high bits are used as the index of buckets, so the identity hash of integers is spread
+  static inline size_t mix_hash(size_t hash) noexcept {
+    return hash * static_cast<size_t>(sizeof(size_t) >= 8 ? 0x9E3779B97F4A7C15ULL : 0x9E3779B9ULL);
+  }
+
+  inline size_t bucket_index(size_t hash) const noexcept { return hash >> bucket_shift_; }
+
+  inline size_t hash_of(const key_type &key) const { return mix_hash(static_cast<size_t>(hasher_(key))); }
+
+  inline void reset_history() noexcept {
+    head_.prev = &head_;
+    head_.next = &head_;
+  }
+
+  inline void link_back(node_type *node) noexcept {
+    node->prev = head_.prev;
+    node->next = &head_;
+    head_.prev->next = node;
+    head_.prev = node;
+  }
+
+  static inline void unlink_node(node_type *node) noexcept {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+  }
+
+  node_type *find_node(const key_type &key, size_t hash) const {
+    if (buckets_.empty()) {
+      return nullptr;
+    }
+
+    size_t mask = buckets_.size() - 1;
+    for (size_t i = bucket_index(hash);; i = (i + 1) & mask) {
+      node_type *node = buckets_[i];
+      if (nullptr == node) {
+        return nullptr;
+      }
+      if (node->hash == hash && key_equal_(node->get()->first, key)) {
+        return node;
+      }
+    }
+  }
+
+  void allocate_chunk(size_type count) {
+    chunks_.reserve(chunks_.size() + 1);
+    node_type *nodes = node_allocator_traits::allocate(node_allocator_, count);
+    chunks_.push_back(chunk_type{nodes, count});
+    pool_capacity_ += count;
+
+    for (size_type i = count; i > 0; --i) {
+      nodes[i - 1].next = free_list_;
+      free_list_ = &nodes[i - 1];
+    }
+  }
+
+  void release_chunks() noexcept {
+    for (auto &chunk : chunks_) {
+      node_allocator_traits::deallocate(node_allocator_, chunk.nodes, chunk.count);
+    }
+    chunks_.clear();
+    free_list_ = nullptr;
+    pool_capacity_ = 0;
+  }
+
+  void rehash_for(size_type s) {
+    // Keep load factor not greater than 0.75
+    size_type bucket_count = kMinBucketCount;
+    size_t bucket_shift = sizeof(size_t) * 8 - kMinBucketBits;
+    while (bucket_count - (bucket_count >> 2) < s) {
+      bucket_count <<= 1;
+      --bucket_shift;
+    }
+    if (bucket_count <= buckets_.size()) {
+      return;
+    }
+
+    bucket_list_type buckets(bucket_count, nullptr, buckets_.get_allocator());
+    size_t mask = bucket_count - 1;
+    for (node_type *node = head_.next; node != &head_; node = node->next) {
+      size_t i = node->hash >> bucket_shift;
+      while (nullptr != buckets[i]) {
+        i = (i + 1) & mask;
+      }
+      buckets[i] = node;
+    }
+    buckets_.swap(buckets);
+    bucket_shift_ = bucket_shift;
+  }
+
+  template <class... TARGS>
+  node_type *construct_node(size_t hash, TARGS &&...args) {
+    rehash_for(size_ + 1);
+    if (nullptr == free_list_) {
+      size_type count = pool_capacity_;
+      if (count < kMinChunkNodes) {
+        count = kMinChunkNodes;
+      } else if (count > kMaxChunkNodes) {
+        count = kMaxChunkNodes;
+      }
+      allocate_chunk(count);
+    }
+
+    // The node is taken from free list after the value is constructed, so nothing leaks if the constructor throws
+    node_type *node = free_list_;
+    ::new (static_cast<void *>(node->get())) value_type(std::forward<TARGS>(args)...);
+    free_list_ = node->next;
+    node->hash = hash;
+    link_back(node);
+
+    size_t mask = buckets_.size() - 1;
+    size_t i = bucket_index(hash);
+    while (nullptr != buckets_[i]) {
+      i = (i + 1) & mask;
+    }
+    buckets_[i] = node;
+    ++size_;
+    return node;
+  }
+
+  void destroy_node(node_type *node) noexcept {
+    node->get()->~value_type();
+    node->next = free_list_;
+    free_list_ = node;
+  }
+
+  void erase_node(node_type *node) {
+    size_t mask = buckets_.size() - 1;
+    size_t hole = bucket_index(node->hash);
+    while (buckets_[hole] != node) {
+      hole = (hole + 1) & mask;
+    }
+
+    // Backward shift deletion, move the following elements which can be placed in the hole
+    for (size_t next = (hole + 1) & mask; nullptr != buckets_[next]; next = (next + 1) & mask) {
+      size_t ideal = bucket_index(buckets_[next]->hash);
+      if (((next - ideal) & mask) >= ((next - hole) & mask)) {
+        buckets_[hole] = buckets_[next];
+        hole = next;
+      }
+    }
+    buckets_[hole] = nullptr;
+
+    unlink_node(node);
+    destroy_node(node);
+    --size_;
+  }
+
+ private:
+  node_type head_;
+  hasher hasher_;
+  key_equal key_equal_;
+  node_allocator_type node_allocator_;
+  bucket_list_type buckets_;
+  chunk_list_type chunks_;
+  node_type *free_list_;
+  size_type pool_capacity_;
+  size_type size_;
+  size_t bucket_shift_;
+};
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
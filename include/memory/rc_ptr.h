@@ -3,10 +3,13 @@
 // Licenses under the MIT License
 // @note This is a smart pointer class that is compatible with std::shared_ptr, but it is more lightweight and do not
 //       use atomic operation for reference counting. It is designed for single thread usage.
+// @note Use atomic_rc_ptr/atomic_weak_rc_ptr (strong_rc_ptr/weak_rc_ptr with rc_ptr_atomic_policy) when the pointers
+//       are shared across threads, and atomic_strong_rc_ptr to publish a pointer to other threads.
 // @note We support all APIs of std::shared_ptr in C++14, and partly APIs of std::shared_ptr in C++17/20/26.
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -29,15 +32,35 @@
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace memory {
 
-template <class T>
+class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_base;
+class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_atomic_base;
+
+/**
+ * @brief Default reference counting policy, counts are not atomic and pointers can only be used in one thread.
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY rc_ptr_single_thread_policy {
+  using counted_data_base = __rc_ptr_counted_data_base;
+};
+
+/**
+ * @brief Reference counting policy with atomic counts, pointers can be copied and destroyed in different threads.
+ */
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY rc_ptr_atomic_policy {
+  using counted_data_base = __rc_ptr_counted_data_atomic_base;
+};
+
+template <class T, class RcPolicy = rc_ptr_single_thread_policy>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY weak_rc_ptr;
 
-template <class T>
+template <class T, class RcPolicy = rc_ptr_single_thread_policy>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr;
 
-template <class T>
+template <class T, class RcPolicy = rc_ptr_single_thread_policy>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY enable_shared_rc_from_this;
 
+template <class T>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY atomic_strong_rc_ptr;
+
 class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_base {
  public:
   UTIL_CONFIG_CONSTEXPR __rc_ptr_counted_data_base() noexcept : use_count_(1), weak_count_(1) {}
@@ -72,6 +95,9 @@ class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_base {
     return true;
   }
 
+  // Increment the use count, the caller must already own a strong reference.
+  UTIL_FORCEINLINE void add_ref_copy() noexcept { ++use_count_; }
+
   // Decrement the use count.
   UTIL_FORCEINLINE void release() noexcept {
     if (--use_count_ == 0) {
@@ -103,12 +129,81 @@ class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_base {
   std::size_t weak_count_;
 };
 
+/**
+ * @brief Counter base class of rc_ptr_atomic_policy.
+ * @note Increments are relaxed, the owner already holds a reference and nothing is published by them. Decrements use
+ *       acq_rel, so all writes to the object happen before it's disposed by the last owner.
+ */
+class ATFW_UTIL_SYMBOL_VISIBLE __rc_ptr_counted_data_atomic_base {
+ public:
+  UTIL_CONFIG_CONSTEXPR __rc_ptr_counted_data_atomic_base() noexcept : use_count_(1), weak_count_(1) {}
+
+  ATFRAMEWORK_UTILS_API virtual ~__rc_ptr_counted_data_atomic_base() noexcept;
+
+  // Called when use_count_ drops to zero, to release the resources
+  // managed by *this.
+  virtual void dispose() noexcept = 0;
+
+  // Called when weak_count_ drops to zero.
+  virtual void destroy() noexcept = 0;
+
+  // Increment the use count if it is non-zero, throw otherwise.
+  UTIL_FORCEINLINE void add_ref() {
+    if (!add_ref_nothrow()) {
+      __rc_ptr_counted_data_base::throw_bad_weak_ptr();
+    }
+  }
+
+  // Increment the use count if it is non-zero.
+  UTIL_FORCEINLINE bool add_ref_nothrow() noexcept {
+    std::size_t count = use_count_.load(std::memory_order_relaxed);
+    while (count != 0) {
+      if (use_count_.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Increment the use count, the caller must already own a strong reference.
+  UTIL_FORCEINLINE void add_ref_copy() noexcept { use_count_.fetch_add(1, std::memory_order_relaxed); }
+
+  // Decrement the use count.
+  UTIL_FORCEINLINE void release() noexcept {
+    if (use_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      dispose();
+      weak_release();
+    }
+  }
+
+  // Increment the weak count.
+  UTIL_FORCEINLINE void weak_add_ref() noexcept { weak_count_.fetch_add(1, std::memory_order_relaxed); }
+
+  // Decrement the weak count.
+  UTIL_FORCEINLINE void weak_release() noexcept {
+    if (weak_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      destroy();
+    }
+  }
+
+  UTIL_FORCEINLINE std::size_t use_count() const noexcept { return use_count_.load(std::memory_order_relaxed); }
+
+ private:
+  __rc_ptr_counted_data_atomic_base(const __rc_ptr_counted_data_atomic_base&) = delete;
+  __rc_ptr_counted_data_atomic_base& operator=(const __rc_ptr_counted_data_atomic_base&) = delete;
+
+ private:
+  std::atomic<std::size_t> use_count_;
+  std::atomic<std::size_t> weak_count_;
+};
+
 /**
  * @brief Template class definition for reference-counted.
  * @note Construct object and counter with default data management and allocator.
  */
-template <class T>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_default final : public __rc_ptr_counted_data_base {
+template <class T, class CountedBase = __rc_ptr_counted_data_base>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_default final : public CountedBase {
  public:
   explicit __rc_ptr_counted_data_default(T* p) noexcept : ptr_(p) {}
 
@@ -124,7 +219,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_default final : publ
   }
 
   void destroy() noexcept override {
-    using alloc_type = ::std::allocator<__rc_ptr_counted_data_default<T>>;
+    using alloc_type = ::std::allocator<__rc_ptr_counted_data_default<T, CountedBase>>;
     alloc_type alloc;
     allocated_ptr<alloc_type> guard_ptr{alloc, this};
     this->~__rc_ptr_counted_data_default();
@@ -139,8 +234,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_default final : publ
  * @note Construct object and counter inplace with default allocator.
  *       This will reduce memory fragmentation and slightly improve performance.
  */
-template <class T>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace final : public __rc_ptr_counted_data_base {
+template <class T, class CountedBase = __rc_ptr_counted_data_base>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace final : public CountedBase {
  public:
   template <class... Args>
   explicit __rc_ptr_counted_data_inplace(Args&&... args) {
@@ -158,7 +253,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace final : publ
   }
 
   void destroy() noexcept override {
-    using alloc_type = ::std::allocator<__rc_ptr_counted_data_inplace<T>>;
+    using alloc_type = ::std::allocator<__rc_ptr_counted_data_inplace<T, CountedBase>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc;
     allocated_ptr<alloc_type> guard_ptr{alloc, this};
@@ -179,8 +274,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace final : publ
  *       This will reduce memory fragmentation and slightly improve performance.
  * @note We use allocator rebind to allocate all data with custom allocator.
  */
-template <class T, class Alloc>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace_alloc final : public __rc_ptr_counted_data_base {
+template <class T, class Alloc, class CountedBase = __rc_ptr_counted_data_base>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace_alloc final : public CountedBase {
  public:
   template <class AllocInput, class... Args>
   explicit __rc_ptr_counted_data_inplace_alloc(AllocInput&& a, Args&&... args) {
@@ -211,8 +306,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace_alloc final
   }
 
   void destroy() noexcept override {
-    using alloc_type_self =
-        typename ::std::allocator_traits<Alloc>::template rebind_alloc<__rc_ptr_counted_data_inplace_alloc<T, Alloc>>;
+    using alloc_type_self = typename ::std::allocator_traits<Alloc>::template rebind_alloc<
+        __rc_ptr_counted_data_inplace_alloc<T, Alloc, CountedBase>>;
     using alloc_traits_self = ::std::allocator_traits<alloc_type_self>;
 
 #if defined(__GNUC__) && !defined(__clang__) && !defined(__apple_build_version__)
@@ -260,8 +355,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_inplace_alloc final
  * @brief Template class definition for reference-counted with deletor.
  * @note Construct object and counter with custom deletor and default allocator.
  */
-template <class T, class Deleter>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_with_deleter final : public __rc_ptr_counted_data_base {
+template <class T, class Deleter, class CountedBase = __rc_ptr_counted_data_base>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_with_deleter final : public CountedBase {
  public:
   template <class DeleterInput>
   inline __rc_ptr_counted_data_with_deleter(T* p, DeleterInput&& d) noexcept
@@ -270,7 +365,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_with_deleter final :
   void dispose() noexcept override { deleter_(ptr_); }
 
   void destroy() noexcept override {
-    using alloc_type = ::std::allocator<__rc_ptr_counted_data_with_deleter<T, Deleter>>;
+    using alloc_type = ::std::allocator<__rc_ptr_counted_data_with_deleter<T, Deleter, CountedBase>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc;
 
@@ -288,9 +383,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_with_deleter final :
  * @brief Template class definition for reference-counted with deletor and allocator.
  * @note Construct object and counter with custom deletor and custom allocator.
  */
-template <class T, class Deleter, class Alloc>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_with_deleter_allocator final
-    : public __rc_ptr_counted_data_base {
+template <class T, class Deleter, class Alloc, class CountedBase = __rc_ptr_counted_data_base>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_with_deleter_allocator final : public CountedBase {
  public:
   template <class DeleterInput, class AllocInput>
   inline __rc_ptr_counted_data_with_deleter_allocator(T* p, DeleterInput&& d, AllocInput&& a) noexcept
@@ -300,7 +394,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __rc_ptr_counted_data_with_deleter_allocat
 
   void destroy() noexcept override {
     using alloc_type = typename ::std::allocator_traits<Alloc>::template rebind_alloc<
-        __rc_ptr_counted_data_with_deleter_allocator<T, Deleter, Alloc>>;
+        __rc_ptr_counted_data_with_deleter_allocator<T, Deleter, Alloc, CountedBase>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc{alloc_};
 
@@ -321,10 +415,10 @@ struct ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_default_alloc_shared_tag {};
 template <class T>
 struct ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_with_alloc_shared_tag {};
 
-template <class T>
+template <class T, class RcPolicy>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY __weak_rc_counter;
 
-template <class T>
+template <class T, class RcPolicy>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
   // Prevent __strong_rc_default_alloc_shared_tag and __strong_rc_with_alloc_shared_tag from matching the shared_ptr(P,
   // D) ctor.
@@ -340,11 +434,13 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
   struct __not_alloc_shared_tag<__strong_rc_with_alloc_shared_tag<Y>> {};
 
  public:
+  using counted_data_base = typename RcPolicy::counted_data_base;
+
   UTIL_CONFIG_CONSTEXPR __strong_rc_counter() noexcept : pi_(nullptr) {}
 
   template <class Y>
   explicit __strong_rc_counter(Y* p) : pi_(nullptr) {
-    using alloc_type = ::std::allocator<__rc_ptr_counted_data_default<Y>>;
+    using alloc_type = ::std::allocator<__rc_ptr_counted_data_default<Y, counted_data_base>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc;
     auto guard = allocate_guarded(alloc);
@@ -372,7 +468,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
 
   template <class Y, class Deleter, class = typename __not_alloc_shared_tag<nostd::remove_cvref_t<Deleter>>::type>
   __strong_rc_counter(Y* p, Deleter&& d) : pi_(nullptr) {
-    using alloc_type = ::std::allocator<__rc_ptr_counted_data_with_deleter<Y, nostd::remove_cvref_t<Deleter>>>;
+    using alloc_type =
+        ::std::allocator<__rc_ptr_counted_data_with_deleter<Y, nostd::remove_cvref_t<Deleter>, counted_data_base>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc;
     auto guard = allocate_guarded(alloc);
@@ -395,7 +492,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
   __strong_rc_counter(Y* p, Deleter&& d, Alloc&& a) : pi_(nullptr) {
     using origin_alloc_traits = ::std::allocator_traits<nostd::remove_cvref_t<Alloc>>;
     using alloc_type = typename origin_alloc_traits::template rebind_alloc<
-        __rc_ptr_counted_data_with_deleter_allocator<Y, nostd::remove_cvref_t<Deleter>, nostd::remove_cvref_t<Alloc>>>;
+        __rc_ptr_counted_data_with_deleter_allocator<Y, nostd::remove_cvref_t<Deleter>, nostd::remove_cvref_t<Alloc>,
+                                                     counted_data_base>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc{a};
     auto guard = allocate_guarded(alloc);
@@ -415,7 +513,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
 
   template <class... Args>
   __strong_rc_counter(T*& __p, __strong_rc_default_alloc_shared_tag<T>, Args&&... args) : pi_(nullptr) {
-    using alloc_type = ::std::allocator<__rc_ptr_counted_data_inplace<T>>;
+    using alloc_type = ::std::allocator<__rc_ptr_counted_data_inplace<T, counted_data_base>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc;
     auto guard = allocate_guarded(alloc);
@@ -439,7 +537,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
     using origin_alloc_traits = ::std::allocator_traits<nostd::remove_cvref_t<Alloc>>;
 
     using alloc_type = typename origin_alloc_traits::template rebind_alloc<
-        __rc_ptr_counted_data_inplace_alloc<T, nostd::remove_cvref_t<Alloc>>>;
+        __rc_ptr_counted_data_inplace_alloc<T, nostd::remove_cvref_t<Alloc>, counted_data_base>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc{a};
     auto guard = allocate_guarded(alloc);
@@ -464,7 +562,8 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
       return;
     }
 
-    using alloc_type = ::std::allocator<__rc_ptr_counted_data_with_deleter<UT, nostd::remove_cvref_t<UDeleter>>>;
+    using alloc_type =
+        ::std::allocator<__rc_ptr_counted_data_with_deleter<UT, nostd::remove_cvref_t<UDeleter>, counted_data_base>>;
     using alloc_traits = ::std::allocator_traits<alloc_type>;
     alloc_type alloc;
     auto guard = allocate_guarded(alloc);
@@ -484,9 +583,9 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
 #endif
   }
 
-  explicit __strong_rc_counter(const __weak_rc_counter<T>& w);
+  explicit __strong_rc_counter(const __weak_rc_counter<T, RcPolicy>& w);
 
-  __strong_rc_counter(const __weak_rc_counter<T>& w, std::nothrow_t) noexcept;
+  __strong_rc_counter(const __weak_rc_counter<T, RcPolicy>& w, std::nothrow_t) noexcept;
 
   ~__strong_rc_counter() {
     if (nullptr != pi_) {
@@ -494,36 +593,36 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
     }
   }
 
-  __strong_rc_counter(const __strong_rc_counter& r) : pi_(r.pi_) {
+  __strong_rc_counter(const __strong_rc_counter& r) noexcept : pi_(r.pi_) {
     if (nullptr != pi_) {
-      pi_->add_ref();
+      pi_->add_ref_copy();
     }
   }
 
   __strong_rc_counter(const __strong_rc_counter& r, std::nothrow_t) noexcept : pi_(r.pi_) {
     if (nullptr != pi_) {
-      pi_->add_ref_nothrow();
+      pi_->add_ref_copy();
     }
   }
 
   __strong_rc_counter(__strong_rc_counter&& r) noexcept : pi_(r.pi_) { r.pi_ = nullptr; }
 
   template <class Y>
-  __strong_rc_counter(const __strong_rc_counter<Y>& r) : pi_(r.pi_) {
+  __strong_rc_counter(const __strong_rc_counter<Y, RcPolicy>& r) noexcept : pi_(r.pi_) {
     if (nullptr != pi_) {
-      pi_->add_ref();
+      pi_->add_ref_copy();
     }
   }
 
   template <class Y>
-  __strong_rc_counter(const __strong_rc_counter<Y>& r, std::nothrow_t) noexcept : pi_(r.pi_) {
+  __strong_rc_counter(const __strong_rc_counter<Y, RcPolicy>& r, std::nothrow_t) noexcept : pi_(r.pi_) {
     if (nullptr != pi_) {
-      pi_->add_ref_nothrow();
+      pi_->add_ref_copy();
     }
   }
 
   template <class Y>
-  __strong_rc_counter(__strong_rc_counter<Y>&& r) noexcept : pi_(r.pi_) {
+  __strong_rc_counter(__strong_rc_counter<Y, RcPolicy>&& r) noexcept : pi_(r.pi_) {
     r.pi_ = nullptr;
   }
 
@@ -533,11 +632,11 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
     }
 
     if (pi_ != r.pi_) {
-      __rc_ptr_counted_data_base* origin_pi = pi_;
+      counted_data_base* origin_pi = pi_;
 
       pi_ = r.pi_;
       if (nullptr != pi_) {
-        pi_->add_ref_nothrow();
+        pi_->add_ref_copy();
       }
       if (nullptr != origin_pi) {
         origin_pi->release();
@@ -548,7 +647,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
 
   __strong_rc_counter& operator=(__strong_rc_counter&& r) noexcept {
     if (pi_ != r.pi_) {
-      __rc_ptr_counted_data_base* origin_pi = pi_;
+      counted_data_base* origin_pi = pi_;
       pi_ = r.pi_;
       r.pi_ = nullptr;
 
@@ -560,36 +659,41 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter {
   }
 
   inline void swap(__strong_rc_counter& r) noexcept {
-    __rc_ptr_counted_data_base* tmp = pi_;
+    counted_data_base* tmp = pi_;
     pi_ = r.pi_;
     r.pi_ = tmp;
   }
 
   template <class Y>
-  inline void swap(__strong_rc_counter<Y>& r) noexcept {
-    __rc_ptr_counted_data_base* tmp = pi_;
+  inline void swap(__strong_rc_counter<Y, RcPolicy>& r) noexcept {
+    counted_data_base* tmp = pi_;
     pi_ = r.pi_;
     r.pi_ = tmp;
   }
 
   inline std::size_t use_count() const noexcept { return (nullptr != pi_) ? pi_->use_count() : 0; }
 
-  inline __rc_ptr_counted_data_base* ref_counter() const noexcept { return pi_; }
+  inline counted_data_base* ref_counter() const noexcept { return pi_; }
 
  private:
-  template <class>
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY __strong_rc_counter;
 
-  __rc_ptr_counted_data_base* pi_;
+  template <class>
+  friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY atomic_strong_rc_ptr;
+
+  counted_data_base* pi_;
 };
 
-template <class T>
+template <class T, class RcPolicy>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY __weak_rc_counter {
  public:
+  using counted_data_base = typename RcPolicy::counted_data_base;
+
   UTIL_CONFIG_CONSTEXPR __weak_rc_counter() noexcept : pi_(nullptr) {}
 
   template <class Y>
-  explicit __weak_rc_counter(const __strong_rc_counter<Y>& other) noexcept : pi_(other.ref_counter()) {
+  explicit __weak_rc_counter(const __strong_rc_counter<Y, RcPolicy>& other) noexcept : pi_(other.ref_counter()) {
     if (nullptr != pi_) {
       pi_->weak_add_ref();
     }
@@ -610,14 +714,14 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __weak_rc_counter {
   __weak_rc_counter(__weak_rc_counter&& r) noexcept : pi_(r.pi_) { r.pi_ = nullptr; }
 
   template <class Y>
-  __weak_rc_counter(const __weak_rc_counter<Y>& r) noexcept : pi_(r.pi_) {
+  __weak_rc_counter(const __weak_rc_counter<Y, RcPolicy>& r) noexcept : pi_(r.pi_) {
     if (nullptr != pi_) {
       pi_->weak_add_ref();
     }
   }
 
   template <class Y>
-  __weak_rc_counter(__weak_rc_counter<Y>&& r) noexcept : pi_(r.pi_) {
+  __weak_rc_counter(__weak_rc_counter<Y, RcPolicy>&& r) noexcept : pi_(r.pi_) {
     r.pi_ = nullptr;
   }
 
@@ -627,7 +731,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __weak_rc_counter {
     }
 
     if (pi_ != r.pi_) {
-      __rc_ptr_counted_data_base* origin_pi = pi_;
+      counted_data_base* origin_pi = pi_;
       pi_ = r.pi_;
       if (nullptr != pi_) {
         pi_->weak_add_ref();
@@ -642,7 +746,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __weak_rc_counter {
 
   __weak_rc_counter& operator=(__weak_rc_counter&& r) noexcept {
     if (pi_ != r.pi_) {
-      __rc_ptr_counted_data_base* origin_pi = pi_;
+      counted_data_base* origin_pi = pi_;
       pi_ = r.pi_;
       r.pi_ = nullptr;
 
@@ -654,39 +758,41 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY __weak_rc_counter {
   }
 
   inline void swap(__weak_rc_counter& r) noexcept {
-    __rc_ptr_counted_data_base* tmp = pi_;
+    counted_data_base* tmp = pi_;
     pi_ = r.pi_;
     r.pi_ = tmp;
   }
 
   template <class Y>
-  inline void swap(__weak_rc_counter<Y>& r) noexcept {
-    __rc_ptr_counted_data_base* tmp = pi_;
+  inline void swap(__weak_rc_counter<Y, RcPolicy>& r) noexcept {
+    counted_data_base* tmp = pi_;
     pi_ = r.pi_;
     r.pi_ = tmp;
   }
 
   inline std::size_t use_count() const noexcept { return (nullptr != pi_) ? pi_->use_count() : 0; }
 
-  inline __rc_ptr_counted_data_base* ref_counter() const noexcept { return pi_; }
+  inline counted_data_base* ref_counter() const noexcept { return pi_; }
 
  private:
-  template <class>
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY __weak_rc_counter;
 
-  __rc_ptr_counted_data_base* pi_;
+  counted_data_base* pi_;
 };
 
-template <class T>
-__strong_rc_counter<T>::__strong_rc_counter(const __weak_rc_counter<T>& w) : pi_(w.ref_counter()) {
+template <class T, class RcPolicy>
+__strong_rc_counter<T, RcPolicy>::__strong_rc_counter(const __weak_rc_counter<T, RcPolicy>& w)
+    : pi_(w.ref_counter()) {
   if (nullptr == pi_ || !pi_->add_ref_nothrow()) {
     pi_ = nullptr;
     __rc_ptr_counted_data_base::throw_bad_weak_ptr();
   }
 }
 
-template <class T>
-__strong_rc_counter<T>::__strong_rc_counter(const __weak_rc_counter<T>& w, std::nothrow_t) noexcept
+template <class T, class RcPolicy>
+__strong_rc_counter<T, RcPolicy>::__strong_rc_counter(const __weak_rc_counter<T, RcPolicy>& w,
+                                                      std::nothrow_t) noexcept
     : pi_(w.ref_counter()) {
   if (nullptr != pi_ && !pi_->add_ref_nothrow()) {
     pi_ = nullptr;
@@ -696,7 +802,7 @@ __strong_rc_counter<T>::__strong_rc_counter(const __weak_rc_counter<T>& w, std::
 /**
  * @brief Base class to mantain all shared APIs.
  */
-template <class T, bool = std::is_array<T>::value, bool = std::is_void<T>::value>
+template <class T, class RcPolicy, bool = std::is_array<T>::value, bool = std::is_void<T>::value>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access {
  public:
   using element_type = T;
@@ -722,14 +828,14 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access {
   }
 
  private:
-  inline element_type* get() const noexcept { return static_cast<const strong_rc_ptr<T>*>(this)->get(); }
+  inline element_type* get() const noexcept { return static_cast<const strong_rc_ptr<T, RcPolicy>*>(this)->get(); }
 };
 
 /**
  * @brief A helper class that used to access internal APIs for void type.
  */
-template <class T>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access<T, false, true> {
+template <class T, class RcPolicy>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access<T, RcPolicy, false, true> {
  public:
   using element_type = T;
 
@@ -744,11 +850,11 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access<T, false, true> {
   }
 
  private:
-  inline element_type* get() const noexcept { return static_cast<const strong_rc_ptr<T>*>(this)->get(); }
+  inline element_type* get() const noexcept { return static_cast<const strong_rc_ptr<T, RcPolicy>*>(this)->get(); }
 };
 
-template <class T>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access<T, true, false> {
+template <class T, class RcPolicy>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access<T, RcPolicy, true, false> {
  public:
   using element_type = nostd::remove_extent_t<T>;
 
@@ -763,7 +869,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access<T, true, false> {
   }
 
  private:
-  inline element_type* get() const noexcept { return static_cast<const strong_rc_ptr<T>*>(this)->get(); }
+  inline element_type* get() const noexcept { return static_cast<const strong_rc_ptr<T, RcPolicy>*>(this)->get(); }
 };
 
 /**
@@ -771,19 +877,19 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr_access<T, true, false> {
  * @note We use the old way to implement this feature, because some old compiler has problems for implementation of the
  *       detection idiom.
  */
-template <class T1, class T2, class T3>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void __enable_shared_from_this_with(const __strong_rc_counter<T1>* __n,
-                                                                           const T2* __py,
-                                                                           const enable_shared_rc_from_this<T3>* __p) {
+template <class T1, class T2, class T3, class RcPolicy>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void __enable_shared_from_this_with(
+    const __strong_rc_counter<T1, RcPolicy>* __n, const T2* __py, const enable_shared_rc_from_this<T3, RcPolicy>* __p) {
   if (nullptr != __p) {
     __p->__internal_weak_assign(const_cast<T2*>(__py), *__n);
   }
 }
 
 // All ptr shares the same lifetime.
-template <class T1, class T2, class T3, size_t T3SIZE>
+template <class T1, class T2, class T3, size_t T3SIZE, class RcPolicy>
 ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void __enable_shared_from_this_with(
-    const __strong_rc_counter<T1>* __n, const T2* __py, const enable_shared_rc_from_this<T3[T3SIZE]>* __p) {
+    const __strong_rc_counter<T1, RcPolicy>* __n, const T2* __py,
+    const enable_shared_rc_from_this<T3[T3SIZE], RcPolicy>* __p) {
   if (nullptr != __p) {
     for (auto& p : *__p) {
       p->__internal_weak_assign(const_cast<T2*>(__py), *__n);
@@ -811,13 +917,14 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY inline void __enable_shared_from_this_with(...)
 
 /**
  * @brief A std::shared_ptr replacement that is more lightweight and do not use atomic operation for reference counting.
- * @note This class is designed for single thread usage.
+ * @note This class is designed for single thread usage, use rc_ptr_atomic_policy to share it across threads.
  */
-template <class T>
-class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr : public strong_rc_ptr_access<T> {
+template <class T, class RcPolicy>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr : public strong_rc_ptr_access<T, RcPolicy> {
  public:
   using element_type = nostd::remove_extent_t<T>;
-  using weak_type = weak_rc_ptr<T>;
+  using weak_type = weak_rc_ptr<T, RcPolicy>;
+  using policy_type = RcPolicy;
 
   // Allow nostd::nullable<T> to be used as a strong_rc_ptr<T>
   using nullability_compatible_type = void;
@@ -854,37 +961,38 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr : public strong_rc_ptr_acces
   strong_rc_ptr(std::nullptr_t ptr, Deleter d, Alloc a) : ptr_(ptr), ref_counter_(ptr, std::move(d), std::move(a)) {}
 
   template <class Y>
-  strong_rc_ptr(const strong_rc_ptr<Y>& other) noexcept
+  strong_rc_ptr(const strong_rc_ptr<Y, RcPolicy>& other) noexcept
       : ptr_(other.ptr_), ref_counter_(other.ref_counter_, std::nothrow) {}
 
   template <class Y>
-  strong_rc_ptr(strong_rc_ptr<Y>&& other) noexcept : ptr_(other.ptr_), ref_counter_() {
+  strong_rc_ptr(strong_rc_ptr<Y, RcPolicy>&& other) noexcept : ptr_(other.ptr_), ref_counter_() {
     ref_counter_.swap(other.ref_counter_);
     other.ptr_ = nullptr;
   }
 
   template <class Y>
-  strong_rc_ptr(const strong_rc_ptr<Y>& other, element_type* ptr) noexcept
+  strong_rc_ptr(const strong_rc_ptr<Y, RcPolicy>& other, element_type* ptr) noexcept
       : ptr_(ptr), ref_counter_(other.ref_counter_, std::nothrow) {}
 
   template <class Y>
-  strong_rc_ptr(strong_rc_ptr<Y>&& other, element_type* ptr) noexcept : ptr_(ptr), ref_counter_() {
+  strong_rc_ptr(strong_rc_ptr<Y, RcPolicy>&& other, element_type* ptr) noexcept : ptr_(ptr), ref_counter_() {
     ref_counter_.swap(other.ref_counter_);
     other.ptr_ = nullptr;
   }
 
-  strong_rc_ptr(const weak_rc_ptr<T>& other)  // NOLINT: runtime/explicit
+  strong_rc_ptr(const weak_rc_ptr<T, RcPolicy>& other)  // NOLINT: runtime/explicit
       : ptr_(nullptr), ref_counter_(other.ref_counter_) {
     ptr_ = other.ptr_;  // NOLINT(cppcoreguidelines-prefer-member-initializer)
   }
 
-  strong_rc_ptr(const weak_rc_ptr<T>& other, std::nothrow_t) noexcept
+  strong_rc_ptr(const weak_rc_ptr<T, RcPolicy>& other, std::nothrow_t) noexcept
       : ptr_(nullptr), ref_counter_(other.ref_counter_, std::nothrow) {
-    ptr_ = other.use_count() > 0 ? other.ptr_ : nullptr;  // NOLINT(cppcoreguidelines-prefer-member-initializer)
+    // Check the counter of this, use count of other may drop to zero after the counter of this is got in other threads
+    ptr_ = ref_counter_.use_count() > 0 ? other.ptr_ : nullptr;  // NOLINT(cppcoreguidelines-prefer-member-initializer)
   }
 
   template <class Y>
-  strong_rc_ptr(const weak_rc_ptr<Y>& other)  // NOLINT: runtime/explicit
+  strong_rc_ptr(const weak_rc_ptr<Y, RcPolicy>& other)  // NOLINT: runtime/explicit
       : ptr_(nullptr), ref_counter_(other.ref_counter_) {
     ptr_ = other.ptr_;  // NOLINT(cppcoreguidelines-prefer-member-initializer)
   }
@@ -892,8 +1000,9 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr : public strong_rc_ptr_acces
   template <class Y, class Deleter>
   strong_rc_ptr(std::unique_ptr<Y, Deleter>&& other)  // NOLINT: runtime/explicit
       : ptr_(other.get()), ref_counter_() {
-    ref_counter_ =                                            // NOLINT(cppcoreguidelines-prefer-member-initializer)
-        __strong_rc_counter<element_type>{std::move(other)};  // NOLINT(cppcoreguidelines-prefer-member-initializer)
+    ref_counter_ =  // NOLINT(cppcoreguidelines-prefer-member-initializer)
+        __strong_rc_counter<element_type, RcPolicy>{
+            std::move(other)};  // NOLINT(cppcoreguidelines-prefer-member-initializer)
     __enable_shared_from_this_with(&ref_counter_, ptr_, ptr_);
   }
 
@@ -935,14 +1044,14 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr : public strong_rc_ptr_acces
   }
 
   template <class Y>
-  inline strong_rc_ptr& operator=(const strong_rc_ptr<Y>& other) noexcept {
+  inline strong_rc_ptr& operator=(const strong_rc_ptr<Y, RcPolicy>& other) noexcept {
     ptr_ = other.ptr_;
     ref_counter_ = other.ref_counter_;
     return *this;
   }
 
   template <class Y>
-  inline strong_rc_ptr& operator=(strong_rc_ptr<Y>&& other) noexcept {
+  inline strong_rc_ptr& operator=(strong_rc_ptr<Y, RcPolicy>&& other) noexcept {
     strong_rc_ptr{std::move(other)}.swap(*this);
     return *this;
   }
@@ -988,49 +1097,52 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr : public strong_rc_ptr_acces
   inline explicit operator bool() const noexcept { return nullptr != get(); }
 
   template <class Y>
-  inline bool owner_before(strong_rc_ptr<Y> const& r) const noexcept {
-    return std::less<__rc_ptr_counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
+  inline bool owner_before(strong_rc_ptr<Y, RcPolicy> const& r) const noexcept {
+    return std::less<counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
   }
 
   template <class Y>
-  inline bool owner_before(weak_rc_ptr<Y> const& r) const noexcept {
-    return std::less<__rc_ptr_counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
+  inline bool owner_before(weak_rc_ptr<Y, RcPolicy> const& r) const noexcept {
+    return std::less<counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
   }
 
   template <class Y>
-  inline bool owner_equal(strong_rc_ptr<Y> const& r) const noexcept {
+  inline bool owner_equal(strong_rc_ptr<Y, RcPolicy> const& r) const noexcept {
     return ref_counter_.ref_counter() == r.ref_counter_.ref_counter();
   }
 
   template <class Y>
-  inline bool owner_equal(weak_rc_ptr<Y> const& r) const noexcept {
+  inline bool owner_equal(weak_rc_ptr<Y, RcPolicy> const& r) const noexcept {
     return ref_counter_.ref_counter() == r.ref_counter_.ref_counter();
   }
 
-  std::size_t owner_hash() const noexcept {
-    return std::hash<__rc_ptr_counted_data_base*>()(ref_counter_.ref_counter());
-  }
+  std::size_t owner_hash() const noexcept { return std::hash<counted_data_base*>()(ref_counter_.ref_counter()); }
 
  private:
-  template <class>
+  using counted_data_base = typename RcPolicy::counted_data_base;
+
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY weak_rc_ptr;
 
-  template <class>
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr;
 
+  template <class>
+  friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY atomic_strong_rc_ptr;
+
  private:
   element_type* ptr_;
-  __strong_rc_counter<element_type> ref_counter_;
+  __strong_rc_counter<element_type, RcPolicy> ref_counter_;
 };
 
-template <class T1, class T2>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(const strong_rc_ptr<T1>& l,
-                                                       const strong_rc_ptr<T2>& r) noexcept {
+template <class T1, class P1, class T2, class P2>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(const strong_rc_ptr<T1, P1>& l,
+                                                       const strong_rc_ptr<T2, P2>& r) noexcept {
   return l.get() == r.get();
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(const strong_rc_ptr<T1>& l, ::std::nullptr_t) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(const strong_rc_ptr<T1, P1>& l, ::std::nullptr_t) noexcept {
   return !l;
 }
 
@@ -1055,116 +1167,119 @@ struct __strong_rc_ptr_compare_common_type<T1, T2, false> {
 
 // Use three way comparison if available
 #ifdef __cpp_impl_three_way_comparison
-template <class T1, class T2>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::strong_ordering operator<=>(const strong_rc_ptr<T1>& l,
-                                                                        const strong_rc_ptr<T2>& r) noexcept {
+template <class T1, class P1, class T2, class P2>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::strong_ordering operator<=>(const strong_rc_ptr<T1, P1>& l,
+                                                                        const strong_rc_ptr<T2, P2>& r) noexcept {
   return reinterpret_cast<typename __strong_rc_ptr_compare_common_type<T1, T2>::left_type>(l.get()) <=>
          reinterpret_cast<typename __strong_rc_ptr_compare_common_type<T1, T2>::right_type>(r.get());
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::strong_ordering operator<=>(const strong_rc_ptr<T1>& l,
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::strong_ordering operator<=>(const strong_rc_ptr<T1, P1>& l,
                                                                         ::std::nullptr_t) noexcept {
   return l.get() <=> static_cast<T1*>(nullptr);
 }
 #else
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(::std::nullptr_t, const strong_rc_ptr<T1>& r) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(::std::nullptr_t, const strong_rc_ptr<T1, P1>& r) noexcept {
   return !r;
 }
 
-template <class T1, class T2>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(const strong_rc_ptr<T1>& l,
-                                                       const strong_rc_ptr<T2>& r) noexcept {
+template <class T1, class P1, class T2, class P2>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(const strong_rc_ptr<T1, P1>& l,
+                                                       const strong_rc_ptr<T2, P2>& r) noexcept {
   return l.get() != r.get();
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(const strong_rc_ptr<T1>& l, ::std::nullptr_t) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(const strong_rc_ptr<T1, P1>& l, ::std::nullptr_t) noexcept {
   return l.get() != nullptr;
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(::std::nullptr_t, const strong_rc_ptr<T1>& r) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(::std::nullptr_t, const strong_rc_ptr<T1, P1>& r) noexcept {
   return r.get() != nullptr;
 }
 
-template <class T1, class T2>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<(const strong_rc_ptr<T1>& l, const strong_rc_ptr<T2>& r) noexcept {
+template <class T1, class P1, class T2, class P2>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<(const strong_rc_ptr<T1, P1>& l,
+                                                      const strong_rc_ptr<T2, P2>& r) noexcept {
   return std::less<typename __strong_rc_ptr_compare_common_type<
-      typename strong_rc_ptr<T1>::element_type, typename strong_rc_ptr<T2>::element_type>::common_type>()(l.get(),
-                                                                                                          r.get());
+      typename strong_rc_ptr<T1, P1>::element_type, typename strong_rc_ptr<T2, P2>::element_type>::common_type>()(
+      l.get(), r.get());
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<(const strong_rc_ptr<T1>& l, ::std::nullptr_t) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<(const strong_rc_ptr<T1, P1>& l, ::std::nullptr_t) noexcept {
   return std::less<T1>()(l.get(), nullptr);
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<(::std::nullptr_t, const strong_rc_ptr<T1>& r) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<(::std::nullptr_t, const strong_rc_ptr<T1, P1>& r) noexcept {
   return std::less<T1>()(nullptr, r.get());
 }
 
-template <class T1, class T2>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>(const strong_rc_ptr<T1>& l, const strong_rc_ptr<T2>& r) noexcept {
+template <class T1, class P1, class T2, class P2>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>(const strong_rc_ptr<T1, P1>& l,
+                                                      const strong_rc_ptr<T2, P2>& r) noexcept {
   return std::greater<typename __strong_rc_ptr_compare_common_type<
-      typename strong_rc_ptr<T1>::element_type, typename strong_rc_ptr<T2>::element_type>::common_type>()(l.get(),
-                                                                                                          r.get());
+      typename strong_rc_ptr<T1, P1>::element_type, typename strong_rc_ptr<T2, P2>::element_type>::common_type>()(
+      l.get(), r.get());
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>(const strong_rc_ptr<T1>& l, ::std::nullptr_t) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>(const strong_rc_ptr<T1, P1>& l, ::std::nullptr_t) noexcept {
   return std::greater<T1>()(l.get(), nullptr);
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>(::std::nullptr_t, const strong_rc_ptr<T1>& r) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>(::std::nullptr_t, const strong_rc_ptr<T1, P1>& r) noexcept {
   return std::greater<T1>()(nullptr, r.get());
 }
 
-template <class T1, class T2>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<=(const strong_rc_ptr<T1>& l,
-                                                       const strong_rc_ptr<T2>& r) noexcept {
+template <class T1, class P1, class T2, class P2>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<=(const strong_rc_ptr<T1, P1>& l,
+                                                       const strong_rc_ptr<T2, P2>& r) noexcept {
   return !(r < l);
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<=(const strong_rc_ptr<T1>& l, ::std::nullptr_t) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<=(const strong_rc_ptr<T1, P1>& l, ::std::nullptr_t) noexcept {
   return !(nullptr < l);
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<=(::std::nullptr_t, const strong_rc_ptr<T1>& r) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator<=(::std::nullptr_t, const strong_rc_ptr<T1, P1>& r) noexcept {
   return !(r < nullptr);
 }
 
-template <class T1, class T2>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>=(const strong_rc_ptr<T1>& l,
-                                                       const strong_rc_ptr<T2>& r) noexcept {
+template <class T1, class P1, class T2, class P2>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>=(const strong_rc_ptr<T1, P1>& l,
+                                                       const strong_rc_ptr<T2, P2>& r) noexcept {
   return !(r > l);
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>=(const strong_rc_ptr<T1>& l, ::std::nullptr_t) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>=(const strong_rc_ptr<T1, P1>& l, ::std::nullptr_t) noexcept {
   return !(nullptr > l);
 }
 
-template <class T1>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>=(::std::nullptr_t, const strong_rc_ptr<T1>& r) noexcept {
+template <class T1, class P1>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator>=(::std::nullptr_t, const strong_rc_ptr<T1, P1>& r) noexcept {
   return !(r > nullptr);
 }
 #endif
 
 /**
  * @brief A std::weak_ptr replacement that is more lightweight and do not use atomic operation for reference counting.
- * @note This class is designed for single thread usage.
+ * @note This class is designed for single thread usage, use rc_ptr_atomic_policy to share it across threads.
  */
-template <typename T>
+template <typename T, class RcPolicy>
 class ATFRAMEWORK_UTILS_API_HEAD_ONLY weak_rc_ptr {
  public:
   using element_type = nostd::remove_extent_t<T>;
+  using policy_type = RcPolicy;
 
  public:
   UTIL_CONFIG_CONSTEXPR weak_rc_ptr() noexcept : ptr_(nullptr), ref_counter_() {}
@@ -1184,36 +1299,37 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY weak_rc_ptr {
   }
 
   template <class Y>
-  weak_rc_ptr(const strong_rc_ptr<Y>& other) noexcept  // NOLINT: runtime/explicit
+  weak_rc_ptr(const strong_rc_ptr<Y, RcPolicy>& other) noexcept  // NOLINT: runtime/explicit
       : ptr_(other.ptr_), ref_counter_(other.ref_counter_) {}
 
   template <class Y>
-  weak_rc_ptr(const weak_rc_ptr<Y>& other) noexcept : ref_counter_(other.ref_counter_) {
+  weak_rc_ptr(const weak_rc_ptr<Y, RcPolicy>& other) noexcept : ref_counter_(other.ref_counter_) {
     ptr_ = other.lock().get();  // NOLINT(cppcoreguidelines-prefer-member-initializer)
   }
 
   template <class Y>
-  weak_rc_ptr(weak_rc_ptr<Y>&& other) noexcept : ptr_(other.lock().get()), ref_counter_(std::move(other.ref_counter_)) {
+  weak_rc_ptr(weak_rc_ptr<Y, RcPolicy>&& other) noexcept
+      : ptr_(other.lock().get()), ref_counter_(std::move(other.ref_counter_)) {
     other.ptr_ = nullptr;
   }
 
   template <class Y>
-  weak_rc_ptr& operator=(const weak_rc_ptr<Y>& other) noexcept {
+  weak_rc_ptr& operator=(const weak_rc_ptr<Y, RcPolicy>& other) noexcept {
     ptr_ = other.lock().get();
     ref_counter_ = other.ref_counter_;
     return *this;
   }
 
   template <class Y>
-  weak_rc_ptr& operator=(weak_rc_ptr<Y>&& other) noexcept {
+  weak_rc_ptr& operator=(weak_rc_ptr<Y, RcPolicy>&& other) noexcept {
     weak_rc_ptr{std::move(other)}.swap(*this);
     return *this;
   }
 
   template <class Y>
-  weak_rc_ptr& operator=(const strong_rc_ptr<Y>& other) noexcept {
+  weak_rc_ptr& operator=(const strong_rc_ptr<Y, RcPolicy>& other) noexcept {
     ptr_ = other.ptr_;
-    __weak_rc_counter<T>{other.ref_counter_}.swap(ref_counter_);
+    __weak_rc_counter<T, RcPolicy>{other.ref_counter_}.swap(ref_counter_);
     return *this;
   }
 
@@ -1228,60 +1344,60 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY weak_rc_ptr {
 
   inline bool expired() const noexcept { return ref_counter_.use_count() == 0; }
 
-  inline strong_rc_ptr<T> lock() const noexcept { return strong_rc_ptr<T>(*this, std::nothrow); }
+  inline strong_rc_ptr<T, RcPolicy> lock() const noexcept { return strong_rc_ptr<T, RcPolicy>(*this, std::nothrow); }
 
   template <class Y>
-  inline bool owner_before(strong_rc_ptr<Y> const& r) const noexcept {
-    return std::less<__rc_ptr_counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
+  inline bool owner_before(strong_rc_ptr<Y, RcPolicy> const& r) const noexcept {
+    return std::less<counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
   }
 
   template <class Y>
-  inline bool owner_before(weak_rc_ptr<Y> const& r) const noexcept {
-    return std::less<__rc_ptr_counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
+  inline bool owner_before(weak_rc_ptr<Y, RcPolicy> const& r) const noexcept {
+    return std::less<counted_data_base*>()(ref_counter_.ref_counter(), r.ref_counter_.ref_counter());
   }
 
   template <class Y>
-  inline bool owner_equal(strong_rc_ptr<Y> const& r) const noexcept {
+  inline bool owner_equal(strong_rc_ptr<Y, RcPolicy> const& r) const noexcept {
     return ref_counter_.ref_counter() == r.ref_counter_.ref_counter();
   }
 
   template <class Y>
-  inline bool owner_equal(weak_rc_ptr<Y> const& r) const noexcept {
+  inline bool owner_equal(weak_rc_ptr<Y, RcPolicy> const& r) const noexcept {
     return ref_counter_.ref_counter() == r.ref_counter_.ref_counter();
   }
 
-  std::size_t owner_hash() const noexcept {
-    return std::hash<__rc_ptr_counted_data_base*>()(ref_counter_.ref_counter());
-  }
+  std::size_t owner_hash() const noexcept { return std::hash<counted_data_base*>()(ref_counter_.ref_counter()); }
 
  private:
-  template <class>
+  using counted_data_base = typename RcPolicy::counted_data_base;
+
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY enable_shared_rc_from_this;
 
   // Used by enable_shared_rc_from_this.
-  void assign(element_type* __ptr, const __strong_rc_counter<T>& __refcount) noexcept {
+  void assign(element_type* __ptr, const __strong_rc_counter<T, RcPolicy>& __refcount) noexcept {
     if (use_count() == 0) {
       ptr_ = __ptr;
-      ref_counter_ = __weak_rc_counter<T>{__refcount};
+      ref_counter_ = __weak_rc_counter<T, RcPolicy>{__refcount};
     }
   }
 
-  template <class>
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY weak_rc_ptr;
 
-  template <class>
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr;
 
  private:
   element_type* ptr_;
-  __weak_rc_counter<T> ref_counter_;
+  __weak_rc_counter<T, RcPolicy> ref_counter_;
 };
 
-template <class T>
+template <class T, class RcPolicy>
 class enable_shared_rc_from_this {
  public:
-  strong_rc_ptr<T> shared_from_this() {
-    strong_rc_ptr<T> result = weak_this_.lock();
+  strong_rc_ptr<T, RcPolicy> shared_from_this() {
+    strong_rc_ptr<T, RcPolicy> result = weak_this_.lock();
 #if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
     if (this != result.get()) {
       __rc_ptr_counted_data_base::throw_bad_weak_ptr();
@@ -1291,20 +1407,20 @@ class enable_shared_rc_from_this {
     return result;
   }
 
-  strong_rc_ptr<const T> shared_from_this() const {
-    strong_rc_ptr<T> result = weak_this_.lock();
+  strong_rc_ptr<const T, RcPolicy> shared_from_this() const {
+    strong_rc_ptr<T, RcPolicy> result = weak_this_.lock();
 #if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
     if (this != result.get()) {
       __rc_ptr_counted_data_base::throw_bad_weak_ptr();
     }
 #endif
     // NRVO
-    return strong_rc_ptr<T>{weak_this_};
+    return strong_rc_ptr<T, RcPolicy>{weak_this_};
   }
 
-  weak_rc_ptr<T> weak_from_this() { return weak_this_; }
+  weak_rc_ptr<T, RcPolicy> weak_from_this() { return weak_this_; }
 
-  weak_rc_ptr<const T> weak_from_this() const { return weak_this_; }
+  weak_rc_ptr<const T, RcPolicy> weak_from_this() const { return weak_this_; }
 
  protected:
   enable_shared_rc_from_this() = default;
@@ -1313,17 +1429,17 @@ class enable_shared_rc_from_this {
   ~enable_shared_rc_from_this() = default;
 
  private:
-  template <class>
+  template <class, class>
   friend class ATFRAMEWORK_UTILS_API_HEAD_ONLY strong_rc_ptr;
 
  public:
   template <class Y>
-  void __internal_weak_assign(T* __p, const __strong_rc_counter<Y>& __n) const noexcept {
+  void __internal_weak_assign(T* __p, const __strong_rc_counter<Y, RcPolicy>& __n) const noexcept {
     weak_this_.assign(__p, __n);
   }
 
  private:
-  mutable weak_rc_ptr<T> weak_this_;
+  mutable weak_rc_ptr<T, RcPolicy> weak_this_;
 };
 
 /**
@@ -1366,14 +1482,51 @@ nostd::enable_if_t<nostd::is_bounded_array<T>::value, strong_rc_ptr<T>> allocate
   return strong_rc_ptr<T>(__strong_rc_with_alloc_shared_tag<T>{}, alloc, std::forward<TArgs>(args)...);
 }
 
+/**
+ * @brief strong_rc_ptr with atomic reference counting, which can be copied and destroyed in different threads.
+ * @note Like std::shared_ptr, one atomic_rc_ptr instance itself still can not be modified by multiple threads, use
+ *       atomic_strong_rc_ptr to publish it.
+ */
+template <class T>
+using atomic_rc_ptr = strong_rc_ptr<T, rc_ptr_atomic_policy>;
+
+/**
+ * @brief weak_rc_ptr with atomic reference counting, lock() is safe when other threads release the last strong owner.
+ */
+template <class T>
+using atomic_weak_rc_ptr = weak_rc_ptr<T, rc_ptr_atomic_policy>;
+
+template <class T>
+using enable_shared_atomic_rc_from_this = enable_shared_rc_from_this<T, rc_ptr_atomic_policy>;
+
+/**
+ * @brief A std::make_shared replacement for atomic_rc_ptr(non-array and bounded array).
+ * @param args Arguments to construct the object.
+ */
+template <class T, class... TArgs>
+nostd::enable_if_t<!nostd::is_unbounded_array<T>::value, atomic_rc_ptr<T>> make_atomic_rc(TArgs&&... args) {
+  return atomic_rc_ptr<T>(__strong_rc_default_alloc_shared_tag<T>{}, std::forward<TArgs>(args)...);
+}
+
+/**
+ * @brief A std::allocate_shared (C++20) replacement for atomic_rc_ptr(non-array and bounded array).
+ * @param alloc The custom allocator.
+ * @param args Arguments to construct the object.
+ */
+template <class T, class Alloc, class... TArgs>
+nostd::enable_if_t<!nostd::is_unbounded_array<T>::value, atomic_rc_ptr<T>> allocate_atomic_rc(const Alloc& alloc,
+                                                                                               TArgs&&... args) {
+  return atomic_rc_ptr<T>(__strong_rc_with_alloc_shared_tag<T>{}, alloc, std::forward<TArgs>(args)...);
+}
+
 /**
  * @brief A std::static_pointer_cast replacement for strong_rc_ptr
  * @param r A strong_rc_ptr instance.
  * @return Converted strong_rc_ptr instance.
  */
-template <class T, class Y>
-strong_rc_ptr<T> static_pointer_cast(const strong_rc_ptr<Y>& r) noexcept {
-  return strong_rc_ptr<T>(r, static_cast<typename strong_rc_ptr<T>::element_type*>(r.get()));
+template <class T, class Y, class RcPolicy>
+strong_rc_ptr<T, RcPolicy> static_pointer_cast(const strong_rc_ptr<Y, RcPolicy>& r) noexcept {
+  return strong_rc_ptr<T, RcPolicy>(r, static_cast<typename strong_rc_ptr<T, RcPolicy>::element_type*>(r.get()));
 }
 
 /**
@@ -1381,9 +1534,9 @@ strong_rc_ptr<T> static_pointer_cast(const strong_rc_ptr<Y>& r) noexcept {
  * @param r A strong_rc_ptr instance.
  * @return Converted strong_rc_ptr instance.
  */
-template <class T, class Y>
-strong_rc_ptr<T> const_pointer_cast(const strong_rc_ptr<Y>& r) noexcept {
-  return strong_rc_ptr<T>(r, const_cast<typename strong_rc_ptr<T>::element_type*>(r.get()));
+template <class T, class Y, class RcPolicy>
+strong_rc_ptr<T, RcPolicy> const_pointer_cast(const strong_rc_ptr<Y, RcPolicy>& r) noexcept {
+  return strong_rc_ptr<T, RcPolicy>(r, const_cast<typename strong_rc_ptr<T, RcPolicy>::element_type*>(r.get()));
 }
 
 #if defined(ATFRAMEWORK_UTILS_ENABLE_RTTI) && ATFRAMEWORK_UTILS_ENABLE_RTTI
@@ -1392,9 +1545,9 @@ strong_rc_ptr<T> const_pointer_cast(const strong_rc_ptr<Y>& r) noexcept {
  * @param r A strong_rc_ptr instance.
  * @return Converted strong_rc_ptr instance.
  */
-template <class T, class Y>
-strong_rc_ptr<T> dynamic_pointer_cast(const strong_rc_ptr<Y>& r) noexcept {
-  return strong_rc_ptr<T>(r, dynamic_cast<typename strong_rc_ptr<T>::element_type*>(r.get()));
+template <class T, class Y, class RcPolicy>
+strong_rc_ptr<T, RcPolicy> dynamic_pointer_cast(const strong_rc_ptr<Y, RcPolicy>& r) noexcept {
+  return strong_rc_ptr<T, RcPolicy>(r, dynamic_cast<typename strong_rc_ptr<T, RcPolicy>::element_type*>(r.get()));
 }
 #endif
 
@@ -1407,9 +1560,10 @@ namespace std {
  * @param a A strong_rc_ptr instance.
  * @param b Another strong_rc_ptr instance.
  */
-template <class T>
-ATFRAMEWORK_UTILS_API_HEAD_ONLY void swap(ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T>& a,
-                                          ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T>& b) noexcept {
+template <class T, class RcPolicy>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY void swap(
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T, RcPolicy>& a,
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T, RcPolicy>& b) noexcept {
   a.swap(b);
 }
 
@@ -1418,9 +1572,9 @@ ATFRAMEWORK_UTILS_API_HEAD_ONLY void swap(ATFRAMEWORK_UTILS_NAMESPACE_ID::memory
  * @param a A strong_rc_ptr instance.
  * @param b Another strong_rc_ptr instance.
  */
-template <class T>
-struct ATFRAMEWORK_UTILS_API_HEAD_ONLY hash<ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T>> {
-  std::size_t operator()(const ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T>& s) const noexcept {
+template <class T, class RcPolicy>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY hash<ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T, RcPolicy>> {
+  std::size_t operator()(const ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T, RcPolicy>& s) const noexcept {
     return std::hash<T*>()(s.get());
   }
 };
@@ -1430,9 +1584,10 @@ struct ATFRAMEWORK_UTILS_API_HEAD_ONLY hash<ATFRAMEWORK_UTILS_NAMESPACE_ID::memo
  * @param a A strong_rc_ptr instance.
  * @param b Another strong_rc_ptr instance.
  */
-template <class CharT, class TraitT, class T>
+template <class CharT, class TraitT, class T, class RcPolicy>
 ATFRAMEWORK_UTILS_API_HEAD_ONLY inline std::basic_ostream<CharT, TraitT>& operator<<(
-    std::basic_ostream<CharT, TraitT>& __os, const ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T>& __p) {
+    std::basic_ostream<CharT, TraitT>& __os,
+    const ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<T, RcPolicy>& __p) {
   __os << __p.get();
   return __os;
 }
@@ -1447,6 +1602,7 @@ namespace memory {
 enum class compat_strong_ptr_mode : int8_t {
   kStrongRc = 0,  // Use strong_rc_ptr
   kStl = 1,       // Use shared_ptr
+  kAtomicRc = 2,  // Use strong_rc_ptr with rc_ptr_atomic_policy
 };
 
 /**
@@ -1494,6 +1650,45 @@ struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compat_strong_ptr_function_trait<compat_s
 #endif
 };
 
+template <>
+struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compat_strong_ptr_function_trait<compat_strong_ptr_mode::kAtomicRc> {
+  template <class Y>
+  using shared_ptr = memory::atomic_rc_ptr<Y>;
+
+  template <class Y>
+  using weak_ptr = memory::atomic_weak_rc_ptr<Y>;
+
+  template <class Y>
+  using enable_shared_from_this = memory::enable_shared_atomic_rc_from_this<Y>;
+
+  template <class Y, class... ArgsT>
+  static inline memory::atomic_rc_ptr<Y> make_shared(ArgsT&&... args) {
+    return memory::make_atomic_rc<Y>(std::forward<ArgsT>(args)...);
+  }
+
+  template <class Y, class Alloc, class... TArgs>
+  static inline memory::atomic_rc_ptr<Y> allocate_shared(const Alloc& alloc, TArgs&&... args) {
+    return memory::allocate_atomic_rc<Y>(alloc, std::forward<TArgs>(args)...);
+  }
+
+  template <class Y, class F>
+  static inline memory::atomic_rc_ptr<Y> static_pointer_cast(F&& f) {
+    return memory::static_pointer_cast<Y>(std::forward<F>(f));
+  }
+
+  template <class Y, class F>
+  static inline memory::atomic_rc_ptr<Y> const_pointer_cast(F&& f) {
+    return memory::const_pointer_cast<Y>(std::forward<F>(f));
+  }
+
+#if defined(ATFRAMEWORK_UTILS_ENABLE_RTTI) && ATFRAMEWORK_UTILS_ENABLE_RTTI
+  template <class Y, class F>
+  static inline memory::atomic_rc_ptr<Y> dynamic_pointer_cast(F&& f) {
+    return memory::dynamic_pointer_cast<Y>(std::forward<F>(f));
+  }
+#endif
+};
+
 template <>
 struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compat_strong_ptr_function_trait<compat_strong_ptr_mode::kStl> {
   template <class Y>
@@ -1558,8 +1753,8 @@ struct ATFRAMEWORK_UTILS_API_HEAD_ONLY compat_strong_ptr_type_trait {
 }  // namespace memory
 
 namespace nostd {
-template <class T>
-struct __is_nullability_support<memory::strong_rc_ptr<T>> {
+template <class T, class RcPolicy>
+struct __is_nullability_support<memory::strong_rc_ptr<T, RcPolicy>> {
   ATFW_UTIL_MACRO_INLINE_VARIABLE static constexpr const bool value = true;
 };
 }  // namespace nostd
@@ -0,0 +1,257 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#pragma once
+
+#include <config/atframe_utils_build_feature.h>
+#include <config/compiler_features.h>
+#include <design_pattern/nomovable.h>
+#include <design_pattern/noncopyable.h>
+
+#include <memory/allocator_traits.h>
+
+#include <stdint.h>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "lock/spin_lock.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+/**
+ * @brief Memory resource of fixed-size blocks, blocks are grouped into size classes and carved from large slabs
+ * @note Blocks which are larger than kMaxBlockSize or over-aligned are not served by slab_resource, the caller should
+ *       fallback to another allocator. Slabs are released only when the slab_resource is destroyed.
+ * @note When thread_safe is set, every thread keeps a small cache of free blocks for each size class, blocks are moved
+ *       between the thread cache and the shared free lists in batches, so most allocate()/deallocate() calls do not
+ *       take the lock.
+ */
+class slab_resource {
+ public:
+  using ptr_t = std::shared_ptr<slab_resource>;
+
+  enum : size_t {
+    kSizeClassGranularity = 16,
+    kSizeClassCount = 16,
+    kMaxBlockSize = kSizeClassGranularity * kSizeClassCount,
+  };
+
+  struct options_t {
+    // Bytes of one slab, every size class allocates slabs of this size from operator new
+    size_t slab_size;
+    // Max free blocks of each size class in the cache of one thread, 0 means disable thread caches
+    size_t thread_cache_size;
+    // Set false when the resource is used by only one thread, then there is no lock and no thread cache
+    bool thread_safe;
+
+    inline options_t() noexcept : slab_size(64 * 1024), thread_cache_size(64), thread_safe(true) {}
+  };
+
+  ATFW_UTIL_DESIGN_PATTERN_NOCOPYABLE(slab_resource)
+  ATFW_UTIL_DESIGN_PATTERN_NOMOVABLE(slab_resource)
+
+ public:
+  ATFRAMEWORK_UTILS_API ~slab_resource();
+
+  static ATFRAMEWORK_UTILS_API ptr_t create(const options_t &options = options_t());
+
+  /**
+   * @brief The shared resource used by default constructed slab_allocator, it's thread safe
+   */
+  static ATFRAMEWORK_UTILS_API const ptr_t &default_resource();
+
+  static inline bool is_slab_block(size_t bytes, size_t alignment) noexcept {
+    return bytes > 0 && bytes <= kMaxBlockSize && alignment <= kSizeClassGranularity &&
+           alignment <= alignof(std::max_align_t);
+  }
+
+  /**
+   * @brief Allocate a block
+   * @return nullptr if is_slab_block(bytes, alignment) is false or failed to allocate a new slab
+   */
+  ATFRAMEWORK_UTILS_API void *allocate(size_t bytes, size_t alignment);
+
+  /**
+   * @brief Give back a block allocated by allocate() with the same bytes and alignment
+   * @return false if is_slab_block(bytes, alignment) is false and nothing is done
+   */
+  ATFRAMEWORK_UTILS_API bool deallocate(void *p, size_t bytes, size_t alignment) noexcept;
+
+  inline const options_t &get_options() const noexcept { return options_; }
+
+  ATFRAMEWORK_UTILS_API size_t get_slab_count() const noexcept;
+
+  /**
+   * @brief Free blocks in the shared free lists, free blocks in thread caches are not included
+   */
+  ATFRAMEWORK_UTILS_API size_t get_free_block_count() const noexcept;
+
+ private:
+  struct free_block_t {
+    free_block_t *next;
+  };
+
+  struct block_list_t {
+    free_block_t *head;
+    size_t count;
+  };
+
+  struct size_class_t {
+    block_list_t free_list;
+    // Blocks of the newest slab are carved lazily, so pages of a new slab are not touched before they are used
+    char *carve_begin;
+    char *carve_end;
+  };
+
+  struct slab_t {
+    slab_t *next;
+  };
+
+  struct thread_cache_t;
+  struct thread_cache_set_t;
+
+  static inline size_t size_class_of(size_t bytes) noexcept {
+    return (bytes + kSizeClassGranularity - 1) / kSizeClassGranularity - 1;
+  }
+
+  // Move at most max_count blocks from shared free lists to output, new slab is allocated when necessary
+  size_t fetch_blocks(size_t size_class, block_list_t &output, size_t max_count) noexcept;
+
+  // Move count blocks of input back to shared free lists
+  void release_blocks(size_t size_class, block_list_t &input, size_t count) noexcept;
+
+  // Lock must be held if thread_safe is set
+  size_t fetch_blocks_unsafe(size_t size_class, block_list_t &output, size_t max_count) noexcept;
+
+  thread_cache_t *get_thread_cache();
+
+  explicit slab_resource(const options_t &options);
+
+ private:
+  options_t options_;
+  uint64_t id_;
+  std::weak_ptr<slab_resource> self_;
+  mutable ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock lock_;
+  size_class_t size_classes_[kSizeClassCount];
+  slab_t *slabs_;
+  size_t slab_count_;
+};
+
+/**
+ * @brief Allocator which allocates small blocks from slab_resource and larger ones from BackendAllocator
+ * @note Small blocks never fallback to BackendAllocator, allocate() throws std::bad_alloc(or returns nullptr when
+ *       exception is disabled) if slab_resource failed to allocate a new slab.
+ * @note Default constructed slab_allocator uses slab_resource::default_resource(), so it can be used as TAlloc of
+ *       lru_map or Allocator of wal_object, which only default construct the allocators.
+ * @note slab_allocator keeps a reference of its slab_resource, so blocks are always valid before they are
+ *       deallocated, even if the slab_resource is not referenced by anyone else.
+ */
+template <class T, class BackendAllocator = ::std::allocator<T>>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY slab_allocator
+    : public allocator_adapter<slab_allocator, T, BackendAllocator> {
+ public:
+  using base_type = allocator_adapter<slab_allocator, T, BackendAllocator>;
+  using value_type = typename base_type::value_type;
+  using pointer = typename base_type::pointer;
+  using size_type = typename base_type::size_type;
+  using const_void_pointer = typename base_type::const_void_pointer;
+
+  // Allocators with different slab_resource can not deallocate blocks of each other
+  using is_always_equal = ::std::false_type;
+  using propagate_on_container_copy_assignment = ::std::true_type;
+  using propagate_on_container_move_assignment = ::std::true_type;
+  using propagate_on_container_swap = ::std::true_type;
+
+  template <class, class>
+  friend class slab_allocator;
+
+ public:
+  inline slab_allocator() : base_type(), resource_(slab_resource::default_resource()) {}
+
+  inline explicit slab_allocator(slab_resource::ptr_t resource)
+      : base_type(), resource_(resource ? std::move(resource) : slab_resource::default_resource()) {}
+
+  inline slab_allocator(slab_resource::ptr_t resource, const BackendAllocator &backend)
+      : base_type(backend), resource_(resource ? std::move(resource) : slab_resource::default_resource()) {}
+
+  template <class U, class UBackendAllocator>
+  inline slab_allocator(const slab_allocator<U, UBackendAllocator> &other) noexcept(  // NOLINT: runtime/explicit
+      ::std::is_nothrow_constructible<BackendAllocator, const UBackendAllocator &>::value)
+      : base_type(static_cast<const typename slab_allocator<U, UBackendAllocator>::base_type &>(other)),
+        resource_(other.resource_) {}
+
+  ATFW_EXPLICIT_NODISCARD_ATTR
+  inline pointer allocate(size_type n) {
+    if (!is_slab_count(n)) {
+      return base_type::allocate(n);
+    }
+
+    void *ret = resource_->allocate(n * sizeof(value_type), alignof(value_type));
+    if (nullptr != ret) {
+      return static_cast<pointer>(ret);
+    }
+
+    // Do not fallback to the backend allocator here, deallocate() gives all blocks of this size to slab_resource
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+    throw ::std::bad_alloc();
+#else
+    return nullptr;
+#endif
+  }
+
+  ATFW_EXPLICIT_NODISCARD_ATTR
+  inline pointer allocate(size_type n, const_void_pointer) { return allocate(n); }
+
+#if ((defined(__cplusplus) && __cplusplus >= 202302L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 202302L)) && \
+    defined(__cpp_lib_allocate_at_least) && __cpp_lib_allocate_at_least >= 202302L
+  // Size of block must be the same as allocate(n), or deallocate() can not find the right size class
+  ATFW_EXPLICIT_NODISCARD_ATTR
+  inline ::std::allocation_result<pointer, size_type> allocate_at_least(size_type n) { return {allocate(n), n}; }
+#endif
+
+  inline void deallocate(pointer p, size_type n) {
+    if (!is_slab_count(n)) {
+      base_type::deallocate(p, n);
+      return;
+    }
+
+    resource_->deallocate(static_cast<void *>(p), n * sizeof(value_type), alignof(value_type));
+  }
+
+  inline const slab_resource::ptr_t &resource() const noexcept { return resource_; }
+
+ private:
+  // T may be incomplete when slab_allocator<T> is instantiated, so sizeof(T) is used only in member functions
+  static inline size_type max_slab_count() noexcept { return slab_resource::kMaxBlockSize / sizeof(value_type); }
+
+  // allocate() and deallocate() must route blocks of the same n to the same place
+  static inline bool is_slab_count(size_type n) noexcept {
+    return n <= max_slab_count() && slab_resource::is_slab_block(n * sizeof(value_type), alignof(value_type));
+  }
+
+  slab_resource::ptr_t resource_;
+};
+
+template <class T, class BackendAllocator, class U, class UBackendAllocator>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator==(const slab_allocator<T, BackendAllocator> &left,
+                                                       const slab_allocator<U, UBackendAllocator> &right) noexcept {
+  return left.resource() == right.resource() &&
+         __util_memory_allocator_adapter_backend_equal<BackendAllocator, UBackendAllocator>::equal(
+             left.backend_allocator(), right.backend_allocator());
+}
+
+template <class T, class BackendAllocator, class U, class UBackendAllocator>
+ATFRAMEWORK_UTILS_API_HEAD_ONLY inline bool operator!=(const slab_allocator<T, BackendAllocator> &left,
+                                                       const slab_allocator<U, UBackendAllocator> &right) noexcept {
+  return !(left == right);
+}
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -14,6 +14,7 @@
 // @history
 //      2017-02-17: 第一版实现，暂时不加锁
 //      2025-06-30: 默认使用非线程安全的智能指针，支持自定义 allocator (除回调函数外)
+//      2026-10-16: 增加时间轮占用位图，支持 next_expire_tick() 并且 tick() 时批量跳过空的时间槽
 
 #pragma once
 
@@ -71,6 +72,7 @@
 
 #include <config/atframe_utils_build_feature.h>
 
+#include <algorithm/bit.h>
 #include <memory/rc_ptr.h>
 
 #include <assert.h>
@@ -89,6 +91,7 @@ namespace time {
  * @brief jiffies timer 定时器实现
  * @note 空间复杂度: O(LVL_DEPTH * 2^LVL_BITS * sizeof(std::list)) <br />
  *       每次tick的最低时间复杂度: O(LVL_DEPTH) <br />
+ *       计算下一个到期时间(next_expire_tick)的时间复杂度: O(LVL_DEPTH * 2^LVL_BITS / 64) <br />
  *       每层定时器误差倍数: 2^LVL_CLK_SHIFT <br />
  *       最大定时器范围: 2^(LVL_CLK_SHIFT * (LVL_DEPTH - 1) + LVL_BITS) * tick周期 <br />
  * @note 如果外部需要引用定时器对象，请使用 timer_t 代替函数签名中的 timer_type
@@ -118,6 +121,11 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
     return static_cast<time_t>(static_cast<time_t>(LVL_SIZE) << ((n - 1) * LVL_CLK_SHIFT));
   }
 
+  enum occupied_consts {
+    OCCUPIED_WORD_BITS = 64,
+    OCCUPIED_WORDS = (LVL_SIZE + OCCUPIED_WORD_BITS - 1) / OCCUPIED_WORD_BITS,  // 每层占用位图的uint64_t数量
+  };
+
  private:
   struct timer_type;
 
@@ -168,7 +176,9 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
   };
 
  public:
-  jiffies_timer() : last_tick_(0), seq_alloc_(0), size_(0), private_data_(nullptr) {}
+  jiffies_timer() : last_tick_(0), seq_alloc_(0), size_(0), private_data_(nullptr) {
+    memset(occupied_, 0, sizeof(occupied_));
+  }
 
   /**
    * @brief 初始化定时器
@@ -418,7 +428,13 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
     }
 
     while (last_tick_ < expires) {
-      ++last_tick_;
+      // 中间的tick所有要检查的时间槽都是空的，直接跳过
+      time_t next_tick = next_expire_tick();
+      if (next_tick > expires) {
+        last_tick_ = expires;
+        break;
+      }
+      last_tick_ = next_tick;
 
       size_t list_sz = collect_expired_timers(last_tick_, timer_list);
       while (list_sz > 0) {
@@ -459,6 +475,9 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
             }
           } else {
             timer_list[list_sz]->erase(timer_list[list_sz]->begin());
+            if (timer_list[list_sz]->empty()) {
+              set_occupied(static_cast<size_t>(timer_list[list_sz] - timer_base_), false);
+            }
           }
         }
       }
@@ -467,6 +486,15 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
     return ret;
   }
 
+  /**
+   * @brief 获取下一次有定时器要处理的tick，可用于计算事件循环的休眠时间
+   * @note 返回的是下一个非空时间槽被检查的时间，不会晚于其中任何定时器的触发时间。
+   *       高层级的时间槽被检查时可能只是把定时器降级而不触发，这时再次调用即可得到更准确的时间。
+   * @note 在两次 tick() 之间添加或删除定时器后需要重新获取
+   * @return 下一次有定时器要处理的tick（绝对时间），没有定时器时返回 get_last_tick() + get_max_tick_distance() + 1
+   */
+  ATFW_UTIL_FORCEINLINE time_t next_expire_tick() const noexcept { return calc_next_expire_tick(occupied_, last_tick_); }
+
   /**
    * @brief 获取最后一次定时器滴答时间（当前定时器时间）
    * @return 最后一次定时器滴答时间（当前定时器时间）
@@ -510,6 +538,62 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
     return LVL_OFFS(lvl) + static_cast<size_t>(expires & LVL_MASK);
   }
 
+  /**
+   * @brief 从start开始循环查找占用位图中第一个非空的时间槽
+   * @param lvl_occupied 一个层级的占用位图
+   * @param start 起始时间槽
+   * @return 非空时间槽相对于start的偏移，没有找到时返回LVL_SIZE
+   */
+  static size_t find_occupied_offset(const uint64_t lvl_occupied[OCCUPIED_WORDS], size_t start) noexcept {
+    size_t start_word = start / OCCUPIED_WORD_BITS;
+    uint64_t start_mask = ~static_cast<uint64_t>(0) << (start % OCCUPIED_WORD_BITS);
+    // 多检查一次起始的uint64_t，用于找到start之前的时间槽
+    for (size_t i = 0; i <= static_cast<size_t>(OCCUPIED_WORDS); ++i) {
+      size_t word = (start_word + i) % OCCUPIED_WORDS;
+      uint64_t bits = lvl_occupied[word];
+      if (0 == i) {
+        bits &= start_mask;
+      } else if (static_cast<size_t>(OCCUPIED_WORDS) == i) {
+        bits &= ~start_mask;
+      }
+
+      if (0 != bits) {
+        size_t slot = word * OCCUPIED_WORD_BITS + static_cast<size_t>(bit::countr_zero(bits));
+        return (slot + LVL_SIZE - start) & LVL_MASK;
+      }
+    }
+
+    return LVL_SIZE;
+  }
+
+  /**
+   * @brief 根据占用位图计算下一个非空时间槽被检查的tick
+   * @param occupied 所有层级的占用位图
+   * @param clk 当前定时器时间
+   * @return 下一个非空时间槽被检查的tick，没有定时器时返回 clk + get_max_tick_distance() + 1
+   */
+  static time_t calc_next_expire_tick(const uint64_t occupied[LVL_DEPTH][OCCUPIED_WORDS], time_t clk) noexcept {
+    time_t ret = clk + get_max_tick_distance() + 1;
+    for (size_t lvl = 0; lvl < LVL_DEPTH; ++lvl) {
+      time_t shift = LVL_SHIFT(static_cast<time_t>(lvl));
+      time_t next_clk = (clk >> shift) + 1;
+      // 更高层级的检查时间不会早于本层的下一次检查时间
+      if (ret <= (next_clk << shift)) {
+        break;
+      }
+
+      size_t offset = find_occupied_offset(occupied[lvl], static_cast<size_t>(next_clk & LVL_MASK));
+      if (offset < static_cast<size_t>(LVL_SIZE)) {
+        time_t lvl_tick = (next_clk + static_cast<time_t>(offset)) << shift;
+        if (lvl_tick < ret) {
+          ret = lvl_tick;
+        }
+      }
+    }
+
+    return ret;
+  }
+
   static size_t calc_wheel_index(time_t expires, time_t clk) noexcept {
     assert(expires > clk);
     time_t delta = expires - clk;
@@ -555,6 +639,10 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
         timer.owner_round->erase(timer.owner_iter);
       }
 
+      if (nullptr != timer.owner && timer.owner_round->empty()) {
+        timer.owner->set_occupied(timer.owner_idx, false);
+      }
+
       timer.owner_iter = timer.owner_round->end();
       timer.owner_round = nullptr;
     }
@@ -585,11 +673,23 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
     timer_inst->owner = this;
     timer_inst->owner_idx = idx;
     unset_timer_flags(*timer_inst, timer_flag_t::EN_JTTF_REMOVED);
+    set_occupied(idx, true);
 
     ++size_;
   }
 
  private:
+  ATFW_UTIL_FORCEINLINE void set_occupied(size_t idx, bool occupied) noexcept {
+    size_t lvl = idx / LVL_SIZE;
+    size_t slot = idx & LVL_MASK;
+    uint64_t mask = static_cast<uint64_t>(1) << (slot % OCCUPIED_WORD_BITS);
+    if (occupied) {
+      occupied_[lvl][slot / OCCUPIED_WORD_BITS] |= mask;
+    } else {
+      occupied_[lvl][slot / OCCUPIED_WORD_BITS] &= ~mask;
+    }
+  }
+
   size_t collect_expired_timers(time_t tick_time, std::list<timer_ptr_t> *timer_list[LVL_DEPTH]) noexcept {
     size_t ret = 0;
     bool active_level = true;
@@ -611,6 +711,7 @@ class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer {
   time_t last_tick_;
   std::bitset<flag_t::EN_JTFT_MAX> flags_;
   std::list<timer_ptr_t> timer_base_[WHEEL_SIZE];
+  uint64_t occupied_[LVL_DEPTH][OCCUPIED_WORDS];  // 每个时间槽是否非空的位图
   uint32_t seq_alloc_;
   size_t size_;
   void *private_data_;
@@ -0,0 +1,350 @@
+// Copyright 2026 atframework
+//
+// @file jiffies_timer_service.h
+// @brief Thread-safe front end of jiffies_timer
+// Licensed under the MIT licenses.
+//
+// @note jiffies_timer must be driven by one thread. jiffies_timer_service keeps this thread(the owner thread) but lets
+//       any thread add or cancel timers:
+//       1. add_timer()/cancel_timer() push commands into a lock-free MPSC queue and never touch the wheel.
+//       2. tick() is called by the owner thread, it applies all queued commands and then ticks the wheel.
+//       3. Expired callbacks are called on the owner thread, or on a worker pool if worker threads are set.
+
+#pragma once
+
+#include <config/compile_optimize.h>
+#include <config/compiler_features.h>
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <nostd/type_traits.h>
+#include <time/jiffies_timer.h>
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace time {
+/**
+ * @brief Thread-safe timer service around jiffies_timer
+ * @note add_timer(), cancel_timer() and get_last_tick() can be called from any thread, all other APIs must be called by
+ *       the owner thread which calls tick().
+ * @note Commands are applied at the start of the next tick(), so the delta of add_timer() is relative to the last tick
+ *       when it's applied, and a timer may still fire if it's cancelled after the tick which expires it.
+ * @note Callbacks already queued to the worker pool can not be cancelled.
+ */
+template <time_t LVL_BITS = 6, time_t LVL_CLK_SHIFT = 3, size_t LVL_DEPTH = 8>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY jiffies_timer_service {
+ public:
+  using wheel_type = jiffies_timer<LVL_BITS, LVL_CLK_SHIFT, LVL_DEPTH>;
+  using error_type_t = typename wheel_type::error_type_t;
+  using timer_flag_t = typename wheel_type::timer_flag_t;
+
+  using timer_id_t = uint64_t;  // 0 means invalid timer id
+  using timer_callback_fn_t = std::function<void(time_t tick_time, timer_id_t timer_id)>;
+
+ private:
+  struct command_type {
+    enum type {
+      EN_CT_ADD = 0,
+      EN_CT_CANCEL,
+    };
+  };
+
+  struct command_node {
+    std::atomic<command_node *> next;
+    typename command_type::type type;
+    timer_id_t timer_id;
+    time_t delta;
+    timer_callback_fn_t fn;
+
+    command_node() noexcept : next(nullptr), type(command_type::EN_CT_ADD), timer_id(0), delta(0) {}
+  };
+
+  struct worker_job {
+    time_t tick_time;
+    timer_id_t timer_id;
+    timer_callback_fn_t fn;
+  };
+
+  // Callback stored in the wheel, forward the user callback to the owner thread or the worker pool
+  struct timer_dispatcher {
+    jiffies_timer_service *owner;
+    timer_id_t timer_id;
+    timer_callback_fn_t fn;
+
+    void operator()(time_t tick_time, const typename wheel_type::timer_t &) {
+      owner->dispatch(tick_time, timer_id, std::move(fn));
+    }
+  };
+
+ public:
+  /**
+   * @brief Constructor
+   * @param worker_threads Count of worker threads to run expired callbacks, 0 means running them in tick()
+   */
+  explicit jiffies_timer_service(size_t worker_threads = 0)
+      : inited_(false),
+        last_tick_(0),
+        timer_id_alloc_(0),
+        queue_head_(&queue_stub_),
+        queue_tail_(&queue_stub_),
+        workers_stop_(false) {
+    workers_.reserve(worker_threads);
+    for (size_t i = 0; i < worker_threads; ++i) {
+      workers_.emplace_back([this]() { worker_main(); });
+    }
+  }
+
+  ~jiffies_timer_service() {
+    stop_workers();
+
+    command_node *command;
+    while (nullptr != (command = pop_command())) {
+      delete command;
+    }
+  }
+
+  jiffies_timer_service(const jiffies_timer_service &) = delete;
+  jiffies_timer_service &operator=(const jiffies_timer_service &) = delete;
+
+  /**
+   * @brief 初始化定时器
+   * @param init_tick 初始定时器tick数（绝对时间），定时器将从这个时间开始触发
+   * @return 0或错误码
+   */
+  int init(time_t init_tick) noexcept {
+    int ret = wheel_.init(init_tick);
+    if (error_type_t::EN_JTET_SUCCESS == ret) {
+      last_tick_.store(init_tick, std::memory_order_release);
+      inited_.store(true, std::memory_order_release);
+    }
+    return ret;
+  }
+
+  /**
+   * @brief 添加定时器，可以在任意线程调用
+   * @param delta 定时器间隔，相对于命令在tick()中被执行时的定时器时间
+   * @param fn 定时器回调函数，签名为 void(time_t tick_time, timer_id_t timer_id)
+   * @param out_timer_id 如果非空，输出定时器ID，用于cancel_timer
+   * @return 0或错误码，未初始化时返回 EN_JTET_NOT_INITED
+   */
+  template <class TCALLBACK>
+  int add_timer(time_t delta, TCALLBACK &&fn, timer_id_t *out_timer_id = nullptr) {
+    // The command would be dropped by the wheel when it's applied
+    if (!inited_.load(std::memory_order_acquire)) {
+      return error_type_t::EN_JTET_NOT_INITED;
+    }
+
+    if (delta > get_max_tick_distance()) {
+      return error_type_t::EN_JTET_TIMEOUT_EXTENDED;
+    }
+
+    command_node *command = new command_node();
+    command->type = command_type::EN_CT_ADD;
+    command->timer_id = timer_id_alloc_.fetch_add(1, std::memory_order_relaxed) + 1;
+    command->delta = delta;
+    command->fn = timer_callback_fn_t(std::forward<TCALLBACK>(fn));
+    if (nullptr != out_timer_id) {
+      *out_timer_id = command->timer_id;
+    }
+
+    push_command(command);
+    return error_type_t::EN_JTET_SUCCESS;
+  }
+
+  /**
+   * @brief 删除定时器，可以在任意线程调用
+   * @param timer_id add_timer输出的定时器ID
+   * @return 是否提交了删除命令，定时器已经触发或不存在时命令会被忽略
+   */
+  bool cancel_timer(timer_id_t timer_id) {
+    if (0 == timer_id) {
+      return false;
+    }
+
+    command_node *command = new command_node();
+    command->type = command_type::EN_CT_CANCEL;
+    command->timer_id = timer_id;
+
+    push_command(command);
+    return true;
+  }
+
+  /**
+   * @brief 定时器滴答，只能在所属线程调用
+   * @param expires 到期的定时器时间（绝对时间）
+   * @return 错误码或触发的定时器数量（包括交给工作线程执行的定时器）
+   */
+  int tick(time_t expires) {
+    apply_commands();
+
+    int ret = wheel_.tick(expires);
+    last_tick_.store(wheel_.get_last_tick(), std::memory_order_release);
+    return ret;
+  }
+
+  /**
+   * @brief Wait for all callbacks queued to the worker pool and join the worker threads
+   * @note Callbacks expired by later tick() will be called by the owner thread
+   */
+  void stop_workers() {
+    {
+      std::lock_guard<std::mutex> guard(workers_lock_);
+      workers_stop_ = true;
+    }
+    workers_cond_.notify_all();
+
+    for (auto &worker : workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+    workers_.clear();
+  }
+
+  /**
+   * @brief 获取最后一次定时器滴答时间（当前定时器时间），可以在任意线程调用
+   */
+  ATFW_UTIL_FORCEINLINE time_t get_last_tick() const noexcept { return last_tick_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 获取已生效的定时器数量，只能在所属线程调用
+   */
+  ATFW_UTIL_FORCEINLINE size_t size() const noexcept { return wheel_.size(); }
+
+  ATFW_UTIL_FORCEINLINE size_t get_worker_count() const noexcept { return workers_.size(); }
+
+  ATFW_UTIL_FORCEINLINE constexpr static time_t get_max_tick_distance() { return wheel_type::get_max_tick_distance(); }
+
+ private:
+  // Vyukov's intrusive MPSC queue, producers only do one exchange and one store
+  void push_command(command_node *command) noexcept {
+    command->next.store(nullptr, std::memory_order_relaxed);
+    command_node *prev = queue_head_.exchange(command, std::memory_order_acq_rel);
+    prev->next.store(command, std::memory_order_release);
+  }
+
+  // Only called by the owner thread, returns nullptr if the queue is empty or a producer is pushing the last command
+  command_node *pop_command() noexcept {
+    command_node *tail = queue_tail_;
+    command_node *next = tail->next.load(std::memory_order_acquire);
+    if (tail == &queue_stub_) {
+      if (nullptr == next) {
+        return nullptr;
+      }
+      queue_tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (nullptr != next) {
+      queue_tail_ = next;
+      return tail;
+    }
+
+    if (tail != queue_head_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+
+    push_command(&queue_stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (nullptr != next) {
+      queue_tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+  void apply_commands() {
+    command_node *command;
+    while (nullptr != (command = pop_command())) {
+      if (command_type::EN_CT_ADD == command->type) {
+        typename wheel_type::timer_wptr_t watcher;
+        int res = wheel_.add_timer(command->delta, timer_dispatcher{this, command->timer_id, std::move(command->fn)},
+                                   nullptr, &watcher);
+        if (error_type_t::EN_JTET_SUCCESS == res) {
+          timers_[command->timer_id] = std::move(watcher);
+        }
+      } else {
+        auto iter = timers_.find(command->timer_id);
+        if (iter != timers_.end()) {
+          typename wheel_type::timer_ptr_t timer = iter->second.lock();
+          timers_.erase(iter);
+          if (timer) {
+            wheel_type::set_timer_flags(*timer, timer_flag_t::EN_JTTF_DISABLED);
+            wheel_type::remove_timer(*timer);
+          }
+        }
+      }
+
+      delete command;
+    }
+  }
+
+  void dispatch(time_t tick_time, timer_id_t timer_id, timer_callback_fn_t &&fn) {
+    timers_.erase(timer_id);
+    if (!fn) {
+      return;
+    }
+
+    if (workers_.empty()) {
+      fn(tick_time, timer_id);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(workers_lock_);
+      worker_jobs_.push_back(worker_job{tick_time, timer_id, std::move(fn)});
+    }
+    workers_cond_.notify_one();
+  }
+
+  void worker_main() {
+    while (true) {
+      worker_job job;
+      {
+        std::unique_lock<std::mutex> guard(workers_lock_);
+        workers_cond_.wait(guard, [this]() { return workers_stop_ || !worker_jobs_.empty(); });
+        // Finish all queued jobs before exit
+        if (worker_jobs_.empty()) {
+          return;
+        }
+
+        job = std::move(worker_jobs_.front());
+        worker_jobs_.pop_front();
+      }
+
+      job.fn(job.tick_time, job.timer_id);
+    }
+  }
+
+ private:
+  wheel_type wheel_;
+  std::atomic<bool> inited_;
+  std::atomic<time_t> last_tick_;
+  std::unordered_map<timer_id_t, typename wheel_type::timer_wptr_t> timers_;
+
+  std::atomic<timer_id_t> timer_id_alloc_;
+  command_node queue_stub_;
+  std::atomic<command_node *> queue_head_;  // Pushed by producers
+  command_node *queue_tail_;                // Popped by the owner thread
+
+  std::vector<std::thread> workers_;
+  std::mutex workers_lock_;
+  std::condition_variable workers_cond_;
+  std::deque<worker_job> worker_jobs_;
+  bool workers_stop_;
+};
+}  // namespace time
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -0,0 +1,560 @@
+// Copyright 2026 atframework
+//
+// @file pooled_jiffies_timer.h
+// @brief jiffies_timer with pooled timer nodes
+// Licensed under the MIT licenses.
+//
+// @note The wheel is the same as jiffies_timer, but:
+//       1. Timer nodes are allocated from chunks owned by the timer and reused after fired or cancelled.
+//       2. Buckets are intrusive doubly-linked lists, inserting and removing a timer never allocate.
+//       3. Callbacks are stored in an inline slot of the node, instead of std::function.
+//       So add/cancel/fire do no heap allocation when the pool is warm(or reserve() is called).
+
+#pragma once
+
+#include <config/compile_optimize.h>
+#include <config/compiler_features.h>
+
+#include <config/atframe_utils_build_feature.h>
+
+#include <nostd/type_traits.h>
+#include <time/jiffies_timer.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace time {
+/**
+ * @brief jiffies timer with pooled timer nodes and inline callbacks
+ * @note Callbacks must be nothrow constructible, no larger than CALLBACK_STORAGE_SIZE and be invoked as
+ *       void(time_t tick_time, const timer_t &timer). Store a pointer(or nostd::function_ref) to larger objects.
+ * @note Timers are referred by timer_handle_t instead of weak pointers. A handle becomes invalid once the timer is
+ *       fired or cancelled, even if its node is reused by another timer.
+ */
+template <time_t LVL_BITS = 6, time_t LVL_CLK_SHIFT = 3, size_t LVL_DEPTH = 8,
+          size_t CALLBACK_STORAGE_SIZE = 4 * sizeof(void *)>
+class ATFRAMEWORK_UTILS_API_HEAD_ONLY pooled_jiffies_timer {
+ public:
+  using wheel_type = jiffies_timer<LVL_BITS, LVL_CLK_SHIFT, LVL_DEPTH>;
+  using error_type_t = typename wheel_type::error_type_t;
+  using timer_flag_t = typename wheel_type::timer_flag_t;
+
+  enum lvl_consts {
+    LVL_SIZE = wheel_type::LVL_SIZE,
+    LVL_MASK = wheel_type::LVL_MASK,
+    WHEEL_SIZE = wheel_type::WHEEL_SIZE,
+    LVL_CLK_MASK = wheel_type::LVL_CLK_MASK,
+    OCCUPIED_WORDS = wheel_type::OCCUPIED_WORDS,
+  };
+
+  enum pool_consts {
+    NODE_CHUNK_SHIFT = 8,
+    NODE_CHUNK_SIZE = 1 << NODE_CHUNK_SHIFT,
+    NODE_CHUNK_MASK = NODE_CHUNK_SIZE - 1,
+  };
+
+ private:
+  struct timer_link_t {
+    timer_link_t *prev;
+    timer_link_t *next;
+  };
+
+  struct timer_type;
+
+  using callback_storage_t = nostd::aligned_storage_t<CALLBACK_STORAGE_SIZE, alignof(::std::max_align_t)>;
+  using callback_invoke_fn_t = void (*)(callback_storage_t &, time_t, const timer_type &);
+  using callback_destroy_fn_t = void (*)(callback_storage_t &);
+
+  struct timer_type : public timer_link_t {
+    mutable uint32_t flags;         // 定时器标记位
+    uint32_t sequence;              // 定时器序号，0表示节点空闲
+    uint32_t index;                 // 节点在池中的下标
+    time_t timeout;                 // 原始的超时时间
+    void *private_data;             // 私有数据指针
+    size_t owner_idx;               // 所在时间轮下标
+    callback_invoke_fn_t invoke;    // 回调函数
+    callback_destroy_fn_t destroy;  // 回调函数析构
+    callback_storage_t fn_storage;  // 回调函数对象
+  };  // 外部请勿直接访问内部成员，只允许通过API访问
+
+ public:
+  using timer_t = timer_type;  // 外部请勿直接访问内部成员，只允许通过API访问
+
+  struct timer_handle_t {
+    uint32_t index;
+    uint32_t sequence;  // 0 means invalid handle
+
+    UTIL_CONFIG_CONSTEXPR timer_handle_t() noexcept : index(0), sequence(0) {}
+  };
+
+ public:
+  pooled_jiffies_timer() noexcept
+      : inited_(false), last_tick_(0), seq_alloc_(0), size_(0), free_list_(nullptr), tick_guard_(nullptr) {
+    for (size_t i = 0; i < WHEEL_SIZE; ++i) {
+      reset_bucket(timer_base_[i]);
+    }
+    memset(occupied_, 0, sizeof(occupied_));
+  }
+
+  ~pooled_jiffies_timer() { clear(); }
+
+  pooled_jiffies_timer(const pooled_jiffies_timer &) = delete;
+  pooled_jiffies_timer &operator=(const pooled_jiffies_timer &) = delete;
+
+  /**
+   * @brief 初始化定时器
+   * @param init_tick 初始定时器tick数（绝对时间），定时器将从这个时间开始触发
+   * @return 0或错误码
+   */
+  int init(time_t init_tick) noexcept {
+    if (inited_) {
+      return error_type_t::EN_JTET_ALREADY_INITED;
+    }
+    inited_ = true;
+
+    last_tick_ = init_tick;
+    seq_alloc_ = 0;
+    size_ = 0;
+
+    return error_type_t::EN_JTET_SUCCESS;
+  }
+
+  /**
+   * @brief Preallocate nodes, so add_timer will not allocate until there are more than count timers
+   * @param count Total count of timer nodes
+   */
+  void reserve(size_t count) {
+    while (get_capacity() < count) {
+      allocate_chunk();
+    }
+  }
+
+  /**
+   * @brief Remove all timers without calling them, nodes are kept for reuse
+   */
+  void clear() noexcept {
+    for (size_t i = 0; i < WHEEL_SIZE; ++i) {
+      release_bucket(timer_base_[i]);
+    }
+    // 在回调里调用时，还要释放 tick() 临时链表中的定时器
+    for (tick_guard_t *guard = tick_guard_; nullptr != guard; guard = guard->parent) {
+      release_bucket(guard->pending);
+    }
+    memset(occupied_, 0, sizeof(occupied_));
+    size_ = 0;
+  }
+
+  /**
+   * @brief 添加定时器
+   * @param delta 定时器间隔，相对时间（向下取整，即如果应该是3.8个后tick触发，这里应该取3）
+   * @param fn 定时器回掉函数，签名为 void(time_t tick_time, const timer_t &timer)
+   * @param priv_data 私有数据指针
+   * @param handle 如果非空，用于以后查询或取消定时器
+   * @note 触发时机和 jiffies_timer::add_timer 相同
+   * @return 0或错误码
+   */
+  template <class TCALLBACK>
+  int add_timer(time_t delta, TCALLBACK &&fn, void *priv_data, timer_handle_t *handle = nullptr) {
+    using callback_type = typename ::std::decay<TCALLBACK>::type;
+    UTIL_CONFIG_STATIC_ASSERT_MSG(sizeof(callback_type) <= CALLBACK_STORAGE_SIZE,
+                                  "callback is too large, store a pointer to it instead");
+    UTIL_CONFIG_STATIC_ASSERT_MSG(alignof(callback_type) <= alignof(::std::max_align_t),
+                                  "callback is over-aligned");
+    UTIL_CONFIG_STATIC_ASSERT_MSG((::std::is_nothrow_constructible<callback_type, TCALLBACK &&>::value),
+                                  "callback must be nothrow constructible");
+
+    if (!inited_) {
+      return error_type_t::EN_JTET_NOT_INITED;
+    }
+
+    if (delta > get_max_tick_distance()) {
+      return error_type_t::EN_JTET_TIMEOUT_EXTENDED;
+    }
+
+    // must greater than 0
+    if (delta <= 0) {
+      delta = 1;
+    }
+
+    timer_type *timer = acquire_node();
+    timer->flags = 0;
+    timer->timeout = last_tick_ + delta;
+    timer->private_data = priv_data;
+    timer->owner_idx = static_cast<size_t>(-1);
+    while (0 == ++seq_alloc_) {
+    }
+    timer->sequence = seq_alloc_;
+
+    new (&timer->fn_storage) callback_type(std::forward<TCALLBACK>(fn));
+    timer->invoke = &invoke_callback<callback_type>;
+    timer->destroy = &destroy_callback<callback_type>;
+
+    if (nullptr != handle) {
+      handle->index = timer->index;
+      handle->sequence = timer->sequence;
+    }
+
+    insert_timer(*timer);
+    return error_type_t::EN_JTET_SUCCESS;
+  }
+
+  /**
+   * @brief 取消定时器
+   * @param handle add_timer 返回的句柄
+   * @return 定时器未触发且被取消时返回true
+   */
+  bool cancel_timer(const timer_handle_t &handle) noexcept {
+    timer_type *timer = find_timer(handle);
+    if (nullptr == timer || nullptr == timer->next) {
+      return false;
+    }
+
+    unlink(*timer);
+    // 定时器可能在 tick() 的临时链表中，所以要检查所属时间轮是否真的空了
+    if (timer->owner_idx < static_cast<size_t>(WHEEL_SIZE) &&
+        timer_base_[timer->owner_idx].next == &timer_base_[timer->owner_idx]) {
+      set_occupied(timer->owner_idx, false);
+    }
+    --size_;
+    release_node(*timer);
+    return true;
+  }
+
+  /**
+   * @brief 查找未触发的定时器
+   * @param handle add_timer 返回的句柄
+   * @return 定时器，已触发或已取消时返回nullptr
+   */
+  const timer_type *find_timer(const timer_handle_t &handle) const noexcept {
+    if (0 == handle.sequence || handle.index >= get_capacity()) {
+      return nullptr;
+    }
+
+    const timer_type &timer = node_at(handle.index);
+    if (timer.sequence != handle.sequence) {
+      return nullptr;
+    }
+    return &timer;
+  }
+
+  /**
+   * @brief 查找未触发的定时器
+   * @param handle add_timer 返回的句柄
+   * @return 定时器，已触发或已取消时返回nullptr
+   */
+  timer_type *find_timer(const timer_handle_t &handle) noexcept {
+    return const_cast<timer_type *>(static_cast<const pooled_jiffies_timer *>(this)->find_timer(handle));
+  }
+
+  /**
+   * @brief 定时器滴答
+   * @param expires 到期的定时器时间（绝对时间）
+   * @note 回调抛出异常时，未触发的定时器保留在时间轮中，last_tick_ 回退到异常所在帧的前一帧
+   * @return 错误码或触发的定时器数量
+   */
+  int tick(time_t expires) {
+    timer_link_t *timer_list[LVL_DEPTH];
+    int ret = 0;
+
+    if (!inited_) {
+      return error_type_t::EN_JTET_NOT_INITED;
+    }
+
+    while (last_tick_ < expires) {
+      // 中间的tick所有要检查的时间槽都是空的，直接跳过
+      time_t next_tick = next_expire_tick();
+      if (next_tick > expires) {
+        last_tick_ = expires;
+        break;
+      }
+      last_tick_ = next_tick;
+
+      size_t list_sz = collect_expired_timers(last_tick_, timer_list);
+      while (list_sz > 0) {
+        --list_sz;
+        // 从高层级往低层级走，这样能保证定时器时序
+        // 先把整个时间轮挪到临时链表，降级的定时器可能会被重新插入到同一个时间轮
+        tick_guard_t guard(*this, *timer_list[list_sz]);
+
+        while (guard.pending.next != &guard.pending) {
+          // 回调里可能取消 pending 中的其他定时器，所以每次都从头部取
+          timer_type *timer = static_cast<timer_type *>(guard.pending.next);
+          unlink(*timer);
+
+          if (timer->timeout > last_tick_) {
+            timer->owner_idx = wheel_type::calc_wheel_index(timer->timeout, last_tick_);
+            link_tail(timer_base_[timer->owner_idx], *timer);
+            set_occupied(timer->owner_idx, true);
+            continue;
+          }
+
+          --size_;
+          if (!(timer->flags & timer_flag_t::EN_JTTF_DISABLED)) {
+            guard.firing = timer;
+            timer->invoke(timer->fn_storage, last_tick_, *timer);
+            guard.firing = nullptr;
+            ++ret;
+          }
+          release_node(*timer);
+        }
+      }
+    }
+
+    return ret;
+  }
+
+  /**
+   * @brief 获取下一次有定时器要处理的tick，可用于计算事件循环的休眠时间
+   * @note 和 jiffies_timer::next_expire_tick 相同
+   */
+  ATFW_UTIL_FORCEINLINE time_t next_expire_tick() const noexcept {
+    return wheel_type::calc_next_expire_tick(occupied_, last_tick_);
+  }
+
+  /**
+   * @brief 获取最后一次定时器滴答时间（当前定时器时间）
+   */
+  ATFW_UTIL_FORCEINLINE time_t get_last_tick() const noexcept { return last_tick_; }
+
+  /**
+   * @brief 获取定时器数量
+   */
+  ATFW_UTIL_FORCEINLINE size_t size() const noexcept { return size_; }
+
+  /**
+   * @brief 获取已分配的定时器节点数量
+   */
+  ATFW_UTIL_FORCEINLINE size_t get_capacity() const noexcept { return chunks_.size() * NODE_CHUNK_SIZE; }
+
+  /**
+   * @brief 获取当前定时器类型的最大时间范围（tick）
+   */
+  ATFW_UTIL_FORCEINLINE constexpr static time_t get_max_tick_distance() { return wheel_type::get_max_tick_distance(); }
+
+ public:
+  ATFW_UTIL_FORCEINLINE static void *get_timer_private_data(const timer_type &timer) noexcept {
+    return timer.private_data;
+  }
+  ATFW_UTIL_FORCEINLINE static void *set_timer_private_data(timer_type &timer, void *priv_data) noexcept {
+    void *old_value = timer.private_data;
+    timer.private_data = priv_data;
+    return old_value;
+  }
+  ATFW_UTIL_FORCEINLINE static uint32_t get_timer_sequence(const timer_type &timer) noexcept { return timer.sequence; }
+  ATFW_UTIL_FORCEINLINE static size_t get_timer_wheel_index(const timer_type &timer) noexcept {
+    return timer.owner_idx;
+  }
+  ATFW_UTIL_FORCEINLINE static time_t get_timer_timeout(const timer_type &timer) noexcept { return timer.timeout; }
+  ATFW_UTIL_FORCEINLINE static bool check_timer_flags(const timer_type &timer, typename timer_flag_t::type f) noexcept {
+    return !!(timer.flags & static_cast<uint32_t>(f));
+  }
+  ATFW_UTIL_FORCEINLINE static void set_timer_flags(const timer_type &timer, typename timer_flag_t::type f) noexcept {
+    timer.flags |= static_cast<uint32_t>(f);
+  }
+  ATFW_UTIL_FORCEINLINE static void unset_timer_flags(const timer_type &timer, typename timer_flag_t::type f) noexcept {
+    timer.flags &= ~static_cast<uint32_t>(f);
+  }
+
+ private:
+  // tick() 中正在处理的时间轮，回调抛出异常时把未处理的定时器放回原来的时间轮，并回退 last_tick_
+  // 这样下一次 tick() 会重新处理这一帧，其他定时器不会被推迟
+  // 用链表串起来是为了支持在回调里调用 clear() 和嵌套调用 tick()
+  struct tick_guard_t {
+    pooled_jiffies_timer &owner;
+    timer_link_t &bucket;
+    tick_guard_t *parent;
+    timer_type *firing;
+    time_t tick_time;
+    timer_link_t pending;
+
+    tick_guard_t(pooled_jiffies_timer &o, timer_link_t &b) noexcept
+        : owner(o), bucket(b), parent(o.tick_guard_), firing(nullptr), tick_time(o.last_tick_) {
+      reset_bucket(pending);
+      splice(pending, bucket);
+      owner.set_occupied(static_cast<size_t>(&bucket - owner.timer_base_), false);
+      owner.tick_guard_ = this;
+    }
+
+    ~tick_guard_t() {
+      owner.tick_guard_ = parent;
+      // 只有回调会抛出异常，正常结束时 firing 和 pending 都是空的
+      if (nullptr == firing) {
+        return;
+      }
+      owner.release_node(*firing);
+
+      // 保持原来的顺序放回时间轮头部
+      if (pending.next != &pending) {
+        splice(pending, bucket);
+        splice(bucket, pending);
+        owner.set_occupied(static_cast<size_t>(&bucket - owner.timer_base_), true);
+      }
+      // tick() 总是会检查超时时间，重新处理这一帧不会提前触发定时器
+      owner.last_tick_ = tick_time - 1;
+    }
+
+    tick_guard_t(const tick_guard_t &) = delete;
+    tick_guard_t &operator=(const tick_guard_t &) = delete;
+  };
+
+  template <class TCALLBACK>
+  static void invoke_callback(callback_storage_t &storage, time_t tick_time, const timer_type &timer) {
+    (*reinterpret_cast<TCALLBACK *>(&storage))(tick_time, timer);
+  }
+
+  template <class TCALLBACK>
+  static void destroy_callback(callback_storage_t &storage) noexcept {
+    reinterpret_cast<TCALLBACK *>(&storage)->~TCALLBACK();
+  }
+
+  ATFW_UTIL_FORCEINLINE static void reset_bucket(timer_link_t &bucket) noexcept {
+    bucket.prev = &bucket;
+    bucket.next = &bucket;
+  }
+
+  ATFW_UTIL_FORCEINLINE static void link_tail(timer_link_t &bucket, timer_link_t &node) noexcept {
+    node.prev = bucket.prev;
+    node.next = &bucket;
+    bucket.prev->next = &node;
+    bucket.prev = &node;
+  }
+
+  ATFW_UTIL_FORCEINLINE static void unlink(timer_link_t &node) noexcept {
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev = nullptr;
+    node.next = nullptr;
+  }
+
+  // Move all nodes of from to the tail of to
+  static void splice(timer_link_t &to, timer_link_t &from) noexcept {
+    if (from.next == &from) {
+      return;
+    }
+
+    from.next->prev = to.prev;
+    to.prev->next = from.next;
+    from.prev->next = &to;
+    to.prev = from.prev;
+    reset_bucket(from);
+  }
+
+  ATFW_UTIL_FORCEINLINE timer_type &node_at(uint32_t index) noexcept {
+    return chunks_[index >> NODE_CHUNK_SHIFT][index & NODE_CHUNK_MASK];
+  }
+
+  ATFW_UTIL_FORCEINLINE const timer_type &node_at(uint32_t index) const noexcept {
+    return chunks_[index >> NODE_CHUNK_SHIFT][index & NODE_CHUNK_MASK];
+  }
+
+  void allocate_chunk() {
+    uint32_t base_index = static_cast<uint32_t>(get_capacity());
+    chunks_.emplace_back(new timer_type[NODE_CHUNK_SIZE]);
+    timer_type *chunk = chunks_.back().get();
+
+    // Push in reverse order, so nodes are acquired in memory order
+    for (size_t i = NODE_CHUNK_SIZE; i > 0; --i) {
+      timer_type &node = chunk[i - 1];
+      node.prev = nullptr;
+      node.next = nullptr;
+      node.sequence = 0;
+      node.index = base_index + static_cast<uint32_t>(i - 1);
+      node.invoke = nullptr;
+      node.destroy = nullptr;
+      node.prev = free_list_;
+      free_list_ = &node;
+    }
+  }
+
+  // Free nodes are linked by prev, next is always nullptr for nodes not in any bucket
+  timer_type *acquire_node() {
+    if (nullptr == free_list_) {
+      allocate_chunk();
+    }
+
+    timer_type *ret = static_cast<timer_type *>(free_list_);
+    free_list_ = ret->prev;
+    ret->prev = nullptr;
+    return ret;
+  }
+
+  void release_bucket(timer_link_t &bucket) noexcept {
+    while (bucket.next != &bucket) {
+      timer_type *timer = static_cast<timer_type *>(bucket.next);
+      unlink(*timer);
+      release_node(*timer);
+    }
+  }
+
+  void release_node(timer_type &timer) noexcept {
+    if (nullptr != timer.destroy) {
+      timer.destroy(timer.fn_storage);
+      timer.destroy = nullptr;
+      timer.invoke = nullptr;
+    }
+    timer.sequence = 0;
+    timer.owner_idx = static_cast<size_t>(-1);
+    timer.next = nullptr;
+    timer.prev = free_list_;
+    free_list_ = &timer;
+  }
+
+  void insert_timer(timer_type &timer) noexcept {
+    size_t idx = wheel_type::calc_wheel_index(timer.timeout, last_tick_);
+    assert(idx < WHEEL_SIZE);
+
+    link_tail(timer_base_[idx], timer);
+    timer.owner_idx = idx;
+    set_occupied(idx, true);
+    ++size_;
+  }
+
+  ATFW_UTIL_FORCEINLINE void set_occupied(size_t idx, bool occupied) noexcept {
+    size_t slot = idx & LVL_MASK;
+    uint64_t mask = static_cast<uint64_t>(1) << (slot % wheel_type::OCCUPIED_WORD_BITS);
+    if (occupied) {
+      occupied_[idx / LVL_SIZE][slot / wheel_type::OCCUPIED_WORD_BITS] |= mask;
+    } else {
+      occupied_[idx / LVL_SIZE][slot / wheel_type::OCCUPIED_WORD_BITS] &= ~mask;
+    }
+  }
+
+  size_t collect_expired_timers(time_t tick_time, timer_link_t *timer_list[LVL_DEPTH]) noexcept {
+    size_t ret = 0;
+    bool active_level = true;
+    for (size_t i = 0; i < LVL_DEPTH; ++i) {
+      size_t idx = static_cast<size_t>(tick_time & LVL_MASK) + wheel_type::LVL_OFFS(i);
+
+      if (active_level && timer_base_[idx].next != &timer_base_[idx]) {
+        timer_list[ret++] = &timer_base_[idx];
+      }
+
+      active_level = 0 == (LVL_CLK_MASK & tick_time);
+      tick_time >>= LVL_CLK_SHIFT;
+    }
+
+    return ret;
+  }
+
+ private:
+  bool inited_;
+  time_t last_tick_;
+  uint32_t seq_alloc_;
+  size_t size_;
+  timer_link_t timer_base_[WHEEL_SIZE];
+  uint64_t occupied_[LVL_DEPTH][OCCUPIED_WORDS];  // 每个时间槽是否非空的位图
+  timer_link_t *free_list_;
+  tick_guard_t *tick_guard_;  // tick() 中正在处理的时间轮
+  ::std::vector<::std::unique_ptr<timer_type[]>> chunks_;
+};
+}  // namespace time
+ATFRAMEWORK_UTILS_NAMESPACE_END
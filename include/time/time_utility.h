@@ -18,6 +18,7 @@
 #include <config/atframe_utils_build_feature.h>
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 
@@ -131,6 +132,65 @@ class time_utility {
    */
   static ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void reset_global_now_offset();
 
+  // ====================== 线程安全的粗粒度时钟 ======================
+  /**
+   * @brief 启动后台时钟线程，每隔interval发布一次粗粒度时间
+   * @note 发布的时间使用顺序锁(seqlock)保护，任意线程都可以通过coarse_now()等接口无锁读取
+   * @param interval 发布间隔
+   * @return 已经启动时返回false
+   */
+  static ATFRAMEWORK_UTILS_API bool start_coarse_clock(
+      std::chrono::microseconds interval = std::chrono::microseconds{1000});
+
+  /**
+   * @brief 停止后台时钟线程，之后coarse_now()等接口直接读取系统粗粒度时钟
+   */
+  static ATFRAMEWORK_UTILS_API void stop_coarse_clock();
+
+  /**
+   * @brief 后台时钟线程是否在运行
+   */
+  static ATFRAMEWORK_UTILS_API bool is_coarse_clock_running();
+
+  /**
+   * @brief 线程安全地获取粗粒度时间，受set_global_now_offset()影响
+   * @note 后台时钟线程运行时返回最后一次发布的时间，每个线程会缓存发布的时间，没有新发布时只有一次原子读取。
+   *       未运行时等同于 fast_sys_now() + get_global_now_offset()。
+   * @note 精度为发布间隔或系统粗粒度时钟的精度(Linux下一般为1-4毫秒)，不需要调用update()
+   * @return 粗粒度的当前时间
+   */
+  static ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD raw_time_t coarse_now();
+
+  /**
+   * @brief 线程安全地获取粗粒度Unix时间戳，受set_global_now_offset()影响
+   * @return 粗粒度的当前Unix时间戳
+   */
+  static ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD time_t get_coarse_now();
+
+  /**
+   * @brief 线程安全地获取粗粒度时间的微秒部分，受set_global_now_offset()影响
+   * @return 粗粒度的当前时间的微秒部分，[0, 1000000)
+   */
+  static ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD int32_t get_coarse_now_usec();
+
+  /**
+   * @brief 线程安全地获取粗粒度单调时间，用于计算超时
+   * @note 和coarse_now()同时发布，来源和精度也相同
+   * @return 粗粒度的单调时间
+   */
+  static ATFRAMEWORK_UTILS_API std::chrono::steady_clock::time_point coarse_steady_now();
+
+  /**
+   * @brief 直接读取系统粗粒度时钟(Linux下为CLOCK_REALTIME_COARSE，其他平台为system_clock)，不受全局偏移影响
+   * @note Linux下通过vDSO读取，不需要系统调用
+   */
+  static ATFRAMEWORK_UTILS_API raw_time_t fast_sys_now();
+
+  /**
+   * @brief 直接读取系统粗粒度单调时钟(Linux下为CLOCK_MONOTONIC_COARSE，其他平台为steady_clock)
+   */
+  static ATFRAMEWORK_UTILS_API std::chrono::steady_clock::time_point fast_steady_now();
+
   // ====================== 后面的函数都和时区相关 ======================
   /**
    * @brief 获取系统时区时间偏移(忽略自定义偏移)
@@ -307,6 +367,47 @@ class time_utility {
    */
   static ATFRAMEWORK_UTILS_API time_t get_month_start_time(time_t t = 0);
 
+  // ====================== 批量接口 ======================
+  // 批量接口每次调用只读取一次时区偏移，并且使用纯整数运算代替gmtime/mktime，适用于大量时间戳的扫描(比如每日重置)
+  // 和单个接口一样使用get_zone_offset()的固定时区偏移，不处理夏令时切换
+
+  /**
+   * @brief 批量判定当前时区，每个left是否和right是同一天
+   * @param left 要判定的时间数组 (每个元素必须大于0)
+   * @param count 数组长度
+   * @param right 比较的时间 (必须大于0)
+   * @param out 输出数组，长度必须不小于count，out[i] 等于 is_same_day(left[i], right, offset)
+   * @param offset 时间点偏移，和 is_same_day(left, right, offset) 相同
+   */
+  static ATFRAMEWORK_UTILS_API void batch_is_same_day(const time_t *left, size_t count, time_t right, bool *out,
+                                                      time_t offset = 0);
+
+  /**
+   * @brief 批量获取每个时间所在周的开始时间的时间戳
+   * @param in 时间数组，元素填0使用get_now()返回的时间
+   * @param count 数组长度
+   * @param out 输出数组，长度必须不小于count，可以和in相同，out[i] 等于 get_week_start_time(in[i], week_first)
+   * @param week_first 一周的第一天，0表示周日，1表示周一，以此类推
+   */
+  static ATFRAMEWORK_UTILS_API void batch_get_week_start_time(const time_t *in, size_t count, time_t *out,
+                                                              time_t week_first = 0);
+
+  /**
+   * @brief 批量获取每个时间所在月的开始时间的时间戳
+   * @param in 时间数组，元素填0使用get_now()返回的时间
+   * @param count 数组长度
+   * @param out 输出数组，长度必须不小于count，可以和in相同，out[i] 等于 get_month_start_time(in[i])
+   */
+  static ATFRAMEWORK_UTILS_API void batch_get_month_start_time(const time_t *in, size_t count, time_t *out);
+
+  /**
+   * @brief 批量获取当前时区每个时间的详细信息
+   * @param in 时间数组 (每个元素必须大于0)
+   * @param count 数组长度
+   * @param out 输出数组，长度必须不小于count，out[i] 的标准字段等于 get_local_tm(in[i])
+   */
+  static ATFRAMEWORK_UTILS_API void batch_get_local_tm(const time_t *in, size_t count, raw_time_desc_t *out);
+
  private:
   // 当前时间
   static ATFRAMEWORK_UTILS_API raw_time_t now_;
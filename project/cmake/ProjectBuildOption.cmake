@@ -151,6 +151,25 @@ else()
   option(ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_SYSLOG_SUPPORT "Enable syslog sink for log." OFF)
 endif()
 
+if(UNIX)
+  check_cxx_source_compiles(
+    "
+  #include <sys/mman.h>
+  #include <unistd.h>
+  int main() {
+      void* addr = mmap(0, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, -1, 0);
+      msync(addr, 4096, MS_ASYNC);
+      munmap(addr, 4096);
+      return ftruncate(-1, 0);
+  }
+  "
+    ATFRAMEWORK_UTILS_TEST_MMAP)
+  cmake_dependent_option(ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT "Enable mmap file sink for log." ON
+                         "ATFRAMEWORK_UTILS_TEST_MMAP" OFF)
+else()
+  option(ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT "Enable mmap file sink for log." OFF)
+endif()
+
 include("${PROJECT_ATFRAME_UTILS_SOURCE_DIR}/log/log_configure.cmake")
 
 if(NOT ATFRAMEWORK_CMAKE_TOOLSET_THIRD_PARTY_CRYPTO_DISABLED)
@@ -456,6 +475,7 @@ option(PROJECT_TEST_ENABLE_BOOST_UNIT_TEST "Enable boost unit test." OFF)
 
 option(PROJECT_ENABLE_UNITTEST "Enable unit test" OFF)
 option(PROJECT_ENABLE_SAMPLE "Enable sample" OFF)
+option(PROJECT_ENABLE_BENCHMARK "Enable benchmark" OFF)
 if(CMAKE_CROSSCOMPILING)
   option(PROJECT_ENABLE_TOOLS "Enable sample" OFF)
 else()
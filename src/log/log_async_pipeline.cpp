@@ -0,0 +1,582 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#include "log/log_async_pipeline.h"
+
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "lock/lock_holder.h"
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace log {
+
+namespace {
+// Record layout in ring buffer:
+//   [header][renderer if deferred][level_name][file_path][func_name][content][deferred data]['\0'][padding to 8 bytes]
+struct log_async_record_header {
+  uint32_t record_size;
+  uint32_t flags;
+  int32_t level_id;
+  uint32_t line_number;
+  uint32_t rotate_index;
+  uint32_t level_name_size;
+  uint32_t file_path_size;
+  uint32_t func_name_size;
+  uint32_t content_size;
+  uint32_t deferred_size;
+};
+
+enum log_async_record_flag : uint32_t {
+  kLogAsyncRecordFlagPadding = 0x01,
+  kLogAsyncRecordFlagDeferred = 0x02,
+};
+
+static constexpr const size_t kLogAsyncRecordAlign = 8;
+static constexpr const size_t kLogAsyncMinRingSize = 4096;
+static constexpr const size_t kLogAsyncMaxBatchRecords = 1024;
+static constexpr const int kLogAsyncBlockSpinCount = 64;
+
+static_assert(sizeof(log_async_record_header) % kLogAsyncRecordAlign == 0,
+              "log_async_record_header must be aligned to kLogAsyncRecordAlign");
+
+UTIL_FORCEINLINE static size_t log_async_align_size(size_t sz) {
+  return (sz + kLogAsyncRecordAlign - 1) & ~(kLogAsyncRecordAlign - 1);
+}
+
+static size_t log_async_round_capacity(size_t sz) {
+  size_t ret = kLogAsyncMinRingSize;
+  while (ret < sz && ret < (std::numeric_limits<size_t>::max() >> 1)) {
+    ret <<= 1;
+  }
+  return ret;
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static std::atomic<uint64_t> g_log_async_pipeline_id_alloc{0};
+}  // namespace
+
+class log_async_ring {
+ public:
+  explicit log_async_ring(size_t cap)
+      : capacity(cap),
+        mask(cap - 1),
+        buffer(new uint64_t[cap / sizeof(uint64_t)]),
+        write_pos(0),
+        read_pos(0),
+        producing(false),
+        producer_exited(false),
+        closed(false),
+        stat_pushed(0),
+        stat_dropped(0),
+        stat_blocked(0) {}
+
+  UTIL_FORCEINLINE unsigned char *data() noexcept { return reinterpret_cast<unsigned char *>(buffer.get()); }
+
+  const size_t capacity;
+  const size_t mask;
+  std::unique_ptr<uint64_t[]> buffer;
+
+  // Written by producer only
+  std::atomic<uint64_t> write_pos;
+  char padding_write_[64 - sizeof(std::atomic<uint64_t>)];
+  // Written by consumer only
+  std::atomic<uint64_t> read_pos;
+  char padding_read_[64 - sizeof(std::atomic<uint64_t>)];
+
+  std::atomic<bool> producing;
+  std::atomic<bool> producer_exited;
+  std::atomic<bool> closed;
+
+  std::atomic<uint64_t> stat_pushed;
+  std::atomic<uint64_t> stat_dropped;
+  std::atomic<uint64_t> stat_blocked;
+};
+
+namespace {
+struct log_async_tls_cache_t {
+  struct entry_t {
+    uint64_t pipeline_id;
+    std::shared_ptr<log_async_ring> ring;
+  };
+
+  std::vector<entry_t> entries;
+
+  ~log_async_tls_cache_t();
+};
+
+// Trivially destructible, so it's still valid when other thread_local objects log in their destructors
+static thread_local bool g_log_async_tls_cache_destroyed = false;
+
+log_async_tls_cache_t::~log_async_tls_cache_t() {
+  g_log_async_tls_cache_destroyed = true;
+  for (auto &entry : entries) {
+    if (entry.ring) {
+      entry.ring->producer_exited.store(true, std::memory_order_release);
+    }
+  }
+}
+
+static log_async_tls_cache_t *get_log_async_tls_cache() {
+  if (g_log_async_tls_cache_destroyed) {
+    return nullptr;
+  }
+
+  static thread_local log_async_tls_cache_t ret;
+  return &ret;
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API log_async_pipeline::log_async_pipeline(const log_async_options &options,
+                                                             dispatcher_t dispatcher)
+    : options_(options),
+      dispatcher_(std::move(dispatcher)),
+      pipeline_id_(++g_log_async_pipeline_id_alloc),
+      running_(false),
+      stop_requested_(false),
+      rings_version_(0),
+      consumer_sleeping_(false),
+      flush_waiters_(0),
+      stat_dispatched_(0),
+      stat_retired_pushed_(0),
+      stat_retired_dropped_(0),
+      stat_retired_blocked_(0) {
+  options_.ring_buffer_size = log_async_round_capacity(options_.ring_buffer_size);
+}
+
+ATFRAMEWORK_UTILS_API log_async_pipeline::~log_async_pipeline() { stop(); }
+
+ATFRAMEWORK_UTILS_API bool log_async_pipeline::start() {
+  if (running_.load(std::memory_order_acquire) || consumer_thread_.joinable() || !dispatcher_) {
+    return false;
+  }
+
+  stop_requested_.store(false, std::memory_order_release);
+  consumer_thread_ = std::thread([this]() { consumer_main(); });
+  consumer_thread_id_ = consumer_thread_.get_id();
+  running_.store(true, std::memory_order_seq_cst);
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API void log_async_pipeline::stop() {
+  if (!consumer_thread_.joinable()) {
+    return;
+  }
+
+  // Reject new records, and then wait for producers which are writing now
+  running_.store(false, std::memory_order_seq_cst);
+  std::vector<std::shared_ptr<log_async_ring>> rings;
+  {
+    lock::lock_holder<lock::spin_lock> holder(rings_lock_);
+    rings = rings_;
+  }
+  for (auto &ring : rings) {
+    while (ring->producing.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Consumer will dispatch all pending records before exit
+  stop_requested_.store(true, std::memory_order_seq_cst);
+  {
+    std::lock_guard<std::mutex> guard(wait_lock_);
+    consumer_cond_.notify_all();
+  }
+  if (std::this_thread::get_id() != consumer_thread_id_) {
+    consumer_thread_.join();
+  } else {
+    consumer_thread_.detach();
+  }
+
+  lock::lock_holder<lock::spin_lock> holder(rings_lock_);
+  for (auto &ring : rings_) {
+    ring->closed.store(true, std::memory_order_release);
+  }
+}
+
+ATFRAMEWORK_UTILS_API bool log_async_pipeline::push(const caller_info_t &caller, const char *content,
+                                                    size_t content_size) {
+  return push(caller, content, content_size, nullptr, nullptr, 0);
+}
+
+ATFRAMEWORK_UTILS_API bool log_async_pipeline::push(const caller_info_t &caller, const char *content,
+                                                    size_t content_size, deferred_renderer_t renderer,
+                                                    const void *data, size_t data_size) {
+  if (!running_.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  // Sinks may write logs, it must not wait for itself
+  if (std::this_thread::get_id() == consumer_thread_id_) {
+    return false;
+  }
+
+  if (nullptr == content) {
+    content_size = 0;
+  }
+  if (nullptr == renderer || nullptr == data) {
+    renderer = nullptr;
+    data_size = 0;
+  }
+
+  size_t payload_size =
+      caller.level_name.size() + caller.file_path.size() + caller.func_name.size() + content_size + data_size + 1;
+  if (nullptr != renderer) {
+    payload_size += sizeof(renderer);
+  }
+  size_t need = log_async_align_size(sizeof(log_async_record_header) + payload_size);
+  // Keep need + tail padding less than capacity
+  if (need > (options_.ring_buffer_size >> 1) || need > static_cast<size_t>(std::numeric_limits<uint32_t>::max())) {
+    return false;
+  }
+
+  // The ring is owned by thread local cache of current thread
+  log_async_ring *ring = mutable_ring();
+  if (nullptr == ring) {
+    return false;
+  }
+
+  ring->producing.store(true, std::memory_order_seq_cst);
+  if (!running_.load(std::memory_order_seq_cst)) {
+    ring->producing.store(false, std::memory_order_release);
+    return false;
+  }
+
+  uint64_t write_pos = ring->write_pos.load(std::memory_order_relaxed);
+  size_t skip = 0;
+  bool blocked = false;
+  int spin_count = 0;
+  while (true) {
+    uint64_t read_pos = ring->read_pos.load(std::memory_order_acquire);
+    size_t tail = ring->capacity - static_cast<size_t>(write_pos & ring->mask);
+    skip = tail < need ? tail : 0;
+    if (ring->capacity - static_cast<size_t>(write_pos - read_pos) >= skip + need) {
+      break;
+    }
+
+    if (log_async_overflow_policy::kDropNewest == options_.overflow_policy ||
+        (log_async_overflow_policy::kDropBelowLevel == options_.overflow_policy &&
+         caller.level_id < options_.drop_level)) {
+      ring->stat_dropped.fetch_add(1, std::memory_order_relaxed);
+      ring->producing.store(false, std::memory_order_release);
+      return true;
+    }
+
+    if (!blocked) {
+      blocked = true;
+      ring->stat_blocked.fetch_add(1, std::memory_order_relaxed);
+    }
+    wakeup_consumer();
+    if (spin_count < kLogAsyncBlockSpinCount) {
+      ++spin_count;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds{100});
+    }
+  }
+
+  unsigned char *base = ring->data();
+  if (skip >= sizeof(log_async_record_header)) {
+    log_async_record_header padding;
+    memset(&padding, 0, sizeof(padding));
+    padding.record_size = static_cast<uint32_t>(skip);
+    padding.flags = kLogAsyncRecordFlagPadding;
+    memcpy(base + (write_pos & ring->mask), &padding, sizeof(padding));
+  }
+  write_pos += skip;
+
+  log_async_record_header header;
+  header.record_size = static_cast<uint32_t>(need);
+  header.flags = nullptr == renderer ? 0 : static_cast<uint32_t>(kLogAsyncRecordFlagDeferred);
+  header.level_id = static_cast<int32_t>(caller.level_id);
+  header.line_number = caller.line_number;
+  header.rotate_index = caller.rotate_index;
+  header.level_name_size = static_cast<uint32_t>(caller.level_name.size());
+  header.file_path_size = static_cast<uint32_t>(caller.file_path.size());
+  header.func_name_size = static_cast<uint32_t>(caller.func_name.size());
+  header.content_size = static_cast<uint32_t>(content_size);
+  header.deferred_size = static_cast<uint32_t>(data_size);
+
+  unsigned char *out = base + (write_pos & ring->mask);
+  memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+  if (nullptr != renderer) {
+    memcpy(out, &renderer, sizeof(renderer));
+    out += sizeof(renderer);
+  }
+  if (!caller.level_name.empty()) {
+    memcpy(out, caller.level_name.data(), caller.level_name.size());
+    out += caller.level_name.size();
+  }
+  if (!caller.file_path.empty()) {
+    memcpy(out, caller.file_path.data(), caller.file_path.size());
+    out += caller.file_path.size();
+  }
+  if (!caller.func_name.empty()) {
+    memcpy(out, caller.func_name.data(), caller.func_name.size());
+    out += caller.func_name.size();
+  }
+  if (content_size > 0) {
+    memcpy(out, content, content_size);
+    out += content_size;
+  }
+  if (data_size > 0) {
+    memcpy(out, data, data_size);
+    out += data_size;
+  }
+  *out = 0;
+
+  ring->write_pos.store(write_pos + need, std::memory_order_release);
+  ring->stat_pushed.fetch_add(1, std::memory_order_relaxed);
+  ring->producing.store(false, std::memory_order_release);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  wakeup_consumer();
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API void log_async_pipeline::flush() {
+  if (!consumer_thread_.joinable() || std::this_thread::get_id() == consumer_thread_id_) {
+    return;
+  }
+
+  std::vector<std::pair<std::shared_ptr<log_async_ring>, uint64_t>> checkpoints;
+  {
+    lock::lock_holder<lock::spin_lock> holder(rings_lock_);
+    checkpoints.reserve(rings_.size());
+    for (auto &ring : rings_) {
+      checkpoints.emplace_back(ring, ring->write_pos.load(std::memory_order_acquire));
+    }
+  }
+
+  flush_waiters_.fetch_add(1, std::memory_order_seq_cst);
+  {
+    std::unique_lock<std::mutex> guard(wait_lock_);
+    consumer_cond_.notify_all();
+    while (true) {
+      bool finished = true;
+      for (auto &checkpoint : checkpoints) {
+        if (checkpoint.first->read_pos.load(std::memory_order_acquire) < checkpoint.second) {
+          finished = false;
+          break;
+        }
+      }
+      if (finished) {
+        break;
+      }
+
+      flush_cond_.wait_for(guard, std::chrono::milliseconds{1});
+    }
+  }
+  flush_waiters_.fetch_sub(1, std::memory_order_release);
+}
+
+ATFRAMEWORK_UTILS_API log_async_statistics log_async_pipeline::get_statistics() const noexcept {
+  log_async_statistics ret;
+  lock::lock_holder<lock::spin_lock> holder(rings_lock_);
+  ret.pushed = stat_retired_pushed_.load(std::memory_order_relaxed);
+  ret.dropped = stat_retired_dropped_.load(std::memory_order_relaxed);
+  ret.blocked = stat_retired_blocked_.load(std::memory_order_relaxed);
+  for (auto &ring : rings_) {
+    ret.pushed += ring->stat_pushed.load(std::memory_order_relaxed);
+    ret.dropped += ring->stat_dropped.load(std::memory_order_relaxed);
+    ret.blocked += ring->stat_blocked.load(std::memory_order_relaxed);
+  }
+  ret.dispatched = stat_dispatched_.load(std::memory_order_acquire);
+  return ret;
+}
+
+log_async_ring *log_async_pipeline::mutable_ring() {
+  log_async_tls_cache_t *cache = get_log_async_tls_cache();
+  if (nullptr == cache) {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < cache->entries.size();) {
+    if (cache->entries[i].ring->closed.load(std::memory_order_acquire)) {
+      cache->entries[i] = std::move(cache->entries.back());
+      cache->entries.pop_back();
+      continue;
+    }
+
+    if (cache->entries[i].pipeline_id == pipeline_id_) {
+      return cache->entries[i].ring.get();
+    }
+    ++i;
+  }
+
+  std::shared_ptr<log_async_ring> ret = std::make_shared<log_async_ring>(options_.ring_buffer_size);
+  {
+    lock::lock_holder<lock::spin_lock> holder(rings_lock_);
+    rings_.push_back(ret);
+    rings_version_.fetch_add(1, std::memory_order_release);
+  }
+
+  log_async_tls_cache_t::entry_t entry;
+  entry.pipeline_id = pipeline_id_;
+  entry.ring = ret;
+  cache->entries.emplace_back(std::move(entry));
+  return ret.get();
+}
+
+size_t log_async_pipeline::dispatch_ring(log_async_ring &ring, size_t max_records,
+                                         std::unique_ptr<char[]> &render_buffer) {
+  uint64_t read_pos = ring.read_pos.load(std::memory_order_relaxed);
+  uint64_t write_pos = ring.write_pos.load(std::memory_order_acquire);
+  const unsigned char *base = ring.data();
+  size_t ret = 0;
+
+  while (read_pos < write_pos && ret < max_records) {
+    size_t offset = static_cast<size_t>(read_pos & ring.mask);
+    // Implicit padding, the tail is too small to hold a header
+    if (ring.capacity - offset < sizeof(log_async_record_header)) {
+      read_pos += ring.capacity - offset;
+      continue;
+    }
+
+    log_async_record_header header;
+    memcpy(&header, base + offset, sizeof(header));
+    if (header.flags & kLogAsyncRecordFlagPadding) {
+      read_pos += header.record_size;
+      continue;
+    }
+
+    const char *payload = reinterpret_cast<const char *>(base + offset + sizeof(header));
+    deferred_renderer_t renderer = nullptr;
+    if (header.flags & kLogAsyncRecordFlagDeferred) {
+      memcpy(&renderer, payload, sizeof(renderer));
+      payload += sizeof(renderer);
+    }
+
+    caller_info_t caller;
+    caller.level_id = static_cast<log_level>(header.level_id);
+    caller.level_name = nostd::string_view{payload, header.level_name_size};
+    payload += header.level_name_size;
+    caller.file_path = nostd::string_view{payload, header.file_path_size};
+    payload += header.file_path_size;
+    caller.line_number = header.line_number;
+    caller.func_name = nostd::string_view{payload, header.func_name_size};
+    payload += header.func_name_size;
+    caller.rotate_index = header.rotate_index;
+
+    if (nullptr == renderer) {
+      dispatcher_(caller, payload, header.content_size);
+    } else {
+      // Deferred record, render [content][text of data] into render buffer
+      const size_t render_buffer_size = static_cast<size_t>(ATFRAMEWORK_UTILS_LOG_MAX_SIZE_PER_LINE);
+      if (!render_buffer) {
+        render_buffer.reset(new char[render_buffer_size]);
+      }
+      size_t content_size = header.content_size < render_buffer_size ? header.content_size : render_buffer_size - 1;
+      memcpy(render_buffer.get(), payload, content_size);
+      content_size += (*renderer)(render_buffer.get() + content_size, render_buffer_size - content_size - 1,
+                                  reinterpret_cast<const unsigned char *>(payload + header.content_size),
+                                  header.deferred_size);
+      render_buffer[content_size] = 0;
+      dispatcher_(caller, render_buffer.get(), content_size);
+    }
+
+    read_pos += header.record_size;
+    ring.read_pos.store(read_pos, std::memory_order_release);
+    stat_dispatched_.fetch_add(1, std::memory_order_release);
+    ++ret;
+  }
+
+  ring.read_pos.store(read_pos, std::memory_order_release);
+  return ret;
+}
+
+bool log_async_pipeline::has_pending_records(const std::vector<std::shared_ptr<log_async_ring>> &rings) const {
+  for (auto &ring : rings) {
+    if (ring->read_pos.load(std::memory_order_acquire) != ring->write_pos.load(std::memory_order_acquire)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void log_async_pipeline::wakeup_consumer() {
+  if (consumer_sleeping_.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> guard(wait_lock_);
+    consumer_cond_.notify_one();
+  }
+}
+
+void log_async_pipeline::consumer_main() {
+  std::vector<std::shared_ptr<log_async_ring>> rings;
+  uint64_t rings_version = std::numeric_limits<uint64_t>::max();
+  std::unique_ptr<char[]> render_buffer;
+
+  while (true) {
+    if (rings_version != rings_version_.load(std::memory_order_acquire)) {
+      lock::lock_holder<lock::spin_lock> holder(rings_lock_);
+      rings = rings_;
+      rings_version = rings_version_.load(std::memory_order_acquire);
+    }
+
+    size_t dispatched = 0;
+    bool has_exited_ring = false;
+    for (auto &ring : rings) {
+      dispatched += dispatch_ring(*ring, kLogAsyncMaxBatchRecords, render_buffer);
+      if (ring->producer_exited.load(std::memory_order_acquire)) {
+        has_exited_ring = true;
+      }
+    }
+
+    // Remove drained rings whose producer threads are gone
+    if (has_exited_ring) {
+      lock::lock_holder<lock::spin_lock> holder(rings_lock_);
+      for (size_t i = 0; i < rings_.size();) {
+        log_async_ring &ring = *rings_[i];
+        if (ring.producer_exited.load(std::memory_order_acquire) &&
+            ring.read_pos.load(std::memory_order_acquire) == ring.write_pos.load(std::memory_order_acquire)) {
+          stat_retired_pushed_.fetch_add(ring.stat_pushed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+          stat_retired_dropped_.fetch_add(ring.stat_dropped.load(std::memory_order_relaxed),
+                                          std::memory_order_relaxed);
+          stat_retired_blocked_.fetch_add(ring.stat_blocked.load(std::memory_order_relaxed),
+                                          std::memory_order_relaxed);
+          ring.closed.store(true, std::memory_order_release);
+          rings_[i] = std::move(rings_.back());
+          rings_.pop_back();
+          rings_version_.fetch_add(1, std::memory_order_release);
+          continue;
+        }
+        ++i;
+      }
+    }
+
+    if (flush_waiters_.load(std::memory_order_acquire) > 0) {
+      std::lock_guard<std::mutex> guard(wait_lock_);
+      flush_cond_.notify_all();
+    }
+
+    if (dispatched > 0) {
+      continue;
+    }
+
+    if (stop_requested_.load(std::memory_order_acquire)) {
+      if (rings_version == rings_version_.load(std::memory_order_acquire) && !has_pending_records(rings)) {
+        break;
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> guard(wait_lock_);
+    consumer_sleeping_.store(true, std::memory_order_seq_cst);
+    if (!stop_requested_.load(std::memory_order_seq_cst) &&
+        rings_version == rings_version_.load(std::memory_order_seq_cst) && !has_pending_records(rings)) {
+      consumer_cond_.wait_for(guard, options_.idle_wait);
+    }
+    consumer_sleeping_.store(false, std::memory_order_relaxed);
+  }
+
+  std::lock_guard<std::mutex> guard(wait_lock_);
+  flush_cond_.notify_all();
+}
+
+}  // namespace log
+ATFRAMEWORK_UTILS_NAMESPACE_END
@@ -45,375 +45,416 @@ ATFW_UTIL_SANITIZER_NO_THREAD static nostd::string_view log_formatter_get_level_
 
   return "FATAL";
 }
-}  // namespace
-
-std::string log_formatter::project_dir_;
-
-ATFRAMEWORK_UTILS_API bool log_formatter::check_flag(int32_t flags, int32_t checked) {
-  return (flags & checked) == checked;
-}
-
-ATFRAMEWORK_UTILS_API struct tm *log_formatter::get_iso_tm() {
-  static THREAD_TLS time_t tm_tp = 0;
-  static THREAD_TLS struct tm tm_obj;
+// 按秒缓存的本地时间，日期和时间部分预先转成字符串，格式化时直接复制
+struct log_formatter_datetime_cache_t {
+  time_t timepoint;
+  struct tm tm_obj;
+  char date[10];  // YYYY-MM-DD
+  char time[8];   // HH:MM:SS
+};
+
+static log_formatter_datetime_cache_t *log_formatter_get_datetime_cache() {
+  static THREAD_TLS log_formatter_datetime_cache_t cache;
 #ifndef NDEBUG
   ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::update();
 #endif
-  if (tm_tp != ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now()) {
-    tm_tp = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now();
-    UTIL_STRFUNC_LOCALTIME_S(&tm_tp, &tm_obj);  // lgtm [cpp/potentially-dangerous-function]
+  time_t now = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now();
+  if (cache.timepoint == now) {
+    return &cache;
   }
 
-  return &tm_obj;
+  cache.timepoint = now;
+  UTIL_STRFUNC_LOCALTIME_S(&cache.timepoint, &cache.tm_obj);  // lgtm [cpp/potentially-dangerous-function]
+
+  int year = cache.tm_obj.tm_year + 1900;
+  int mon = cache.tm_obj.tm_mon + 1;
+  cache.date[0] = static_cast<char>(year / 1000 + '0');
+  cache.date[1] = static_cast<char>((year / 100) % 10 + '0');
+  cache.date[2] = static_cast<char>((year / 10) % 10 + '0');
+  cache.date[3] = static_cast<char>(year % 10 + '0');
+  cache.date[4] = '-';
+  cache.date[5] = static_cast<char>(mon / 10 + '0');
+  cache.date[6] = static_cast<char>(mon % 10 + '0');
+  cache.date[7] = '-';
+  cache.date[8] = static_cast<char>(cache.tm_obj.tm_mday / 10 + '0');
+  cache.date[9] = static_cast<char>(cache.tm_obj.tm_mday % 10 + '0');
+
+  cache.time[0] = static_cast<char>(cache.tm_obj.tm_hour / 10 + '0');
+  cache.time[1] = static_cast<char>(cache.tm_obj.tm_hour % 10 + '0');
+  cache.time[2] = ':';
+  cache.time[3] = static_cast<char>(cache.tm_obj.tm_min / 10 + '0');
+  cache.time[4] = static_cast<char>(cache.tm_obj.tm_min % 10 + '0');
+  cache.time[5] = ':';
+  cache.time[6] = static_cast<char>(cache.tm_obj.tm_sec / 10 + '0');
+  cache.time[7] = static_cast<char>(cache.tm_obj.tm_sec % 10 + '0');
+  return &cache;
 }
 
-ATFRAMEWORK_UTILS_API size_t log_formatter::format(char *buff, size_t bufz, const char *fmt, size_t fmtz,
-                                                   const caller_info_t &caller) {
-  if (nullptr == buff || 0 == bufz) {
-    return 0;
+struct log_formatter_context_t {
+  const log_formatter::caller_info_t *caller;
+  nostd::string_view level_name;
+  nostd::string_view project_dir;
+  // 时间加缓存，以防使用过程中时间变化
+  const log_formatter_datetime_cache_t *datetime;
+
+  inline const log_formatter_datetime_cache_t &get_datetime() {
+    if (nullptr == datetime) {
+      datetime = log_formatter_get_datetime_cache();
+    }
+    return *datetime;
+  }
+};
+
+static log_formatter::format_op_type log_formatter_parse_op(char c) {
+  switch (c) {
+    case 'Y':
+      return log_formatter::format_op_type::kYear;
+    case 'y':
+      return log_formatter::format_op_type::kYearShort;
+    case 'm':
+      return log_formatter::format_op_type::kMonth;
+    case 'j':
+      return log_formatter::format_op_type::kYearDay;
+    case 'd':
+      return log_formatter::format_op_type::kMonthDay;
+    case 'w':
+      return log_formatter::format_op_type::kWeekDay;
+    case 'H':
+      return log_formatter::format_op_type::kHour;
+    case 'I':
+      return log_formatter::format_op_type::kHour12;
+    case 'M':
+      return log_formatter::format_op_type::kMinute;
+    case 'S':
+      return log_formatter::format_op_type::kSecond;
+    case 'F':
+      return log_formatter::format_op_type::kDate;
+    case 'T':
+      return log_formatter::format_op_type::kTime;
+    case 'R':
+      return log_formatter::format_op_type::kHourMinute;
+    case 'f':
+      return log_formatter::format_op_type::kSubSecond;
+    case 'L':
+      return log_formatter::format_op_type::kLevelName;
+    case 'l':
+      return log_formatter::format_op_type::kLevelId;
+    case 's':
+      return log_formatter::format_op_type::kFilePath;
+    case 'k':
+      return log_formatter::format_op_type::kFileName;
+    case 'n':
+      return log_formatter::format_op_type::kLineNumber;
+    case 'C':
+      return log_formatter::format_op_type::kFuncName;
+    case 'N':
+      return log_formatter::format_op_type::kRotateIndex;
+    default:
+      return log_formatter::format_op_type::kLiteral;
   }
+}
 
-  if (nullptr == fmt || 0 == fmtz) {
-    buff[0] = '\0';
-    return 0;
+// 空间足够才写入，否则返回false并终止格式化
+static inline bool log_formatter_write_fixed(char *buff, size_t bufz, size_t &ret, const char *src, size_t sz) {
+  if (bufz - ret < sz) {
+    return false;
   }
+  memcpy(&buff[ret], src, sz);
+  ret += sz;
+  return true;
+}
 
-  // Level id to level name
-  nostd::string_view level_name = caller.level_name;
-  if (level_name.empty()) {
-    level_name = log_formatter_get_level_name(caller.level_id);
+// 同snprintf的截断行为，但不需要解析格式串
+static bool log_formatter_write_integer(char *buff, size_t bufz, size_t &ret, int64_t v) {
+  char digits[24];
+  size_t len = 0;
+  uint64_t abs_value = v < 0 ? static_cast<uint64_t>(0) - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+  do {
+    digits[len++] = static_cast<char>(abs_value % 10 + '0');
+    abs_value /= 10;
+  } while (abs_value > 0);
+  if (v < 0) {
+    digits[len++] = '-';
   }
 
-  bool need_parse = false, running = true;
-  size_t ret = 0;
-  struct tm tm_obj_cache;
-  struct tm *tm_obj_ptr = nullptr;
-
-// 时间加缓存，以防使用过程中时间变化
-#define LOG_FMT_FN_TM_MEM(VAR, EXPRESS) \
-                                        \
-  int VAR;                              \
-                                        \
-  if (nullptr == tm_obj_ptr) {          \
-    tm_obj_cache = *get_iso_tm();       \
-    tm_obj_ptr = &tm_obj_cache;         \
-    VAR = tm_obj_ptr->EXPRESS;          \
-                                        \
-  } else {                              \
-    VAR = tm_obj_ptr->EXPRESS;          \
+  bool complete = bufz - ret >= len;
+  while (len > 0 && ret < bufz) {
+    buff[ret++] = digits[--len];
   }
+  return complete;
+}
 
-  for (size_t i = 0; i < fmtz && ret < bufz && running; ++i) {
-    if (!need_parse) {
-      if ('%' == fmt[i]) {
-        need_parse = true;
-      } else {
-        buff[ret++] = fmt[i];
+static inline void log_formatter_write_2digits(char *buff, size_t &ret, int v) {
+  buff[ret++] = static_cast<char>(v / 10 + '0');
+  buff[ret++] = static_cast<char>(v % 10 + '0');
+}
+
+// 简化版本的 strftime 格式支持
+// @see https://en.cppreference.com/w/cpp/chrono/c/strftime
+// 额外支持毫秒，rotate index, log level 名称等
+// 调用前保证 ret < bufz ，返回false表示空间不足需要终止格式化
+static bool log_formatter_write_op(char *buff, size_t bufz, size_t &ret, log_formatter::format_op_type op,
+                                   log_formatter_context_t &ctx) {
+  switch (op) {
+    // =================== datetime ===================
+    case log_formatter::format_op_type::kYear:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().date, 4);
+    case log_formatter::format_op_type::kYearShort:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().date + 2, 2);
+    case log_formatter::format_op_type::kMonth:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().date + 5, 2);
+    case log_formatter::format_op_type::kYearDay: {
+      if (bufz - ret < 3) {
+        return false;
       }
-      continue;
+      int yday = ctx.get_datetime().tm_obj.tm_yday;
+      buff[ret++] = static_cast<char>(yday / 100 + '0');
+      log_formatter_write_2digits(buff, ret, yday % 100);
+      return true;
     }
-
-    need_parse = false;
-    // 简化版本的 strftime 格式支持
-    // @see https://en.cppreference.com/w/cpp/chrono/c/strftime
-    // 额外支持毫秒，rotate index, log level 名称等
-    switch (fmt[i]) {
-      // =================== datetime ===================
-      case 'Y': {
-        if (bufz - ret < 4) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(year, tm_year + 1900);
-          buff[ret++] = static_cast<char>(year / 1000 + '0');
-          buff[ret++] = static_cast<char>((year / 100) % 10 + '0');
-          buff[ret++] = static_cast<char>((year / 10) % 10 + '0');
-          buff[ret++] = static_cast<char>(year % 10 + '0');
-        }
-        break;
+    case log_formatter::format_op_type::kMonthDay:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().date + 8, 2);
+    case log_formatter::format_op_type::kWeekDay: {
+      buff[ret++] = static_cast<char>(ctx.get_datetime().tm_obj.tm_wday + '0');
+      return true;
+    }
+    case log_formatter::format_op_type::kHour:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().time, 2);
+    case log_formatter::format_op_type::kHour12: {
+      if (bufz - ret < 2) {
+        return false;
       }
-      case 'y': {
-        if (bufz - ret < 2) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(year, tm_year + 1900);
-          buff[ret++] = static_cast<char>((year / 10) % 10 + '0');
-          buff[ret++] = static_cast<char>(year % 10 + '0');
-        }
-        break;
+      log_formatter_write_2digits(buff, ret, ctx.get_datetime().tm_obj.tm_hour % 12 + 1);
+      return true;
+    }
+    case log_formatter::format_op_type::kMinute:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().time + 3, 2);
+    case log_formatter::format_op_type::kSecond:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().time + 6, 2);
+    case log_formatter::format_op_type::kDate:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().date, 10);
+    case log_formatter::format_op_type::kTime:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().time, 8);
+    case log_formatter::format_op_type::kHourMinute:
+      return log_formatter_write_fixed(buff, bufz, ret, ctx.get_datetime().time, 5);
+    case log_formatter::format_op_type::kSubSecond: {
+      time_t ms = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_now_usec() / 10;
+      char digits[5] = {static_cast<char>(ms / 10000 + '0'), static_cast<char>((ms / 1000) % 10 + '0'),
+                        static_cast<char>((ms / 100) % 10 + '0'), static_cast<char>((ms / 10) % 10 + '0'),
+                        static_cast<char>(ms % 10 + '0')};
+      for (size_t i = 0; i < sizeof(digits) && ret < bufz; ++i) {
+        buff[ret++] = digits[i];
       }
-      case 'm': {
-        if (bufz - ret < 2) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(mon, tm_mon + 1);
-          buff[ret++] = static_cast<char>(mon / 10 + '0');
-          buff[ret++] = static_cast<char>(mon % 10 + '0');
-        }
-        break;
+      return true;
+    }
+
+    // =================== caller data ===================
+    case log_formatter::format_op_type::kLevelName: {
+      if (ctx.level_name.empty()) {
+        return true;
       }
-      case 'j': {
-        if (bufz - ret < 3) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(yday, tm_yday);
-          buff[ret++] = static_cast<char>(yday / 100 + '0');
-          buff[ret++] = static_cast<char>((yday / 10) % 10 + '0');
-          buff[ret++] = static_cast<char>(yday % 10 + '0');
-        }
-        break;
+      if (bufz - ret <= 8) {
+        return false;
       }
-      case 'd': {
-        if (bufz - ret < 2) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(mday, tm_mday);
-          buff[ret++] = static_cast<char>(mday / 10 + '0');
-          buff[ret++] = static_cast<char>(mday % 10 + '0');
-        }
-        break;
+      size_t write_size = ctx.level_name.size() < 8 ? ctx.level_name.size() : 8;
+      memcpy(&buff[ret], ctx.level_name.data(), write_size);
+      for (size_t j = write_size; j < 8; ++j) {
+        buff[ret + j] = ' ';
       }
-      case 'w': {
-        LOG_FMT_FN_TM_MEM(wday, tm_wday);
-        buff[ret++] = static_cast<char>(wday + '0');
-        break;
+      ret += 8;
+      return true;
+    }
+    case log_formatter::format_op_type::kLevelId:
+      return log_formatter_write_integer(buff, bufz, ret, static_cast<int64_t>(ctx.caller->level_id));
+    case log_formatter::format_op_type::kFilePath: {
+      nostd::string_view file_path = ctx.caller->file_path;
+      if (file_path.empty()) {
+        return true;
       }
-      case 'H': {
-        if (bufz - ret < 2) {
-          running = false;
+
+      size_t strip_position = 0;
+      for (size_t j = 0; j < ctx.project_dir.size() && j < file_path.size(); ++j) {
+        if (ctx.project_dir[j] == file_path[j]) {
+          strip_position = j + 1;
         } else {
-          LOG_FMT_FN_TM_MEM(hour, tm_hour);
-          buff[ret++] = static_cast<char>(hour / 10 + '0');
-          buff[ret++] = static_cast<char>(hour % 10 + '0');
+          break;
         }
-        break;
       }
-      case 'I': {
-        if (bufz - ret < 2) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(hour, tm_hour % 12 + 1);
-          buff[ret++] = static_cast<char>(hour / 10 + '0');
-          buff[ret++] = static_cast<char>(hour % 10 + '0');
-        }
-        break;
+      if (strip_position > 0) {
+        file_path = file_path.substr(strip_position);
+        buff[ret++] = '~';
       }
-      case 'M': {
-        if (bufz - ret < 2) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(minite, tm_min);
-          buff[ret++] = static_cast<char>(minite / 10 + '0');
-          buff[ret++] = static_cast<char>(minite % 10 + '0');
-        }
-        break;
+
+      if (bufz - ret <= file_path.size()) {
+        return false;
       }
-      case 'S': {
-        if (bufz - ret < 2) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(sec, tm_sec);
-          buff[ret++] = static_cast<char>(sec / 10 + '0');
-          buff[ret++] = static_cast<char>(sec % 10 + '0');
-        }
-        break;
+      memcpy(&buff[ret], file_path.data(), file_path.size());
+      ret += file_path.size();
+      return true;
+    }
+    case log_formatter::format_op_type::kFileName: {
+      nostd::string_view file_name = ctx.caller->file_path;
+      if (file_name.empty()) {
+        return true;
       }
-      case 'F': {
-        if (bufz - ret < 10) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(year, tm_year + 1900);
-          LOG_FMT_FN_TM_MEM(mon, tm_mon + 1);
-          LOG_FMT_FN_TM_MEM(mday, tm_mday);
-          buff[ret++] = static_cast<char>(year / 1000 + '0');
-          buff[ret++] = static_cast<char>((year / 100) % 10 + '0');
-          buff[ret++] = static_cast<char>((year / 10) % 10 + '0');
-          buff[ret++] = static_cast<char>(year % 10 + '0');
-          buff[ret++] = '-';
-          buff[ret++] = static_cast<char>(mon / 10 + '0');
-          buff[ret++] = static_cast<char>(mon % 10 + '0');
-          buff[ret++] = '-';
-          buff[ret++] = static_cast<char>(mday / 10 + '0');
-          buff[ret++] = static_cast<char>(mday % 10 + '0');
+      for (size_t j = file_name.size(); j > 0; --j) {
+        if ('/' == file_name[j - 1] || '\\' == file_name[j - 1]) {
+          file_name = file_name.substr(j);
+          break;
         }
-        break;
       }
-      case 'T': {
-        if (bufz - ret < 8) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(hour, tm_hour);
-          LOG_FMT_FN_TM_MEM(minite, tm_min);
-          LOG_FMT_FN_TM_MEM(sec, tm_sec);
-          buff[ret++] = static_cast<char>(hour / 10 + '0');
-          buff[ret++] = static_cast<char>(hour % 10 + '0');
-          buff[ret++] = ':';
-          buff[ret++] = static_cast<char>(minite / 10 + '0');
-          buff[ret++] = static_cast<char>(minite % 10 + '0');
-          buff[ret++] = ':';
-          buff[ret++] = static_cast<char>(sec / 10 + '0');
-          buff[ret++] = static_cast<char>(sec % 10 + '0');
-        }
-        break;
+      if (bufz - ret <= file_name.size()) {
+        return false;
       }
-      case 'R': {
-        if (bufz - ret < 5) {
-          running = false;
-        } else {
-          LOG_FMT_FN_TM_MEM(hour, tm_hour);
-          LOG_FMT_FN_TM_MEM(minite, tm_min);
-          buff[ret++] = static_cast<char>(hour / 10 + '0');
-          buff[ret++] = static_cast<char>(hour % 10 + '0');
-          buff[ret++] = ':';
-          buff[ret++] = static_cast<char>(minite / 10 + '0');
-          buff[ret++] = static_cast<char>(minite % 10 + '0');
-        }
-        break;
+      memcpy(&buff[ret], file_name.data(), file_name.size());
+      ret += file_name.size();
+      return true;
+    }
+    case log_formatter::format_op_type::kLineNumber:
+      return log_formatter_write_integer(buff, bufz, ret, static_cast<int64_t>(ctx.caller->line_number));
+    case log_formatter::format_op_type::kFuncName: {
+      if (ctx.caller->func_name.empty()) {
+        return true;
+      }
+      if (bufz - ret <= ctx.caller->func_name.size()) {
+        return false;
       }
+      memcpy(&buff[ret], ctx.caller->func_name.data(), ctx.caller->func_name.size());
+      ret += ctx.caller->func_name.size();
+      return true;
+    }
+    // =================== rotate index ===================
+    case log_formatter::format_op_type::kRotateIndex:
+      return log_formatter_write_integer(buff, bufz, ret, static_cast<int64_t>(ctx.caller->rotate_index));
 
-      case 'f': {
-        if (bufz - ret < 1) {
-          running = false;
-        } else {
-          time_t ms = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_now_usec() / 10;
-          if (bufz - ret >= 1) {
-            buff[ret++] = static_cast<char>(ms / 10000 + '0');
-          }
-          if (bufz - ret >= 1) {
-            buff[ret++] = static_cast<char>((ms / 1000) % 10 + '0');
-          }
-          if (bufz - ret >= 1) {
-            buff[ret++] = static_cast<char>((ms / 100) % 10 + '0');
-          }
-          if (bufz - ret >= 1) {
-            buff[ret++] = static_cast<char>((ms / 10) % 10 + '0');
-          }
-          if (bufz - ret >= 1) {
-            buff[ret++] = static_cast<char>(ms % 10 + '0');
-          }
-        }
+    default:
+      return true;
+  }
+}
 
-        break;
-      }
+static inline void log_formatter_finish(char *buff, size_t bufz, size_t ret) {
+  if (ret < bufz) {
+    buff[ret] = '\0';
+  } else {
+    buff[bufz - 1] = '\0';
+  }
+}
+}  // namespace
 
-      // =================== caller data ===================
-      case 'L': {
-        if (!level_name.empty()) {
-          size_t write_size = 8;
-          if (level_name.size() < write_size) {
-            write_size = level_name.size();
-          }
-          if (bufz - ret <= 8) {
-            running = false;
-          } else {
-            memcpy(&buff[ret], level_name.data(), write_size);
-            for (size_t j = write_size; j < 8; ++j) {
-              buff[ret + j] = ' ';
-            }
-            ret += 8;
-          }
-        }
-        break;
-      }
-      case 'l': {
-        int res = UTIL_STRFUNC_SNPRINTF(&buff[ret], bufz - ret, "%d", static_cast<int>(caller.level_id));
-        if (res < 0) {
-          running = false;
-        } else {
-          ret += static_cast<size_t>(res);
-        }
-        break;
-      }
-      case 's': {
-        if (!caller.file_path.empty()) {
-          nostd::string_view file_path = caller.file_path;
-          size_t strip_position = 0;
-          if (!project_dir_.empty()) {
-            for (size_t j = 0; j < project_dir_.size() && j < file_path.size(); ++j) {
-              if (project_dir_[j] == file_path[j]) {
-                strip_position = j + 1;
-              } else {
-                break;
-              }
-            }
-
-            if (strip_position > 0) {
-              file_path = file_path.substr(strip_position);
-              buff[ret++] = '~';
-            }
-          }
-
-          if (bufz - ret <= file_path.size()) {
-            running = false;
-          } else {
-            memcpy(&buff[ret], file_path.data(), file_path.size());
-            ret += file_path.size();
-          }
-        }
-        break;
-      }
-      case 'k': {
-        if (!caller.file_path.empty()) {
-          nostd::string_view file_name = caller.file_path;
-          for (size_t j = 0; j < caller.file_path.size(); ++j) {
-            if ('/' == caller.file_path[j] || '\\' == caller.file_path[j]) {
-              file_name = caller.file_path.substr(j + 1);
-            }
-          }
-          if (bufz - ret <= file_name.size()) {
-            running = false;
-          } else {
-            memcpy(&buff[ret], file_name.data(), file_name.size());
-            ret += file_name.size();
-          }
-        }
-        break;
-      }
-      case 'n': {
-        int res = UTIL_STRFUNC_SNPRINTF(&buff[ret], bufz - ret, "%u", caller.line_number);
-        if (res < 0) {
-          running = false;
-        } else {
-          ret += static_cast<size_t>(res);
-        }
-        break;
-      }
-      case 'C': {
-        if (!caller.func_name.empty()) {
-          if (bufz - ret <= caller.func_name.size()) {
-            running = false;
-          } else {
-            memcpy(&buff[ret], caller.func_name.data(), caller.func_name.size());
-            ret += caller.func_name.size();
-          }
-        }
-        break;
-      }
-      // =================== rotate index ===================
-      case 'N': {
-        int res = UTIL_STRFUNC_SNPRINTF(&buff[ret], bufz - ret, "%u", caller.rotate_index);
-        if (res < 0) {
-          running = false;
-        } else {
-          ret += static_cast<size_t>(res);
-        }
-        break;
+std::string log_formatter::project_dir_;
+
+ATFRAMEWORK_UTILS_API bool log_formatter::check_flag(int32_t flags, int32_t checked) {
+  return (flags & checked) == checked;
+}
+
+ATFRAMEWORK_UTILS_API struct tm *log_formatter::get_iso_tm() { return &log_formatter_get_datetime_cache()->tm_obj; }
+
+ATFRAMEWORK_UTILS_API size_t log_formatter::format(char *buff, size_t bufz, const char *fmt, size_t fmtz,
+                                                   const caller_info_t &caller) {
+  if (nullptr == buff || 0 == bufz) {
+    return 0;
+  }
+
+  if (nullptr == fmt || 0 == fmtz) {
+    buff[0] = '\0';
+    return 0;
+  }
+
+  log_formatter_context_t ctx;
+  ctx.caller = &caller;
+  // Level id to level name
+  ctx.level_name = caller.level_name.empty() ? log_formatter_get_level_name(caller.level_id) : caller.level_name;
+  ctx.project_dir = project_dir_;
+  ctx.datetime = nullptr;
+
+  bool need_parse = false, running = true;
+  size_t ret = 0;
+  for (size_t i = 0; i < fmtz && ret < bufz && running; ++i) {
+    if (!need_parse) {
+      if ('%' == fmt[i]) {
+        need_parse = true;
+      } else {
+        buff[ret++] = fmt[i];
       }
+      continue;
+    }
 
+    need_parse = false;
+    format_op_type op = log_formatter_parse_op(fmt[i]);
+    if (format_op_type::kLiteral == op) {
       // =================== unknown ===================
-      default: {
-        buff[ret++] = fmt[i];
+      buff[ret++] = fmt[i];
+    } else {
+      running = log_formatter_write_op(buff, bufz, ret, op, ctx);
+    }
+  }
+
+  log_formatter_finish(buff, bufz, ret);
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void log_formatter::compile(compiled_format_t &out, const char *fmt, size_t fmtz) {
+  out.ops.clear();
+  if (nullptr == fmt) {
+    out.pattern.clear();
+    return;
+  }
+  out.pattern.assign(fmt, fmtz);
+
+  for (size_t i = 0; i < fmtz; ++i) {
+    format_op_t op;
+    op.type = format_op_type::kLiteral;
+    op.offset = static_cast<uint32_t>(i);
+    op.size = 1;
+    if ('%' == fmt[i]) {
+      // 结尾单独的%不输出任何内容
+      if (++i >= fmtz) {
         break;
       }
+      op.type = log_formatter_parse_op(fmt[i]);
+      // 未知的格式原样输出后面的字符
+      op.offset = static_cast<uint32_t>(i);
+      op.size = format_op_type::kLiteral == op.type ? 1 : 0;
     }
+
+    // 合并相邻的普通字符
+    if (format_op_type::kLiteral == op.type && !out.ops.empty() &&
+        format_op_type::kLiteral == out.ops.back().type && out.ops.back().offset + out.ops.back().size == op.offset) {
+      ++out.ops.back().size;
+    } else {
+      out.ops.push_back(op);
+    }
+  }
+}
+
+ATFRAMEWORK_UTILS_API size_t log_formatter::format(char *buff, size_t bufz, const compiled_format_t &fmt,
+                                                   const caller_info_t &caller) {
+  if (nullptr == buff || 0 == bufz) {
+    return 0;
   }
 
-#undef LOG_FMT_FN_TM_MEM
+  log_formatter_context_t ctx;
+  ctx.caller = &caller;
+  ctx.level_name = caller.level_name.empty() ? log_formatter_get_level_name(caller.level_id) : caller.level_name;
+  ctx.project_dir = project_dir_;
+  ctx.datetime = nullptr;
 
-  if (ret < bufz) {
-    buff[ret] = '\0';
-  } else {
-    buff[bufz - 1] = '\0';
+  size_t ret = 0;
+  for (size_t i = 0; i < fmt.ops.size() && ret < bufz; ++i) {
+    const format_op_t &op = fmt.ops[i];
+    if (format_op_type::kLiteral == op.type) {
+      size_t write_size = op.size;
+      if (write_size > bufz - ret) {
+        write_size = bufz - ret;
+      }
+      memcpy(&buff[ret], fmt.pattern.data() + op.offset, write_size);
+      ret += write_size;
+    } else if (!log_formatter_write_op(buff, bufz, ret, op.type, ctx)) {
+      break;
+    }
   }
+
+  log_formatter_finish(buff, bufz, ret);
   return ret;
 }
 
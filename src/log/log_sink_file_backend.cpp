@@ -7,8 +7,13 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "common/file_system.h"
 #include "common/string_oprs.h"
@@ -17,18 +22,195 @@
 
 #include "log/log_sink_file_backend.h"
 
+#if defined(UTIL_FS_WINDOWS_API)
+#  include <io.h>
+#else
+#  include <errno.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif
+
 // 默认文件大小是256KB
 #define DEFAULT_FILE_SIZE 256 * 1024
+// 默认缓冲写出的超时时间
+#define DEFAULT_WRITE_BUFFER_TIMEOUT_MS 1000
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace log {
 
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+struct log_sink_file_backend::compression_worker_t {
+  struct task_t {
+    std::string file_path;
+    // 文件的所有引用都释放(已关闭)后才能压缩
+    std::weak_ptr<std::FILE> opened_file;
+    compression::algorithm_t algorithm;
+    compression::level_t level;
+  };
+
+  std::mutex lock;
+  std::condition_variable cv;
+  std::deque<task_t> pending;
+  size_t running;
+  std::string running_path;
+  bool running_cancelled;
+  bool stop;
+  std::thread worker;
+
+  compression_worker_t() : running(0), running_cancelled(false), stop(false) {
+    worker = std::thread([this]() { run(); });
+  }
+
+  ~compression_worker_t() {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stop = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  void push(task_t &&task) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      pending.emplace_back(std::move(task));
+    }
+    cv.notify_all();
+  }
+
+  // 文件要被重新打开写入前，取消它的压缩任务，否则会压缩并删除新写入的文件
+  // 正在执行的压缩只做标记，不等待它完成，以免阻塞写日志的线程
+  void cancel(const std::string &file_path) {
+    std::lock_guard<std::mutex> guard(lock);
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [&file_path](const task_t &task) { return task.file_path == file_path; }),
+                  pending.end());
+    if (0 != running && running_path == file_path) {
+      running_cancelled = true;
+    }
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+      auto iter = std::find_if(pending.begin(), pending.end(),
+                               [](const task_t &task) { return task.opened_file.expired(); });
+      if (iter != pending.end()) {
+        task_t task = std::move(*iter);
+        pending.erase(iter);
+        ++running;
+        running_path = task.file_path;
+        running_cancelled = false;
+
+        guard.unlock();
+        compress_file(task);
+        guard.lock();
+
+        running_path.clear();
+        running_cancelled = false;
+        --running;
+        cv.notify_all();
+        continue;
+      }
+
+      if (stop) {
+        // 退出时仍被引用的文件不再压缩，保留原文件
+        pending.clear();
+        cv.notify_all();
+        break;
+      }
+
+      if (pending.empty()) {
+        cv.wait(guard);
+      } else {
+        // 等待其他地方释放文件引用
+        cv.wait_for(guard, std::chrono::milliseconds{16});
+      }
+    }
+  }
+
+  void compress_file(const task_t &task) {
+    std::string content;
+    if (!file_system::get_file_content(content, task.file_path.c_str(), true)) {
+      return;
+    }
+
+    std::vector<unsigned char> output;
+    int res = compression::compress(
+        task.algorithm,
+        gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(content.data()), content.size()}, output,
+        task.level);
+    if (compression::error_code_t::kOk != res) {
+      std::cerr << "log.file compress " << task.file_path << " with "
+                << compression::get_algorithm_name(task.algorithm) << " failed, res: " << res << std::endl;
+      return;
+    }
+
+    // 先写临时文件再改名，保证压缩文件总是完整的
+    std::string target_path = task.file_path + log_sink_file_backend::get_compression_suffix(task.algorithm);
+    std::string tmp_path = target_path + ".tmp";
+    std::FILE *f = nullptr;
+    UTIL_FS_OPEN(open_res, f, tmp_path.c_str(), "wb");
+    if (nullptr == f) {
+      std::cerr << "log.file open " << tmp_path << " failed" << std::endl;
+      return;
+    }
+
+    bool write_ok = true;
+    if (compression::algorithm_t::kLz4 == task.algorithm) {
+      unsigned char original_size[8];
+      uint64_t content_size = static_cast<uint64_t>(content.size());
+      for (size_t i = 0; i < sizeof(original_size); ++i) {
+        original_size[i] = static_cast<unsigned char>((content_size >> (i * 8)) & 0xFF);
+      }
+      write_ok = sizeof(original_size) == fwrite(original_size, 1, sizeof(original_size), f);
+    }
+    if (write_ok && !output.empty()) {
+      write_ok = output.size() == fwrite(output.data(), 1, output.size(), f);
+    }
+    write_ok = 0 == std::fclose(f) && write_ok;
+
+    if (!write_ok) {
+      std::cerr << "log.file write " << tmp_path << " failed" << std::endl;
+      file_system::remove(tmp_path.c_str());
+      return;
+    }
+
+    // 改名和删除原文件时持有锁，这样 cancel() 返回后就不会再修改这个文件和它的压缩文件
+    std::lock_guard<std::mutex> guard(lock);
+    if (running_cancelled) {
+      // 文件已经被重新打开写入，丢弃压缩结果
+      file_system::remove(tmp_path.c_str());
+      return;
+    }
+
+    file_system::remove(target_path.c_str());
+    if (!file_system::rename(tmp_path.c_str(), target_path.c_str())) {
+      std::cerr << "log.file rename " << tmp_path << " to " << target_path << " failed" << std::endl;
+      file_system::remove(tmp_path.c_str());
+      return;
+    }
+    file_system::remove(task.file_path.c_str());
+  }
+};
+#endif
+
 ATFRAMEWORK_UTILS_API log_sink_file_backend::log_sink_file_backend()
     : rotation_size_(10),                 // 默认10个文件
       max_file_size_(DEFAULT_FILE_SIZE),  // 默认文件大小
       check_interval_(0),                 // 默认文件切换检查周期
       flush_interval_(0),                 // 默认关闭定时刷入
-      inited_(false) {
+      inited_(false),
+      write_buffer_size_(0),  // 默认关闭缓冲写出
+      write_buffer_timeout_(DEFAULT_WRITE_BUFFER_TIMEOUT_MS)
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+      ,
+      rotate_compression_(compression::algorithm_t::kNone),  // 默认关闭滚动压缩
+      rotate_compression_level_(compression::level_t::kDefault)
+#endif
+{
   log_file_.opened_file_point_ = 0;
   log_file_.last_flush_timepoint_ = 0;
   log_file_.auto_flush = log_level::kDisabled;
@@ -43,7 +225,15 @@ ATFRAMEWORK_UTILS_API log_sink_file_backend::log_sink_file_backend(const std::st
       max_file_size_(DEFAULT_FILE_SIZE),  // 默认文件大小
       check_interval_(0),                 // 默认文件切换检查周期
       flush_interval_(0),                 // 默认关闭定时刷入
-      inited_(false) {
+      inited_(false),
+      write_buffer_size_(0),  // 默认关闭缓冲写出
+      write_buffer_timeout_(DEFAULT_WRITE_BUFFER_TIMEOUT_MS)
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+      ,
+      rotate_compression_(compression::algorithm_t::kNone),  // 默认关闭滚动压缩
+      rotate_compression_level_(compression::level_t::kDefault)
+#endif
+{
   log_file_.opened_file_point_ = 0;
   log_file_.last_flush_timepoint_ = 0;
   log_file_.auto_flush = log_level::kDisabled;
@@ -58,7 +248,15 @@ ATFRAMEWORK_UTILS_API log_sink_file_backend::log_sink_file_backend(const log_sin
       max_file_size_(other.max_file_size_),    // 默认文件大小
       check_interval_(other.check_interval_),  // 默认文件切换检查周期
       flush_interval_(other.flush_interval_),  // 默认定时刷入周期
-      inited_(false) {
+      inited_(false),
+      write_buffer_size_(other.write_buffer_size_),
+      write_buffer_timeout_(other.write_buffer_timeout_)
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+      ,
+      rotate_compression_(other.rotate_compression_),
+      rotate_compression_level_(other.rotate_compression_level_)
+#endif
+{
   log_file_.opened_file_point_ = other.log_file_.opened_file_point_;
   log_file_.last_flush_timepoint_ = other.log_file_.last_flush_timepoint_;
   set_file_pattern(other.path_pattern_);
@@ -71,6 +269,7 @@ ATFRAMEWORK_UTILS_API log_sink_file_backend::log_sink_file_backend(const log_sin
 
 ATFRAMEWORK_UTILS_API log_sink_file_backend::~log_sink_file_backend() {
   if (log_file_.opened_file) {
+    flush_write_buffer(*log_file_.opened_file, nostd::string_view{});
     fflush(log_file_.opened_file.get());
   }
 }
@@ -153,12 +352,140 @@ ATFRAMEWORK_UTILS_API void log_sink_file_backend::operator()(const log_formatter
     return;
   }
 
+  if (write_buffer_size_ > 0) {
+    write_buffered_log(caller, *f, content);
+    return;
+  }
+
   fwrite(content.data(), 1, content.size(), f.get());
   fputc('\n', f.get());
 
   after_write_log(caller, *f, content.size());
 }
 
+namespace {
+static void log_sink_file_backend_write_file(FILE &f, nostd::string_view buffered, nostd::string_view content,
+                                             bool append_new_line) {
+#if defined(UTIL_FS_WINDOWS_API)
+  int fd = _fileno(&f);
+  nostd::string_view segments[3] = {buffered, content,
+                                    append_new_line ? nostd::string_view{"\n", 1} : nostd::string_view{}};
+  for (auto &segment : segments) {
+    const char *data = segment.data();
+    size_t left = segment.size();
+    while (left > 0) {
+      unsigned int write_size = left > static_cast<size_t>(INT32_MAX) ? static_cast<unsigned int>(INT32_MAX)
+                                                                       : static_cast<unsigned int>(left);
+      int res = _write(fd, data, write_size);
+      if (res <= 0) {
+        return;
+      }
+      data += res;
+      left -= static_cast<size_t>(res);
+    }
+  }
+#else
+  int fd = fileno(&f);
+  char new_line = '\n';
+  struct iovec iov[3];
+  int iovcnt = 0;
+  if (!buffered.empty()) {
+    iov[iovcnt].iov_base = const_cast<char *>(buffered.data());
+    iov[iovcnt].iov_len = buffered.size();
+    ++iovcnt;
+  }
+  if (!content.empty()) {
+    iov[iovcnt].iov_base = const_cast<char *>(content.data());
+    iov[iovcnt].iov_len = content.size();
+    ++iovcnt;
+  }
+  if (append_new_line) {
+    iov[iovcnt].iov_base = &new_line;
+    iov[iovcnt].iov_len = 1;
+    ++iovcnt;
+  }
+
+  struct iovec *iov_begin = iov;
+  while (iovcnt > 0) {
+    ssize_t res = writev(fd, iov_begin, iovcnt);
+    if (res < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return;
+    }
+
+    // 部分写出，跳过已写出的部分
+    size_t written = static_cast<size_t>(res);
+    while (iovcnt > 0 && written >= iov_begin->iov_len) {
+      written -= iov_begin->iov_len;
+      ++iov_begin;
+      --iovcnt;
+    }
+    if (iovcnt > 0) {
+      iov_begin->iov_base = static_cast<char *>(iov_begin->iov_base) + written;
+      iov_begin->iov_len -= written;
+    }
+  }
+#endif
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API void log_sink_file_backend::write_buffered_log(const log_formatter::caller_info_t &caller,
+                                                                     FILE &f, nostd::string_view content) {
+  std::chrono::system_clock::time_point now_point = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::sys_now();
+  time_t now = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now();
+
+  lock::lock_holder<lock::spin_lock> holder(write_buffer_lock_);
+  if (write_buffer_.empty()) {
+    write_buffer_first_timepoint_ = now_point;
+  }
+
+  // 日志级别高于指定级别，需要写出
+  bool need_flush = caller.level_id >= log_file_.auto_flush;
+
+  // 定期刷入
+  if (flush_interval_ > 0 && (log_file_.last_flush_timepoint_ > now  // 说明系统时间被改小了
+                              || log_file_.last_flush_timepoint_ + flush_interval_ <= now)) {
+    need_flush = true;
+  }
+
+  // 缓冲区超时
+  if (write_buffer_timeout_.count() > 0 && (write_buffer_first_timepoint_ > now_point  // 说明系统时间被改小了
+                                            || now_point - write_buffer_first_timepoint_ >= write_buffer_timeout_)) {
+    need_flush = true;
+  }
+
+  if (need_flush || write_buffer_.size() + content.size() + 1 > write_buffer_size_) {
+    // 缓冲区和本条日志一次写出，不再拷贝本条日志
+    log_sink_file_backend_write_file(f, nostd::string_view{write_buffer_.data(), write_buffer_.size()}, content,
+                                     true);
+    write_buffer_.clear();
+    if (need_flush) {
+      log_file_.last_flush_timepoint_ = now;
+    }
+  } else {
+    if (write_buffer_.capacity() < write_buffer_size_) {
+      write_buffer_.reserve(write_buffer_size_);
+    }
+    write_buffer_.append(content.data(), content.size());
+    write_buffer_.push_back('\n');
+  }
+
+  log_file_.written_size += content.size() + 1;
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_file_backend::flush_write_buffer(FILE &f, nostd::string_view content) {
+  lock::lock_holder<lock::spin_lock> holder(write_buffer_lock_);
+  if (write_buffer_.empty() && content.empty()) {
+    return;
+  }
+
+  log_sink_file_backend_write_file(f, nostd::string_view{write_buffer_.data(), write_buffer_.size()}, content,
+                                   !content.empty());
+  write_buffer_.clear();
+}
+
 ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void log_sink_file_backend::after_write_log(
     const log_formatter::caller_info_t &caller, FILE &f, size_t content_size) {
   time_t now = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now();
@@ -218,6 +545,163 @@ ATFRAMEWORK_UTILS_API log_sink_file_backend &log_sink_file_backend::set_rotate_s
   return *this;
 }
 
+ATFRAMEWORK_UTILS_API size_t log_sink_file_backend::get_write_buffer_size() const { return write_buffer_size_; }
+
+ATFRAMEWORK_UTILS_API log_sink_file_backend &log_sink_file_backend::set_write_buffer_size(size_t sz) {
+  std::shared_ptr<std::FILE> f;
+  {
+    lock::read_lock_holder<lock::spin_rw_lock> lkholder(fs_lock_);
+    f = log_file_.opened_file;
+  }
+
+  if (f) {
+    // 切换写出方式前先写出所有已缓冲的数据，stdio和writev不能混用缓冲
+    flush_write_buffer(*f, nostd::string_view{});
+    fflush(f.get());
+  }
+
+  write_buffer_size_ = sz;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API std::chrono::milliseconds log_sink_file_backend::get_write_buffer_timeout() const {
+  return write_buffer_timeout_;
+}
+
+ATFRAMEWORK_UTILS_API log_sink_file_backend &log_sink_file_backend::set_write_buffer_timeout(
+    std::chrono::milliseconds timeout) {
+  write_buffer_timeout_ = timeout;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_file_backend::flush() {
+  std::shared_ptr<std::FILE> f;
+  {
+    lock::read_lock_holder<lock::spin_rw_lock> lkholder(fs_lock_);
+    f = log_file_.opened_file;
+  }
+
+  if (!f) {
+    return;
+  }
+
+  flush_write_buffer(*f, nostd::string_view{});
+  fflush(f.get());
+  log_file_.last_flush_timepoint_ = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now();
+}
+
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+ATFRAMEWORK_UTILS_API compression::algorithm_t log_sink_file_backend::get_rotate_compression() const {
+  return rotate_compression_;
+}
+
+ATFRAMEWORK_UTILS_API compression::level_t log_sink_file_backend::get_rotate_compression_level() const {
+  return rotate_compression_level_;
+}
+
+ATFRAMEWORK_UTILS_API log_sink_file_backend &log_sink_file_backend::set_rotate_compression(
+    compression::algorithm_t algorithm, compression::level_t level) {
+  if (!compression::is_algorithm_supported(algorithm)) {
+    algorithm = compression::algorithm_t::kNone;
+  }
+
+  rotate_compression_ = algorithm;
+  rotate_compression_level_ = level;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API bool log_sink_file_backend::wait_rotate_compression(std::chrono::milliseconds timeout) {
+  compression_worker_t *worker;
+  {
+    lock::lock_holder<lock::spin_lock> holder(compression_worker_lock_);
+    worker = compression_worker_.get();
+  }
+  if (nullptr == worker) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> guard(worker->lock);
+  return worker->cv.wait_for(guard, timeout, [worker]() { return worker->pending.empty() && 0 == worker->running; });
+}
+
+ATFRAMEWORK_UTILS_API const char *log_sink_file_backend::get_compression_suffix(compression::algorithm_t algorithm) {
+  switch (algorithm) {
+    case compression::algorithm_t::kZstd:
+      return ".zst";
+    case compression::algorithm_t::kLz4:
+      return ".lz4";
+    case compression::algorithm_t::kSnappy:
+      return ".snappy";
+    case compression::algorithm_t::kZlib:
+      return ".zz";
+    default:
+      return "";
+  }
+}
+
+ATFRAMEWORK_UTILS_API bool log_sink_file_backend::is_compressed_segment_exist(const char *file_path) const {
+  // 切换压缩算法后，之前的压缩文件仍然要能识别
+  const compression::algorithm_t algorithms[] = {compression::algorithm_t::kZstd, compression::algorithm_t::kLz4,
+                                                 compression::algorithm_t::kSnappy, compression::algorithm_t::kZlib};
+  std::string compressed_path;
+  for (auto &algorithm : algorithms) {
+    compressed_path = file_path;
+    compressed_path += get_compression_suffix(algorithm);
+    if (file_system::is_exist(compressed_path.c_str())) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_file_backend::remove_compressed_segment(const char *file_path) const {
+  const compression::algorithm_t algorithms[] = {compression::algorithm_t::kZstd, compression::algorithm_t::kLz4,
+                                                 compression::algorithm_t::kSnappy, compression::algorithm_t::kZlib};
+  std::string compressed_path;
+  for (auto &algorithm : algorithms) {
+    compressed_path = file_path;
+    compressed_path += get_compression_suffix(algorithm);
+    if (file_system::is_exist(compressed_path.c_str())) {
+      file_system::remove(compressed_path.c_str());
+    }
+  }
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_file_backend::compress_finished_log_file(const std::string &file_path,
+                                                                             std::weak_ptr<std::FILE> opened_file) {
+  if (compression::algorithm_t::kNone == rotate_compression_ || file_path.empty()) {
+    return;
+  }
+
+  compression_worker_t::task_t task;
+  task.file_path = file_path;
+  task.opened_file = std::move(opened_file);
+  task.algorithm = rotate_compression_;
+  task.level = rotate_compression_level_;
+
+  // 后台线程在第一次压缩时才创建
+  lock::lock_holder<lock::spin_lock> holder(compression_worker_lock_);
+  if (!compression_worker_) {
+    compression_worker_.reset(new compression_worker_t());
+  }
+  compression_worker_->push(std::move(task));
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_file_backend::cancel_finished_log_file_compression(const std::string &file_path) {
+  compression_worker_t *worker;
+  {
+    lock::lock_holder<lock::spin_lock> holder(compression_worker_lock_);
+    worker = compression_worker_.get();
+  }
+  if (nullptr == worker) {
+    return;
+  }
+
+  worker->cancel(file_path);
+}
+#endif
+
 ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void log_sink_file_backend::init() {
   if (inited_) {
     return;
@@ -242,6 +726,13 @@ ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void log_sink_file_backend::
     log_formatter::format(log_file, sizeof(log_file), path_pattern_.c_str(), path_pattern_.size(), caller);
     file_system::file_size(log_file, fsz);
 
+    // 已压缩的文件也是已写完的文件
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+    if (is_compressed_segment_exist(log_file)) {
+      continue;
+    }
+#endif
+
     // 文件不存在fsz也是0
     if (fsz < max_file_size_) {
       log_file_.rotation_index = caller.rotate_index;
@@ -278,6 +769,11 @@ ATFRAMEWORK_UTILS_API std::shared_ptr<std::FILE> log_sink_file_backend::open_log
     log_file[file_path_len] = 0;
   }
 
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  // 轮转回到一个还在等待压缩的文件时，不能让后台线程再压缩和删除它
+  cancel_finished_log_file_compression(std::string(log_file, file_path_len));
+#endif
+
   std::shared_ptr<std::FILE> of;
   std::string dir_name;
   ATFRAMEWORK_UTILS_NAMESPACE_ID::file_system::dirname(log_file, file_path_len, dir_name);
@@ -287,6 +783,11 @@ ATFRAMEWORK_UTILS_API std::shared_ptr<std::FILE> log_sink_file_backend::open_log
 
   // 销毁原先的内容
   if (destroy_content) {
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+    // 轮转回来时上一轮的压缩文件也要删除
+    remove_compressed_segment(log_file);
+#endif
+
     std::FILE *destroy_file = nullptr;
     UTIL_FS_OPEN(dfe, destroy_file, log_file, "wb");
     if (nullptr == destroy_file) {
@@ -356,12 +857,43 @@ ATFRAMEWORK_UTILS_API std::shared_ptr<std::FILE> log_sink_file_backend::open_log
 }
 
 ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void log_sink_file_backend::rotate_log() {
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  std::string finished_file_path;
+  std::weak_ptr<std::FILE> finished_file;
+  if (compression::algorithm_t::kNone != rotate_compression_) {
+    lock::read_lock_holder<lock::spin_rw_lock> lkholder(fs_lock_);
+    if (log_file_.opened_file) {
+      finished_file_path = log_file_.file_path;
+      finished_file = log_file_.opened_file;
+    }
+  }
+#endif
+
   if (rotation_size_ > 0) {
     log_file_.rotation_index = (log_file_.rotation_index + 1) % rotation_size_;
   } else {
     log_file_.rotation_index = 0;
   }
+
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  // 路径里没有%N或者只有一个滚动文件时，下一个文件还是同一个路径，它会被清空后重新写入，不能压缩
+  if (!finished_file_path.empty()) {
+    char next_file[file_system::MAX_PATH_LEN];
+    log_formatter::caller_info_t caller;
+    caller.rotate_index = log_file_.rotation_index;
+    size_t next_file_len =
+        log_formatter::format(next_file, sizeof(next_file), path_pattern_.c_str(), path_pattern_.size(), caller);
+    if (next_file_len > 0 && 0 == finished_file_path.compare(0, std::string::npos, next_file, next_file_len)) {
+      finished_file_path.clear();
+    }
+  }
+#endif
+
   reset_log_file();
+
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  compress_finished_log_file(finished_file_path, std::move(finished_file));
+#endif
 }
 
 ATFW_UTIL_SANITIZER_NO_THREAD static bool _check_update_file_path_not_changed(lock::spin_rw_lock &fs_lock,
@@ -419,13 +951,36 @@ ATFRAMEWORK_UTILS_API void log_sink_file_backend::check_update() {
     log_file_.rotation_index = 0;
   }
 
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  // 滚动后还未打开新文件时，旧文件已经在rotate_log中处理过了
+  std::string finished_file_path;
+  std::weak_ptr<std::FILE> finished_file;
+  if (compression::algorithm_t::kNone != rotate_compression_) {
+    lock::read_lock_holder<lock::spin_rw_lock> lkholder(fs_lock_);
+    if (log_file_.opened_file) {
+      finished_file_path = old_file_path;
+      finished_file = log_file_.opened_file;
+    }
+  }
+#endif
+
   reset_log_file();
+
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+  // 按时间切换的文件也已经写完了
+  compress_finished_log_file(finished_file_path, std::move(finished_file));
+#endif
 }
 
 ATFRAMEWORK_UTILS_API void log_sink_file_backend::reset_log_file() {
   // 更换日志文件需要加锁
   lock::write_lock_holder<lock::spin_rw_lock> lkholder(fs_lock_);
 
+  // 关闭前写出缓冲区，保证切换文件后旧文件内容完整
+  if (log_file_.opened_file) {
+    flush_write_buffer(*log_file_.opened_file, nostd::string_view{});
+  }
+
   // 必须依赖析构来关闭文件，以防这个文件正在其他地方被引用
   log_file_.opened_file.reset();
   log_file_.opened_file_point_ = 0;
@@ -0,0 +1,538 @@
+// Copyright 2026 atframework
+//
+// Licensed under the MIT licenses.
+// Created by owent on 2026-10-16
+
+#include "log/log_sink_mmap_file_backend.h"
+
+#if defined(ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT) && ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT
+
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <sys/types.h>
+#  include <unistd.h>
+
+#  include <cstring>
+#  include <iostream>
+#  include <limits>
+
+#  include "common/file_system.h"
+#  include "lock/lock_holder.h"
+#  include "time/time_utility.h"
+
+// Default file size is 256KB, the same as log_sink_file_backend
+#  define DEFAULT_MMAP_FILE_SIZE 256 * 1024
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace log {
+
+struct log_sink_mmap_file_backend::segment_t {
+  int fd;
+  char *base;
+  size_t capacity;
+  // Reserved size, may be greater than capacity when it's full
+  std::atomic<size_t> cursor;
+  // The offset of the only one reservation which crosses the end
+  std::atomic<size_t> tail_size;
+  std::atomic<time_t> check_timepoint;
+  uint32_t rotation_index;
+  std::string file_path;
+
+  segment_t()
+      : fd(-1),
+        base(nullptr),
+        capacity(0),
+        cursor(0),
+        tail_size(std::numeric_limits<size_t>::max()),
+        check_timepoint(0),
+        rotation_index(0) {}
+
+  ~segment_t() {
+    size_t real_size = get_real_size();
+    if (nullptr != base) {
+      munmap(base, capacity);
+    }
+    if (fd >= 0) {
+      // Remove the preallocated but unused space
+      if (0 != ftruncate(fd, static_cast<off_t>(real_size))) {
+        std::cerr << "log.mmap ftruncate " << file_path << " failed, errno: " << errno << std::endl;
+      }
+      close(fd);
+    }
+  }
+
+  size_t get_real_size() const noexcept {
+    size_t ret = tail_size.load(std::memory_order_acquire);
+    if (ret != std::numeric_limits<size_t>::max()) {
+      return ret;
+    }
+
+    ret = cursor.load(std::memory_order_acquire);
+    return ret < capacity ? ret : capacity;
+  }
+};
+
+namespace {
+static time_t log_sink_mmap_file_backend_get_check_interval(const std::string &file_name_pattern) {
+  // @see log_sink_file_backend::set_file_pattern
+  time_t ret = 0;
+  for (size_t i = 0; i + 1 < file_name_pattern.size(); ++i) {
+    if (file_name_pattern[i] != '%') {
+      continue;
+    }
+
+    time_t checked = 0;
+    switch (file_name_pattern[i + 1]) {
+      case 'f':
+      case 'T':
+      case 'S':
+        checked = 1;
+        break;
+      case 'R':
+      case 'M':
+        checked = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::MINITE_SECONDS;
+        break;
+      case 'F':
+      case 'I':
+      case 'H':
+      case 'w':
+      case 'd':
+      case 'j':
+      case 'm':
+      case 'y':
+      case 'Y':
+        // Max check interval is 1 hour because of daylight saving time
+        checked = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::HOUR_SECONDS;
+        break;
+      default:
+        break;
+    }
+
+    if (checked > 0 && (0 == ret || checked < ret)) {
+      ret = checked;
+    }
+  }
+
+  return ret;
+}
+
+static size_t log_sink_mmap_file_backend_get_page_size() {
+  static size_t page_size = 0;
+  if (0 == page_size) {
+    long res = sysconf(_SC_PAGESIZE);
+    page_size = res > 0 ? static_cast<size_t>(res) : 4096;
+  }
+  return page_size;
+}
+
+static void log_sink_mmap_file_backend_msync(char *base, size_t begin, size_t end, int flags) {
+  if (nullptr == base || end <= begin) {
+    return;
+  }
+
+  size_t page_size = log_sink_mmap_file_backend_get_page_size();
+  size_t aligned_begin = begin - begin % page_size;
+  msync(base + aligned_begin, end - aligned_begin, flags);
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend::log_sink_mmap_file_backend()
+    : rotation_size_(10),
+      max_file_size_(DEFAULT_MMAP_FILE_SIZE),
+      check_interval_(0),
+      flush_interval_(0),
+      auto_flush_(log_level::kDisabled),
+      last_flush_timepoint_(0),
+      inited_(false),
+      reopen_rotation_index_(0),
+      reopen_destroy_content_(false),
+      reopen_failed_timepoint_(0) {
+  set_file_pattern("%Y-%m-%d.%N.log");
+}
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend::log_sink_mmap_file_backend(const std::string &file_name_pattern)
+    : rotation_size_(10),
+      max_file_size_(DEFAULT_MMAP_FILE_SIZE),
+      check_interval_(0),
+      flush_interval_(0),
+      auto_flush_(log_level::kDisabled),
+      last_flush_timepoint_(0),
+      inited_(false),
+      reopen_rotation_index_(0),
+      reopen_destroy_content_(false),
+      reopen_failed_timepoint_(0) {
+  set_file_pattern(file_name_pattern);
+}
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend::log_sink_mmap_file_backend(const log_sink_mmap_file_backend &other)
+    : rotation_size_(other.rotation_size_),
+      max_file_size_(other.max_file_size_),
+      check_interval_(other.check_interval_),
+      flush_interval_(other.flush_interval_),
+      auto_flush_(other.auto_flush_),
+      last_flush_timepoint_(0),
+      inited_(false),
+      reopen_rotation_index_(0),
+      reopen_destroy_content_(false),
+      reopen_failed_timepoint_(0) {
+  // Opened files can not be shared, the copy will open them again
+  set_file_pattern(other.path_pattern_);
+  check_interval_ = other.check_interval_;
+}
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend::~log_sink_mmap_file_backend() { reset_segment(nullptr); }
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::set_file_pattern(const std::string &file_name_pattern) {
+  {
+    lock::lock_holder<lock::spin_lock> lkholder(rotate_lock_);
+    check_interval_ = log_sink_mmap_file_backend_get_check_interval(file_name_pattern);
+    path_pattern_ = file_name_pattern;
+  }
+
+  // Reopen if it's already inited
+  if (inited_.load(std::memory_order_acquire)) {
+    reset_segment(nullptr);
+    inited_.store(false, std::memory_order_release);
+    init();
+  }
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::operator()(const log_formatter::caller_info_t &caller,
+                                                                  nostd::string_view content) {
+  if (!inited_.load(std::memory_order_acquire)) {
+    init();
+  }
+
+  time_t now = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now();
+  // Retry a few times when the file is full or switched by other threads
+  for (int retry_times = 0; retry_times < 8; ++retry_times) {
+    std::shared_ptr<segment_t> segment = get_segment();
+    if (!segment) {
+      // Another thread is switching files or the last open failed, wait for it or open again
+      retry_open_segment(now);
+      segment = get_segment();
+      if (!segment) {
+        return;
+      }
+    }
+
+    if (check_interval_ > 0 && now / check_interval_ !=
+                                   segment->check_timepoint.load(std::memory_order_relaxed) / check_interval_) {
+      check_update(segment, now);
+      continue;
+    }
+
+    // Truncate record larger than the whole file
+    nostd::string_view record = content;
+    if (record.size() + 1 > segment->capacity) {
+      record = record.substr(0, segment->capacity - 1);
+    }
+
+    size_t record_size = record.size() + 1;
+    size_t offset = segment->cursor.fetch_add(record_size, std::memory_order_acq_rel);
+    if (offset + record_size <= segment->capacity) {
+      if (!record.empty()) {
+        memcpy(segment->base + offset, record.data(), record.size());
+      }
+      segment->base[offset + record.size()] = '\n';
+
+      if (caller.level_id >= auto_flush_) {
+        log_sink_mmap_file_backend_msync(segment->base, offset, offset + record_size, MS_ASYNC);
+      }
+
+      if (flush_interval_ > 0) {
+        time_t last_flush_timepoint = last_flush_timepoint_.load(std::memory_order_relaxed);
+        if ((last_flush_timepoint > now || last_flush_timepoint + flush_interval_ <= now) &&
+            last_flush_timepoint_.compare_exchange_strong(last_flush_timepoint, now, std::memory_order_relaxed)) {
+          log_sink_mmap_file_backend_msync(segment->base, 0, offset + record_size, MS_ASYNC);
+        }
+      }
+      return;
+    }
+
+    // This is the reservation which crosses the end, all data before it is valid
+    if (offset < segment->capacity) {
+      segment->tail_size.store(offset, std::memory_order_release);
+    }
+    rotate_segment(segment);
+  }
+}
+
+ATFRAMEWORK_UTILS_API time_t log_sink_mmap_file_backend::get_check_interval() const { return check_interval_; }
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &log_sink_mmap_file_backend::set_check_interval(
+    time_t check_interval) {
+  check_interval_ = check_interval;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API time_t log_sink_mmap_file_backend::get_flush_interval() const { return flush_interval_; }
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &log_sink_mmap_file_backend::set_flush_interval(time_t v) {
+  flush_interval_ = v;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API log_level log_sink_mmap_file_backend::get_auto_flush() const { return auto_flush_; }
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &log_sink_mmap_file_backend::set_auto_flush(log_level flush_level) {
+  auto_flush_ = flush_level;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API size_t log_sink_mmap_file_backend::get_max_file_size() const { return max_file_size_; }
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &log_sink_mmap_file_backend::set_max_file_size(
+    size_t max_file_size) {
+  // The whole file is mapped, so it can not be unlimited
+  if (0 == max_file_size) {
+    max_file_size = DEFAULT_MMAP_FILE_SIZE;
+  }
+  max_file_size_ = max_file_size;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API uint32_t log_sink_mmap_file_backend::get_rotate_size() const { return rotation_size_; }
+
+ATFRAMEWORK_UTILS_API log_sink_mmap_file_backend &log_sink_mmap_file_backend::set_rotate_size(uint32_t sz) {
+  if (sz <= 1) {
+    sz = 1;
+  }
+  rotation_size_ = sz;
+  return *this;
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::flush() {
+  std::shared_ptr<segment_t> segment = get_segment();
+  if (!segment) {
+    return;
+  }
+
+  log_sink_mmap_file_backend_msync(segment->base, 0, segment->get_real_size(), MS_SYNC);
+  last_flush_timepoint_.store(ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now(),
+                              std::memory_order_relaxed);
+}
+
+ATFRAMEWORK_UTILS_API std::string log_sink_mmap_file_backend::get_current_file_path() const {
+  std::shared_ptr<segment_t> segment = get_segment();
+  if (!segment) {
+    return std::string();
+  }
+
+  return segment->file_path;
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::init() {
+  lock::lock_holder<lock::spin_lock> lkholder(rotate_lock_);
+  if (inited_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // Find the first file which is not full, the same as log_sink_file_backend
+  uint32_t rotation_index = 0;
+  log_formatter::caller_info_t caller;
+  char log_file[file_system::MAX_PATH_LEN];
+  for (uint32_t i = 0; i < rotation_size_; ++i) {
+    caller.rotate_index = i;
+    size_t fsz = 0;
+    log_formatter::format(log_file, sizeof(log_file), path_pattern_.c_str(), path_pattern_.size(), caller);
+    file_system::file_size(log_file, fsz);
+
+    if (fsz < max_file_size_) {
+      rotation_index = i;
+      break;
+    }
+  }
+
+  switch_segment(rotation_index, false);
+  inited_.store(true, std::memory_order_release);
+}
+
+ATFRAMEWORK_UTILS_API std::shared_ptr<log_sink_mmap_file_backend::segment_t> log_sink_mmap_file_backend::get_segment()
+    const {
+  lock::read_lock_holder<lock::spin_rw_lock> holder(segment_lock_);
+  return current_segment_;
+}
+
+ATFRAMEWORK_UTILS_API std::shared_ptr<log_sink_mmap_file_backend::segment_t> log_sink_mmap_file_backend::open_segment(
+    uint32_t rotation_index, bool destroy_content) {
+  char log_file[file_system::MAX_PATH_LEN + 1];
+  log_formatter::caller_info_t caller;
+  caller.rotate_index = rotation_index;
+  size_t file_path_len =
+      log_formatter::format(log_file, sizeof(log_file), path_pattern_.c_str(), path_pattern_.size(), caller);
+  if (file_path_len <= 0) {
+    std::cerr << "log.format " << path_pattern_ << " failed" << std::endl;
+    return nullptr;
+  }
+  if (file_path_len < sizeof(log_file)) {
+    log_file[file_path_len] = 0;
+  }
+
+  std::string dir_name;
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::file_system::dirname(log_file, file_path_len, dir_name);
+  if (!dir_name.empty() && !ATFRAMEWORK_UTILS_NAMESPACE_ID::file_system::is_exist(dir_name.c_str())) {
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::file_system::mkdir(dir_name.c_str(), true);
+  }
+
+  int flags = O_RDWR | O_CREAT;
+#  ifdef O_CLOEXEC
+  flags |= O_CLOEXEC;
+#  endif
+  if (destroy_content) {
+    // Writers may still hold the old segment of the same path(no %N in pattern, rotation size is 1 or the index wraps).
+    // Truncating the shared inode under their mappings causes SIGBUS, and the old segment will truncate the new file
+    // when it's closed, so always create a new inode instead of O_TRUNC.
+    if (0 != unlink(log_file) && ENOENT != errno) {
+      std::cerr << "log.mmap unlink " << static_cast<const char *>(log_file) << " failed, errno: " << errno
+                << std::endl;
+      return nullptr;
+    }
+  }
+
+  std::shared_ptr<segment_t> ret = std::make_shared<segment_t>();
+  ret->rotation_index = rotation_index;
+  ret->file_path.assign(log_file, file_path_len);
+  ret->check_timepoint.store(ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now(),
+                             std::memory_order_relaxed);
+  last_file_path_ = ret->file_path;
+
+  ret->fd = open(log_file, flags, 0644);
+  if (ret->fd < 0) {
+    std::cerr << "log.mmap open " << static_cast<const char *>(log_file) << " failed, errno: " << errno << std::endl;
+    return nullptr;
+  }
+
+  struct stat file_stat;
+  memset(&file_stat, 0, sizeof(file_stat));
+  if (0 != fstat(ret->fd, &file_stat)) {
+    std::cerr << "log.mmap fstat " << static_cast<const char *>(log_file) << " failed, errno: " << errno << std::endl;
+    return nullptr;
+  }
+  size_t existed_size = file_stat.st_size > 0 ? static_cast<size_t>(file_stat.st_size) : 0;
+  ret->capacity = max_file_size_ > existed_size ? max_file_size_ : existed_size;
+  // It's already full, the first write will rotate it
+  ret->cursor.store(existed_size, std::memory_order_relaxed);
+
+  // Preallocate the whole file, so writing to mapped memory will not get SIGBUS when disk is full
+  int alloc_res = -1;
+#  if defined(__linux__)
+  alloc_res = fallocate(ret->fd, 0, 0, static_cast<off_t>(ret->capacity));
+#  endif
+  if (0 != alloc_res && 0 != ftruncate(ret->fd, static_cast<off_t>(ret->capacity))) {
+    std::cerr << "log.mmap preallocate " << static_cast<const char *>(log_file) << " failed, errno: " << errno
+              << std::endl;
+    ret->capacity = existed_size;
+    return nullptr;
+  }
+
+  void *base = mmap(nullptr, ret->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, ret->fd, 0);
+  if (MAP_FAILED == base) {
+    std::cerr << "log.mmap mmap " << static_cast<const char *>(log_file) << " failed, errno: " << errno << std::endl;
+    ret->capacity = existed_size;
+    return nullptr;
+  }
+  ret->base = reinterpret_cast<char *>(base);
+
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::rotate_segment(const std::shared_ptr<segment_t> &full_segment) {
+  lock::lock_holder<lock::spin_lock> lkholder(rotate_lock_);
+  if (get_segment() != full_segment) {
+    // Already rotated by other thread
+    return;
+  }
+
+  uint32_t rotation_index = 0;
+  if (rotation_size_ > 0) {
+    rotation_index = (full_segment->rotation_index + 1) % rotation_size_;
+  }
+
+  switch_segment(rotation_index, true);
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::check_update(const std::shared_ptr<segment_t> &segment,
+                                                                    time_t now) {
+  lock::lock_holder<lock::spin_lock> lkholder(rotate_lock_);
+  if (get_segment() != segment) {
+    return;
+  }
+
+  char log_file[file_system::MAX_PATH_LEN];
+  log_formatter::caller_info_t caller;
+  caller.rotate_index = segment->rotation_index;
+  size_t file_path_len =
+      log_formatter::format(log_file, sizeof(log_file), path_pattern_.c_str(), path_pattern_.size(), caller);
+  if (file_path_len <= 0) {
+    return;
+  }
+
+  std::string new_file_path;
+  new_file_path.assign(log_file, file_path_len);
+  if (new_file_path == segment->file_path) {
+    // File name is not changed in this period, skip checking until next period
+    segment->check_timepoint.store(now, std::memory_order_relaxed);
+    return;
+  }
+
+  // Reset rotation index if directory changed
+  std::string new_dir;
+  std::string old_dir;
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::file_system::dirname(new_file_path.c_str(), new_file_path.size(), new_dir);
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::file_system::dirname(last_file_path_.c_str(), last_file_path_.size(), old_dir);
+  uint32_t rotation_index = segment->rotation_index;
+  if (new_dir != old_dir) {
+    rotation_index = 0;
+  }
+
+  switch_segment(rotation_index, true);
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::switch_segment(uint32_t rotation_index, bool destroy_content) {
+  // Release the old file first, it will be truncated after all writers finished
+  reset_segment(nullptr);
+
+  std::shared_ptr<segment_t> segment = open_segment(rotation_index, destroy_content);
+  if (!segment) {
+    // Keep what to open, the next writer will try again
+    reopen_rotation_index_ = rotation_index;
+    reopen_destroy_content_ = destroy_content;
+    reopen_failed_timepoint_ = ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::get_sys_now();
+    return;
+  }
+
+  reset_segment(std::move(segment));
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::retry_open_segment(time_t now) {
+  lock::lock_holder<lock::spin_lock> lkholder(rotate_lock_);
+  // Already opened by other thread
+  if (get_segment()) {
+    return;
+  }
+
+  // Try at most once per second, open may fail for a long time, such as disk full
+  if (now == reopen_failed_timepoint_) {
+    return;
+  }
+
+  switch_segment(reopen_rotation_index_, reopen_destroy_content_);
+}
+
+ATFRAMEWORK_UTILS_API void log_sink_mmap_file_backend::reset_segment(std::shared_ptr<segment_t> segment) {
+  {
+    lock::write_lock_holder<lock::spin_rw_lock> holder(segment_lock_);
+    current_segment_.swap(segment);
+  }
+
+  // The old segment is destroyed here or by the last writer
+  segment.reset();
+}
+
+}  // namespace log
+ATFRAMEWORK_UTILS_NAMESPACE_END
+
+#endif
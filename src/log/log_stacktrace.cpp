@@ -7,6 +7,7 @@
 
 #include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "design_pattern/singleton.h"
@@ -16,6 +17,11 @@
 #include "common/string_oprs.h"
 #include "log/log_wrapper.h"
 
+#if defined(__linux__)
+#  include <link.h>
+#  include <unistd.h>
+#endif
+
 #ifndef ATFRAMEWORK_UTILS_LOG_STACKTRACE_MAX_STACKS
 #  define ATFRAMEWORK_UTILS_LOG_STACKTRACE_MAX_STACKS 256
 #endif
@@ -1215,6 +1221,136 @@ ATFRAMEWORK_UTILS_API std::shared_ptr<stacktrace_symbol> stacktrace_find_symbol(
   return nullptr;
 }
 
+namespace {
+static size_t stacktrace_write_symbols(char *buf, size_t bufsz,
+                                       const std::vector<std::shared_ptr<stacktrace_symbol>> &symbols) {
+  int frame_id = 0;
+  size_t ret = 0;
+  for (auto &symbol : symbols) {
+    if (!symbol) {
+      ++frame_id;
+      continue;
+    }
+
+    auto res = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::format_to_n(buf, bufsz, "Frame #{:#03}: ({}{}) [{:#x}]\r\n",
+                                                                   frame_id, symbol->get_demangle_name(),
+                                                                   symbol->get_offset_hint(), symbol->get_address());
+
+    if (res.size <= 0) {
+      break;
+    }
+
+    // res.size is the total (not truncated) output size, cap to bufsz
+    size_t actual_written = static_cast<size_t>(res.size);
+    if (actual_written >= bufsz) {
+      ret += bufsz;
+      break;
+    }
+
+    ret += actual_written;
+    buf += actual_written;
+    bufsz -= actual_written;
+
+    ++frame_id;
+  }
+
+  return ret;
+}
+
+static inline uintptr_t stacktrace_to_address(const void *address) noexcept {
+  return reinterpret_cast<uintptr_t>(address);
+}
+
+template <class TADDRESS>
+static inline typename std::enable_if<std::is_integral<TADDRESS>::value, uintptr_t>::type
+stacktrace_to_address(TADDRESS address) noexcept {
+  return static_cast<uintptr_t>(address);
+}
+
+template <class TADDRESS>
+static size_t stacktrace_copy_addresses(const TADDRESS *stacks, size_t frames_count, uintptr_t *addresses,
+                                        size_t max_frames, const stacktrace_options *options) noexcept {
+  // The frame of stacktrace_get_addresses is also skipped
+  size_t skip_frames = 1 + static_cast<size_t>(options->skip_start_frames);
+  if (frames_count <= skip_frames + options->skip_end_frames) {
+    return 0;
+  }
+  frames_count -= options->skip_end_frames;
+
+  size_t ret = 0;
+  for (size_t i = skip_frames; i < frames_count && ret < max_frames; ++i) {
+    if (0 != options->max_frames && ret >= options->max_frames) {
+      break;
+    }
+
+    uintptr_t address = stacktrace_to_address(stacks[i]);
+    if (0 == address || 0x01 == address) {
+      break;
+    }
+    addresses[ret++] = address;
+  }
+
+  return ret;
+}
+
+#if defined(__linux__)
+struct ATFW_UTIL_SYMBOL_LOCAL stacktrace_module_map_writer_t {
+  char *buf;
+  size_t bufsz;
+  size_t written;
+};
+
+static int stacktrace_write_module_map_callback(struct dl_phdr_info *info, size_t, void *data) {
+  stacktrace_module_map_writer_t *writer = reinterpret_cast<stacktrace_module_map_writer_t *>(data);
+  if (nullptr == info || writer->written >= writer->bufsz) {
+    return 1;
+  }
+
+  uintptr_t start_address = 0;
+  uintptr_t end_address = 0;
+  for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+    if (PT_LOAD != info->dlpi_phdr[i].p_type) {
+      continue;
+    }
+    uintptr_t segment_start = static_cast<uintptr_t>(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+    uintptr_t segment_end = segment_start + static_cast<uintptr_t>(info->dlpi_phdr[i].p_memsz);
+    if (0 == start_address || segment_start < start_address) {
+      start_address = segment_start;
+    }
+    if (segment_end > end_address) {
+      end_address = segment_end;
+    }
+  }
+  if (0 == end_address) {
+    return 0;
+  }
+
+  // The main executable has an empty name
+  const char *module_path = info->dlpi_name;
+  char executable_path[512];
+  if (nullptr == module_path || 0 == *module_path) {
+    ssize_t len = readlink("/proc/self/exe", executable_path, sizeof(executable_path) - 1);
+    if (len <= 0) {
+      return 0;
+    }
+    executable_path[len] = 0;
+    module_path = executable_path;
+  }
+
+  auto res = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::format_to_n(
+      writer->buf + writer->written, writer->bufsz - writer->written, "{:#x} {:#x} {:#x} {}\n",
+      static_cast<uintptr_t>(info->dlpi_addr), start_address, end_address, module_path);
+  size_t actual_written = static_cast<size_t>(res.size);
+  if (actual_written >= writer->bufsz - writer->written) {
+    writer->written = writer->bufsz;
+    return 1;
+  }
+  writer->written += actual_written;
+  return 0;
+}
+#endif
+}  // namespace
+
 ATFRAMEWORK_UTILS_API size_t stacktrace_write(char *buf, size_t bufsz, const stacktrace_options *options) {
   if (nullptr == buf || bufsz <= 0) {
     return 0;
@@ -1227,23 +1363,104 @@ ATFRAMEWORK_UTILS_API size_t stacktrace_write(char *buf, size_t bufsz, const sta
   std::vector<std::shared_ptr<stacktrace_symbol>> symbols;
   stacktrace_parse_symbols(gsl::make_span(stack_handles), symbols);
 
-  int frame_id = 0;
-  size_t ret = 0;
-  for (auto &symbol : symbols) {
-    if (!symbol) {
-      ++frame_id;
-      continue;
+  return stacktrace_write_symbols(buf, bufsz, symbols);
+}
+
+ATFRAMEWORK_UTILS_API size_t stacktrace_get_addresses(uintptr_t *addresses, size_t max_frames,
+                                                      const stacktrace_options *options) noexcept {
+  if (nullptr == addresses || 0 == max_frames) {
+    return 0;
+  }
+
+  if (nullptr == options) {
+    options = &default_stacktrace_options();
+  }
+
+#if defined(ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_LIBUNWIND) && ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_LIBUNWIND
+  unw_context_t unw_ctx;
+  unw_cursor_t unw_cur;
+  unw_getcontext(&unw_ctx);
+  unw_init_local(&unw_cur, &unw_ctx);
+
+  unw_word_t stacks[LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE];
+  size_t frames_count = 0;
+  do {
+    unw_word_t ip = 0;
+    if (unw_get_reg(&unw_cur, UNW_REG_IP, &ip) < 0 || 0 == ip) {
+      break;
     }
+    stacks[frames_count++] = ip;
+  } while (frames_count < LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE && unw_step(&unw_cur) > 0);
 
-    auto res = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::format_to_n(buf, bufsz, "Frame #{:#03}: ({}{}) [{:#x}]\r\n",
-                                                                   frame_id, symbol->get_demangle_name(),
-                                                                   symbol->get_offset_hint(), symbol->get_address());
+  return stacktrace_copy_addresses(stacks, frames_count, addresses, max_frames, options);
+#elif defined(ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_EXECINFO) && ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_EXECINFO
+  void *stacks[LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE] = {nullptr};
+  size_t frames_count = static_cast<size_t>(backtrace(stacks, LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE));
+
+  return stacktrace_copy_addresses(stacks, frames_count, addresses, max_frames, options);
+#elif defined(ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_UNWIND) && ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_UNWIND
+  _Unwind_Word stacks[LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE];
+  stacktrace_unwind_state_t state;
+  state.frames_to_skip = 0;
+  state.current = stacks;
+  state.end = stacks + LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE;
+
+  ::_Unwind_Backtrace(&stacktrace_unwind_callback, &state);
+  size_t frames_count = static_cast<size_t>(state.current - &stacks[0]);
+
+  return stacktrace_copy_addresses(stacks, frames_count, addresses, max_frames, options);
+#elif (defined(ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_DBGHELP) && ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_DBGHELP) || \
+    (defined(ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_DBGENG) && ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_DBGENG)
+  PVOID stacks[LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE];
+  USHORT frames_count = CaptureStackBackTrace(0, LOG_STACKTRACE_MAX_STACKS_ARRAY_SIZE, stacks, nullptr);
+
+  return stacktrace_copy_addresses(stacks, static_cast<size_t>(frames_count), addresses, max_frames, options);
+#else
+  return 0;
+#endif
+}
+
+ATFRAMEWORK_UTILS_API size_t stacktrace_write_addresses(char *buf, size_t bufsz,
+                                                        gsl::span<const uintptr_t> addresses) {
+  if (nullptr == buf || bufsz <= 0) {
+    return 0;
+  }
+
+#if defined(ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_LIBUNWIND) && ATFRAMEWORK_UTILS_LOG_STACKTRACE_USING_LIBUNWIND
+  // libunwind can only resolve symbols with a cursor of the current stack
+  return stacktrace_write_raw(buf, bufsz, addresses);
+#else
+  if (!is_stacktrace_enabled()) {
+    return stacktrace_write_raw(buf, bufsz, addresses);
+  }
 
+  std::vector<stacktrace_handle> stack_handles;
+  stack_handles.reserve(addresses.size());
+  for (auto &address : addresses) {
+    stack_handles.emplace_back(stacktrace_handle{address});
+  }
+
+  std::vector<std::shared_ptr<stacktrace_symbol>> symbols;
+  stacktrace_parse_symbols(gsl::make_span(stack_handles), symbols);
+
+  return stacktrace_write_symbols(buf, bufsz, symbols);
+#endif
+}
+
+ATFRAMEWORK_UTILS_API size_t stacktrace_write_raw(char *buf, size_t bufsz, gsl::span<const uintptr_t> addresses) {
+  if (nullptr == buf || bufsz <= 0) {
+    return 0;
+  }
+
+  int frame_id = 0;
+  size_t ret = 0;
+  for (auto &address : addresses) {
+    auto res = ATFRAMEWORK_UTILS_NAMESPACE_ID::string::format_to_n(buf, bufsz, "Frame #{:#03}: [{:#x}]\r\n", frame_id,
+                                                                   address);
     if (res.size <= 0) {
       break;
     }
 
-    // res.size is the total (not truncated) output size, cap to bufsz
     size_t actual_written = static_cast<size_t>(res.size);
     if (actual_written >= bufsz) {
       ret += bufsz;
@@ -1260,6 +1477,23 @@ ATFRAMEWORK_UTILS_API size_t stacktrace_write(char *buf, size_t bufsz, const sta
   return ret;
 }
 
+ATFRAMEWORK_UTILS_API size_t stacktrace_write_module_map(char *buf, size_t bufsz) {
+  if (nullptr == buf || bufsz <= 0) {
+    return 0;
+  }
+
+#if defined(__linux__)
+  stacktrace_module_map_writer_t writer;
+  writer.buf = buf;
+  writer.bufsz = bufsz;
+  writer.written = 0;
+  dl_iterate_phdr(stacktrace_write_module_map_callback, &writer);
+  return writer.written;
+#else
+  return 0;
+#endif
+}
+
 }  // namespace log
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
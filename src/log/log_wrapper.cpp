@@ -3,10 +3,11 @@
 // Licensed under the MIT licenses.
 // Created by owent on 2015-06-29
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
-#include <iterator>
+#include <limits>
 
 #include "std/thread.h"
 
@@ -81,17 +82,204 @@ ATFRAMEWORK_UTILS_NAMESPACE_END
 
 #endif
 
+#ifndef ATFRAMEWORK_UTILS_LOG_STACKTRACE_MAX_STACKS
+#  define ATFRAMEWORK_UTILS_LOG_STACKTRACE_MAX_STACKS 256
+#endif
+
+#define LOG_WRAPPER_STACKTRACE_MAX_RAW_FRAMES ATFRAMEWORK_UTILS_LOG_STACKTRACE_MAX_STACKS
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace log {
 namespace {
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 static bool log_wrapper_global_destroyed_ = false;
+
+static const char kLogWrapperStacktraceTitle[] = "\r\nCall stacks:\r\n";
+
+// 在异步线程中解析调用栈地址的符号
+static size_t log_wrapper_render_stacktrace_addresses(char *out, size_t out_size, const unsigned char *data,
+                                                      size_t data_size) {
+  size_t ret = sizeof(kLogWrapperStacktraceTitle) - 1;
+  if (ret > out_size) {
+    ret = out_size;
+  }
+  memcpy(out, kLogWrapperStacktraceTitle, ret);
+
+  uintptr_t addresses[LOG_WRAPPER_STACKTRACE_MAX_RAW_FRAMES];
+  size_t frames = data_size / sizeof(uintptr_t);
+  if (frames > LOG_WRAPPER_STACKTRACE_MAX_RAW_FRAMES) {
+    frames = LOG_WRAPPER_STACKTRACE_MAX_RAW_FRAMES;
+  }
+  if (frames > 0) {
+    memcpy(addresses, data, frames * sizeof(uintptr_t));
+  }
+
+  if (ret < out_size) {
+    ret += stacktrace_write_addresses(out + ret, out_size - ret, gsl::span<const uintptr_t>{addresses, frames});
+  }
+  return ret;
+}
+
+// 登记过的限流/采样调用点，update()时汇总输出被抑制的日志数
+struct log_wrapper_callsite_summary_t {
+  log_wrapper *logger;
+  log_callsite_suppressed_counter *counter;
+  log_wrapper::caller_info_t caller;
+};
+
+struct log_wrapper_callsite_summary_registry_t {
+  lock::spin_lock lock;
+  // 没有登记的调用点时update()不需要加锁
+  std::atomic<size_t> size;
+  // 下一次汇总的时间(粗粒度时钟)，开启OPT_AUTO_UPDATE_TIME时每条日志都会调用update()，未到时间只需要一次relaxed读取
+  std::atomic<int64_t> next_flush_ns;
+  // 所有调用点中最短的汇总间隔
+  std::atomic<int64_t> flush_interval_ns;
+  std::vector<log_wrapper_callsite_summary_t> callsites;
+
+  log_wrapper_callsite_summary_registry_t()
+      : size(0), next_flush_ns(0), flush_interval_ns(std::numeric_limits<int64_t>::max()) {}
+};
+
+static log_wrapper_callsite_summary_registry_t &get_log_wrapper_callsite_summary_registry() {
+  // 不释放，静态存储的logger析构时还会访问
+  static log_wrapper_callsite_summary_registry_t *ret = new log_wrapper_callsite_summary_registry_t();
+  return *ret;
+}
+
+// 读取后端列表快照的线程槽位，进入读取时记录当时的纪元，0表示不在读取中
+// 读者只写自己的槽位，写者替换快照后推进纪元，只释放比所有槽位纪元都早被替换的快照
+struct log_wrapper_sink_reader_slot_t {
+  std::atomic<uint64_t> epoch;
+  std::atomic<bool> in_use;
+  // 嵌套读取的深度(后端里又写了日志)，只由持有槽位的线程访问
+  size_t depth;
+  log_wrapper_sink_reader_slot_t *next;
+
+  log_wrapper_sink_reader_slot_t() : epoch(0), in_use(true), depth(0), next(nullptr) {}
+};
+
+struct log_wrapper_sink_reader_slots_t {
+  std::atomic<uint64_t> epoch;
+  // 槽位只增不减，线程退出后由新线程复用
+  std::atomic<log_wrapper_sink_reader_slot_t *> head;
+
+  log_wrapper_sink_reader_slots_t() : epoch(1), head(nullptr) {}
+};
+
+static log_wrapper_sink_reader_slots_t &get_log_wrapper_sink_reader_slots() {
+  // 不释放，线程可能在静态对象析构后才退出
+  static log_wrapper_sink_reader_slots_t *ret = new log_wrapper_sink_reader_slots_t();
+  return *ret;
+}
+
+static log_wrapper_sink_reader_slot_t *acquire_log_wrapper_sink_reader_slot() {
+  log_wrapper_sink_reader_slots_t &slots = get_log_wrapper_sink_reader_slots();
+  for (log_wrapper_sink_reader_slot_t *slot = slots.head.load(std::memory_order_acquire); nullptr != slot;
+       slot = slot->next) {
+    bool expected = false;
+    if (!slot->in_use.load(std::memory_order_relaxed) &&
+        slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+      return slot;
+    }
+  }
+
+  log_wrapper_sink_reader_slot_t *slot = new log_wrapper_sink_reader_slot_t();
+  log_wrapper_sink_reader_slot_t *head = slots.head.load(std::memory_order_relaxed);
+  do {
+    slot->next = head;
+  } while (!slots.head.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+  return slot;
+}
+
+static void release_log_wrapper_sink_reader_slot(log_wrapper_sink_reader_slot_t *slot) {
+  if (nullptr != slot) {
+    slot->in_use.store(false, std::memory_order_release);
+  }
+}
+
+#if !(defined(ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && ATFRAMEWORK_UTILS_THREAD_TLS_USE_PTHREAD) && \
+    defined(THREAD_TLS_ENABLED) && 1 == THREAD_TLS_ENABLED
+struct log_wrapper_sink_reader_slot_releaser_t {
+  void operator()(log_wrapper_sink_reader_slot_t *slot) const { release_log_wrapper_sink_reader_slot(slot); }
+};
+
+static log_wrapper_sink_reader_slot_t *get_log_wrapper_sink_reader_slot() {
+  static THREAD_TLS std::unique_ptr<log_wrapper_sink_reader_slot_t, log_wrapper_sink_reader_slot_releaser_t> ret(
+      acquire_log_wrapper_sink_reader_slot());
+  return ret.get();
+}
+#else
+static pthread_once_t gt_log_wrapper_sink_reader_slot_once = PTHREAD_ONCE_INIT;
+static pthread_key_t gt_log_wrapper_sink_reader_slot_key;
+
+static void dtor_pthread_log_wrapper_sink_reader_slot(void *p) {
+  release_log_wrapper_sink_reader_slot(reinterpret_cast<log_wrapper_sink_reader_slot_t *>(p));
+}
+
+static void init_pthread_log_wrapper_sink_reader_slot() {
+  (void)pthread_key_create(&gt_log_wrapper_sink_reader_slot_key, dtor_pthread_log_wrapper_sink_reader_slot);
+}
+
+static log_wrapper_sink_reader_slot_t *get_log_wrapper_sink_reader_slot() {
+  (void)pthread_once(&gt_log_wrapper_sink_reader_slot_once, init_pthread_log_wrapper_sink_reader_slot);
+  log_wrapper_sink_reader_slot_t *ret =
+      reinterpret_cast<log_wrapper_sink_reader_slot_t *>(pthread_getspecific(gt_log_wrapper_sink_reader_slot_key));
+  if (nullptr == ret) {
+    ret = acquire_log_wrapper_sink_reader_slot();
+    pthread_setspecific(gt_log_wrapper_sink_reader_slot_key, ret);
+  }
+  return ret;
+}
+#endif
+
+// 遍历后端列表快照期间阻止被替换的快照释放，不写共享的缓存行
+// 每次读取的开销是一次TLS访问、一次写本线程槽位的seq_cst store(x86上相当于一次完整的内存屏障)、一次读取快照指针的
+// seq_cst load和退出时一次release store
+class log_wrapper_sink_reader_t {
+ public:
+  log_wrapper_sink_reader_t() : slot_(get_log_wrapper_sink_reader_slot()) {
+    if (0 == slot_->depth++) {
+      // seq_cst和写者替换快照后对槽位的检查配合，写者没看到这个槽位时，之后读取的一定是新快照
+      slot_->epoch.store(get_log_wrapper_sink_reader_slots().epoch.load(std::memory_order_acquire),
+                         std::memory_order_seq_cst);
+    }
+  }
+
+  ~log_wrapper_sink_reader_t() {
+    if (0 == --slot_->depth) {
+      slot_->epoch.store(0, std::memory_order_release);
+    }
+  }
+
+ private:
+  log_wrapper_sink_reader_slot_t *slot_;
+};
+
+// 返回正在读取的线程中最早的纪元，没有线程在读取时返回uint64_t的最大值
+static uint64_t get_log_wrapper_sink_reader_min_epoch() {
+  // 和读者写入槽位后读取快照指针的seq_cst配合，替换快照指针和推进纪元不能被重排到扫描槽位(包括新线程刚登记的槽位)之后
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  uint64_t ret = std::numeric_limits<uint64_t>::max();
+  for (log_wrapper_sink_reader_slot_t *slot = get_log_wrapper_sink_reader_slots().head.load(std::memory_order_acquire);
+       nullptr != slot; slot = slot->next) {
+    uint64_t epoch = slot->epoch.load(std::memory_order_seq_cst);
+    if (0 != epoch && epoch < ret) {
+      ret = epoch;
+    }
+  }
+  return ret;
+}
 }  // namespace
 
 ATFRAMEWORK_UTILS_API log_wrapper::log_wrapper()
     : log_level_(level_t::kDisabled),
       stacktrace_level_(level_t::kDisabled, level_t::kDisabled),
-      prefix_format_("[%F %T.%f][%L](%k:%n): ") {
+      prefix_format_("[%F %T.%f][%L](%k:%n): "),
+      log_sinks_(nullptr) {
+  log_formatter::compile(prefix_compiled_, prefix_format_.c_str(), prefix_format_.size());
+
   // 默认设为全局logger，如果是用户logger，则create_user_logger里重新设为false
   options_.set(options_t::OPT_IS_GLOBAL, true);
 
@@ -101,15 +289,39 @@ ATFRAMEWORK_UTILS_API log_wrapper::log_wrapper()
 ATFRAMEWORK_UTILS_API log_wrapper::log_wrapper(construct_helper_t &)
     : log_level_(level_t::kDisabled),
       stacktrace_level_(level_t::kDisabled, level_t::kDisabled),
-      prefix_format_("[%F %T.%f][%L](%k:%n): ") {
+      prefix_format_("[%F %T.%f][%L](%k:%n): "),
+      log_sinks_(nullptr) {
+  log_formatter::compile(prefix_compiled_, prefix_format_.c_str(), prefix_format_.size());
+
   // 这个接口由create_user_logger调用，不设置OPT_IS_GLOBAL
 }
 
 ATFRAMEWORK_UTILS_API log_wrapper::~log_wrapper() {
+  // 先写出所有异步日志，consumer线程会访问log_sinks_
+  disable_async();
+  clear_sinks();
+
   if (get_option(options_t::OPT_IS_GLOBAL)) {
     log_wrapper_global_destroyed_ = true;
   }
 
+  // 取消登记的调用点，之后这些调用点再抑制日志时会重新登记到新的logger
+  log_wrapper_callsite_summary_registry_t &callsite_registry = get_log_wrapper_callsite_summary_registry();
+  if (0 != callsite_registry.size.load(std::memory_order_acquire)) {
+    lock::lock_holder<lock::spin_lock> holder(callsite_registry.lock);
+    auto &callsites = callsite_registry.callsites;
+    callsites.erase(std::remove_if(callsites.begin(), callsites.end(),
+                                   [this](const log_wrapper_callsite_summary_t &callsite) {
+                                     if (callsite.logger != this) {
+                                       return false;
+                                     }
+                                     callsite.counter->set_report_owner(nullptr);
+                                     return true;
+                                   }),
+                    callsites.end());
+    callsite_registry.size.store(callsites.size(), std::memory_order_release);
+  }
+
   // 重置level，只要内存没释放，就还可以内存访问，但是不能写出日志
   log_level_ = level_t::kDisabled;
 }
@@ -121,10 +333,9 @@ ATFRAMEWORK_UTILS_API int32_t log_wrapper::init(log_level level) {
 }
 
 ATFRAMEWORK_UTILS_API size_t log_wrapper::sink_size() const {
-  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::read_lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_rw_lock> holder(
-      log_sinks_lock_);
-
-  return log_sinks_.size();
+  log_wrapper_sink_reader_t reader;
+  const std::vector<log_router_t> *sinks = log_sinks_.load(std::memory_order_seq_cst);
+  return nullptr == sinks ? 0 : sinks->size();
 }
 
 ATFRAMEWORK_UTILS_API void log_wrapper::add_sink(log_handler_t &&h, log_level level_min, log_level level_max) {
@@ -134,45 +345,78 @@ ATFRAMEWORK_UTILS_API void log_wrapper::add_sink(log_handler_t &&h, log_level le
     router.level_min = level_min;
     router.level_max = level_max;
 
-    ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::write_lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_rw_lock> holder(
+    ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock> holder(
         log_sinks_lock_);
-    log_sinks_.push_back(router);
+    std::unique_ptr<std::vector<log_router_t>> sinks{new std::vector<log_router_t>()};
+    if (log_sinks_holder_) {
+      sinks->reserve(log_sinks_holder_->size() + 1);
+      *sinks = *log_sinks_holder_;
+    }
+    sinks->push_back(std::move(router));
+    publish_sinks(std::move(sinks));
   }
 }
 
 ATFRAMEWORK_UTILS_API void log_wrapper::pop_sink() {
-  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::write_lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_rw_lock> holder(
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock> holder(
       log_sinks_lock_);
 
-  if (log_sinks_.empty()) {
+  if (!log_sinks_holder_ || log_sinks_holder_->empty()) {
     return;
   }
 
-  log_sinks_.pop_front();
+  std::unique_ptr<std::vector<log_router_t>> sinks{
+      new std::vector<log_router_t>(log_sinks_holder_->begin() + 1, log_sinks_holder_->end())};
+  publish_sinks(std::move(sinks));
 }
 
 ATFRAMEWORK_UTILS_API bool log_wrapper::set_sink(size_t idx, log_level level_min, log_level level_max) {
-  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::write_lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_rw_lock> holder(
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock> holder(
       log_sinks_lock_);
 
-  if (log_sinks_.size() <= idx) {
+  if (!log_sinks_holder_ || log_sinks_holder_->size() <= idx) {
     return false;
   }
 
-  std::list<log_router_t>::iterator beg = log_sinks_.begin();
-  if (idx > 0) {
-    std::advance(beg, static_cast<std::iterator_traits<std::list<log_router_t>::iterator>::difference_type>(idx));
-  }
-
-  (*beg).level_min = level_min;
-  (*beg).level_max = level_max;
+  std::unique_ptr<std::vector<log_router_t>> sinks{new std::vector<log_router_t>(*log_sinks_holder_)};
+  (*sinks)[idx].level_min = level_min;
+  (*sinks)[idx].level_max = level_max;
+  publish_sinks(std::move(sinks));
   return true;
 }
 
 ATFRAMEWORK_UTILS_API void log_wrapper::clear_sinks() {
-  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::write_lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_rw_lock> holder(
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_lock> holder(
       log_sinks_lock_);
-  log_sinks_.clear();
+  publish_sinks(std::unique_ptr<std::vector<log_router_t>>());
+}
+
+ATFRAMEWORK_UTILS_API void log_wrapper::publish_sinks(std::unique_ptr<std::vector<log_router_t>> sinks) {
+  if (sinks && sinks->empty()) {
+    sinks.reset();
+  }
+
+  // seq_cst和读者对槽位的写入配合，之后进入读取的读者只能看到新快照
+  log_sinks_.store(sinks.get(), std::memory_order_seq_cst);
+  if (log_sinks_holder_) {
+    // 读到推进后纪元的读者一定能看到新快照
+    uint64_t retired_epoch = get_log_wrapper_sink_reader_slots().epoch.fetch_add(1, std::memory_order_acq_rel);
+    log_sinks_retired_.emplace_back(retired_epoch, std::move(log_sinks_holder_));
+  }
+  log_sinks_holder_ = std::move(sinks);
+
+  if (log_sinks_retired_.empty()) {
+    return;
+  }
+
+  // 还有读者可能在访问的快照延迟到下一次修改或析构时释放，后端中可能引用了日志对象，不能在读者还在访问时析构
+  uint64_t min_reader_epoch = get_log_wrapper_sink_reader_min_epoch();
+  using retired_sinks_t = std::pair<uint64_t, std::unique_ptr<std::vector<log_router_t>>>;
+  log_sinks_retired_.erase(std::remove_if(log_sinks_retired_.begin(), log_sinks_retired_.end(),
+                                          [min_reader_epoch](const retired_sinks_t &retired) {
+                                            return retired.first < min_reader_epoch;
+                                          }),
+                           log_sinks_retired_.end());
 }
 
 ATFRAMEWORK_UTILS_API void log_wrapper::set_stacktrace_level(log_level level_min, log_level level_max) {
@@ -185,7 +429,117 @@ ATFRAMEWORK_UTILS_API void log_wrapper::set_stacktrace_level(log_level level_min
   }
 }
 
-ATFRAMEWORK_UTILS_API void log_wrapper::update() { ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::update(); }
+ATFRAMEWORK_UTILS_API bool log_wrapper::enable_async(const log_async_options &options) {
+  disable_async();
+
+  std::unique_ptr<log_async_pipeline> pipeline{new log_async_pipeline(
+      options, [this](const caller_info_t &caller, const char *content, size_t content_size) {
+        write_log(caller, content, content_size);
+      })};
+  if (!pipeline->start()) {
+    return false;
+  }
+
+  async_pipeline_ = std::move(pipeline);
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API void log_wrapper::disable_async() {
+  if (!async_pipeline_) {
+    return;
+  }
+
+  async_pipeline_->stop();
+  async_pipeline_.reset();
+}
+
+ATFRAMEWORK_UTILS_API void log_wrapper::flush_async() {
+  if (async_pipeline_) {
+    async_pipeline_->flush();
+  }
+}
+
+ATFRAMEWORK_UTILS_API log_async_statistics log_wrapper::get_async_statistics() const {
+  if (async_pipeline_) {
+    return async_pipeline_->get_statistics();
+  }
+
+  return log_async_statistics();
+}
+
+ATFRAMEWORK_UTILS_API void log_wrapper::update() {
+  ATFRAMEWORK_UTILS_NAMESPACE_ID::time::time_utility::update();
+  flush_callsite_summary();
+}
+
+ATFRAMEWORK_UTILS_API void log_wrapper::register_callsite_summary(log_wrapper *logger,
+                                                                  log_callsite_suppressed_counter &counter,
+                                                                  const caller_info_t &caller) {
+  if (nullptr == logger) {
+    return;
+  }
+
+  log_wrapper_callsite_summary_registry_t &callsite_registry = get_log_wrapper_callsite_summary_registry();
+  // 后端可能在flush_callsite_summary()中写日志，这时不能等待锁。没有登记上的调用点会在下次抑制日志时重试
+  lock::lock_holder<lock::spin_lock, lock::detail::default_try_lock_action<lock::spin_lock>> holder(
+      callsite_registry.lock);
+  if (!holder.is_available()) {
+    return;
+  }
+
+  counter.set_report_owner(logger);
+  for (auto &callsite : callsite_registry.callsites) {
+    if (callsite.counter == &counter) {
+      callsite.logger = logger;
+      callsite.caller = caller;
+      return;
+    }
+  }
+
+  callsite_registry.callsites.push_back(log_wrapper_callsite_summary_t{logger, &counter, caller});
+  if (counter.get_summary_interval_ns() < callsite_registry.flush_interval_ns.load(std::memory_order_relaxed)) {
+    callsite_registry.flush_interval_ns.store(counter.get_summary_interval_ns(), std::memory_order_relaxed);
+  }
+  // 新调用点的第一次汇总不用等到下一个周期
+  callsite_registry.next_flush_ns.store(0, std::memory_order_relaxed);
+  callsite_registry.size.store(callsite_registry.callsites.size(), std::memory_order_release);
+}
+
+ATFRAMEWORK_UTILS_API void log_wrapper::flush_callsite_summary() {
+  log_wrapper_callsite_summary_registry_t &callsite_registry = get_log_wrapper_callsite_summary_registry();
+  if (0 == callsite_registry.size.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // 每个周期只有一个线程输出
+  int64_t coarse_now = log_callsite_suppressed_counter::coarse_now_ns();
+  int64_t next_flush = callsite_registry.next_flush_ns.load(std::memory_order_relaxed);
+  if (coarse_now < next_flush) {
+    return;
+  }
+  if (!callsite_registry.next_flush_ns.compare_exchange_strong(
+          next_flush, coarse_now + callsite_registry.flush_interval_ns.load(std::memory_order_relaxed),
+          std::memory_order_relaxed)) {
+    return;
+  }
+
+  // 其他线程正在输出时跳过，写日志时也可能再调用update()
+  lock::lock_holder<lock::spin_lock, lock::detail::default_try_lock_action<lock::spin_lock>> holder(
+      callsite_registry.lock);
+  if (!holder.is_available()) {
+    return;
+  }
+
+  int64_t now = log_callsite_suppressed_counter::now_ns();
+  for (auto &callsite : callsite_registry.callsites) {
+    uint64_t suppressed = callsite.counter->take(now);
+    if (0 == suppressed || !callsite.logger->check_level(callsite.caller.level_id)) {
+      continue;
+    }
+
+    callsite.logger->log(callsite.caller, "suppressed %llu messages", static_cast<unsigned long long>(suppressed));
+  }
+}
 
 ATFRAMEWORK_UTILS_API void log_wrapper::log(const caller_info_t &caller,
 #ifdef _MSC_VER
@@ -201,7 +555,7 @@ ATFRAMEWORK_UTILS_API void log_wrapper::log(const caller_info_t &caller,
 
   start_log(caller, writer);
 
-  if (!log_sinks_.empty() && nullptr != writer.buffer) {
+  if (has_sink() && nullptr != writer.buffer) {
     // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-init-variables)
     va_list va_args;
     va_start(va_args, fmt);
@@ -224,12 +578,15 @@ ATFRAMEWORK_UTILS_API void log_wrapper::log(const caller_info_t &caller,
 
 ATFRAMEWORK_UTILS_API void log_wrapper::write_log(const caller_info_t &caller, const char *content,
                                                   size_t content_size) {
-  ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::read_lock_holder<ATFRAMEWORK_UTILS_NAMESPACE_ID::lock::spin_rw_lock> holder(
-      log_sinks_lock_);
+  log_wrapper_sink_reader_t reader;
+  const std::vector<log_router_t> *sinks = log_sinks_.load(std::memory_order_seq_cst);
+  if (nullptr == sinks) {
+    return;
+  }
 
-  for (std::list<log_router_t>::iterator iter = log_sinks_.begin(); iter != log_sinks_.end(); ++iter) {
-    if (caller.level_id >= iter->level_min && caller.level_id <= iter->level_max) {
-      iter->handle(caller, nostd::string_view{content, content_size});
+  for (const log_router_t &router : *sinks) {
+    if (caller.level_id >= router.level_min && caller.level_id <= router.level_max) {
+      router.handle(caller, nostd::string_view{content, content_size});
     }
   }
 }
@@ -262,7 +619,7 @@ ATFRAMEWORK_UTILS_API void log_wrapper::start_log(const caller_info_t &caller, l
   if (get_option(options_t::OPT_AUTO_UPDATE_TIME) && !prefix_format_.empty()) {
     update();
   }
-  if (log_sinks_.empty()) {
+  if (!has_sink()) {
     return;
   }
 
@@ -271,18 +628,48 @@ ATFRAMEWORK_UTILS_API void log_wrapper::start_log(const caller_info_t &caller, l
   writer.writen_size = 0;
 
   // format => "[Log    DEBUG][2015-01-12 10:09:08.]
-  writer.writen_size =
-      log_formatter::format(writer.buffer, writer.total_size, prefix_format_.c_str(), prefix_format_.size(), caller);
+  writer.writen_size = log_formatter::format(writer.buffer, writer.total_size, prefix_compiled_, caller);
 }
 
 ATFRAMEWORK_UTILS_API void log_wrapper::finish_log(const caller_info_t &caller, log_operation_t &writer) {
-  if (log_sinks_.empty() || nullptr == writer.buffer) {
+  if (!has_sink() || nullptr == writer.buffer) {
     return;
   }
 
   if (is_stacktrace_enabled() && caller.level_id >= stacktrace_level_.first &&
-      caller.level_id <= stacktrace_level_.second) {
-    append_log(writer, "\r\nCall stacks:\r\n", 0);
+      caller.level_id <= stacktrace_level_.second && get_option(options_t::OPT_STACKTRACE_RAW_ADDRESS)) {
+    // 只获取地址，不解析符号
+    uintptr_t addresses[LOG_WRAPPER_STACKTRACE_MAX_RAW_FRAMES];
+    stacktrace_options options{};
+    options.skip_start_frames = 1;
+    options.skip_end_frames = 0;
+    options.max_frames = 0;
+    size_t frames = stacktrace_get_addresses(addresses, LOG_WRAPPER_STACKTRACE_MAX_RAW_FRAMES, &options);
+
+    // 异步模式下由异步线程解析符号
+    if (async_pipeline_ && async_pipeline_->push(caller, writer.buffer, writer.writen_size,
+                                                 log_wrapper_render_stacktrace_addresses,
+                                                 reinterpret_cast<const unsigned char *>(addresses),
+                                                 frames * sizeof(uintptr_t))) {
+      return;
+    }
+
+    append_log(writer, kLogWrapperStacktraceTitle, sizeof(kLogWrapperStacktraceTitle) - 1);
+    if (writer.writen_size + 1 < writer.total_size) {
+      writer.writen_size += stacktrace_write_raw(writer.buffer + writer.writen_size,
+                                                 writer.total_size - writer.writen_size - 1,
+                                                 gsl::span<const uintptr_t>{addresses, frames});
+    }
+
+    if (writer.writen_size < writer.total_size) {
+      *(writer.buffer + writer.writen_size) = 0;
+    } else {
+      writer.writen_size = writer.total_size - 1;
+      *(writer.buffer + writer.total_size - 1) = 0;
+    }
+  } else if (is_stacktrace_enabled() && caller.level_id >= stacktrace_level_.first &&
+             caller.level_id <= stacktrace_level_.second) {
+    append_log(writer, kLogWrapperStacktraceTitle, sizeof(kLogWrapperStacktraceTitle) - 1);
     if (writer.writen_size + 1 < writer.total_size) {
       stacktrace_options options{};
       options.skip_start_frames = 1;
@@ -303,9 +690,30 @@ ATFRAMEWORK_UTILS_API void log_wrapper::finish_log(const caller_info_t &caller,
     }
   }
 
+  // 异步模式下只拷贝到ring buffer，失败时（日志过长或在consumer线程中）同步写出
+  if (async_pipeline_ && async_pipeline_->push(caller, writer.buffer, writer.writen_size)) {
+    return;
+  }
+
   write_log(caller, writer.buffer, writer.writen_size);
 }
 
+ATFRAMEWORK_UTILS_API bool log_wrapper::push_deferred_log(const caller_info_t &caller, log_operation_t &writer,
+                                                         log_async_pipeline::deferred_renderer_t renderer,
+                                                         const unsigned char *data, size_t data_size) {
+  if (!async_pipeline_ || nullptr == writer.buffer) {
+    return false;
+  }
+
+  // 调用栈必须在调用线程获取，走同步格式化流程
+  if (is_stacktrace_enabled() && caller.level_id >= stacktrace_level_.first &&
+      caller.level_id <= stacktrace_level_.second) {
+    return false;
+  }
+
+  return async_pipeline_->push(caller, writer.buffer, writer.writen_size, renderer, data, data_size);
+}
+
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
 ATFRAMEWORK_UTILS_API void log_wrapper::append_log(log_operation_t &writer, const char *str, size_t strsz) {
   if (writer.buffer == nullptr || writer.writen_size + 1 >= writer.total_size) {
@@ -0,0 +1,155 @@
+// Copyright 2026 atframework
+//
+// Licenses under the MIT License
+
+#include "memory/arena_allocator.h"
+
+#include <assert.h>
+#include <new>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+namespace {
+constexpr size_t kArenaChunkHeaderSize =
+    (sizeof(void *) + sizeof(size_t) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+    alignof(std::max_align_t);
+}  // namespace
+
+arena_resource::arena_resource(const options_t &options)
+    : options_(options),
+      chunks_(nullptr),
+      free_chunks_(nullptr),
+      current_begin_(nullptr),
+      current_end_(nullptr),
+      chunk_count_(0),
+      used_bytes_(0) {
+  if (options_.chunk_size < kArenaChunkHeaderSize * 2) {
+    options_.chunk_size = kArenaChunkHeaderSize * 2;
+  }
+}
+
+ATFRAMEWORK_UTILS_API arena_resource::~arena_resource() { release(); }
+
+ATFRAMEWORK_UTILS_API arena_resource::ptr_t arena_resource::create(const options_t &options) {
+  return ptr_t(new arena_resource(options));
+}
+
+ATFRAMEWORK_UTILS_API void *arena_resource::allocate(size_t bytes, size_t alignment) noexcept {
+  assert(0 != alignment && 0 == (alignment & (alignment - 1)));
+  if (0 == bytes) {
+    bytes = 1;
+  }
+
+  if (nullptr != current_begin_) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(current_begin_);
+    size_t padding = static_cast<size_t>((alignment - (address & (alignment - 1))) & (alignment - 1));
+    if (padding <= static_cast<size_t>(current_end_ - current_begin_) &&
+        bytes <= static_cast<size_t>(current_end_ - current_begin_) - padding) {
+      char *ret = current_begin_ + padding;
+      current_begin_ = ret + bytes;
+      used_bytes_ += padding + bytes;
+      return ret;
+    }
+  }
+
+  // Padding for alignment is always less than alignment
+  size_t payload_size = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+  if (payload_size < bytes) {
+    return nullptr;
+  }
+
+  // Large blocks get a chunk of their own and the current chunk is still used by the next allocation
+  bool dedicated = payload_size > (options_.chunk_size - kArenaChunkHeaderSize) / 4;
+  chunk_t *chunk;
+  if (dedicated) {
+    if (payload_size > static_cast<size_t>(-1) - kArenaChunkHeaderSize) {
+      return nullptr;
+    }
+    chunk = allocate_chunk(kArenaChunkHeaderSize + payload_size);
+  } else {
+    chunk = allocate_chunk(options_.chunk_size);
+  }
+  if (nullptr == chunk) {
+    return nullptr;
+  }
+
+  char *chunk_begin = reinterpret_cast<char *>(chunk) + kArenaChunkHeaderSize;
+  char *chunk_end = reinterpret_cast<char *>(chunk) + chunk->size;
+  uintptr_t address = reinterpret_cast<uintptr_t>(chunk_begin);
+  size_t padding = static_cast<size_t>((alignment - (address & (alignment - 1))) & (alignment - 1));
+  char *ret = chunk_begin + padding;
+  used_bytes_ += padding + bytes;
+
+  if (dedicated && nullptr != chunks_) {
+    // Keep the current chunk at the head
+    chunk->next = chunks_->next;
+    chunks_->next = chunk;
+  } else {
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    current_begin_ = ret + bytes;
+    current_end_ = chunk_end;
+  }
+
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void arena_resource::reset() noexcept {
+  size_t reserved_bytes = 0;
+  for (chunk_t *chunk = free_chunks_; nullptr != chunk; chunk = chunk->next) {
+    reserved_bytes += chunk->size;
+  }
+
+  while (nullptr != chunks_) {
+    chunk_t *chunk = chunks_;
+    chunks_ = chunk->next;
+
+    // Only chunks of standard size can be reused
+    if (chunk->size == options_.chunk_size && reserved_bytes + chunk->size <= options_.max_reserved_bytes) {
+      reserved_bytes += chunk->size;
+      chunk->next = free_chunks_;
+      free_chunks_ = chunk;
+    } else {
+      ::operator delete(reinterpret_cast<void *>(chunk));
+      --chunk_count_;
+    }
+  }
+
+  current_begin_ = nullptr;
+  current_end_ = nullptr;
+  used_bytes_ = 0;
+}
+
+ATFRAMEWORK_UTILS_API void arena_resource::release() noexcept {
+  reset();
+
+  while (nullptr != free_chunks_) {
+    chunk_t *chunk = free_chunks_;
+    free_chunks_ = chunk->next;
+    ::operator delete(reinterpret_cast<void *>(chunk));
+    --chunk_count_;
+  }
+}
+
+arena_resource::chunk_t *arena_resource::allocate_chunk(size_t size) noexcept {
+  if (size == options_.chunk_size && nullptr != free_chunks_) {
+    chunk_t *ret = free_chunks_;
+    free_chunks_ = ret->next;
+    ret->next = nullptr;
+    return ret;
+  }
+
+  chunk_t *ret = reinterpret_cast<chunk_t *>(::operator new(size, std::nothrow));
+  if (nullptr == ret) {
+    return nullptr;
+  }
+
+  ret->next = nullptr;
+  ret->size = size;
+  ++chunk_count_;
+  return ret;
+}
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
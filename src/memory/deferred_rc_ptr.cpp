@@ -0,0 +1,96 @@
+// Copyright 2026 atframework
+//
+// Licenses under the MIT License
+
+#include "memory/deferred_rc_ptr.h"
+
+#include <limits>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+namespace {
+struct deferred_rc_release_queue {
+  __rc_ptr_counted_data_deferred_base *head;
+  __rc_ptr_counted_data_deferred_base *tail;
+  size_t size;
+  bool *destroyed;
+
+  explicit deferred_rc_release_queue(bool *d) noexcept : head(nullptr), tail(nullptr), size(0), destroyed(d) {}
+  ~deferred_rc_release_queue() {
+    deferred_rc_release::drain_all();
+    *destroyed = true;
+  }
+};
+
+deferred_rc_release_queue *get_deferred_rc_release_queue() noexcept {
+  // Objects may be released by destructors of other thread_local objects after the queue is destroyed
+  static thread_local bool queue_destroyed = false;
+  if (queue_destroyed) {
+    return nullptr;
+  }
+
+  static thread_local deferred_rc_release_queue queue(&queue_destroyed);
+  return &queue;
+}
+}  // namespace
+
+ATFRAMEWORK_UTILS_API __rc_ptr_counted_data_deferred_base::~__rc_ptr_counted_data_deferred_base() noexcept {}
+
+ATFRAMEWORK_UTILS_API size_t deferred_rc_release::drain(size_t max_objects) noexcept {
+  deferred_rc_release_queue *queue = get_deferred_rc_release_queue();
+  if (nullptr == queue) {
+    return 0;
+  }
+
+  size_t ret = 0;
+  while (ret < max_objects && nullptr != queue->head) {
+    __rc_ptr_counted_data_deferred_base *counter = queue->head;
+    queue->head = counter->deferred_next_;
+    if (nullptr == queue->head) {
+      queue->tail = nullptr;
+    }
+    --queue->size;
+    counter->deferred_next_ = nullptr;
+
+    // dispose() may push more counters into the tail of queue
+    counter->dispose();
+    counter->weak_release();
+    ++ret;
+  }
+
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API size_t deferred_rc_release::drain_all() noexcept {
+  return drain((std::numeric_limits<size_t>::max)());
+}
+
+ATFRAMEWORK_UTILS_API size_t deferred_rc_release::size() noexcept {
+  deferred_rc_release_queue *queue = get_deferred_rc_release_queue();
+  if (nullptr == queue) {
+    return 0;
+  }
+
+  return queue->size;
+}
+
+ATFRAMEWORK_UTILS_API void deferred_rc_release::push(__rc_ptr_counted_data_deferred_base *counter) noexcept {
+  deferred_rc_release_queue *queue = get_deferred_rc_release_queue();
+  if (nullptr == queue) {
+    counter->dispose();
+    counter->weak_release();
+    return;
+  }
+
+  if (nullptr == queue->tail) {
+    queue->head = counter;
+  } else {
+    queue->tail->deferred_next_ = counter;
+  }
+  queue->tail = counter;
+  ++queue->size;
+}
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
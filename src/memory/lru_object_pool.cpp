@@ -8,10 +8,18 @@
 #include <stdint.h>
 #include <cstddef>
 #include <ctime>
+#include <limits>
 #include <memory>
 
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace memory {
+namespace {
+// 空闲链表中节点的prev标记，用于识别重复删除或过期的handle
+static inline lru_pool_manager::check_handle_t free_check_item_marker() {
+  return (std::numeric_limits<lru_pool_manager::check_handle_t>::max)() - 1;
+}
+}  // namespace
+
 ATFRAMEWORK_UTILS_API lru_pool_base::list_type_base::list_type_base() {}
 ATFRAMEWORK_UTILS_API lru_pool_base::list_type_base::~list_type_base() {}
 
@@ -93,7 +101,7 @@ ATFRAMEWORK_UTILS_API size_t lru_pool_manager::proc(time_t tick) {
 
   if (gc_item_ <= 0) {
     // 如果没有失效的check list缓存则不用继续走资源回收流程
-    if (checked_list_.empty() || check_tick(checked_list_.front().push_tick)) {
+    if (end_check_list() == checked_head_ || check_tick(checked_list_[checked_head_].push_tick)) {
       return 0;
     }
   }
@@ -108,30 +116,21 @@ ATFRAMEWORK_UTILS_API size_t lru_pool_manager::proc(time_t tick) {
 
     if (0 == gc_item_) {
       // 如果没有失效的check list缓存则后续流程也可以取消
-      if (checked_list_.empty() || check_tick(checked_list_.front().push_tick)) {
+      if (end_check_list() == checked_head_ || check_tick(checked_list_[checked_head_].push_tick)) {
         break;
       }
     }
 
-    if (checked_list_.empty()) {
+    if (end_check_list() == checked_head_) {
       gc_item_ = 0;
       item_count_.set(0);
       break;
     }
 
-    check_item_t checked_item = checked_list_.front();
-
-    if (checked_item.list_.expired()) {
-      item_count_.dec();
-      checked_list_.pop_front();
-      continue;
-    }
-
     ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::strong_rc_ptr<lru_pool_base::list_type_base> tar_ls =
-        checked_item.list_.lock();
+        checked_list_[checked_head_].list_.lock();
     if (!tar_ls) {
-      item_count_.dec();
-      checked_list_.pop_front();
+      erase_check_list(checked_head_);
       continue;
     }
 
@@ -155,14 +154,22 @@ ATFRAMEWORK_UTILS_API size_t lru_pool_manager::proc(time_t tick) {
 /**
  * @brief 添加检查列表
  */
-ATFRAMEWORK_UTILS_API lru_pool_manager::check_list_t::iterator lru_pool_manager::push_check_list(
-    ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::weak_rc_ptr<lru_pool_base::list_type_base> list_) {
-  check_list_t::iterator ret = checked_list_.insert(checked_list_.end(), check_item_t());
-  if (ret == checked_list_.end()) {
-    return ret;
+ATFRAMEWORK_UTILS_API lru_pool_manager::check_handle_t lru_pool_manager::push_check_list(
+    const ATFRAMEWORK_UTILS_NAMESPACE_ID::memory::weak_rc_ptr<lru_pool_base::list_type_base> &list_) {
+  check_handle_t ret = allocate_check_item();
+  check_item_t &item = checked_list_[ret];
+  item.list_ = list_;
+  item.push_tick = last_proc_tick_;
+
+  // 添加到检查列表末尾
+  item.prev = checked_tail_;
+  item.next = end_check_list();
+  if (end_check_list() != checked_tail_) {
+    checked_list_[checked_tail_].next = ret;
+  } else {
+    checked_head_ = ret;
   }
-  (*ret).list_ = list_;
-  (*ret).push_tick = last_proc_tick_;
+  checked_tail_ = ret;
 
   item_count_.inc();
 
@@ -178,27 +185,40 @@ ATFRAMEWORK_UTILS_API lru_pool_manager::check_list_t::iterator lru_pool_manager:
   return ret;
 }
 
-ATFRAMEWORK_UTILS_API bool lru_pool_manager::erase_check_list(check_list_t::iterator iter) {
-  if (iter == checked_list_.end()) {
+ATFRAMEWORK_UTILS_API bool lru_pool_manager::erase_check_list(check_handle_t handle) {
+  if (handle >= checked_list_.size()) {
+    return false;
+  }
+
+  check_item_t &item = checked_list_[handle];
+  // 已经在空闲链表中，重复链入会破坏空闲链表
+  if (free_check_item_marker() == item.prev) {
     return false;
   }
-  checked_list_.erase(iter);
+
+  if (end_check_list() != item.prev) {
+    checked_list_[item.prev].next = item.next;
+  } else {
+    checked_head_ = item.next;
+  }
+  if (end_check_list() != item.next) {
+    checked_list_[item.next].prev = item.prev;
+  } else {
+    checked_tail_ = item.prev;
+  }
+
+  // 放入空闲链表，下次push_check_list时复用
+  item.list_.reset();
+  item.prev = free_check_item_marker();
+  item.next = checked_free_;
+  checked_free_ = handle;
+
   item_count_.dec();
   return true;
 }
 
-// GCC 4.4 don't support erase(const_iterator)
-// ATFRAMEWORK_UTILS_API bool lru_pool_manager::erase_check_list(check_list_t::const_iterator iter) {
-//     if (iter == checked_list_.end()) {
-//         return false;
-//     }
-//     checked_list_.erase(iter);
-//     item_count_.dec();
-//     return true;
-// }
-
-ATFRAMEWORK_UTILS_API lru_pool_manager::check_list_t::iterator lru_pool_manager::end_check_list() {
-  return checked_list_.end();
+ATFRAMEWORK_UTILS_API lru_pool_manager::check_handle_t lru_pool_manager::end_check_list() const {
+  return (std::numeric_limits<check_handle_t>::max)();
 }
 
 ATFRAMEWORK_UTILS_API lru_pool_manager::lru_pool_manager()
@@ -217,6 +237,9 @@ ATFRAMEWORK_UTILS_API lru_pool_manager::lru_pool_manager()
 #endif
       last_proc_tick_(0),
       list_tick_timeout_(0) {
+  checked_head_ = end_check_list();
+  checked_tail_ = end_check_list();
+  checked_free_ = end_check_list();
   item_count_.set(0);
 }
 
@@ -233,6 +256,17 @@ ATFRAMEWORK_UTILS_API bool lru_pool_manager::check_tick(time_t tp) {
   return 0 == list_tick_timeout_ || abs(last_proc_tick_ - tp) <= list_tick_timeout_;
 }
 
+ATFRAMEWORK_UTILS_API lru_pool_manager::check_handle_t lru_pool_manager::allocate_check_item() {
+  if (end_check_list() != checked_free_) {
+    check_handle_t ret = checked_free_;
+    checked_free_ = checked_list_[ret].next;
+    return ret;
+  }
+
+  checked_list_.push_back(check_item_t());
+  return checked_list_.size() - 1;
+}
+
 }  // namespace memory
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
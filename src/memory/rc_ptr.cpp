@@ -24,6 +24,8 @@ ATFRAMEWORK_UTILS_API void __rc_ptr_counted_data_base::throw_bad_weak_ptr() {
 
 ATFRAMEWORK_UTILS_API void __rc_ptr_counted_data_base::abort_bad_weak_ptr() noexcept { abort(); }
 
+ATFRAMEWORK_UTILS_API __rc_ptr_counted_data_atomic_base::~__rc_ptr_counted_data_atomic_base() noexcept {}
+
 }  // namespace memory
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
@@ -0,0 +1,320 @@
+// Copyright 2026 atframework
+//
+// Licenses under the MIT License
+
+#include "memory/slab_allocator.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <unordered_map>
+
+ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
+namespace memory {
+
+namespace {
+constexpr size_t kSlabHeaderSize =
+    (sizeof(void *) + slab_resource::kSizeClassGranularity - 1) / slab_resource::kSizeClassGranularity *
+    slab_resource::kSizeClassGranularity;
+
+uint64_t allocate_slab_resource_id() noexcept {
+  static std::atomic<uint64_t> id_alloc{0};
+  return ++id_alloc;
+}
+}  // namespace
+
+struct slab_resource::thread_cache_t {
+  std::weak_ptr<slab_resource> owner;
+  block_list_t lists[kSizeClassCount];
+
+  thread_cache_t() noexcept {
+    for (auto &list : lists) {
+      list.head = nullptr;
+      list.count = 0;
+    }
+  }
+
+  ~thread_cache_t() {
+    // Blocks are given back only when slab_resource is still alive, or they are already released with slabs
+    ptr_t resource = owner.lock();
+    if (!resource) {
+      return;
+    }
+
+    for (size_t i = 0; i < kSizeClassCount; ++i) {
+      resource->release_blocks(i, lists[i], lists[i].count);
+    }
+  }
+};
+
+struct slab_resource::thread_cache_set_t {
+  std::unordered_map<uint64_t, std::unique_ptr<thread_cache_t>> caches;
+  bool *destroyed;
+
+  explicit thread_cache_set_t(bool *d) noexcept : destroyed(d) {}
+  ~thread_cache_set_t() { *destroyed = true; }
+};
+
+slab_resource::slab_resource(const options_t &options)
+    : options_(options), id_(allocate_slab_resource_id()), slabs_(nullptr), slab_count_(0) {
+  // A slab can hold at least one block of every size class
+  if (options_.slab_size < kSlabHeaderSize + kMaxBlockSize) {
+    options_.slab_size = kSlabHeaderSize + kMaxBlockSize;
+  }
+
+  if (!options_.thread_safe) {
+    options_.thread_cache_size = 0;
+  }
+
+  for (auto &size_class : size_classes_) {
+    size_class.free_list.head = nullptr;
+    size_class.free_list.count = 0;
+    size_class.carve_begin = nullptr;
+    size_class.carve_end = nullptr;
+  }
+}
+
+ATFRAMEWORK_UTILS_API slab_resource::~slab_resource() {
+  while (nullptr != slabs_) {
+    slab_t *next = slabs_->next;
+    ::operator delete(reinterpret_cast<void *>(slabs_));
+    slabs_ = next;
+  }
+  slab_count_ = 0;
+}
+
+ATFRAMEWORK_UTILS_API slab_resource::ptr_t slab_resource::create(const options_t &options) {
+  ptr_t ret = ptr_t(new slab_resource(options));
+  if (ret) {
+    ret->self_ = ret;
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API const slab_resource::ptr_t &slab_resource::default_resource() {
+  static ptr_t ret = create();
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API void *slab_resource::allocate(size_t bytes, size_t alignment) {
+  if (!is_slab_block(bytes, alignment)) {
+    return nullptr;
+  }
+
+  size_t size_class = size_class_of(bytes);
+  thread_cache_t *cache = get_thread_cache();
+  if (nullptr == cache) {
+    block_list_t output = {nullptr, 0};
+    if (0 == fetch_blocks(size_class, output, 1)) {
+      return nullptr;
+    }
+    return reinterpret_cast<void *>(output.head);
+  }
+
+  block_list_t &list = cache->lists[size_class];
+  if (nullptr == list.head) {
+    fetch_blocks(size_class, list, (options_.thread_cache_size + 1) / 2);
+    if (nullptr == list.head) {
+      return nullptr;
+    }
+  }
+
+  free_block_t *ret = list.head;
+  list.head = ret->next;
+  --list.count;
+  return reinterpret_cast<void *>(ret);
+}
+
+ATFRAMEWORK_UTILS_API bool slab_resource::deallocate(void *p, size_t bytes, size_t alignment) noexcept {
+  if (!is_slab_block(bytes, alignment)) {
+    return false;
+  }
+
+  if (nullptr == p) {
+    return true;
+  }
+
+  size_t size_class = size_class_of(bytes);
+  free_block_t *block = reinterpret_cast<free_block_t *>(p);
+
+  thread_cache_t *cache = nullptr;
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  try {
+#endif
+    cache = get_thread_cache();
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  } catch (...) {
+    cache = nullptr;
+  }
+#endif
+
+  if (nullptr == cache) {
+    block->next = nullptr;
+    block_list_t input = {block, 1};
+    release_blocks(size_class, input, 1);
+    return true;
+  }
+
+  block_list_t &list = cache->lists[size_class];
+  block->next = list.head;
+  list.head = block;
+  ++list.count;
+
+  // Keep half of the cache, so the next allocate() or deallocate() will not hit the shared free lists again
+  if (list.count > options_.thread_cache_size) {
+    release_blocks(size_class, list, list.count - options_.thread_cache_size / 2);
+  }
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API size_t slab_resource::get_slab_count() const noexcept {
+  if (options_.thread_safe) {
+    lock_.lock();
+  }
+  size_t ret = slab_count_;
+  if (options_.thread_safe) {
+    lock_.unlock();
+  }
+  return ret;
+}
+
+ATFRAMEWORK_UTILS_API size_t slab_resource::get_free_block_count() const noexcept {
+  if (options_.thread_safe) {
+    lock_.lock();
+  }
+  size_t ret = 0;
+  for (auto &size_class : size_classes_) {
+    ret += size_class.free_list.count;
+  }
+  if (options_.thread_safe) {
+    lock_.unlock();
+  }
+  return ret;
+}
+
+size_t slab_resource::fetch_blocks(size_t size_class, block_list_t &output, size_t max_count) noexcept {
+  if (0 == max_count) {
+    max_count = 1;
+  }
+
+  if (options_.thread_safe) {
+    lock_.lock();
+  }
+  size_t ret = fetch_blocks_unsafe(size_class, output, max_count);
+  if (options_.thread_safe) {
+    lock_.unlock();
+  }
+  return ret;
+}
+
+size_t slab_resource::fetch_blocks_unsafe(size_t size_class, block_list_t &output, size_t max_count) noexcept {
+  size_class_t &target = size_classes_[size_class];
+  size_t ret = 0;
+  while (ret < max_count && nullptr != target.free_list.head) {
+    free_block_t *block = target.free_list.head;
+    target.free_list.head = block->next;
+    --target.free_list.count;
+
+    block->next = output.head;
+    output.head = block;
+    ++output.count;
+    ++ret;
+  }
+
+  if (ret > 0) {
+    return ret;
+  }
+
+  size_t block_size = (size_class + 1) * kSizeClassGranularity;
+  if (nullptr == target.carve_begin || target.carve_begin + block_size > target.carve_end) {
+    char *slab_data = reinterpret_cast<char *>(::operator new(options_.slab_size, std::nothrow));
+    if (nullptr == slab_data) {
+      return 0;
+    }
+
+    slab_t *slab = reinterpret_cast<slab_t *>(slab_data);
+    slab->next = slabs_;
+    slabs_ = slab;
+    ++slab_count_;
+
+    target.carve_begin = slab_data + kSlabHeaderSize;
+    target.carve_end = slab_data + options_.slab_size;
+  }
+
+  while (ret < max_count && target.carve_begin + block_size <= target.carve_end) {
+    free_block_t *block = reinterpret_cast<free_block_t *>(target.carve_begin);
+    target.carve_begin += block_size;
+
+    block->next = output.head;
+    output.head = block;
+    ++output.count;
+    ++ret;
+  }
+
+  return ret;
+}
+
+void slab_resource::release_blocks(size_t size_class, block_list_t &input, size_t count) noexcept {
+  if (0 == count || nullptr == input.head) {
+    return;
+  }
+
+  // Detach blocks before taking the lock
+  free_block_t *head = input.head;
+  free_block_t *tail = head;
+  size_t moved = 1;
+  while (moved < count && nullptr != tail->next) {
+    tail = tail->next;
+    ++moved;
+  }
+  input.head = tail->next;
+  input.count -= moved;
+
+  if (options_.thread_safe) {
+    lock_.lock();
+  }
+  size_class_t &target = size_classes_[size_class];
+  tail->next = target.free_list.head;
+  target.free_list.head = head;
+  target.free_list.count += moved;
+  if (options_.thread_safe) {
+    lock_.unlock();
+  }
+}
+
+slab_resource::thread_cache_t *slab_resource::get_thread_cache() {
+  if (0 == options_.thread_cache_size) {
+    return nullptr;
+  }
+
+  // Blocks may be deallocated by destructors of other thread_local objects after caches of this thread are destroyed
+  static thread_local bool caches_destroyed = false;
+  if (caches_destroyed) {
+    return nullptr;
+  }
+
+  static thread_local thread_cache_set_t cache_set(&caches_destroyed);
+  auto iter = cache_set.caches.find(id_);
+  if (iter != cache_set.caches.end()) {
+    return iter->second.get();
+  }
+
+  // Remove caches of destroyed resources
+  for (iter = cache_set.caches.begin(); iter != cache_set.caches.end();) {
+    if (iter->second->owner.expired()) {
+      iter = cache_set.caches.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  std::unique_ptr<thread_cache_t> cache(new thread_cache_t());
+  cache->owner = self_;
+  thread_cache_t *ret = cache.get();
+  cache_set.caches[id_] = std::move(cache);
+  return ret;
+}
+
+}  // namespace memory
+ATFRAMEWORK_UTILS_NAMESPACE_END
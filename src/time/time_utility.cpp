@@ -3,8 +3,128 @@
 
 #include "time/time_utility.h"
 
+#include <time.h>
+
+#include <atomic>
+#include <cstring>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 ATFRAMEWORK_UTILS_NAMESPACE_BEGIN
 namespace time {
+namespace {
+// Published by the coarse clock thread and protected by a seqlock, fields are atomic so readers never race with the
+// writer even when they read a torn snapshot and retry
+struct coarse_clock_snapshot_t {
+  std::atomic<bool> running;
+  std::atomic<uint64_t> sequence;  // odd while the writer is updating
+  std::atomic<time_utility::raw_duration_t::rep> sys_ticks;
+  std::atomic<std::chrono::steady_clock::duration::rep> steady_ticks;
+};
+
+struct coarse_clock_ticker_t {
+  std::mutex lock;
+  std::condition_variable cond;
+  std::thread thread;
+  bool stop_requested;
+
+  coarse_clock_ticker_t() : stop_requested(false) {}
+  ~coarse_clock_ticker_t() { time_utility::stop_coarse_clock(); }
+};
+
+// Snapshot of current thread, readers only load the sequence when there is no new publication
+struct coarse_clock_tls_cache_t {
+  uint64_t sequence;  // 0 means nothing cached
+  time_utility::raw_duration_t::rep sys_ticks;
+  std::chrono::steady_clock::duration::rep steady_ticks;
+};
+
+static coarse_clock_snapshot_t g_coarse_clock_snapshot;
+static thread_local coarse_clock_tls_cache_t g_coarse_clock_tls_cache = {0, 0, 0};
+
+static coarse_clock_ticker_t &get_coarse_clock_ticker() {
+  static coarse_clock_ticker_t ret;
+  return ret;
+}
+
+static void publish_coarse_clock() {
+  // Only one writer, the ticker thread or start_coarse_clock() with the ticker lock
+  uint64_t sequence = g_coarse_clock_snapshot.sequence.load(std::memory_order_relaxed);
+  g_coarse_clock_snapshot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  g_coarse_clock_snapshot.sys_ticks.store(std::chrono::system_clock::now().time_since_epoch().count(),
+                                          std::memory_order_relaxed);
+  g_coarse_clock_snapshot.steady_ticks.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                                             std::memory_order_relaxed);
+
+  g_coarse_clock_snapshot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// Return nullptr if the coarse clock thread is not running
+static const coarse_clock_tls_cache_t *read_coarse_clock() {
+  if (!g_coarse_clock_snapshot.running.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  coarse_clock_tls_cache_t &cache = g_coarse_clock_tls_cache;
+  uint64_t sequence = g_coarse_clock_snapshot.sequence.load(std::memory_order_acquire);
+  if (sequence == cache.sequence) {
+    return &cache;
+  }
+
+  while (true) {
+    if (0 == (sequence & 1)) {
+      time_utility::raw_duration_t::rep sys_ticks = g_coarse_clock_snapshot.sys_ticks.load(std::memory_order_relaxed);
+      std::chrono::steady_clock::duration::rep steady_ticks =
+          g_coarse_clock_snapshot.steady_ticks.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence == g_coarse_clock_snapshot.sequence.load(std::memory_order_relaxed)) {
+        cache.sequence = sequence;
+        cache.sys_ticks = sys_ticks;
+        cache.steady_ticks = steady_ticks;
+        return &cache;
+      }
+    } else {
+      std::this_thread::yield();
+    }
+
+    sequence = g_coarse_clock_snapshot.sequence.load(std::memory_order_acquire);
+  }
+}
+
+// Floor division by DAY_SECONDS, the remainder is adjusted without branch
+ATFW_UTIL_FORCEINLINE static int64_t floor_days(int64_t t) {
+  int64_t days = t / time_utility::DAY_SECONDS;
+  return days - static_cast<int64_t>((t - days * time_utility::DAY_SECONDS) < 0);
+}
+
+// civil_from_days of Howard Hinnant: days since 1970-01-01 to proleptic Gregorian year/month(1-12)/day(1-31)
+// @see https://howardhinnant.github.io/date_algorithms.html#civil_from_days
+ATFW_UTIL_FORCEINLINE static void civil_from_days(int64_t z, int64_t &year, uint32_t &month, uint32_t &day) {
+  z += 719468;
+  const int64_t era = (z - static_cast<int64_t>(z < 0) * 146096) / 146097;
+  const uint32_t doe = static_cast<uint32_t>(z - era * 146097);                // [0, 146096]
+  const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+  const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365], starts from March 1st
+  const uint32_t mp = (5 * doy + 2) / 153;                                     // [0, 11], starts from March
+  day = doy - (153 * mp + 2) / 5 + 1;
+  month = mp + 3 - static_cast<uint32_t>(mp >= 10) * 12;
+  year = static_cast<int64_t>(yoe) + era * 400 + static_cast<int64_t>(month <= 2);
+}
+
+// Days from 1970-01-01 to January 1st of year
+ATFW_UTIL_FORCEINLINE static int64_t days_from_year(int64_t year) {
+  // January is the 11th month of the previous year starts from March
+  year -= 1;
+  const int64_t era = (year - static_cast<int64_t>(year < 0) * 399) / 400;
+  const uint32_t yoe = static_cast<uint32_t>(year - era * 400);
+  const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + 306;
+  return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+}  // namespace
+
 ATFRAMEWORK_UTILS_API time_utility::raw_time_t time_utility::now_;
 ATFRAMEWORK_UTILS_API time_t time_utility::now_unix_;
 ATFRAMEWORK_UTILS_API int32_t time_utility::now_usec_ = 0;
@@ -77,6 +197,116 @@ ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD void time_utility::reset_glo
   update(&old_now);
 }
 
+// ====================== 线程安全的粗粒度时钟 ======================
+ATFRAMEWORK_UTILS_API bool time_utility::start_coarse_clock(std::chrono::microseconds interval) {
+  coarse_clock_ticker_t &ticker = get_coarse_clock_ticker();
+  std::lock_guard<std::mutex> guard(ticker.lock);
+  if (ticker.thread.joinable()) {
+    return false;
+  }
+
+  if (interval <= std::chrono::microseconds::zero()) {
+    interval = std::chrono::microseconds{1};
+  }
+
+  // Publish once before returning, so readers always see a valid snapshot
+  publish_coarse_clock();
+  g_coarse_clock_snapshot.running.store(true, std::memory_order_release);
+
+  ticker.stop_requested = false;
+  ticker.thread = std::thread([&ticker, interval]() {
+    std::unique_lock<std::mutex> lock(ticker.lock);
+    while (!ticker.stop_requested) {
+      ticker.cond.wait_for(lock, interval);
+      if (ticker.stop_requested) {
+        break;
+      }
+      publish_coarse_clock();
+    }
+  });
+  return true;
+}
+
+ATFRAMEWORK_UTILS_API void time_utility::stop_coarse_clock() {
+  coarse_clock_ticker_t &ticker = get_coarse_clock_ticker();
+  std::thread thread;
+  {
+    std::lock_guard<std::mutex> guard(ticker.lock);
+    if (!ticker.thread.joinable()) {
+      return;
+    }
+
+    ticker.stop_requested = true;
+    g_coarse_clock_snapshot.running.store(false, std::memory_order_release);
+    thread = std::move(ticker.thread);
+  }
+
+  ticker.cond.notify_all();
+  thread.join();
+}
+
+ATFRAMEWORK_UTILS_API bool time_utility::is_coarse_clock_running() {
+  return g_coarse_clock_snapshot.running.load(std::memory_order_acquire);
+}
+
+ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD time_utility::raw_time_t time_utility::coarse_now() {
+  const coarse_clock_tls_cache_t *cache = read_coarse_clock();
+  if (nullptr == cache) {
+    return fast_sys_now() + global_now_offset_;
+  }
+
+  return raw_time_t(raw_duration_t(cache->sys_ticks)) + global_now_offset_;
+}
+
+ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD time_t time_utility::get_coarse_now() {
+  return std::chrono::system_clock::to_time_t(coarse_now());
+}
+
+ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD int32_t time_utility::get_coarse_now_usec() {
+  raw_time_t now_tp = coarse_now();
+  raw_time_t padding_time = raw_time_t::clock::from_time_t(std::chrono::system_clock::to_time_t(now_tp));
+  std::chrono::microseconds::rep usec =
+      std::chrono::duration_cast<std::chrono::microseconds>(now_tp - padding_time).count();
+  if (usec < 0) {
+    usec = 0;
+  } else if (usec >= 1000000) {
+    usec = 999999;
+  }
+  return static_cast<int32_t>(usec);
+}
+
+ATFRAMEWORK_UTILS_API std::chrono::steady_clock::time_point time_utility::coarse_steady_now() {
+  const coarse_clock_tls_cache_t *cache = read_coarse_clock();
+  if (nullptr == cache) {
+    return fast_steady_now();
+  }
+
+  return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(cache->steady_ticks));
+}
+
+ATFRAMEWORK_UTILS_API time_utility::raw_time_t time_utility::fast_sys_now() {
+#if defined(__linux__) && defined(CLOCK_REALTIME_COARSE)
+  struct timespec ts;
+  if (0 == clock_gettime(CLOCK_REALTIME_COARSE, &ts)) {
+    return raw_time_t(std::chrono::duration_cast<raw_duration_t>(std::chrono::seconds{ts.tv_sec} +
+                                                                 std::chrono::nanoseconds{ts.tv_nsec}));
+  }
+#endif
+  return std::chrono::system_clock::now();
+}
+
+ATFRAMEWORK_UTILS_API std::chrono::steady_clock::time_point time_utility::fast_steady_now() {
+  // steady_clock of libstdc++ and libc++ on Linux use CLOCK_MONOTONIC, which has the same epoch as the coarse one
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+  struct timespec ts;
+  if (0 == clock_gettime(CLOCK_MONOTONIC_COARSE, &ts)) {
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec}));
+  }
+#endif
+  return std::chrono::steady_clock::now();
+}
+
 // ====================== 后面的函数都和时区相关 ======================
 ATFRAMEWORK_UTILS_API ATFW_UTIL_SANITIZER_NO_THREAD time_t time_utility::get_sys_zone_offset() {
   // 部分地区当前时间时区和70年不一样，所以要基于当前时间算
@@ -259,6 +489,77 @@ ATFRAMEWORK_UTILS_API time_t time_utility::get_month_start_time(time_t t) {
   ttm.tm_mday = 1;
   return mktime(&ttm) + local_offset;
 }
+
+ATFRAMEWORK_UTILS_API void time_utility::batch_is_same_day(const time_t *left, size_t count, time_t right, bool *out,
+                                                           time_t offset) {
+  // The same as is_same_day(), but the zone offset and the day of right are only calculated once
+  time_t zone_offset = get_zone_offset() + offset;
+  time_t right_day = (right - zone_offset) / DAY_SECONDS;
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = (left[i] - zone_offset) / DAY_SECONDS == right_day;
+  }
+}
+
+ATFRAMEWORK_UTILS_API void time_utility::batch_get_week_start_time(const time_t *in, size_t count, time_t *out,
+                                                                   time_t week_first) {
+  time_t now = get_now();
+  if (week_first >= 7 || week_first < 0) {
+    week_first %= 7;
+  }
+  time_t week_offset = (4 - week_first) * DAY_SECONDS - get_zone_offset();
+
+  for (size_t i = 0; i < count; ++i) {
+    time_t t = 0 == in[i] ? now : in[i];
+    out[i] = t - (t + week_offset) % WEEK_SECONDS;
+  }
+}
+
+ATFRAMEWORK_UTILS_API void time_utility::batch_get_month_start_time(const time_t *in, size_t count, time_t *out) {
+  time_t now = get_now();
+  time_t zone_offset = get_zone_offset();
+  // The same as get_month_start_time(), the month is based on the time shifted by the difference from the system zone
+  time_t month_offset = zone_offset + (zone_offset - get_sys_zone_offset());
+
+  for (size_t i = 0; i < count; ++i) {
+    time_t t = 0 == in[i] ? now : in[i];
+    int64_t days = floor_days(static_cast<int64_t>(t - month_offset));
+    int64_t year;
+    uint32_t month;
+    uint32_t day;
+    civil_from_days(days, year, month, day);
+    out[i] = static_cast<time_t>((days - static_cast<int64_t>(day) + 1) * DAY_SECONDS) + zone_offset;
+  }
+}
+
+ATFRAMEWORK_UTILS_API void time_utility::batch_get_local_tm(const time_t *in, size_t count, raw_time_desc_t *out) {
+  time_t zone_offset = get_zone_offset();
+
+  for (size_t i = 0; i < count; ++i) {
+    int64_t local = static_cast<int64_t>(in[i] - zone_offset);
+    int64_t days = floor_days(local);
+    int32_t seconds = static_cast<int32_t>(local - days * DAY_SECONDS);
+    int64_t year;
+    uint32_t month;
+    uint32_t day;
+    civil_from_days(days, year, month, day);
+
+    // Days since 1970-01-01 of Thursday is 0
+    int64_t week_day = (days + 4) % 7;
+    week_day += static_cast<int64_t>(week_day < 0) * 7;
+
+    std::tm &ttm = out[i];
+    memset(&ttm, 0, sizeof(ttm));
+    ttm.tm_sec = seconds % MINITE_SECONDS;
+    ttm.tm_min = (seconds / MINITE_SECONDS) % 60;
+    ttm.tm_hour = seconds / HOUR_SECONDS;
+    ttm.tm_mday = static_cast<int>(day);
+    ttm.tm_mon = static_cast<int>(month) - 1;
+    ttm.tm_year = static_cast<int>(year - 1900);
+    ttm.tm_wday = static_cast<int>(week_day);
+    ttm.tm_yday = static_cast<int>(days - days_from_year(year));
+    ttm.tm_isdst = 0;
+  }
+}
 }  // namespace time
 ATFRAMEWORK_UTILS_NAMESPACE_END
 
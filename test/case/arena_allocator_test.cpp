@@ -0,0 +1,78 @@
+// Copyright 2026 atframework
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "memory/arena_allocator.h"
+
+CASE_TEST(arena_allocator_test, resource) {
+  atfw::util::memory::arena_resource::options_t options;
+  options.chunk_size = 1024;
+  options.max_reserved_bytes = 2048;
+  atfw::util::memory::arena_resource::ptr_t resource = atfw::util::memory::arena_resource::create(options);
+
+  char *p1 = reinterpret_cast<char *>(resource->allocate(10, 1));
+  char *p2 = reinterpret_cast<char *>(resource->allocate(8, 8));
+  CASE_EXPECT_TRUE(nullptr != p1);
+  CASE_EXPECT_TRUE(nullptr != p2);
+  CASE_EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p2) % 8);
+  CASE_EXPECT_EQ(reinterpret_cast<uintptr_t>(p1) + 16, reinterpret_cast<uintptr_t>(p2));
+  CASE_EXPECT_EQ(24, resource->get_used_bytes());
+  CASE_EXPECT_EQ(1, resource->get_chunk_count());
+
+  void *p3 = resource->allocate(32, 64);
+  CASE_EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p3) % 64);
+
+  // Large blocks get a chunk of their own and do not waste the current chunk
+  void *large = resource->allocate(4096, 8);
+  CASE_EXPECT_TRUE(nullptr != large);
+  CASE_EXPECT_EQ(2, resource->get_chunk_count());
+  char *p4 = reinterpret_cast<char *>(resource->allocate(8, 8));
+  CASE_EXPECT_EQ(reinterpret_cast<uintptr_t>(p3) + 32, reinterpret_cast<uintptr_t>(p4));
+
+  for (int i = 0; i < 64; ++i) {
+    CASE_EXPECT_TRUE(nullptr != resource->allocate(64, 8));
+  }
+  size_t chunk_count = resource->get_chunk_count();
+  CASE_EXPECT_GT(chunk_count, 2);
+
+  // Standard chunks are kept up to max_reserved_bytes and reused
+  resource->reset();
+  CASE_EXPECT_EQ(0, resource->get_used_bytes());
+  CASE_EXPECT_EQ(2, resource->get_chunk_count());
+  CASE_EXPECT_TRUE(nullptr != resource->allocate(64, 8));
+  CASE_EXPECT_EQ(2, resource->get_chunk_count());
+
+  resource->release();
+  CASE_EXPECT_EQ(0, resource->get_chunk_count());
+}
+
+CASE_TEST(arena_allocator_test, containers) {
+  atfw::util::memory::arena_resource::ptr_t resource = atfw::util::memory::arena_resource::create();
+  using allocator_t = atfw::util::memory::arena_allocator<int>;
+
+  {
+    std::vector<int, allocator_t> vec{allocator_t(resource)};
+    std::list<int, allocator_t> ls{allocator_t(resource)};
+    for (int i = 0; i < 1000; ++i) {
+      vec.push_back(i);
+      ls.push_back(i);
+    }
+    CASE_EXPECT_EQ(999, vec.back());
+    CASE_EXPECT_EQ(999, ls.back());
+    CASE_EXPECT_GT(resource->get_used_bytes(), 1000 * sizeof(int));
+    CASE_EXPECT_TRUE(vec.get_allocator() == ls.get_allocator());
+  }
+  resource->reset();
+
+  // Default constructed arena_allocator forwards to backend allocator
+  allocator_t alloc;
+  CASE_EXPECT_TRUE(alloc != allocator_t(resource));
+  std::vector<int, allocator_t> vec;
+  vec.resize(128, 1);
+  CASE_EXPECT_EQ(128, vec.size());
+  CASE_EXPECT_EQ(0, resource->get_used_bytes());
+}
@@ -0,0 +1,193 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "memory/atomic_strong_rc_ptr.h"
+#include "memory/rc_ptr.h"
+
+namespace {
+struct test_atomic_rc_object {
+  explicit test_atomic_rc_object(int v) : value(v) { ++alive_count(); }
+  ~test_atomic_rc_object() { --alive_count(); }
+
+  static std::atomic<int> &alive_count() {
+    static std::atomic<int> ret{0};
+    return ret;
+  }
+
+  int value;
+};
+
+struct test_atomic_rc_esft : public atfw::util::memory::enable_shared_atomic_rc_from_this<test_atomic_rc_esft> {
+  int value = 0;
+};
+}  // namespace
+
+CASE_TEST(atomic_rc_ptr, basic) {
+  {
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> p1 =
+        atfw::util::memory::make_atomic_rc<test_atomic_rc_object>(1);
+    CASE_EXPECT_EQ(1, p1.use_count());
+    CASE_EXPECT_EQ(1, test_atomic_rc_object::alive_count().load());
+
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> p2 = p1;
+    CASE_EXPECT_EQ(2, p1.use_count());
+
+    atfw::util::memory::atomic_weak_rc_ptr<test_atomic_rc_object> w1 = p1;
+    CASE_EXPECT_EQ(2, w1.use_count());
+    CASE_EXPECT_TRUE(w1.lock() == p1);
+
+    p1.reset();
+    p2.reset();
+    CASE_EXPECT_TRUE(w1.expired());
+    CASE_EXPECT_TRUE(nullptr == w1.lock());
+  }
+  CASE_EXPECT_EQ(0, test_atomic_rc_object::alive_count().load());
+
+  {
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_esft> p1 =
+        atfw::util::memory::allocate_atomic_rc<test_atomic_rc_esft>(std::allocator<test_atomic_rc_esft>());
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_esft> p2 = p1->shared_from_this();
+    CASE_EXPECT_TRUE(p1 == p2);
+    CASE_EXPECT_EQ(2, p1.use_count());
+  }
+}
+
+CASE_TEST(atomic_rc_ptr, multi_thread_copy) {
+  atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> origin =
+      atfw::util::memory::make_atomic_rc<test_atomic_rc_object>(1);
+  atfw::util::memory::atomic_weak_rc_ptr<test_atomic_rc_object> weak = origin;
+
+  // The test framework is not thread-safe, so we only count errors in worker threads
+  std::atomic<int> error_count{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&origin, &weak, &error_count]() {
+      for (int j = 0; j < 10000; ++j) {
+        atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> copy = origin;
+        atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> locked = weak.lock();
+        if (copy != locked) {
+          ++error_count;
+        }
+      }
+    });
+  }
+  for (auto &thd : threads) {
+    thd.join();
+  }
+  CASE_EXPECT_EQ(0, error_count.load());
+
+  CASE_EXPECT_EQ(1, origin.use_count());
+  CASE_EXPECT_EQ(1, test_atomic_rc_object::alive_count().load());
+
+  // Release the last strong reference while other threads are locking the weak one
+  std::atomic<bool> start{false};
+  threads.clear();
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&start, &weak, &error_count]() {
+      while (!start.load()) {
+        std::this_thread::yield();
+      }
+      for (int j = 0; j < 1000; ++j) {
+        atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> locked = weak.lock();
+        if (locked && 1 != locked->value) {
+          ++error_count;
+        }
+      }
+    });
+  }
+  start.store(true);
+  origin.reset();
+  for (auto &thd : threads) {
+    thd.join();
+  }
+  CASE_EXPECT_EQ(0, error_count.load());
+
+  CASE_EXPECT_TRUE(weak.expired());
+  CASE_EXPECT_EQ(0, test_atomic_rc_object::alive_count().load());
+}
+
+CASE_TEST(atomic_rc_ptr, atomic_strong_rc_ptr_basic) {
+  {
+    atfw::util::memory::atomic_strong_rc_ptr<test_atomic_rc_object> holder;
+    CASE_EXPECT_FALSE(holder.is_lock_free());
+    CASE_EXPECT_TRUE(nullptr == holder.load());
+
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> p1 =
+        atfw::util::memory::make_atomic_rc<test_atomic_rc_object>(1);
+    holder.store(p1);
+    CASE_EXPECT_EQ(2, p1.use_count());
+    CASE_EXPECT_TRUE(holder.load() == p1);
+
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> p2 =
+        atfw::util::memory::make_atomic_rc<test_atomic_rc_object>(2);
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> old = holder.exchange(p2);
+    CASE_EXPECT_TRUE(old == p1);
+    CASE_EXPECT_EQ(2, p1.use_count());
+    old.reset();
+    CASE_EXPECT_EQ(1, p1.use_count());
+
+    // expected mismatch: expected is replaced by the stored value
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> expected = p1;
+    CASE_EXPECT_FALSE(holder.compare_exchange_strong(expected, p1));
+    CASE_EXPECT_TRUE(expected == p2);
+    CASE_EXPECT_EQ(1, p1.use_count());
+    CASE_EXPECT_EQ(3, p2.use_count());
+
+    CASE_EXPECT_TRUE(holder.compare_exchange_weak(expected, p1));
+    CASE_EXPECT_TRUE(holder.load() == p1);
+    CASE_EXPECT_EQ(2, p2.use_count());
+
+    atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> p3 = holder;
+    CASE_EXPECT_TRUE(p3 == p1);
+    holder = nullptr;
+    CASE_EXPECT_EQ(2, p1.use_count());
+  }
+  CASE_EXPECT_EQ(0, test_atomic_rc_object::alive_count().load());
+}
+
+CASE_TEST(atomic_rc_ptr, atomic_strong_rc_ptr_publish) {
+  {
+    atfw::util::memory::atomic_strong_rc_ptr<test_atomic_rc_object> holder(
+        atfw::util::memory::make_atomic_rc<test_atomic_rc_object>(0));
+    std::atomic<bool> stop{false};
+    std::atomic<int> error_count{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+      readers.emplace_back([&holder, &stop, &error_count]() {
+        int last_value = 0;
+        while (!stop.load()) {
+          atfw::util::memory::atomic_rc_ptr<test_atomic_rc_object> snapshot = holder.load();
+          // Published values are monotonic
+          if (!snapshot || snapshot->value < last_value) {
+            ++error_count;
+            break;
+          }
+          last_value = snapshot->value;
+        }
+      });
+    }
+
+    std::thread writer([&holder]() {
+      for (int i = 1; i <= 10000; ++i) {
+        holder.store(atfw::util::memory::make_atomic_rc<test_atomic_rc_object>(i));
+      }
+    });
+    writer.join();
+    stop.store(true);
+    for (auto &thd : readers) {
+      thd.join();
+    }
+    CASE_EXPECT_EQ(0, error_count.load());
+
+    CASE_EXPECT_EQ(10000, holder.load()->value);
+    CASE_EXPECT_EQ(1, test_atomic_rc_object::alive_count().load());
+  }
+  CASE_EXPECT_EQ(0, test_atomic_rc_object::alive_count().load());
+}
@@ -0,0 +1,140 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "memory/concurrent_lru_map.h"
+
+CASE_TEST(concurrent_lru_map_test, basic_container) {
+  using lru_t = atfw::util::memory::concurrent_lru_map<int, long>;
+  lru_t lru(4, 0);
+  CASE_EXPECT_EQ(4, lru.shard_count());
+  CASE_EXPECT_TRUE(lru.empty());
+
+  CASE_EXPECT_TRUE(lru.insert(1, std::make_shared<long>(101)));
+  CASE_EXPECT_FALSE(lru.insert(1, std::make_shared<long>(1001)));
+  CASE_EXPECT_TRUE(lru.insert(2, std::make_shared<long>(102)));
+  CASE_EXPECT_EQ(2, lru.size());
+
+  std::shared_ptr<long> value = lru.get(1);
+  CASE_EXPECT_TRUE(!!value);
+  if (value) {
+    CASE_EXPECT_EQ(101, *value);
+  }
+  CASE_EXPECT_TRUE(!lru.get(3));
+
+  lru.insert_or_assign(1, std::make_shared<long>(1001));
+  lru.insert_or_assign(3, std::make_shared<long>(103));
+  CASE_EXPECT_EQ(3, lru.size());
+  CASE_EXPECT_EQ(1001, *lru.get(1));
+  CASE_EXPECT_EQ(103, *lru.get(3));
+
+  CASE_EXPECT_EQ(1, lru.erase(2));
+  CASE_EXPECT_EQ(0, lru.erase(2));
+  CASE_EXPECT_EQ(2, lru.size());
+
+  lru.clear();
+  CASE_EXPECT_TRUE(lru.empty());
+}
+
+CASE_TEST(concurrent_lru_map_test, evict_per_shard) {
+  using lru_t = atfw::util::memory::concurrent_lru_map<int, long>;
+  // One shard is an exact LRU
+  lru_t lru(1, 8);
+
+  for (int i = 0; i < 8; ++i) {
+    lru.insert(i, std::make_shared<long>(100 + i));
+  }
+  // 0 becomes the most recently used one
+  CASE_EXPECT_TRUE(!!lru.get(0));
+  lru.insert(8, std::make_shared<long>(108));
+  lru.insert(9, std::make_shared<long>(109));
+
+  CASE_EXPECT_EQ(8, lru.size());
+  CASE_EXPECT_TRUE(!!lru.get(0));
+  CASE_EXPECT_TRUE(!lru.get(1));
+  CASE_EXPECT_TRUE(!lru.get(2));
+  CASE_EXPECT_TRUE(!!lru.get(9));
+
+  lru_t sharded_lru(4, 16);
+  for (int i = 0; i < 1000; ++i) {
+    sharded_lru.insert(i, std::make_shared<long>(i));
+  }
+  CASE_EXPECT_LE(sharded_lru.size(), 64);
+  // The most recently inserted element is never evicted
+  CASE_EXPECT_TRUE(!!sharded_lru.get(999));
+}
+
+CASE_TEST(concurrent_lru_map_test, get_or_insert_once) {
+  using lru_t = atfw::util::memory::concurrent_lru_map<int, long>;
+  lru_t lru(8, 1024);
+
+  std::atomic<int> load_times{0};
+  std::atomic<int> ready_threads{0};
+  std::atomic<int> failed{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&lru, &load_times, &ready_threads, &failed]() {
+      ready_threads.fetch_add(1);
+      while (ready_threads.load() < 8) {
+        std::this_thread::yield();
+      }
+
+      for (int key = 0; key < 64; ++key) {
+        std::shared_ptr<long> value = lru.get_or_insert(key, [&load_times](const int &k) {
+          load_times.fetch_add(1);
+          // Make concurrent misses of the same key
+          std::this_thread::sleep_for(std::chrono::milliseconds{1});
+          return std::make_shared<long>(1000 + k);
+        });
+        if (!value || *value != 1000 + key) {
+          failed.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto &thd : threads) {
+    thd.join();
+  }
+
+  CASE_EXPECT_EQ(64, load_times.load());
+  CASE_EXPECT_EQ(0, failed.load());
+  CASE_EXPECT_EQ(64, lru.size());
+}
+
+CASE_TEST(concurrent_lru_map_test, get_or_insert_not_found) {
+  using lru_t = atfw::util::memory::concurrent_lru_map<int, long>;
+  lru_t lru(2, 0);
+
+  int load_times = 0;
+  auto loader = [&load_times](const int &) {
+    ++load_times;
+    return std::shared_ptr<long>();
+  };
+  CASE_EXPECT_TRUE(!lru.get_or_insert(1, loader));
+  CASE_EXPECT_TRUE(!lru.get_or_insert(1, loader));
+  // Nothing is cached when the loader returns nullptr
+  CASE_EXPECT_EQ(2, load_times);
+  CASE_EXPECT_TRUE(lru.empty());
+
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+  bool caught = false;
+  try {
+    lru.get_or_insert(2, [](const int &) -> std::shared_ptr<long> { throw std::runtime_error("load failed"); });
+  } catch (const std::runtime_error &) {
+    caught = true;
+  }
+  CASE_EXPECT_TRUE(caught);
+
+  // The loading record is removed, the next call loads again
+  std::shared_ptr<long> value = lru.get_or_insert(2, [](const int &) { return std::make_shared<long>(102); });
+  CASE_EXPECT_TRUE(!!value);
+  CASE_EXPECT_EQ(1, lru.size());
+#endif
+}
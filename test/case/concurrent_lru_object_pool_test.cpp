@@ -0,0 +1,194 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "memory/concurrent_lru_object_pool.h"
+
+namespace {
+struct test_concurrent_lru_data {
+  int value;
+};
+
+static std::atomic<int> g_concurrent_lru_gc_count{0};
+
+struct test_concurrent_lru_action : public atfw::util::memory::lru_default_action<test_concurrent_lru_data> {
+  using base_type = atfw::util::memory::lru_default_action<test_concurrent_lru_data>;
+  void gc(test_concurrent_lru_data *obj) {
+    g_concurrent_lru_gc_count.fetch_add(1);
+    base_type::gc(obj);
+  }
+};
+
+using test_concurrent_lru_pool_t =
+    atfw::util::memory::concurrent_lru_pool<int, test_concurrent_lru_data, test_concurrent_lru_action>;
+}  // namespace
+
+CASE_TEST(concurrent_lru_object_pool_test, basic) {
+  g_concurrent_lru_gc_count.store(0);
+  {
+    test_concurrent_lru_pool_t pool(4);
+    CASE_EXPECT_EQ(4, pool.get_magazine_size());
+    CASE_EXPECT_EQ(nullptr, pool.pull(1));
+    CASE_EXPECT_FALSE(pool.push(1, nullptr));
+
+    // 10 objects fill 2 magazines of this thread, and the first full one is given to depot
+    for (int i = 0; i < 10; ++i) {
+      CASE_EXPECT_TRUE(pool.push(1, new test_concurrent_lru_data{i}));
+    }
+    CASE_EXPECT_EQ(10, pool.size());
+    CASE_EXPECT_EQ(4, pool.get_depot_item_count());
+
+    // FILO
+    test_concurrent_lru_data *obj = pool.pull(1);
+    CASE_EXPECT_TRUE(nullptr != obj);
+    if (nullptr != obj) {
+      CASE_EXPECT_EQ(9, obj->value);
+      delete obj;
+    }
+    CASE_EXPECT_EQ(nullptr, pool.pull(2));
+
+    // Objects in magazines of threads are not destroyed by gc()
+    CASE_EXPECT_EQ(4, pool.gc());
+    CASE_EXPECT_EQ(4, g_concurrent_lru_gc_count.load());
+    CASE_EXPECT_EQ(5, pool.size());
+
+    for (int i = 0; i < 5; ++i) {
+      obj = pool.pull(1);
+      CASE_EXPECT_TRUE(nullptr != obj);
+      delete obj;
+    }
+    CASE_EXPECT_EQ(nullptr, pool.pull(1));
+    CASE_EXPECT_EQ(0, pool.size());
+
+    CASE_EXPECT_TRUE(pool.push(2, new test_concurrent_lru_data{100}));
+  }
+
+  // The destructor reclaims objects in magazines of threads
+  CASE_EXPECT_EQ(5, g_concurrent_lru_gc_count.load());
+}
+
+CASE_TEST(concurrent_lru_object_pool_test, proc) {
+  g_concurrent_lru_gc_count.store(0);
+  test_concurrent_lru_pool_t pool(2);
+  pool.set_list_tick_timeout(60);
+
+  pool.proc(1);
+  for (int i = 0; i < 6; ++i) {
+    pool.push(1, new test_concurrent_lru_data{i});
+  }
+  // Magazine of objects 0,1 is in depot
+  pool.proc(30);
+  for (int i = 6; i < 8; ++i) {
+    pool.push(1, new test_concurrent_lru_data{i});
+  }
+  // Magazine of objects 2,3 is in depot
+  CASE_EXPECT_EQ(4, pool.get_depot_item_count());
+
+  CASE_EXPECT_EQ(0, pool.proc(61));
+  CASE_EXPECT_EQ(2, pool.proc(62));
+  CASE_EXPECT_EQ(2, pool.get_depot_item_count());
+
+  pool.set_item_max_bound(1);
+  CASE_EXPECT_EQ(2, pool.proc(63));
+  CASE_EXPECT_EQ(0, pool.get_depot_item_count());
+  CASE_EXPECT_EQ(4, pool.size());
+
+  pool.clear();
+  CASE_EXPECT_EQ(0, pool.size());
+  CASE_EXPECT_EQ(8, g_concurrent_lru_gc_count.load());
+}
+
+CASE_TEST(concurrent_lru_object_pool_test, multi_thread) {
+  g_concurrent_lru_gc_count.store(0);
+  std::atomic<int> created{0};
+  std::atomic<int> destroyed{0};
+  {
+    test_concurrent_lru_pool_t pool(8);
+    std::vector<std::thread> threads;
+    std::atomic<bool> stop{false};
+
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&pool, &created, &destroyed, t]() {
+        std::vector<test_concurrent_lru_data *> objects;
+        for (int round = 0; round < 200; ++round) {
+          for (int i = 0; i < 16; ++i) {
+            test_concurrent_lru_data *obj = pool.pull(round % 3);
+            if (nullptr == obj) {
+              obj = new test_concurrent_lru_data{t};
+              created.fetch_add(1);
+            }
+            objects.push_back(obj);
+          }
+          // Producer threads push more objects than they pull, so objects move across threads through depot
+          if (t % 2 == 0) {
+            objects.push_back(new test_concurrent_lru_data{t});
+            created.fetch_add(1);
+          } else if (!objects.empty()) {
+            delete objects.back();
+            objects.pop_back();
+            destroyed.fetch_add(1);
+          }
+          for (auto &obj : objects) {
+            pool.push(round % 3, obj);
+          }
+          objects.clear();
+        }
+      });
+    }
+
+    // proc() and gc() run without stopping workers
+    std::thread gc_thread([&pool, &stop]() {
+      time_t tick = 0;
+      while (!stop.load()) {
+        pool.proc(++tick);
+        pool.gc();
+        std::this_thread::yield();
+      }
+    });
+
+    for (auto &thd : threads) {
+      thd.join();
+    }
+    stop.store(true);
+    gc_thread.join();
+
+    CASE_EXPECT_EQ(created.load() - destroyed.load() - g_concurrent_lru_gc_count.load(), static_cast<int>(pool.size()));
+  }
+
+  // Every object is destroyed exactly once
+  CASE_EXPECT_EQ(created.load(), destroyed.load() + g_concurrent_lru_gc_count.load());
+}
+
+CASE_TEST(concurrent_lru_object_pool_test, thread_exit_when_destroying) {
+  g_concurrent_lru_gc_count.store(0);
+  int created = 0;
+  for (int round = 0; round < 32; ++round) {
+    test_concurrent_lru_pool_t *pool = new test_concurrent_lru_pool_t(4);
+    std::atomic<bool> pushed{false};
+    std::atomic<bool> exit{false};
+    std::thread thd([pool, &pushed, &exit]() {
+      for (int i = 0; i < 10; ++i) {
+        pool->push(i % 2, new test_concurrent_lru_data{i});
+      }
+      pushed.store(true);
+      while (!exit.load()) {
+        std::this_thread::yield();
+      }
+    });
+    created += 10;
+
+    while (!pushed.load()) {
+      std::this_thread::yield();
+    }
+    // The thread may return its magazines to depot while the pool is destroying
+    exit.store(true);
+    delete pool;
+    thd.join();
+  }
+
+  CASE_EXPECT_EQ(created, g_concurrent_lru_gc_count.load());
+}
@@ -0,0 +1,112 @@
+// Copyright 2026 atframework
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "memory/deferred_rc_ptr.h"
+
+namespace {
+struct test_deferred_rc_node {
+  explicit test_deferred_rc_node(int *c) : counter(c) {}
+  ~test_deferred_rc_node() { ++*counter; }
+
+  int *counter;
+  std::vector<atfw::util::memory::deferred_rc_ptr<test_deferred_rc_node>> children;
+};
+
+struct test_deferred_rc_esft
+    : public atfw::util::memory::enable_shared_deferred_rc_from_this<test_deferred_rc_esft> {
+  int value = 0;
+};
+}  // namespace
+
+CASE_TEST(deferred_rc_ptr, basic) {
+  atfw::util::memory::deferred_rc_release::drain_all();
+
+  int destroyed = 0;
+  atfw::util::memory::deferred_rc_ptr<test_deferred_rc_node> p1 =
+      atfw::util::memory::make_deferred_rc<test_deferred_rc_node>(&destroyed);
+  atfw::util::memory::deferred_rc_ptr<test_deferred_rc_node> p2 = p1;
+  atfw::util::memory::deferred_weak_rc_ptr<test_deferred_rc_node> w1 = p1;
+  CASE_EXPECT_EQ(2, p1.use_count());
+
+  p1.reset();
+  p2.reset();
+  CASE_EXPECT_EQ(0, destroyed);
+  CASE_EXPECT_EQ(1, atfw::util::memory::deferred_rc_release::size());
+
+  // Pending objects can not be locked any more
+  CASE_EXPECT_TRUE(w1.expired());
+  CASE_EXPECT_TRUE(nullptr == w1.lock());
+
+  CASE_EXPECT_EQ(1, atfw::util::memory::deferred_rc_release::drain(8));
+  CASE_EXPECT_EQ(1, destroyed);
+  CASE_EXPECT_EQ(0, atfw::util::memory::deferred_rc_release::size());
+  CASE_EXPECT_EQ(0, atfw::util::memory::deferred_rc_release::drain(8));
+
+  // Custom deleter and allocator
+  {
+    atfw::util::memory::deferred_rc_ptr<test_deferred_rc_node> p3(new test_deferred_rc_node(&destroyed),
+                                                                  std::default_delete<test_deferred_rc_node>());
+    atfw::util::memory::deferred_rc_ptr<test_deferred_rc_esft> p4 =
+        atfw::util::memory::allocate_deferred_rc<test_deferred_rc_esft>(std::allocator<test_deferred_rc_esft>());
+    CASE_EXPECT_TRUE(p4 == p4->shared_from_this());
+  }
+  CASE_EXPECT_EQ(2, atfw::util::memory::deferred_rc_release::size());
+  CASE_EXPECT_EQ(2, atfw::util::memory::deferred_rc_release::drain_all());
+  CASE_EXPECT_EQ(2, destroyed);
+}
+
+CASE_TEST(deferred_rc_ptr, budgeted_drain) {
+  atfw::util::memory::deferred_rc_release::drain_all();
+
+  // A tree with 1 root, 4 children and 16 grandchildren
+  int destroyed = 0;
+  {
+    atfw::util::memory::deferred_rc_ptr<test_deferred_rc_node> root =
+        atfw::util::memory::make_deferred_rc<test_deferred_rc_node>(&destroyed);
+    for (int i = 0; i < 4; ++i) {
+      root->children.push_back(atfw::util::memory::make_deferred_rc<test_deferred_rc_node>(&destroyed));
+      for (int j = 0; j < 4; ++j) {
+        root->children.back()->children.push_back(
+            atfw::util::memory::make_deferred_rc<test_deferred_rc_node>(&destroyed));
+      }
+    }
+  }
+
+  // Releasing the root only queue the root
+  CASE_EXPECT_EQ(1, atfw::util::memory::deferred_rc_release::size());
+  CASE_EXPECT_EQ(0, destroyed);
+
+  CASE_EXPECT_EQ(1, atfw::util::memory::deferred_rc_release::drain(1));
+  CASE_EXPECT_EQ(1, destroyed);
+  CASE_EXPECT_EQ(4, atfw::util::memory::deferred_rc_release::size());
+
+  CASE_EXPECT_EQ(3, atfw::util::memory::deferred_rc_release::drain(3));
+  CASE_EXPECT_EQ(4, destroyed);
+  CASE_EXPECT_EQ(13, atfw::util::memory::deferred_rc_release::size());
+
+  size_t frames = 0;
+  while (atfw::util::memory::deferred_rc_release::size() > 0) {
+    CASE_EXPECT_GE(5, atfw::util::memory::deferred_rc_release::drain(5));
+    ++frames;
+  }
+  CASE_EXPECT_EQ(4, frames);
+  CASE_EXPECT_EQ(21, destroyed);
+}
+
+CASE_TEST(deferred_rc_ptr, thread_exit) {
+  int destroyed = 0;
+  std::thread thd([&destroyed]() {
+    atfw::util::memory::deferred_rc_ptr<test_deferred_rc_node> p1 =
+        atfw::util::memory::make_deferred_rc<test_deferred_rc_node>(&destroyed);
+    p1->children.push_back(atfw::util::memory::make_deferred_rc<test_deferred_rc_node>(&destroyed));
+  });
+  thd.join();
+
+  // Pending objects are destroyed when the thread exits
+  CASE_EXPECT_EQ(2, destroyed);
+}
@@ -0,0 +1,153 @@
+// Copyright 2026 atframework
+
+#include <stdint.h>
+#include <atomic>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "time/jiffies_timer_service.h"
+
+namespace {
+using short_timer_service_t = atfw::util::time::jiffies_timer_service<6, 3, 4>;
+}  // namespace
+
+CASE_TEST(jiffies_timer_service, basic) {
+  short_timer_service_t service;
+  int count = 0;
+  short_timer_service_t::timer_id_t not_inited_timer_id = 0;
+  CASE_EXPECT_EQ(short_timer_service_t::error_type_t::EN_JTET_NOT_INITED,
+                 service.add_timer(
+                     1, [&count](time_t, short_timer_service_t::timer_id_t) { ++count; }, &not_inited_timer_id));
+  CASE_EXPECT_EQ(0, not_inited_timer_id);
+
+  CASE_EXPECT_EQ(short_timer_service_t::error_type_t::EN_JTET_SUCCESS, service.init(100));
+  CASE_EXPECT_EQ(short_timer_service_t::error_type_t::EN_JTET_ALREADY_INITED, service.init(100));
+  CASE_EXPECT_EQ(0, static_cast<int>(service.get_worker_count()));
+
+  CASE_EXPECT_EQ(
+      short_timer_service_t::error_type_t::EN_JTET_TIMEOUT_EXTENDED,
+      service.add_timer(service.get_max_tick_distance() + 1, [&count](time_t, short_timer_service_t::timer_id_t) {
+        ++count;
+      }));
+
+  short_timer_service_t::timer_id_t timer_id1 = 0;
+  short_timer_service_t::timer_id_t timer_id2 = 0;
+  CASE_EXPECT_EQ(short_timer_service_t::error_type_t::EN_JTET_SUCCESS,
+                 service.add_timer(
+                     10,
+                     [&count, &timer_id1](time_t tick_time, short_timer_service_t::timer_id_t timer_id) {
+                       CASE_EXPECT_EQ(110, tick_time);
+                       CASE_EXPECT_EQ(timer_id1, timer_id);
+                       ++count;
+                     },
+                     &timer_id1));
+  service.add_timer(
+      20, [&count](time_t, short_timer_service_t::timer_id_t) { ++count; }, &timer_id2);
+  CASE_EXPECT_NE(0, timer_id1);
+  CASE_EXPECT_NE(timer_id1, timer_id2);
+
+  // Commands are not applied until tick()
+  CASE_EXPECT_EQ(0, static_cast<int>(service.size()));
+  CASE_EXPECT_EQ(0, service.tick(100));
+  CASE_EXPECT_EQ(2, static_cast<int>(service.size()));
+
+  CASE_EXPECT_EQ(1, service.tick(110));
+  CASE_EXPECT_EQ(1, count);
+  CASE_EXPECT_EQ(110, service.get_last_tick());
+
+  CASE_EXPECT_TRUE(service.cancel_timer(timer_id2));
+  CASE_EXPECT_FALSE(service.cancel_timer(0));
+  // Cancel a fired timer is ignored
+  CASE_EXPECT_TRUE(service.cancel_timer(timer_id1));
+  CASE_EXPECT_EQ(0, service.tick(200));
+  CASE_EXPECT_EQ(1, count);
+  CASE_EXPECT_EQ(0, static_cast<int>(service.size()));
+}
+
+CASE_TEST(jiffies_timer_service, multi_producers) {
+  short_timer_service_t service;
+  service.init(0);
+
+  const int producer_count = 4;
+  const int timers_per_producer = 2000;
+  std::atomic<int> fired{0};
+  std::atomic<int> started_producers{0};
+  std::atomic<bool> producers_done{false};
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < producer_count; ++i) {
+    producers.emplace_back([&service, &fired, &started_producers, i]() {
+      started_producers.fetch_add(1);
+      for (int j = 0; j < timers_per_producer; ++j) {
+        short_timer_service_t::timer_id_t timer_id = 0;
+        service.add_timer(
+            (i * timers_per_producer + j) % 50,
+            [&fired](time_t, short_timer_service_t::timer_id_t) { fired.fetch_add(1, std::memory_order_relaxed); },
+            &timer_id);
+        // Cancel every odd timer
+        if (j & 1) {
+          service.cancel_timer(timer_id);
+        }
+      }
+    });
+  }
+
+  // The owner thread keeps applying commands while producers are adding timers. The wheel is not moved before all
+  // producers finished, or a timer may fire before its cancel command is applied.
+  std::thread owner([&service, &producers_done]() {
+    while (!producers_done.load(std::memory_order_acquire)) {
+      service.tick(0);
+      std::this_thread::yield();
+    }
+    service.tick(100);
+  });
+
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  producers_done.store(true, std::memory_order_release);
+  owner.join();
+
+  CASE_EXPECT_EQ(producer_count, started_producers.load());
+  CASE_EXPECT_EQ(producer_count * timers_per_producer / 2, fired.load());
+  CASE_EXPECT_EQ(0, static_cast<int>(service.size()));
+}
+
+CASE_TEST(jiffies_timer_service, worker_pool) {
+  short_timer_service_t service(2);
+  service.init(0);
+  CASE_EXPECT_EQ(2, static_cast<int>(service.get_worker_count()));
+
+  std::thread::id owner_thread_id = std::this_thread::get_id();
+  std::atomic<int> fired{0};
+  std::atomic<int> fired_on_owner{0};
+  for (int i = 0; i < 1000; ++i) {
+    service.add_timer(i % 30, [&fired, &fired_on_owner, owner_thread_id](time_t, short_timer_service_t::timer_id_t) {
+      if (std::this_thread::get_id() == owner_thread_id) {
+        fired_on_owner.fetch_add(1);
+      }
+      fired.fetch_add(1);
+    });
+  }
+
+  // Every callback is queued to workers
+  CASE_EXPECT_EQ(1000, service.tick(100));
+  service.stop_workers();
+  CASE_EXPECT_EQ(1000, fired.load());
+  CASE_EXPECT_EQ(0, fired_on_owner.load());
+  CASE_EXPECT_EQ(0, static_cast<int>(service.get_worker_count()));
+
+  // Callbacks run on the owner thread after workers stopped
+  service.add_timer(1, [&fired, &fired_on_owner, owner_thread_id](time_t, short_timer_service_t::timer_id_t) {
+    if (std::this_thread::get_id() == owner_thread_id) {
+      fired_on_owner.fetch_add(1);
+    }
+    fired.fetch_add(1);
+  });
+  CASE_EXPECT_EQ(1, service.tick(200));
+  CASE_EXPECT_EQ(1001, fired.load());
+  CASE_EXPECT_EQ(1, fired_on_owner.load());
+}
@@ -0,0 +1,162 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+#include "log/log_async_pipeline.h"
+#include "log/log_wrapper.h"
+
+CASE_TEST(log_async_pipeline, dispatch_in_order) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+  logger->set_prefix_format("%L|%n|");
+
+  std::vector<std::string> records;
+  std::thread::id sink_thread_id;
+  logger->add_sink([&records, &sink_thread_id](const atfw::util::log::log_wrapper::caller_info_t &,
+                                               atfw::util::nostd::string_view content) {
+    records.push_back(std::string(content.data(), content.size()));
+    sink_thread_id = std::this_thread::get_id();
+  });
+
+  CASE_EXPECT_TRUE(logger->enable_async());
+  CASE_EXPECT_TRUE(logger->is_async_enabled());
+  for (int i = 0; i < 100; ++i) {
+    WINSTLOGINFO(*logger, "record %d", i);
+  }
+  logger->flush_async();
+
+  CASE_EXPECT_EQ(100, static_cast<int>(records.size()));
+  CASE_EXPECT_TRUE(sink_thread_id != std::this_thread::get_id());
+  for (size_t i = 0; i < records.size(); ++i) {
+    CASE_EXPECT_NE(std::string::npos, records[i].find("record " + std::to_string(i)));
+    CASE_EXPECT_EQ(0, records[i].find("INFO"));
+  }
+
+  atfw::util::log::log_async_statistics stats = logger->get_async_statistics();
+  CASE_EXPECT_EQ(100, stats.pushed);
+  CASE_EXPECT_EQ(100, stats.dispatched);
+  CASE_EXPECT_EQ(0, stats.dropped);
+
+  logger->disable_async();
+  CASE_EXPECT_FALSE(logger->is_async_enabled());
+
+  // Synchronous mode after disabled
+  WINSTLOGINFO(*logger, "record sync");
+  CASE_EXPECT_EQ(101, static_cast<int>(records.size()));
+  CASE_EXPECT_TRUE(sink_thread_id == std::this_thread::get_id());
+}
+
+CASE_TEST(log_async_pipeline, multi_producers) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+
+  std::atomic<int> counter{0};
+  logger->add_sink([&counter](const atfw::util::log::log_wrapper::caller_info_t &,
+                              atfw::util::nostd::string_view) { ++counter; });
+
+  atfw::util::log::log_async_options options;
+  options.ring_buffer_size = 8192;
+  options.overflow_policy = atfw::util::log::log_async_overflow_policy::kBlock;
+  CASE_EXPECT_TRUE(logger->enable_async(options));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&logger]() {
+      for (int j = 0; j < 2000; ++j) {
+        WINSTLOGDEBUG(*logger, "producer record %d", j);
+      }
+    });
+  }
+  for (auto &thd : threads) {
+    thd.join();
+  }
+
+  // Records of exited threads are dispatched when stopping
+  logger->flush_async();
+  atfw::util::log::log_async_statistics stats = logger->get_async_statistics();
+  logger->disable_async();
+
+  CASE_EXPECT_EQ(8000, counter.load());
+  CASE_EXPECT_EQ(8000, stats.pushed);
+  CASE_EXPECT_EQ(8000, stats.dispatched);
+  CASE_EXPECT_EQ(0, stats.dropped);
+}
+
+CASE_TEST(log_async_pipeline, drop_policy) {
+  std::atomic<bool> release_sink{false};
+  std::atomic<int> counter{0};
+  std::atomic<int> error_counter{0};
+
+  atfw::util::log::log_async_options options;
+  options.ring_buffer_size = 4096;
+  options.overflow_policy = atfw::util::log::log_async_overflow_policy::kDropBelowLevel;
+  options.drop_level = atfw::util::log::log_level::kError;
+
+  atfw::util::log::log_async_pipeline pipeline(
+      options, [&](const atfw::util::log::log_async_pipeline::caller_info_t &caller, const char *, size_t) {
+        while (!release_sink.load()) {
+          std::this_thread::yield();
+        }
+        ++counter;
+        if (caller.level_id >= atfw::util::log::log_level::kError) {
+          ++error_counter;
+        }
+      });
+  CASE_EXPECT_TRUE(pipeline.start());
+
+  std::string content(200, 'x');
+  atfw::util::log::log_async_pipeline::caller_info_t info_caller(atfw::util::log::log_level::kInfo, "INFO", __FILE__,
+                                                                 __LINE__, __FUNCTION__);
+  for (int i = 0; i < 100; ++i) {
+    CASE_EXPECT_TRUE(pipeline.push(info_caller, content.c_str(), content.size()));
+  }
+
+  atfw::util::log::log_async_statistics stats = pipeline.get_statistics();
+  CASE_EXPECT_GT(stats.dropped, 0);
+  CASE_EXPECT_EQ(100, stats.pushed + stats.dropped);
+
+  // Records above drop_level will wait for the consumer
+  release_sink.store(true);
+  atfw::util::log::log_async_pipeline::caller_info_t error_caller(atfw::util::log::log_level::kError, "ERROR",
+                                                                  __FILE__, __LINE__, __FUNCTION__);
+  for (int i = 0; i < 100; ++i) {
+    CASE_EXPECT_TRUE(pipeline.push(error_caller, content.c_str(), content.size()));
+  }
+  pipeline.flush();
+  CASE_EXPECT_EQ(100, error_counter.load());
+
+  pipeline.stop();
+  CASE_EXPECT_FALSE(pipeline.push(error_caller, content.c_str(), content.size()));
+
+  stats = pipeline.get_statistics();
+  CASE_EXPECT_EQ(static_cast<uint64_t>(counter.load()), stats.dispatched);
+  CASE_EXPECT_EQ(stats.pushed, stats.dispatched);
+}
+
+CASE_TEST(log_async_pipeline, oversize_record) {
+  atfw::util::log::log_async_options options;
+  options.ring_buffer_size = 4096;
+  options.overflow_policy = atfw::util::log::log_async_overflow_policy::kDropNewest;
+
+  atfw::util::log::log_async_pipeline pipeline(
+      options, [](const atfw::util::log::log_async_pipeline::caller_info_t &, const char *, size_t) {});
+  CASE_EXPECT_TRUE(pipeline.start());
+
+  // Too large to be queued, caller should write it synchronously
+  std::string content(4096, 'x');
+  atfw::util::log::log_async_pipeline::caller_info_t caller(atfw::util::log::log_level::kInfo, "INFO", __FILE__,
+                                                            __LINE__, __FUNCTION__);
+  CASE_EXPECT_FALSE(pipeline.push(caller, content.c_str(), content.size()));
+  CASE_EXPECT_TRUE(pipeline.push(caller, content.c_str(), 128));
+  pipeline.flush();
+
+  atfw::util::log::log_async_statistics stats = pipeline.get_statistics();
+  CASE_EXPECT_EQ(1, stats.pushed);
+  CASE_EXPECT_EQ(1, stats.dispatched);
+}
@@ -0,0 +1,138 @@
+// Copyright 2026 atframework
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+#include "log/log_deferred_format.h"
+#include "log/log_wrapper.h"
+
+#if defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI
+
+namespace {
+struct log_deferred_format_test_object {
+  int value;
+};
+}  // namespace
+
+ATFRAMEWORK_UTILS_STRING_FWAPI_NAMESPACE_BEGIN
+template <class CharT>
+struct formatter<log_deferred_format_test_object, CharT> : formatter<int, CharT> {
+  template <class FormatContext>
+  auto format(const log_deferred_format_test_object &obj, FormatContext &ctx) const {
+    return formatter<int, CharT>::format(obj.value * 10, ctx);
+  }
+};
+ATFRAMEWORK_UTILS_STRING_FWAPI_NAMESPACE_END
+
+CASE_TEST(log_deferred_format, encode_and_render) {
+  using codec_type = atfw::util::log::log_deferred_codec<int, double, const char *, std::string, bool,
+                                                          log_deferred_format_test_object>;
+  unsigned char buffer[256];
+
+  std::string temporary = "temporary string";
+  unsigned char *end = codec_type::encode(buffer, buffer + sizeof(buffer), "{}-{:.2f}-{}-{}-{}-{}", 42, 3.14159,
+                                          "literal", temporary, true, log_deferred_format_test_object{7});
+  CASE_EXPECT_TRUE(nullptr != end);
+  // Strings are copied, the arguments can be destroyed before rendering
+  temporary.assign(temporary.size(), 'x');
+
+  char output[256];
+  size_t len = codec_type::render(output, sizeof(output), buffer, static_cast<size_t>(end - buffer));
+  CASE_EXPECT_EQ("42-3.14-literal-temporary string-true-70", std::string(output, len));
+
+  // Truncated
+  len = codec_type::render(output, 5, buffer, static_cast<size_t>(end - buffer));
+  CASE_EXPECT_EQ("42-3.", std::string(output, len));
+
+  // Not enough space to encode
+  CASE_EXPECT_TRUE(nullptr == codec_type::encode(buffer, buffer + 24, "{}-{:.2f}-{}-{}-{}-{}", 42, 3.14159,
+                                                 "literal", temporary, true, log_deferred_format_test_object{7}));
+}
+
+CASE_TEST(log_deferred_format, fallback_to_sync) {
+  using codec_type = atfw::util::log::log_deferred_codec<int, log_deferred_format_test_object>;
+  unsigned char buffer[256];
+
+  // Specs of pre-rendered arguments can not be applied at rendering
+  CASE_EXPECT_TRUE(nullptr == codec_type::encode(buffer, buffer + sizeof(buffer), "{} {:04x}", 1,
+                                                 log_deferred_format_test_object{2}));
+  CASE_EXPECT_TRUE(nullptr == codec_type::encode(buffer, buffer + sizeof(buffer), "{0:>4} {1:>4}", 1,
+                                                 log_deferred_format_test_object{2}));
+  CASE_EXPECT_TRUE(nullptr == codec_type::encode(buffer, buffer + sizeof(buffer), "{:>{}}", 1,
+                                                 log_deferred_format_test_object{2}));
+  CASE_EXPECT_TRUE(nullptr != codec_type::encode(buffer, buffer + sizeof(buffer), "{{}} {:04x} {}", 1,
+                                                 log_deferred_format_test_object{2}));
+
+  // Null C string
+  const char *null_string = nullptr;
+  CASE_EXPECT_TRUE(nullptr == atfw::util::log::log_deferred_codec<const char *>::encode(
+                                  buffer, buffer + sizeof(buffer), "{}", null_string));
+}
+
+CASE_TEST(log_deferred_format, render_in_async_pipeline) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+  logger->set_prefix_format("[%L]");
+
+  std::vector<std::string> records;
+  std::thread::id sink_thread_id;
+  logger->add_sink([&records, &sink_thread_id](const atfw::util::log::log_wrapper::caller_info_t &,
+                                               atfw::util::nostd::string_view content) {
+    records.push_back(std::string(content.data(), content.size()));
+    sink_thread_id = std::this_thread::get_id();
+  });
+
+  // Formatted synchronously without async pipeline
+  logger->format_log_deferred(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, {},
+                                                                          __FILE__, __LINE__, __FUNCTION__),
+                              "sync {} {}", 1, "x");
+  CASE_EXPECT_EQ(1, static_cast<int>(records.size()));
+  CASE_EXPECT_TRUE(sink_thread_id == std::this_thread::get_id());
+
+  CASE_EXPECT_TRUE(logger->enable_async());
+  for (int i = 0; i < 100; ++i) {
+    std::string name = "name-" + std::to_string(i);
+    logger->format_log_deferred(atfw::util::log::log_wrapper::caller_info_t(atfw::util::log::log_level::kInfo, {},
+                                                                            __FILE__, __LINE__, __FUNCTION__),
+                                "record {} {} {:.1f}", i, name, i * 0.5);
+  }
+  FWINSTLOGDEFERRED(atfw::util::log::log_level::kDebug, *logger, "macro {}", 100);
+  logger->flush_async();
+  std::thread::id async_sink_thread_id = sink_thread_id;
+
+  // Formatted synchronously when the deferred result may be different
+  std::vector<std::string> sync_records;
+  sync_records.swap(records);
+  const char *null_string = nullptr;
+  FWINSTLOGDEFERRED(atfw::util::log::log_level::kDebug, *logger, "spec {:04x}", log_deferred_format_test_object{2});
+  FWINSTLOGDEFERRED(atfw::util::log::log_level::kDebug, *logger, "null {}", null_string);
+  logger->flush_async();
+  CASE_EXPECT_EQ(2, static_cast<int>(records.size()));
+  if (records.size() >= 2) {
+    CASE_EXPECT_EQ("[DEBUG   ]spec 0014", records[0]);
+    logger->disable_async();
+    FWINSTLOGDEBUG(*logger, "null {}", null_string);
+    CASE_EXPECT_EQ(3, static_cast<int>(records.size()));
+    if (records.size() >= 3) {
+      CASE_EXPECT_EQ(records[2], records[1]);
+    }
+  }
+  records.swap(sync_records);
+  logger->disable_async();
+
+  CASE_EXPECT_EQ(102, static_cast<int>(records.size()));
+  CASE_EXPECT_TRUE(async_sink_thread_id != std::this_thread::get_id());
+  CASE_EXPECT_EQ("[INFO    ]sync 1 x", records[0]);
+  CASE_EXPECT_EQ("[DEBUG   ]macro 100", records.back());
+  for (size_t i = 1; i + 1 < records.size(); ++i) {
+    int index = static_cast<int>(i - 1);
+    CASE_EXPECT_EQ("[INFO    ]record " + std::to_string(index) + " name-" + std::to_string(index) + " " +
+                       std::to_string(index / 2) + (index % 2 ? ".5" : ".0"),
+                   records[i]);
+  }
+}
+
+#endif
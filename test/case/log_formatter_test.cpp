@@ -452,3 +452,70 @@ CASE_TEST(log_formatter, format_level_auto_names) {
     CASE_EXPECT_EQ(0, strncmp(buffer, c.expected_prefix, strlen(c.expected_prefix)));
   }
 }
+
+CASE_TEST(log_formatter, compile_merge_literal) {
+  atfw::util::log::log_formatter::compiled_format_t compiled;
+  const char *fmt = "[%F %T][%Z]%%:%n%";
+  atfw::util::log::log_formatter::compile(compiled, fmt, strlen(fmt));
+
+  using op_type = atfw::util::log::log_formatter::format_op_type;
+  // "[" F " " T "][" "Z]" "%:" n, the escaped characters are merged with the following literals
+  CASE_EXPECT_EQ(8, static_cast<int>(compiled.ops.size()));
+  if (compiled.ops.size() >= 8) {
+    CASE_EXPECT_TRUE(op_type::kLiteral == compiled.ops[0].type);
+    CASE_EXPECT_TRUE(op_type::kDate == compiled.ops[1].type);
+    CASE_EXPECT_TRUE(op_type::kTime == compiled.ops[3].type);
+    CASE_EXPECT_TRUE(op_type::kLiteral == compiled.ops[4].type);
+    CASE_EXPECT_EQ(2, static_cast<int>(compiled.ops[4].size));
+    CASE_EXPECT_TRUE(op_type::kLiteral == compiled.ops[5].type);
+    CASE_EXPECT_EQ("Z]", compiled.pattern.substr(compiled.ops[5].offset, compiled.ops[5].size));
+    CASE_EXPECT_EQ("%:", compiled.pattern.substr(compiled.ops[6].offset, compiled.ops[6].size));
+    CASE_EXPECT_TRUE(op_type::kLineNumber == compiled.ops[7].type);
+  }
+
+  atfw::util::log::log_formatter::compile(compiled, nullptr, 0);
+  CASE_EXPECT_TRUE(compiled.ops.empty());
+}
+
+CASE_TEST(log_formatter, compiled_same_as_format) {
+  atfw::util::time::time_utility::update();
+  atfw::util::log::log_formatter::caller_info_t caller(atfw::util::log::log_level::kWarning, "", __FILE__, __LINE__,
+                                                       __FUNCTION__, 12345);
+
+  const char *patterns[] = {"[%F %T][%L](%k:%n): ",
+                            "%Y%y%m%j%d%w%H%I%M%S",
+                            "%R|%l|%s|%C|%N",
+                            "unknown %Z %% end%",
+                            "no format at all",
+                            ""};
+  for (const char *fmt : patterns) {
+    atfw::util::log::log_formatter::compiled_format_t compiled;
+    atfw::util::log::log_formatter::compile(compiled, fmt, strlen(fmt));
+
+    // Also check truncation at every buffer size
+    for (size_t bufz = 1; bufz <= 256; ++bufz) {
+      char expect_buffer[256] = {0};
+      char compiled_buffer[256] = {0};
+      size_t expect_len = atfw::util::log::log_formatter::format(expect_buffer, bufz, fmt, strlen(fmt), caller);
+      size_t compiled_len = atfw::util::log::log_formatter::format(compiled_buffer, bufz, compiled, caller);
+      if (expect_len != compiled_len || 0 != memcmp(expect_buffer, compiled_buffer, bufz)) {
+        // The second may change between two calls, try again
+        expect_len = atfw::util::log::log_formatter::format(expect_buffer, bufz, fmt, strlen(fmt), caller);
+      }
+      CASE_EXPECT_EQ(expect_len, compiled_len);
+      CASE_EXPECT_EQ(0, memcmp(expect_buffer, compiled_buffer, bufz));
+    }
+  }
+}
+
+CASE_TEST(log_formatter, compiled_integer_truncation) {
+  atfw::util::log::log_formatter::caller_info_t caller(atfw::util::log::log_level::kInfo, "INFO", __FILE__, 123456,
+                                                       __FUNCTION__);
+  atfw::util::log::log_formatter::compiled_format_t compiled;
+  atfw::util::log::log_formatter::compile(compiled, "%n", 2);
+
+  char buffer[4] = {0};
+  size_t len = atfw::util::log::log_formatter::format(buffer, sizeof(buffer), compiled, caller);
+  CASE_EXPECT_LE(len, sizeof(buffer));
+  CASE_EXPECT_EQ(0, strcmp(buffer, "123"));
+}
@@ -0,0 +1,206 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+#include "log/log_rate_limiter.h"
+#include "log/log_wrapper.h"
+
+CASE_TEST(log_rate_limiter, burst_and_refill) {
+  // 10 records per second, burst 3
+  atfw::util::log::log_rate_limiter limiter(10, 3, std::chrono::milliseconds{0});
+
+  uint64_t suppressed = 0;
+  int passed = 0;
+  for (int i = 0; i < 10; ++i) {
+    if (limiter.check(suppressed)) {
+      ++passed;
+      CASE_EXPECT_EQ(0, suppressed);
+    }
+  }
+  CASE_EXPECT_EQ(3, passed);
+  CASE_EXPECT_EQ(7, limiter.get_suppressed());
+
+  // Refilled after 100ms, and the suppressed count is reported
+  std::this_thread::sleep_for(std::chrono::milliseconds{120});
+  CASE_EXPECT_TRUE(limiter.check(suppressed));
+  CASE_EXPECT_EQ(7, suppressed);
+  CASE_EXPECT_EQ(0, limiter.get_suppressed());
+
+  // Unlimited
+  atfw::util::log::log_rate_limiter unlimited(0);
+  for (int i = 0; i < 100; ++i) {
+    CASE_EXPECT_TRUE(unlimited.check(suppressed));
+  }
+}
+
+CASE_TEST(log_rate_limiter, sampler) {
+  atfw::util::log::log_sampler sampler(4, std::chrono::milliseconds{0});
+
+  uint64_t suppressed = 0;
+  int passed = 0;
+  uint64_t total_suppressed = 0;
+  for (int i = 0; i < 16; ++i) {
+    if (sampler.check(suppressed)) {
+      ++passed;
+      total_suppressed += suppressed;
+    }
+  }
+  CASE_EXPECT_EQ(4, passed);
+  // The last 3 records are not reported yet
+  CASE_EXPECT_EQ(9, total_suppressed);
+  CASE_EXPECT_EQ(3, sampler.get_suppressed());
+
+  // Sampled by each thread, suppressed records are counted in the thread state
+  atfw::util::log::log_sampler thread_sampler(4, std::chrono::milliseconds{0});
+  atfw::util::log::log_sampler::thread_state_t thread_state;
+  passed = 0;
+  total_suppressed = 0;
+  for (int i = 0; i < 16; ++i) {
+    if (thread_sampler.check(suppressed, thread_state)) {
+      ++passed;
+      total_suppressed += suppressed;
+    }
+  }
+  CASE_EXPECT_EQ(4, passed);
+  CASE_EXPECT_EQ(9, total_suppressed);
+  CASE_EXPECT_EQ(3, thread_sampler.get_suppressed());
+}
+
+CASE_TEST(log_rate_limiter, summary_interval) {
+  atfw::util::log::log_sampler sampler(2, std::chrono::seconds{3600});
+
+  uint64_t suppressed = 0;
+  int reported = 0;
+  for (int i = 0; i < 100; ++i) {
+    if (sampler.check(suppressed) && suppressed > 0) {
+      ++reported;
+    }
+  }
+
+  // Only the first summary is reported in the interval
+  CASE_EXPECT_EQ(1, reported);
+}
+
+CASE_TEST(log_rate_limiter, callsite_macros) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+  logger->set_prefix_format("");
+
+  std::vector<std::string> records;
+  logger->add_sink([&records](const atfw::util::log::log_wrapper::caller_info_t &,
+                              atfw::util::nostd::string_view content) {
+    records.push_back(std::string(content.data(), content.size()));
+  });
+
+  for (int i = 0; i < 100; ++i) {
+    WINSTLOGRATELIMIT(atfw::util::log::log_level::kError, *logger, 1, 2, "rate limited %d", i);
+  }
+  CASE_EXPECT_EQ(2, static_cast<int>(records.size()));
+
+  // No more record passes the callsite, the summary is reported by update()
+  atfw::util::log::log_wrapper::update();
+  CASE_EXPECT_EQ(3, static_cast<int>(records.size()));
+  if (records.size() >= 3) {
+    CASE_EXPECT_EQ("suppressed 98 messages", records[2]);
+  }
+  atfw::util::log::log_wrapper::update();
+  CASE_EXPECT_EQ(3, static_cast<int>(records.size()));
+
+  records.clear();
+  for (int i = 0; i < 100; ++i) {
+    WINSTLOGSAMPLE(atfw::util::log::log_level::kError, *logger, 10, "sampled %d", i);
+  }
+  // 10 sampled records and one summary, the next summary is reported at least 1 second later
+  CASE_EXPECT_EQ(11, static_cast<int>(records.size()));
+  if (records.size() >= 3) {
+    CASE_EXPECT_EQ("sampled 0", records[0]);
+    CASE_EXPECT_EQ("suppressed 9 messages", records[1]);
+    CASE_EXPECT_EQ("sampled 10", records[2]);
+  }
+
+  // Filtered by level before the limiter
+  records.clear();
+  logger->set_level(atfw::util::log::log_level::kError);
+  for (int i = 0; i < 10; ++i) {
+    WINSTLOGSAMPLE(atfw::util::log::log_level::kDebug, *logger, 1, "filtered %d", i);
+  }
+  CASE_EXPECT_TRUE(records.empty());
+
+#if defined(ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI) && ATFRAMEWORK_UTILS_STRING_ENABLE_FWAPI
+  for (int i = 0; i < 10; ++i) {
+    FWINSTLOGSAMPLE(atfw::util::log::log_level::kError, *logger, 5, "fw sampled {}", i);
+  }
+  CASE_EXPECT_EQ(3, static_cast<int>(records.size()));
+  if (records.size() >= 3) {
+    CASE_EXPECT_EQ("fw sampled 0", records[0]);
+    // Suppressed records before the second sample
+    CASE_EXPECT_EQ("suppressed 4 messages", records[1]);
+    CASE_EXPECT_EQ("fw sampled 5", records[2]);
+  }
+#endif
+}
+
+CASE_TEST(log_rate_limiter, multi_thread) {
+  atfw::util::log::log_rate_limiter limiter(1, 50, std::chrono::seconds{3600});
+
+  std::atomic<int> passed{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&limiter, &passed]() {
+      uint64_t suppressed = 0;
+      for (int j = 0; j < 1000; ++j) {
+        if (limiter.check(suppressed)) {
+          ++passed;
+        }
+      }
+    });
+  }
+  for (auto &thd : threads) {
+    thd.join();
+  }
+
+  CASE_EXPECT_EQ(50, passed.load());
+  CASE_EXPECT_EQ(4000 - 50, static_cast<int>(limiter.get_suppressed()));
+}
+
+CASE_TEST(log_rate_limiter, thread_state) {
+  atfw::util::log::log_rate_limiter limiter(1, 50, std::chrono::milliseconds{0});
+
+  std::atomic<int> passed{0};
+  std::atomic<int> reported{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&limiter, &passed, &reported]() {
+      atfw::util::log::log_rate_limiter::thread_state_t thread_state;
+      uint64_t suppressed = 0;
+      for (int j = 0; j < 1000; ++j) {
+        if (limiter.check(suppressed, thread_state)) {
+          ++passed;
+          reported += static_cast<int>(suppressed);
+        }
+      }
+    });
+  }
+  for (auto &thd : threads) {
+    thd.join();
+  }
+
+  // Counts of destroyed thread states are moved into the counter
+  CASE_EXPECT_EQ(50, passed.load());
+  CASE_EXPECT_EQ(4000 - 50, reported.load() + static_cast<int>(limiter.get_suppressed()));
+
+  // Counts of live thread states are folded by the summary
+  atfw::util::log::log_rate_limiter::thread_state_t thread_state;
+  uint64_t suppressed = 0;
+  CASE_EXPECT_FALSE(limiter.check(suppressed, thread_state));
+  CASE_EXPECT_EQ(4000 - 50 + 1, reported.load() + static_cast<int>(limiter.get_suppressed()));
+  uint64_t pending = limiter.get_suppressed();
+  CASE_EXPECT_EQ(pending,
+                 limiter.get_suppressed_counter().take(atfw::util::log::log_callsite_suppressed_counter::now_ns()));
+  CASE_EXPECT_EQ(0, limiter.get_suppressed());
+}
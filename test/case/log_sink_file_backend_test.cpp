@@ -1,8 +1,10 @@
 // Copyright 2026 atframework
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "common/file_system.h"
 #include "log/log_sink_file_backend.h"
@@ -225,3 +227,256 @@ CASE_TEST(log_sink_file_backend, auto_flush_on_high_level) {
   atfw::util::file_system::remove(pattern.c_str());
   atfw::util::file_system::remove(log_dir.c_str());
 }
+
+CASE_TEST(log_sink_file_backend, buffered_write) {
+  atfw::util::time::time_utility::update();
+
+  std::string log_dir = "test_log_buffered";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+
+  std::string pattern = log_dir + "/buffered.log";
+  atfw::util::file_system::remove(pattern.c_str());
+  size_t expect_size = 0;
+  {
+    atfw::util::log::log_sink_file_backend backend;
+    backend.set_file_pattern(pattern);
+    backend.set_write_buffer_size(4096).set_write_buffer_timeout(std::chrono::milliseconds{0});
+    backend.set_auto_flush(atfw::util::log::log_level::kWarning);
+    CASE_EXPECT_EQ(4096, static_cast<int>(backend.get_write_buffer_size()));
+    CASE_EXPECT_EQ(0, static_cast<int>(backend.get_write_buffer_timeout().count()));
+
+    atfw::util::log::log_formatter::caller_info_t caller;
+    caller.level_id = atfw::util::log::log_level::kInfo;
+    caller.level_name = "Info";
+    caller.file_path = __FILE__;
+    caller.line_number = __LINE__;
+    caller.func_name = __FUNCTION__;
+    caller.rotate_index = 0;
+
+    for (int i = 0; i < 10; ++i) {
+      std::string content = "buffered log entry " + std::to_string(i);
+      backend(caller, content);
+      expect_size += content.size() + 1;
+    }
+
+    // Records below auto_flush level are kept in buffer
+    size_t file_size = 0;
+    CASE_EXPECT_TRUE(atfw::util::file_system::file_size(pattern.c_str(), file_size));
+    CASE_EXPECT_EQ(0, static_cast<int>(file_size));
+
+    // auto_flush level writes the whole buffer
+    caller.level_id = atfw::util::log::log_level::kError;
+    std::string content = "buffered error entry";
+    backend(caller, content);
+    expect_size += content.size() + 1;
+    CASE_EXPECT_TRUE(atfw::util::file_system::file_size(pattern.c_str(), file_size));
+    CASE_EXPECT_EQ(expect_size, file_size);
+
+    caller.level_id = atfw::util::log::log_level::kInfo;
+    content = "buffered tail entry";
+    backend(caller, content);
+    expect_size += content.size() + 1;
+  }
+
+  // Destructor writes the rest
+  std::string file_content;
+  CASE_EXPECT_TRUE(atfw::util::file_system::get_file_content(file_content, pattern.c_str(), true));
+  CASE_EXPECT_EQ(expect_size, file_content.size());
+  CASE_EXPECT_EQ(0, file_content.find("buffered log entry 0\nbuffered log entry 1\n"));
+  CASE_EXPECT_NE(std::string::npos, file_content.find("buffered error entry\nbuffered tail entry\n"));
+
+  // Cleanup
+  atfw::util::file_system::remove(pattern.c_str());
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+CASE_TEST(log_sink_file_backend, buffered_write_rotation) {
+  atfw::util::time::time_utility::update();
+
+  std::string log_dir = "test_log_buffered_rotation";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+
+  std::string pattern = log_dir + "/rotation.%N.log";
+  for (int i = 0; i < 3; ++i) {
+    std::string path = log_dir + "/rotation." + std::to_string(i) + ".log";
+    atfw::util::file_system::remove(path.c_str());
+  }
+
+  {
+    atfw::util::log::log_sink_file_backend backend;
+    backend.set_file_pattern(pattern);
+    backend.set_rotate_size(3).set_max_file_size(256).set_write_buffer_size(100);
+
+    atfw::util::log::log_formatter::caller_info_t caller;
+    caller.level_id = atfw::util::log::log_level::kInfo;
+    caller.level_name = "Info";
+    caller.file_path = __FILE__;
+    caller.line_number = __LINE__;
+    caller.func_name = __FUNCTION__;
+    caller.rotate_index = 0;
+
+    // 32 bytes per record, 8 records per file
+    std::string content(31, 'x');
+    for (int i = 0; i < 20; ++i) {
+      backend(caller, content);
+    }
+    backend.flush();
+
+    size_t file_size = 0;
+    CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.0.log").c_str(), file_size));
+    CASE_EXPECT_EQ(256, static_cast<int>(file_size));
+    CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.1.log").c_str(), file_size));
+    CASE_EXPECT_EQ(256, static_cast<int>(file_size));
+    CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.2.log").c_str(), file_size));
+    CASE_EXPECT_EQ(128, static_cast<int>(file_size));
+  }
+
+  // Cleanup
+  for (int i = 0; i < 3; ++i) {
+    std::string path = log_dir + "/rotation." + std::to_string(i) + ".log";
+    atfw::util::file_system::remove(path.c_str());
+  }
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+#if defined(ATFW_UTIL_MACRO_COMPRESSION_ENABLED)
+CASE_TEST(log_sink_file_backend, compressed_rotation) {
+  atfw::util::time::time_utility::update();
+
+  std::vector<atfw::util::compression::algorithm_t> algorithms = atfw::util::compression::get_supported_algorithms();
+  if (algorithms.empty()) {
+    return;
+  }
+  // LZ4 segments have a size header, use the others first
+  atfw::util::compression::algorithm_t algorithm = algorithms.front();
+  if (atfw::util::compression::algorithm_t::kLz4 == algorithm && algorithms.size() > 1) {
+    algorithm = algorithms[1];
+  }
+  std::string suffix = atfw::util::log::log_sink_file_backend::get_compression_suffix(algorithm);
+
+  std::string log_dir = "test_log_compressed_rotation";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+
+  std::string pattern = log_dir + "/rotation.%N.log";
+  for (int i = 0; i < 4; ++i) {
+    std::string path = log_dir + "/rotation." + std::to_string(i) + ".log";
+    atfw::util::file_system::remove(path.c_str());
+    atfw::util::file_system::remove((path + suffix).c_str());
+  }
+
+  atfw::util::log::log_formatter::caller_info_t caller;
+  caller.level_id = atfw::util::log::log_level::kInfo;
+  caller.level_name = "Info";
+  caller.file_path = __FILE__;
+  caller.line_number = __LINE__;
+  caller.func_name = __FUNCTION__;
+  caller.rotate_index = 0;
+
+  // 32 bytes per record, 8 records per file
+  std::string content(31, 'x');
+  {
+    atfw::util::log::log_sink_file_backend backend;
+    backend.set_file_pattern(pattern);
+    backend.set_rotate_size(4).set_max_file_size(256).set_rotate_compression(algorithm);
+    CASE_EXPECT_EQ(algorithm, backend.get_rotate_compression());
+
+    for (int i = 0; i < 20; ++i) {
+      backend(caller, content);
+    }
+    CASE_EXPECT_TRUE(backend.wait_rotate_compression(std::chrono::seconds{10}));
+  }
+
+  // Finished segments are replaced by compressed files
+  for (int i = 0; i < 2; ++i) {
+    std::string path = log_dir + "/rotation." + std::to_string(i) + ".log";
+    CASE_EXPECT_FALSE(atfw::util::file_system::is_exist(path.c_str()));
+
+    std::string compressed;
+    CASE_EXPECT_TRUE(atfw::util::file_system::get_file_content(compressed, (path + suffix).c_str(), true));
+
+    std::vector<unsigned char> decompressed;
+    CASE_EXPECT_EQ(atfw::util::compression::error_code_t::kOk,
+                   atfw::util::compression::decompress(
+                       algorithm,
+                       gsl::span<const unsigned char>{reinterpret_cast<const unsigned char *>(compressed.data()),
+                                                      compressed.size()},
+                       256, decompressed));
+    CASE_EXPECT_EQ(256, static_cast<int>(decompressed.size()));
+  }
+
+  size_t file_size = 0;
+  CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.2.log").c_str(), file_size));
+  CASE_EXPECT_EQ(128, static_cast<int>(file_size));
+
+  // Compressed segments are skipped when picking the rotation index
+  {
+    atfw::util::log::log_sink_file_backend backend;
+    backend.set_file_pattern(pattern);
+    backend.set_rotate_size(4).set_max_file_size(256).set_rotate_compression(algorithm);
+    backend(caller, content);
+  }
+  CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.2.log").c_str(), file_size));
+  CASE_EXPECT_EQ(160, static_cast<int>(file_size));
+  CASE_EXPECT_FALSE(atfw::util::file_system::is_exist((log_dir + "/rotation.0.log").c_str()));
+
+  // Cleanup
+  for (int i = 0; i < 4; ++i) {
+    std::string path = log_dir + "/rotation." + std::to_string(i) + ".log";
+    atfw::util::file_system::remove(path.c_str());
+    atfw::util::file_system::remove((path + suffix).c_str());
+  }
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+CASE_TEST(log_sink_file_backend, compressed_rotation_same_path) {
+  atfw::util::time::time_utility::update();
+
+  std::vector<atfw::util::compression::algorithm_t> algorithms = atfw::util::compression::get_supported_algorithms();
+  if (algorithms.empty()) {
+    return;
+  }
+  atfw::util::compression::algorithm_t algorithm = algorithms.front();
+
+  std::string log_dir = "test_log_compressed_rotation_same_path";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+
+  atfw::util::log::log_formatter::caller_info_t caller;
+  caller.level_id = atfw::util::log::log_level::kInfo;
+  caller.level_name = "Info";
+  caller.file_path = __FILE__;
+  caller.line_number = __LINE__;
+  caller.func_name = __FUNCTION__;
+  caller.rotate_index = 0;
+
+  // 32 bytes per record, 8 records per file
+  std::string content(31, 'x');
+
+  // No %N in pattern and rotation size 1 with %N, the next file is always the one just finished
+  std::string paths[] = {log_dir + "/no_index.log", log_dir + "/single.%N.log"};
+  std::string real_paths[] = {log_dir + "/no_index.log", log_dir + "/single.0.log"};
+  for (int i = 0; i < 2; ++i) {
+    atfw::util::file_system::remove(real_paths[i].c_str());
+    {
+      atfw::util::log::log_sink_file_backend backend;
+      backend.set_file_pattern(paths[i]);
+      backend.set_rotate_size(0 == i ? 4 : 1).set_max_file_size(256).set_rotate_compression(algorithm);
+
+      for (int j = 0; j < 20; ++j) {
+        backend(caller, content);
+        // Give the background worker a chance to pick the finished file
+        CASE_EXPECT_TRUE(backend.wait_rotate_compression(std::chrono::seconds{10}));
+      }
+    }
+
+    // The active file is neither compressed nor removed
+    size_t file_size = 0;
+    CASE_EXPECT_TRUE(atfw::util::file_system::file_size(real_paths[i].c_str(), file_size));
+    CASE_EXPECT_EQ(128, static_cast<int>(file_size));
+    CASE_EXPECT_FALSE(atfw::util::file_system::is_exist(
+        (real_paths[i] + atfw::util::log::log_sink_file_backend::get_compression_suffix(algorithm)).c_str()));
+
+    atfw::util::file_system::remove(real_paths[i].c_str());
+  }
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+#endif
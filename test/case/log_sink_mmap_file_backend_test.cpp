@@ -0,0 +1,286 @@
+// Copyright 2026 atframework
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/file_system.h"
+#include "log/log_sink_mmap_file_backend.h"
+#include "time/time_utility.h"
+
+#include "frame/test_macros.h"
+
+#if defined(ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT) && ATFRAMEWORK_UTILS_LOG_SINK_ENABLE_MMAP_SUPPORT
+
+CASE_TEST(log_sink_mmap_file_backend, chain_setters) {
+  atfw::util::log::log_sink_mmap_file_backend backend;
+
+  backend.set_check_interval(120)
+      .set_flush_interval(60)
+      .set_auto_flush(atfw::util::log::log_level::kWarning)
+      .set_max_file_size(1048576)
+      .set_rotate_size(5);
+
+  CASE_EXPECT_EQ(120, backend.get_check_interval());
+  CASE_EXPECT_EQ(60, backend.get_flush_interval());
+  CASE_EXPECT_EQ(atfw::util::log::log_level::kWarning, backend.get_auto_flush());
+  CASE_EXPECT_EQ(1048576, static_cast<int>(backend.get_max_file_size()));
+  CASE_EXPECT_EQ(5, static_cast<int>(backend.get_rotate_size()));
+
+  // The whole file is mapped, it can not be unlimited
+  backend.set_max_file_size(0);
+  CASE_EXPECT_GT(backend.get_max_file_size(), 0);
+}
+
+CASE_TEST(log_sink_mmap_file_backend, truncate_on_close) {
+  atfw::util::time::time_utility::update();
+
+  std::string log_dir = "test_log_mmap";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+  std::string pattern = log_dir + "/mmap_test.log";
+  atfw::util::file_system::remove(pattern.c_str());
+
+  atfw::util::log::log_formatter::caller_info_t caller;
+  caller.level_id = atfw::util::log::log_level::kInfo;
+  caller.level_name = "Info";
+  caller.file_path = __FILE__;
+  caller.line_number = __LINE__;
+  caller.func_name = __FUNCTION__;
+  caller.rotate_index = 0;
+
+  std::string expect_content;
+  {
+    atfw::util::log::log_sink_mmap_file_backend backend(pattern);
+    backend.set_max_file_size(64 * 1024);
+
+    for (int i = 0; i < 10; ++i) {
+      std::string content = "mmap log entry " + std::to_string(i);
+      backend(caller, content);
+      expect_content += content + "\n";
+    }
+    CASE_EXPECT_EQ(pattern, backend.get_current_file_path());
+
+    // Preallocated while writing
+    size_t file_size = 0;
+    CASE_EXPECT_TRUE(atfw::util::file_system::file_size(pattern.c_str(), file_size));
+    CASE_EXPECT_EQ(64 * 1024, static_cast<int>(file_size));
+    backend.flush();
+  }
+
+  std::string file_content;
+  CASE_EXPECT_TRUE(atfw::util::file_system::get_file_content(file_content, pattern.c_str(), true));
+  CASE_EXPECT_EQ(expect_content, file_content);
+
+  // Append to the existing file
+  {
+    atfw::util::log::log_sink_mmap_file_backend backend(pattern);
+    backend.set_max_file_size(64 * 1024);
+    std::string content = "mmap log append";
+    backend(caller, content);
+    expect_content += content + "\n";
+  }
+  CASE_EXPECT_TRUE(atfw::util::file_system::get_file_content(file_content, pattern.c_str(), true));
+  CASE_EXPECT_EQ(expect_content, file_content);
+
+  atfw::util::file_system::remove(pattern.c_str());
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+CASE_TEST(log_sink_mmap_file_backend, rotation) {
+  atfw::util::time::time_utility::update();
+
+  std::string log_dir = "test_log_mmap_rotation";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+  std::string pattern = log_dir + "/rotation.%N.log";
+  for (int i = 0; i < 3; ++i) {
+    std::string path = log_dir + "/rotation." + std::to_string(i) + ".log";
+    atfw::util::file_system::remove(path.c_str());
+  }
+
+  {
+    atfw::util::log::log_sink_mmap_file_backend backend;
+    backend.set_rotate_size(3).set_max_file_size(256);
+    backend.set_file_pattern(pattern);
+
+    atfw::util::log::log_formatter::caller_info_t caller;
+    caller.level_id = atfw::util::log::log_level::kInfo;
+    caller.level_name = "Info";
+    caller.file_path = __FILE__;
+    caller.line_number = __LINE__;
+    caller.func_name = __FUNCTION__;
+    caller.rotate_index = 0;
+
+    // 30 bytes per record, 8 records per file
+    std::string content(29, 'x');
+    for (int i = 0; i < 20; ++i) {
+      backend(caller, content);
+    }
+  }
+
+  size_t file_size = 0;
+  CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.0.log").c_str(), file_size));
+  CASE_EXPECT_EQ(240, static_cast<int>(file_size));
+  CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.1.log").c_str(), file_size));
+  CASE_EXPECT_EQ(240, static_cast<int>(file_size));
+  CASE_EXPECT_TRUE(atfw::util::file_system::file_size((log_dir + "/rotation.2.log").c_str(), file_size));
+  CASE_EXPECT_EQ(120, static_cast<int>(file_size));
+
+  for (int i = 0; i < 3; ++i) {
+    std::string path = log_dir + "/rotation." + std::to_string(i) + ".log";
+    atfw::util::file_system::remove(path.c_str());
+  }
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+CASE_TEST(log_sink_mmap_file_backend, multi_thread_append) {
+  atfw::util::time::time_utility::update();
+
+  std::string log_dir = "test_log_mmap_mt";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+  std::string pattern = log_dir + "/mt.%N.log";
+  for (int i = 0; i < 16; ++i) {
+    std::string path = log_dir + "/mt." + std::to_string(i) + ".log";
+    atfw::util::file_system::remove(path.c_str());
+  }
+
+  {
+    atfw::util::log::log_sink_mmap_file_backend backend;
+    backend.set_rotate_size(16).set_max_file_size(16 * 1024);
+    backend.set_file_pattern(pattern);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&backend, i]() {
+        atfw::util::log::log_formatter::caller_info_t caller;
+        caller.level_id = atfw::util::log::log_level::kInfo;
+        std::string content(63, static_cast<char>('a' + i));
+        for (int j = 0; j < 500; ++j) {
+          backend(caller, content);
+        }
+      });
+    }
+    for (auto &thd : threads) {
+      thd.join();
+    }
+  }
+
+  // Every record must be complete
+  size_t total_size = 0;
+  for (int i = 0; i < 16; ++i) {
+    std::string path = log_dir + "/mt." + std::to_string(i) + ".log";
+    std::string file_content;
+    if (!atfw::util::file_system::get_file_content(file_content, path.c_str(), true)) {
+      continue;
+    }
+
+    CASE_EXPECT_EQ(0, file_content.size() % 64);
+    for (size_t off = 0; off + 64 <= file_content.size(); off += 64) {
+      CASE_EXPECT_EQ('\n', file_content[off + 63]);
+      CASE_EXPECT_EQ(std::string::npos, file_content.substr(off, 63).find_first_not_of(file_content[off]));
+    }
+    total_size += file_content.size();
+    atfw::util::file_system::remove(path.c_str());
+  }
+  CASE_EXPECT_EQ(4 * 500 * 64, static_cast<int>(total_size));
+
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+CASE_TEST(log_sink_mmap_file_backend, rotation_same_path) {
+  atfw::util::time::time_utility::update();
+
+  std::string log_dir = "test_log_mmap_same_path";
+  atfw::util::file_system::mkdir(log_dir.c_str(), true);
+  std::string pattern = log_dir + "/same_path.log";
+  atfw::util::file_system::remove(pattern.c_str());
+
+  {
+    // No %N in pattern, every rotation reopens the same path while other threads are still writing the old one
+    atfw::util::log::log_sink_mmap_file_backend backend;
+    backend.set_rotate_size(4).set_max_file_size(4096);
+    backend.set_file_pattern(pattern);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&backend, i]() {
+        atfw::util::log::log_formatter::caller_info_t caller;
+        caller.level_id = atfw::util::log::log_level::kInfo;
+        std::string content(63, static_cast<char>('a' + i));
+        for (int j = 0; j < 2000; ++j) {
+          backend(caller, content);
+        }
+      });
+    }
+    for (auto &thd : threads) {
+      thd.join();
+    }
+  }
+
+  // The file of the last rotation is not truncated by segments closed later
+  std::string file_content;
+  CASE_EXPECT_TRUE(atfw::util::file_system::get_file_content(file_content, pattern.c_str(), true));
+  CASE_EXPECT_LT(0, static_cast<int>(file_content.size()));
+  CASE_EXPECT_LE(file_content.size(), 4096);
+  CASE_EXPECT_EQ(0, file_content.size() % 64);
+  for (size_t off = 0; off + 64 <= file_content.size(); off += 64) {
+    CASE_EXPECT_EQ('\n', file_content[off + 63]);
+    CASE_EXPECT_EQ(std::string::npos, file_content.substr(off, 63).find_first_not_of(file_content[off]));
+  }
+
+  atfw::util::file_system::remove(pattern.c_str());
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+CASE_TEST(log_sink_mmap_file_backend, retry_after_open_failed) {
+  atfw::util::time::time_utility::update();
+
+  // The directory is a regular file, so the log file can not be opened
+  std::string log_dir = "test_log_mmap_retry";
+  std::string pattern = log_dir + "/retry.log";
+  atfw::util::file_system::remove(pattern.c_str());
+  atfw::util::file_system::remove(log_dir.c_str());
+  {
+    std::FILE *f = nullptr;
+    UTIL_FS_OPEN(open_res, f, log_dir.c_str(), "wb");
+    CASE_EXPECT_TRUE(nullptr != f);
+    if (nullptr != f) {
+      std::fclose(f);
+    }
+  }
+
+  atfw::util::log::log_formatter::caller_info_t caller;
+  caller.level_id = atfw::util::log::log_level::kInfo;
+
+  {
+    atfw::util::log::log_sink_mmap_file_backend backend;
+    backend.set_rotate_size(1).set_max_file_size(4096);
+    backend.set_file_pattern(pattern);
+
+    backend(caller, "dropped");
+    CASE_EXPECT_TRUE(backend.get_current_file_path().empty());
+
+    // The sink opens the file again after the error is fixed
+    atfw::util::file_system::remove(log_dir.c_str());
+    atfw::util::file_system::mkdir(log_dir.c_str(), true);
+    time_t failed_time = atfw::util::time::time_utility::get_sys_now();
+    while (atfw::util::time::time_utility::get_sys_now() == failed_time) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      atfw::util::time::time_utility::update();
+    }
+
+    backend(caller, "recovered");
+    CASE_EXPECT_EQ(pattern, backend.get_current_file_path());
+  }
+
+  std::string file_content;
+  CASE_EXPECT_TRUE(atfw::util::file_system::get_file_content(file_content, pattern.c_str(), true));
+  CASE_EXPECT_EQ(std::string("recovered\n"), file_content);
+
+  atfw::util::file_system::remove(pattern.c_str());
+  atfw::util::file_system::remove(log_dir.c_str());
+}
+
+#endif
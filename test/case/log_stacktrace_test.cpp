@@ -223,3 +223,51 @@ CASE_TEST(log_stacktrace, handle_assignment) {
   CASE_MSG_INFO() << "Skipped: non-trivial handle mode" << std::endl;
 #endif
 }
+
+CASE_TEST(log_stacktrace, raw_addresses) {
+  uintptr_t addresses[32];
+  size_t frames = atfw::util::log::stacktrace_get_addresses(addresses, 32);
+  if (!atfw::util::log::is_stacktrace_enabled()) {
+    CASE_EXPECT_EQ(0, static_cast<int>(frames));
+    return;
+  }
+  CASE_EXPECT_GT(frames, 0);
+
+  atfw::util::log::stacktrace_options opts;
+  opts.skip_start_frames = 0;
+  opts.skip_end_frames = 0;
+  opts.max_frames = 2;
+  CASE_EXPECT_LE(atfw::util::log::stacktrace_get_addresses(addresses, 32, &opts), 2);
+  CASE_EXPECT_LE(atfw::util::log::stacktrace_get_addresses(addresses, 1), 1);
+
+  // Raw output contains only addresses
+  char buf[4096] = {0};
+  size_t written = atfw::util::log::stacktrace_write_raw(buf, sizeof(buf) - 1,
+                                                         gsl::span<const uintptr_t>{addresses, frames});
+  CASE_EXPECT_GT(written, 0);
+  CASE_EXPECT_EQ(0, std::string(buf, written).find("Frame #"));
+  CASE_EXPECT_NE(std::string::npos, std::string(buf, written).find("[0x"));
+
+  // Symbolize later
+  written = atfw::util::log::stacktrace_write_addresses(buf, sizeof(buf) - 1,
+                                                        gsl::span<const uintptr_t>{addresses, frames});
+  CASE_EXPECT_GT(written, 0);
+  CASE_MSG_INFO() << "symbolized stacktrace:\n" << std::string(buf, written) << std::endl;
+
+  // Truncated
+  char small_buf[8];
+  CASE_EXPECT_LE(atfw::util::log::stacktrace_write_raw(small_buf, sizeof(small_buf),
+                                                       gsl::span<const uintptr_t>{addresses, frames}),
+                 sizeof(small_buf));
+}
+
+CASE_TEST(log_stacktrace, module_map) {
+  std::vector<char> buf;
+  buf.resize(65536);
+  size_t written = atfw::util::log::stacktrace_write_module_map(buf.data(), buf.size());
+#if defined(__linux__)
+  CASE_EXPECT_GT(written, 0);
+  CASE_EXPECT_EQ(0, std::string(buf.data(), written).find("0x"));
+#endif
+  CASE_EXPECT_LE(written, buf.size());
+}
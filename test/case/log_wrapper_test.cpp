@@ -0,0 +1,276 @@
+// Copyright 2026 atframework
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame/test_macros.h"
+#include "log/log_stacktrace.h"
+#include "log/log_wrapper.h"
+
+CASE_TEST(log_wrapper, sink_management) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+  logger->set_prefix_format("");
+
+  std::vector<int> called;
+  for (int i = 0; i < 3; ++i) {
+    logger->add_sink([&called, i](const atfw::util::log::log_wrapper::caller_info_t &,
+                                  atfw::util::nostd::string_view) { called.push_back(i); });
+  }
+  CASE_EXPECT_EQ(3, static_cast<int>(logger->sink_size()));
+
+  WINSTLOGINFO(*logger, "all sinks");
+  CASE_EXPECT_EQ(3, static_cast<int>(called.size()));
+
+  // Sink 1 only accept errors now
+  called.clear();
+  CASE_EXPECT_TRUE(
+      logger->set_sink(1, atfw::util::log::log_level::kError, atfw::util::log::log_level::kFatal));
+  CASE_EXPECT_FALSE(logger->set_sink(3));
+  WINSTLOGINFO(*logger, "info");
+  CASE_EXPECT_EQ(2, static_cast<int>(called.size()));
+  if (called.size() == 2) {
+    CASE_EXPECT_EQ(0, called[0]);
+    CASE_EXPECT_EQ(2, called[1]);
+  }
+
+  // pop_sink removes the first one
+  called.clear();
+  logger->pop_sink();
+  CASE_EXPECT_EQ(2, static_cast<int>(logger->sink_size()));
+  WINSTLOGERROR(*logger, "error");
+  CASE_EXPECT_EQ(2, static_cast<int>(called.size()));
+  if (called.size() == 2) {
+    CASE_EXPECT_EQ(1, called[0]);
+    CASE_EXPECT_EQ(2, called[1]);
+  }
+
+  called.clear();
+  logger->clear_sinks();
+  CASE_EXPECT_EQ(0, static_cast<int>(logger->sink_size()));
+  WINSTLOGERROR(*logger, "error");
+  CASE_EXPECT_TRUE(called.empty());
+  logger->pop_sink();
+}
+
+CASE_TEST(log_wrapper, modify_sinks_in_sink) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+
+  int counter = 0;
+  atfw::util::log::log_wrapper *raw_logger = logger.get();
+  logger->add_sink([raw_logger, &counter](const atfw::util::log::log_wrapper::caller_info_t &,
+                                          atfw::util::nostd::string_view) {
+    ++counter;
+    // The snapshot being iterated must be kept alive
+    raw_logger->clear_sinks();
+  });
+
+  WINSTLOGINFO(*logger, "first");
+  WINSTLOGINFO(*logger, "second");
+  CASE_EXPECT_EQ(1, counter);
+  CASE_EXPECT_EQ(0, static_cast<int>(logger->sink_size()));
+}
+
+CASE_TEST(log_wrapper, modify_sinks_concurrently) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+
+  std::atomic<bool> running{true};
+  std::atomic<int> counter{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&logger, &running]() {
+      while (running.load()) {
+        WINSTLOGDEBUG(*logger, "concurrent record");
+      }
+    });
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    logger->add_sink([&counter](const atfw::util::log::log_wrapper::caller_info_t &,
+                                atfw::util::nostd::string_view content) {
+      if (!content.empty()) {
+        ++counter;
+      }
+    });
+    if (i % 3 == 0) {
+      logger->pop_sink();
+    }
+    if (i % 100 == 99) {
+      logger->clear_sinks();
+    }
+  }
+
+  running.store(false);
+  for (auto &thd : threads) {
+    thd.join();
+  }
+
+  CASE_EXPECT_EQ(0, static_cast<int>(logger->sink_size()));
+  CASE_EXPECT_GE(counter.load(), 0);
+}
+
+CASE_TEST(log_wrapper, reclaim_retired_sinks) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+
+  // 0: not entered, 1: the reader is blocked in the sink, 2: release the reader
+  std::atomic<int> reader_state{0};
+  std::shared_ptr<int> blocking_token = std::make_shared<int>(1);
+  std::weak_ptr<int> blocking_token_ref = blocking_token;
+  logger->add_sink([&reader_state, blocking_token](const atfw::util::log::log_wrapper::caller_info_t &,
+                                                   atfw::util::nostd::string_view) {
+    int expected = 0;
+    if (!reader_state.compare_exchange_strong(expected, 1)) {
+      return;
+    }
+    while (2 != reader_state.load()) {
+      std::this_thread::yield();
+    }
+    CASE_EXPECT_EQ(1, *blocking_token);
+  });
+  blocking_token.reset();
+
+  std::thread reader([&logger]() { WINSTLOGINFO(*logger, "blocked record"); });
+  while (1 != reader_state.load()) {
+    std::this_thread::yield();
+  }
+
+  // Snapshots retired while the reader is blocked are kept
+  std::vector<std::weak_ptr<int>> tokens;
+  for (int i = 0; i < 16; ++i) {
+    std::shared_ptr<int> token = std::make_shared<int>(i);
+    tokens.push_back(token);
+    logger->add_sink([token](const atfw::util::log::log_wrapper::caller_info_t &, atfw::util::nostd::string_view) {});
+    logger->pop_sink();
+  }
+  WINSTLOGINFO(*logger, "record of this thread");
+  CASE_EXPECT_FALSE(blocking_token_ref.expired());
+
+  reader_state.store(2);
+  reader.join();
+
+  // All retired snapshots are released by the next modification after the reader left
+  logger->clear_sinks();
+  CASE_EXPECT_TRUE(blocking_token_ref.expired());
+  for (auto &token : tokens) {
+    CASE_EXPECT_TRUE(token.expired());
+  }
+}
+
+CASE_TEST(log_wrapper, reclaim_retired_sinks_with_active_reader) {
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+
+  std::atomic<int> records{0};
+  auto record_sink = [&records](const atfw::util::log::log_wrapper::caller_info_t &, atfw::util::nostd::string_view) {
+    ++records;
+    // Keep the reader in the snapshot for most of the time
+    std::this_thread::sleep_for(std::chrono::microseconds{100});
+  };
+  logger->add_sink(record_sink);
+
+  // The reader thread is almost always iterating a snapshot
+  std::atomic<bool> running{true};
+  std::thread reader([&logger, &running]() {
+    while (running.load()) {
+      WINSTLOGINFO(*logger, "concurrent record");
+    }
+  });
+
+  std::vector<std::weak_ptr<int>> tokens;
+  for (int i = 0; i < 64; ++i) {
+    std::shared_ptr<int> token = std::make_shared<int>(i);
+    tokens.push_back(token);
+
+    // The sink of token is only kept by retired snapshots
+    logger->clear_sinks();
+    logger->add_sink([token](const atfw::util::log::log_wrapper::caller_info_t &, atfw::util::nostd::string_view) {});
+    logger->add_sink(record_sink);
+    logger->pop_sink();
+    token.reset();
+
+    // Wait for a record which is started after the last modification
+    int start_records = records.load();
+    while (records.load() < start_records + 2) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Snapshots retired before the current record of the reader are released by the next modification
+  logger->set_sink(0, atfw::util::log::log_level::kDebug, atfw::util::log::log_level::kFatal);
+  int alive_tokens = 0;
+  for (auto &token : tokens) {
+    if (!token.expired()) {
+      ++alive_tokens;
+    }
+  }
+  CASE_EXPECT_EQ(0, alive_tokens);
+
+  running.store(false);
+  reader.join();
+}
+
+CASE_TEST(log_wrapper, stacktrace_raw_address) {
+  if (!atfw::util::log::is_stacktrace_enabled()) {
+    return;
+  }
+
+  auto logger = atfw::util::log::log_wrapper::create_user_logger();
+  logger->init(atfw::util::log::log_level::kDebug);
+  logger->set_prefix_format("");
+  logger->set_stacktrace_level(atfw::util::log::log_level::kError, atfw::util::log::log_level::kFatal);
+  logger->set_option(atfw::util::log::log_wrapper::options_t::OPT_STACKTRACE_RAW_ADDRESS, true);
+  CASE_EXPECT_TRUE(logger->get_option(atfw::util::log::log_wrapper::options_t::OPT_STACKTRACE_RAW_ADDRESS));
+
+  std::vector<std::string> records;
+  logger->add_sink([&records](const atfw::util::log::log_wrapper::caller_info_t &,
+                              atfw::util::nostd::string_view content) {
+    records.push_back(std::string(content.data(), content.size()));
+  });
+
+  // Only addresses in synchronous mode
+  WINSTLOGERROR(*logger, "raw stacktrace");
+  WINSTLOGINFO(*logger, "no stacktrace");
+  CASE_EXPECT_EQ(2, static_cast<int>(records.size()));
+  if (records.size() >= 2) {
+    CASE_EXPECT_EQ(0, records[0].find("raw stacktrace\r\nCall stacks:\r\nFrame #"));
+    CASE_EXPECT_NE(std::string::npos, records[0].find("[0x"));
+    CASE_EXPECT_EQ("no stacktrace", records[1]);
+  }
+
+  // The same frames are skipped as the symbolized stacktrace, frames without symbol may be omitted in the
+  // symbolized one, so compare the index of the outermost frame
+  records.clear();
+  for (int i = 0; i < 2; ++i) {
+    logger->set_option(atfw::util::log::log_wrapper::options_t::OPT_STACKTRACE_RAW_ADDRESS, 0 == i);
+    WINSTLOGERROR(*logger, "stacktrace");
+  }
+  logger->set_option(atfw::util::log::log_wrapper::options_t::OPT_STACKTRACE_RAW_ADDRESS, true);
+  CASE_EXPECT_EQ(2, static_cast<int>(records.size()));
+  if (records.size() >= 2) {
+    size_t raw_last_frame = records[0].rfind("Frame #");
+    size_t symbolized_last_frame = records[1].rfind("Frame #");
+    CASE_EXPECT_NE(std::string::npos, raw_last_frame);
+    CASE_EXPECT_NE(std::string::npos, symbolized_last_frame);
+    if (std::string::npos != raw_last_frame && std::string::npos != symbolized_last_frame) {
+      CASE_EXPECT_EQ(records[1].substr(symbolized_last_frame, 10), records[0].substr(raw_last_frame, 10));
+    }
+  }
+
+  // Symbolized by the consumer thread in asynchronous mode
+  records.clear();
+  CASE_EXPECT_TRUE(logger->enable_async());
+  WINSTLOGERROR(*logger, "async stacktrace");
+  logger->flush_async();
+  logger->disable_async();
+  CASE_EXPECT_EQ(1, static_cast<int>(records.size()));
+  if (!records.empty()) {
+    CASE_EXPECT_EQ(0, records[0].find("async stacktrace\r\nCall stacks:\r\nFrame #"));
+  }
+}
@@ -1,6 +1,10 @@
 // Copyright 2026 atframework
 
+#include <chrono>
 #include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "frame/test_macros.h"
 
@@ -159,3 +163,286 @@ CASE_TEST(lru_map_test, lru_reorder) {
   }
 }
 
+
+CASE_TEST(lru_map_test, max_size_and_stats) {
+  using lru_t = atfw::util::memory::lru_map<int, long>;
+  lru_t lru;
+  lru.set_max_size(4);
+  CASE_EXPECT_EQ(4, lru.get_max_size());
+
+  for (int i = 1; i <= 6; ++i) {
+    lru[i] = 100 + i;
+  }
+  CASE_EXPECT_EQ(4, lru.size());
+  CASE_EXPECT_EQ(3, lru.front().first);
+  CASE_EXPECT_EQ(6, lru.back().first);
+
+  // 3 becomes the most recently used one, so 4 is evicted
+  CASE_EXPECT_FALSE(lru.end() == lru.find(3));
+  CASE_EXPECT_TRUE(lru.end() == lru.find(1));
+  lru.insert_key_value(7, 107);
+  CASE_EXPECT_TRUE(lru.end() == lru.find(4, false));
+  CASE_EXPECT_FALSE(lru.end() == lru.find(3, false));
+
+  // operator[] missed 6 times, find() hit 2 times and missed 2 times
+  const atfw::util::memory::lru_map_stats &stats = lru.get_stats();
+  CASE_EXPECT_EQ(2, stats.hit_count);
+  CASE_EXPECT_EQ(8, stats.miss_count);
+  CASE_EXPECT_EQ(3, stats.eviction_count);
+
+  // Shrink
+  lru.set_max_size(2);
+  CASE_EXPECT_EQ(2, lru.size());
+  CASE_EXPECT_EQ(5, lru.get_stats().eviction_count);
+
+  lru.reset_stats();
+  CASE_EXPECT_EQ(0, lru.get_stats().hit_count);
+  CASE_EXPECT_EQ(0, lru.get_stats().eviction_count);
+}
+
+namespace {
+template <class TLRU>
+static int lru_map_test_hot_hits_after_scan(TLRU &lru) {
+  lru.set_max_size(100);
+  auto visit = [&lru](int key) {
+    if (lru.find(key) == lru.end()) {
+      lru.insert_key_value(key, static_cast<long>(key));
+    }
+  };
+
+  // 50 hot keys mixed with cold keys
+  int cold_key = 10000;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 50; ++i) {
+      visit(i);
+    }
+    for (int i = 0; i < 30; ++i) {
+      visit(cold_key++);
+    }
+  }
+
+  // A full scan of keys which are only visited once
+  for (int i = 0; i < 1000; ++i) {
+    visit(cold_key++);
+  }
+
+  int ret = 0;
+  for (int i = 0; i < 50; ++i) {
+    if (lru.find(i, false) != lru.end()) {
+      ++ret;
+    }
+  }
+
+  CASE_EXPECT_EQ(100, lru.size());
+  return ret;
+}
+
+template <class TLRU>
+static void lru_map_test_random_operations(TLRU &lru) {
+  lru.set_max_size(64);
+  uint32_t seed = 20261016;
+  for (int i = 0; i < 50000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int key = static_cast<int>((seed >> 8) % 256);
+    switch ((seed >> 4) % 8) {
+      case 0:
+        lru.erase(key);
+        break;
+      case 1:
+        lru.pop_front();
+        break;
+      case 2:
+        lru.set_max_size(32 + (seed >> 20) % 64);
+        break;
+      default:
+        if (lru.find(key) == lru.end()) {
+          lru.insert_key_value(key, static_cast<long>(key));
+        }
+        break;
+    }
+    CASE_EXPECT_LE(lru.size(), lru.get_max_size());
+  }
+
+  size_t count = 0;
+  for (auto iter = lru.begin(); iter != lru.end(); ++iter) {
+    CASE_EXPECT_TRUE(lru.find(iter->first, false) == iter);
+    ++count;
+  }
+  CASE_EXPECT_EQ(count, lru.size());
+
+  lru.clear();
+  lru.set_max_size(8);
+  for (int i = 0; i < 100; ++i) {
+    lru[i] = i;
+  }
+  CASE_EXPECT_EQ(8, lru.size());
+}
+}  // namespace
+
+CASE_TEST(lru_map_test, eviction_policy_scan_resistance) {
+  using compat_strong_ptr_mode = atfw::util::memory::compat_strong_ptr_mode;
+  atfw::util::memory::lru_map<int, long> lru;
+  atfw::util::memory::lru_map<
+      int, long, std::hash<int>, std::equal_to<int>,
+      atfw::util::memory::lru_map_option<compat_strong_ptr_mode::kStl, atfw::util::memory::lru_map_policy_2q>>
+      lru_2q;
+  atfw::util::memory::lru_map<
+      int, long, std::hash<int>, std::equal_to<int>,
+      atfw::util::memory::lru_map_option<compat_strong_ptr_mode::kStl, atfw::util::memory::lru_map_policy_arc>>
+      lru_arc;
+  atfw::util::memory::lru_map<
+      int, long, std::hash<int>, std::equal_to<int>,
+      atfw::util::memory::lru_map_option<compat_strong_ptr_mode::kStl, atfw::util::memory::lru_map_policy_w_tinylfu>>
+      lru_w_tinylfu;
+
+  int lru_hits = lru_map_test_hot_hits_after_scan(lru);
+  int lru_2q_hits = lru_map_test_hot_hits_after_scan(lru_2q);
+  int lru_arc_hits = lru_map_test_hot_hits_after_scan(lru_arc);
+  int lru_w_tinylfu_hits = lru_map_test_hot_hits_after_scan(lru_w_tinylfu);
+  CASE_MSG_INFO() << "Hot keys after scan, LRU: " << lru_hits << ", 2Q: " << lru_2q_hits << ", ARC: " << lru_arc_hits
+                  << ", W-TinyLFU: " << lru_w_tinylfu_hits << std::endl;
+
+  // The whole hot working set is evicted by the scan in LRU
+  CASE_EXPECT_EQ(0, lru_hits);
+  CASE_EXPECT_GE(lru_2q_hits, 45);
+  CASE_EXPECT_GE(lru_arc_hits, 45);
+  CASE_EXPECT_GE(lru_w_tinylfu_hits, 45);
+
+  lru_map_test_random_operations(lru);
+  lru_map_test_random_operations(lru_2q);
+  lru_map_test_random_operations(lru_arc);
+  lru_map_test_random_operations(lru_w_tinylfu);
+}
+
+CASE_TEST(lru_map_test, max_weight) {
+  using lru_t = atfw::util::memory::lru_map<int, std::string>;
+  lru_t lru;
+  lru.set_weigher([](const lru_t::value_type &value) { return value.second->size(); });
+  lru.set_max_weight(16);
+  lru.set_max_size(8);
+
+  lru.insert_key_value(1, std::string(4, 'a'));
+  lru.insert_key_value(2, std::string(4, 'b'));
+  lru.insert_key_value(3, std::string(4, 'c'));
+  CASE_EXPECT_EQ(12, lru.get_total_weight());
+
+  // 1 becomes the most recently used one, so 2 and 3 are evicted
+  CASE_EXPECT_FALSE(lru.end() == lru.find(1));
+  lru.insert_key_value(4, std::string(10, 'd'));
+  CASE_EXPECT_EQ(2, lru.size());
+  CASE_EXPECT_EQ(14, lru.get_total_weight());
+  CASE_EXPECT_TRUE(lru.end() == lru.find(2, false));
+  CASE_EXPECT_TRUE(lru.end() == lru.find(3, false));
+  CASE_EXPECT_EQ(2, lru.get_stats().eviction_count);
+
+  // Modify value and update its weight
+  *lru.find(1, false)->second = std::string(1, 'a');
+  CASE_EXPECT_TRUE(lru.update_weight(1));
+  CASE_EXPECT_EQ(11, lru.get_total_weight());
+
+  // A heavy element evicts all other elements
+  lru.insert_key_value(5, std::string(20, 'e'));
+  CASE_EXPECT_EQ(1, lru.size());
+  CASE_EXPECT_EQ(20, lru.get_total_weight());
+
+  lru.erase(5);
+  CASE_EXPECT_EQ(0, lru.get_total_weight());
+
+  // Both limits work together
+  for (int i = 0; i < 20; ++i) {
+    lru.insert_key_value(100 + i, std::string(1, 'f'));
+  }
+  CASE_EXPECT_EQ(8, lru.size());
+  CASE_EXPECT_EQ(8, lru.get_total_weight());
+
+  lru_t copied = lru;
+  CASE_EXPECT_EQ(16, copied.get_max_weight());
+  CASE_EXPECT_EQ(8, copied.get_total_weight());
+}
+
+CASE_TEST(lru_map_test, ttl) {
+  using lru_t = atfw::util::memory::lru_map<int, long>;
+  lru_t lru;
+  lru.set_default_ttl(std::chrono::milliseconds{30});
+  for (int i = 0; i < 8; ++i) {
+    lru.insert_key_value(i, 100 + i);
+  }
+  // Never expire
+  CASE_EXPECT_TRUE(lru.set_ttl(0, std::chrono::milliseconds{0}));
+  CASE_EXPECT_TRUE(lru.set_ttl(1, std::chrono::seconds{60}));
+  CASE_EXPECT_FALSE(lru.set_ttl(100, std::chrono::seconds{60}));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{60});
+  CASE_EXPECT_TRUE(lru.end() == lru.find(2));
+  CASE_EXPECT_EQ(2, lru.size());
+  CASE_EXPECT_EQ(6, lru.get_stats().expiration_count);
+  CASE_EXPECT_FALSE(lru.end() == lru.find(0));
+  CASE_EXPECT_FALSE(lru.end() == lru.find(1));
+
+  // Expired elements can be inserted again
+  lru.set_default_ttl(std::chrono::milliseconds{20});
+  CASE_EXPECT_TRUE(lru.insert_key_value(2, 102).second);
+  CASE_EXPECT_EQ(3, lru.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds{40});
+  CASE_EXPECT_EQ(1, lru.remove_expired());
+  CASE_EXPECT_EQ(2, lru.size());
+
+  lru.clear();
+  CASE_EXPECT_EQ(0, lru.remove_expired());
+}
+
+namespace {
+struct lru_map_test_expiry_node {
+  lru_map_test_expiry_node *prev;
+  lru_map_test_expiry_node *next;
+  int64_t expire_tick;
+  int32_t wheel_slot;
+};
+}  // namespace
+
+CASE_TEST(lru_map_test, expiry_wheel) {
+  using wheel_t = atfw::util::memory::details::lru_map_expiry_wheel<lru_map_test_expiry_node>;
+  const int64_t start_tick = 1000000007;
+  wheel_t wheel(start_tick);
+
+  // Ticks cover all levels and some out of range ones
+  std::vector<lru_map_test_expiry_node> nodes;
+  nodes.resize(2048);
+  uint64_t seed = 20261016;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    int64_t delay = 1 + static_cast<int64_t>((seed >> 16) % (static_cast<uint64_t>(1) << (2 + (i % 20) * 2)));
+    nodes[i].prev = nullptr;
+    nodes[i].next = nullptr;
+    nodes[i].wheel_slot = -1;
+    nodes[i].expire_tick = start_tick + delay;
+    wheel.add(&nodes[i]);
+  }
+  CASE_EXPECT_EQ(nodes.size(), wheel.size());
+
+  // Remove some nodes before they expire
+  for (size_t i = 0; i < nodes.size(); i += 7) {
+    wheel.remove(&nodes[i]);
+  }
+
+  size_t expired = 0;
+  size_t bad_order = 0;
+  int64_t now_tick = start_tick;
+  for (int step = 0; step < 400 && wheel.size() > 0; ++step) {
+    int64_t previous_tick = now_tick;
+    now_tick += static_cast<int64_t>(1) << (step / 8);
+    wheel.advance(now_tick);
+    while (wheel.has_expired()) {
+      lru_map_test_expiry_node *node = wheel.pop_expired();
+      ++expired;
+      // Expired nodes must be due, and must not be missed by the previous advance()
+      if (node->expire_tick > now_tick || node->expire_tick <= previous_tick) {
+        ++bad_order;
+      }
+    }
+  }
+
+  CASE_EXPECT_EQ(0, wheel.size());
+  CASE_EXPECT_EQ(nodes.size() - (nodes.size() + 6) / 7, expired);
+  CASE_EXPECT_EQ(0, bad_order);
+}
@@ -1,6 +1,7 @@
 // Copyright 2026 atframework
 
 #include <cstring>
+#include <vector>
 
 #include "frame/test_macros.h"
 
@@ -244,3 +245,103 @@ CASE_TEST(lru_object_pool_test, adjust_bound) {
   }
 }
 
+
+struct test_lru_order_data {
+  int id;
+};
+static std::vector<int> g_lru_gc_order;
+
+struct test_lru_order_action : public atfw::util::mempool::lru_default_action<test_lru_order_data> {
+  using base_type = atfw::util::mempool::lru_default_action<test_lru_order_data>;
+  void gc(test_lru_order_data *obj) {
+    g_lru_gc_order.push_back(obj->id);
+    base_type::gc(obj);
+  }
+};
+
+CASE_TEST(lru_object_pool_test, ring_cache_and_empty_list) {
+  using test_lru_pool_t = atfw::util::mempool::lru_pool<uint32_t, test_lru_order_data, test_lru_order_action>;
+  atfw::util::mempool::lru_pool_manager::ptr_t mgr = atfw::util::mempool::lru_pool_manager::create();
+  test_lru_pool_t lru;
+  lru.init(mgr);
+  g_lru_gc_order.clear();
+
+  // Make the ring buffer wrap around
+  for (int i = 0; i < 4; ++i) {
+    CASE_EXPECT_TRUE(lru.push(1, new test_lru_order_data{i}));
+  }
+  for (int i = 0; i < 2; ++i) {
+    test_lru_order_data *obj = lru.pull(1);
+    CASE_EXPECT_TRUE(nullptr != obj);
+    if (nullptr != obj) {
+      CASE_EXPECT_EQ(3 - i, obj->id);
+      delete obj;
+    }
+  }
+  for (int i = 4; i < 10; ++i) {
+    CASE_EXPECT_TRUE(lru.push(1, new test_lru_order_data{i}));
+  }
+  CASE_EXPECT_EQ(8, lru.size());
+  CASE_EXPECT_EQ(lru.size(), mgr->item_count().get());
+
+  // GC the oldest ones first
+  mgr->set_item_min_bound(0);
+  mgr->set_item_max_bound(5);
+  mgr->set_proc_item_count(3);
+  CASE_EXPECT_EQ(3, mgr->gc());
+  CASE_EXPECT_EQ(3, g_lru_gc_order.size());
+  if (g_lru_gc_order.size() >= 3) {
+    CASE_EXPECT_EQ(0, g_lru_gc_order[0]);
+    CASE_EXPECT_EQ(1, g_lru_gc_order[1]);
+    CASE_EXPECT_EQ(4, g_lru_gc_order[2]);
+  }
+  CASE_EXPECT_EQ(5, lru.size());
+  CASE_EXPECT_EQ(lru.size(), mgr->item_count().get());
+
+  // The newest one is pulled first
+  test_lru_order_data *obj = lru.pull(1);
+  CASE_EXPECT_TRUE(nullptr != obj);
+  if (nullptr != obj) {
+    CASE_EXPECT_EQ(9, obj->id);
+    delete obj;
+  }
+
+  // Empty lists are kept for the next push, and are removed when there are too many of them
+  for (uint32_t key = 100; key < 200; ++key) {
+    CASE_EXPECT_TRUE(lru.push(key, new test_lru_order_data{static_cast<int>(key)}));
+    obj = lru.pull(key);
+    CASE_EXPECT_TRUE(nullptr != obj);
+    delete obj;
+  }
+  CASE_EXPECT_LE(lru.data().size(), 40);
+  CASE_EXPECT_EQ(4, lru.size());
+  CASE_EXPECT_EQ(lru.size(), mgr->item_count().get());
+  CASE_EXPECT_TRUE(lru.data().end() != lru.data().find(1));
+}
+
+CASE_TEST(lru_object_pool_test, erase_check_list_twice) {
+  atfw::util::mempool::lru_pool_manager::ptr_t mgr = atfw::util::mempool::lru_pool_manager::create();
+  atfw::util::memory::weak_rc_ptr<atfw::util::mempool::lru_pool_base::list_type_base> empty_list;
+
+  atfw::util::mempool::lru_pool_manager::check_handle_t handle1 = mgr->push_check_list(empty_list);
+  atfw::util::mempool::lru_pool_manager::check_handle_t handle2 = mgr->push_check_list(empty_list);
+  CASE_EXPECT_EQ(2, mgr->item_count().get());
+
+  CASE_EXPECT_TRUE(mgr->erase_check_list(handle1));
+  // A stale handle must not link the node into the free list twice
+  CASE_EXPECT_FALSE(mgr->erase_check_list(handle1));
+  CASE_EXPECT_FALSE(mgr->erase_check_list(mgr->end_check_list()));
+  CASE_EXPECT_EQ(1, mgr->item_count().get());
+
+  atfw::util::mempool::lru_pool_manager::check_handle_t handle3 = mgr->push_check_list(empty_list);
+  atfw::util::mempool::lru_pool_manager::check_handle_t handle4 = mgr->push_check_list(empty_list);
+  CASE_EXPECT_EQ(handle1, handle3);
+  CASE_EXPECT_NE(handle3, handle4);
+  CASE_EXPECT_NE(handle2, handle4);
+  CASE_EXPECT_EQ(3, mgr->item_count().get());
+
+  CASE_EXPECT_TRUE(mgr->erase_check_list(handle2));
+  CASE_EXPECT_TRUE(mgr->erase_check_list(handle3));
+  CASE_EXPECT_TRUE(mgr->erase_check_list(handle4));
+  CASE_EXPECT_EQ(0, mgr->item_count().get());
+}
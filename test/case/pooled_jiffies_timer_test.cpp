@@ -0,0 +1,246 @@
+// Copyright 2026 atframework
+
+#include <stdint.h>
+#include <ctime>
+#include <map>
+#include <stdexcept>
+
+#include "frame/test_macros.h"
+
+#include "time/jiffies_timer.h"
+#include "time/pooled_jiffies_timer.h"
+
+namespace {
+using short_pooled_timer_t = atfw::util::time::pooled_jiffies_timer<6, 3, 4>;
+
+struct pooled_jiffies_timer_fn {
+  int *count;
+
+  void operator()(time_t tick, const short_pooled_timer_t::timer_t &timer) noexcept {
+    CASE_EXPECT_EQ(short_pooled_timer_t::get_timer_timeout(timer), tick);
+    ++(*count);
+  }
+};
+}  // namespace
+
+CASE_TEST(pooled_jiffies_timer, basic) {
+  short_pooled_timer_t short_timer;
+  int count = 0;
+  time_t max_tick = short_timer.get_max_tick_distance() + 1;
+
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_NOT_INITED,
+                 short_timer.add_timer(123, pooled_jiffies_timer_fn{&count}, nullptr));
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_NOT_INITED, short_timer.tick(456));
+
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_SUCCESS, short_timer.init(max_tick));
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_ALREADY_INITED, short_timer.init(max_tick));
+
+  CASE_EXPECT_EQ(32767, short_timer.get_max_tick_distance());
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_TIMEOUT_EXTENDED,
+                 short_timer.add_timer(short_timer.get_max_tick_distance() + 1, pooled_jiffies_timer_fn{&count},
+                                       nullptr));
+
+  short_pooled_timer_t::timer_handle_t handle;
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_SUCCESS,
+                 short_timer.add_timer(-123, pooled_jiffies_timer_fn{&count}, &count, &handle));
+  CASE_EXPECT_TRUE(nullptr != short_timer.find_timer(handle));
+  CASE_EXPECT_EQ(short_timer.get_last_tick() + 1,
+                 short_pooled_timer_t::get_timer_timeout(*short_timer.find_timer(handle)));
+  CASE_EXPECT_EQ(&count, short_pooled_timer_t::get_timer_private_data(*short_timer.find_timer(handle)));
+
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_SUCCESS,
+                 short_timer.add_timer(30, pooled_jiffies_timer_fn{&count}, nullptr));
+  CASE_EXPECT_EQ(short_pooled_timer_t::error_type_t::EN_JTET_SUCCESS,
+                 short_timer.add_timer(831, pooled_jiffies_timer_fn{&count}, nullptr));
+  CASE_EXPECT_EQ(3, static_cast<int>(short_timer.size()));
+
+  CASE_EXPECT_EQ(0, short_timer.tick(max_tick));
+  CASE_EXPECT_EQ(1, short_timer.tick(max_tick + 1));
+  CASE_EXPECT_EQ(1, count);
+  CASE_EXPECT_TRUE(nullptr == short_timer.find_timer(handle));
+  CASE_EXPECT_FALSE(short_timer.cancel_timer(handle));
+
+  short_timer.tick(max_tick + 29);
+  CASE_EXPECT_EQ(1, count);
+  short_timer.tick(max_tick + 30);
+  CASE_EXPECT_EQ(2, count);
+
+  // Moved from higher level before fired
+  short_timer.tick(max_tick + 830);
+  CASE_EXPECT_EQ(2, count);
+  short_timer.tick(max_tick + 831);
+  CASE_EXPECT_EQ(3, count);
+  CASE_EXPECT_EQ(0, static_cast<int>(short_timer.size()));
+}
+
+CASE_TEST(pooled_jiffies_timer, cancel_and_reuse) {
+  short_pooled_timer_t short_timer;
+  int count = 0;
+  short_timer.init(0);
+  short_timer.reserve(100);
+  CASE_EXPECT_EQ(short_pooled_timer_t::NODE_CHUNK_SIZE, short_timer.get_capacity());
+
+  short_pooled_timer_t::timer_handle_t handle1;
+  short_pooled_timer_t::timer_handle_t handle2;
+  short_timer.add_timer(10, pooled_jiffies_timer_fn{&count}, nullptr, &handle1);
+  short_timer.add_timer(10, pooled_jiffies_timer_fn{&count}, nullptr, &handle2);
+  CASE_EXPECT_TRUE(short_timer.cancel_timer(handle1));
+  CASE_EXPECT_FALSE(short_timer.cancel_timer(handle1));
+  CASE_EXPECT_EQ(1, static_cast<int>(short_timer.size()));
+
+  // The node of handle1 is reused, but handle1 is still invalid
+  short_pooled_timer_t::timer_handle_t handle3;
+  short_timer.add_timer(20, pooled_jiffies_timer_fn{&count}, nullptr, &handle3);
+  CASE_EXPECT_EQ(handle1.index, handle3.index);
+  CASE_EXPECT_TRUE(nullptr == short_timer.find_timer(handle1));
+  CASE_EXPECT_TRUE(nullptr != short_timer.find_timer(handle3));
+
+  // Disabled timers are removed without calling
+  short_pooled_timer_t::set_timer_flags(*short_timer.find_timer(handle3),
+                                        short_pooled_timer_t::timer_flag_t::EN_JTTF_DISABLED);
+  CASE_EXPECT_EQ(1, short_timer.tick(100));
+  CASE_EXPECT_EQ(1, count);
+  CASE_EXPECT_EQ(0, static_cast<int>(short_timer.size()));
+
+  // Steady state add/fire do not allocate more nodes
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 200; ++i) {
+      short_timer.add_timer(i % 70, pooled_jiffies_timer_fn{&count}, nullptr);
+    }
+    short_timer.tick(short_timer.get_last_tick() + 100);
+  }
+  CASE_EXPECT_EQ(20001, count);
+  CASE_EXPECT_EQ(short_pooled_timer_t::NODE_CHUNK_SIZE, short_timer.get_capacity());
+}
+
+CASE_TEST(pooled_jiffies_timer, modify_in_callback) {
+  short_pooled_timer_t short_timer;
+  short_timer.init(0);
+
+  int count = 0;
+  short_pooled_timer_t::timer_handle_t cancel_handle;
+
+  // Cancel the other timer of the same tick and add a new one
+  short_pooled_timer_t *timer_ptr = &short_timer;
+  short_pooled_timer_t::timer_handle_t *cancel_handle_ptr = &cancel_handle;
+  int *count_ptr = &count;
+  short_timer.add_timer(
+      5,
+      [timer_ptr, cancel_handle_ptr, count_ptr](time_t, const short_pooled_timer_t::timer_t &) noexcept {
+        CASE_EXPECT_TRUE(timer_ptr->cancel_timer(*cancel_handle_ptr));
+        timer_ptr->add_timer(1, pooled_jiffies_timer_fn{count_ptr}, nullptr);
+      },
+      nullptr);
+  short_timer.add_timer(5, pooled_jiffies_timer_fn{&count}, nullptr, &cancel_handle);
+
+  short_timer.tick(5);
+  CASE_EXPECT_EQ(0, count);
+  CASE_EXPECT_EQ(1, static_cast<int>(short_timer.size()));
+  short_timer.tick(6);
+  CASE_EXPECT_EQ(1, count);
+  CASE_EXPECT_EQ(0, static_cast<int>(short_timer.size()));
+}
+
+CASE_TEST(pooled_jiffies_timer, clear_in_callback) {
+  short_pooled_timer_t short_timer;
+  int count = 0;
+  short_timer.init(0);
+
+  short_pooled_timer_t::timer_handle_t pending_handle;
+  short_pooled_timer_t *timer_ptr = &short_timer;
+  short_timer.add_timer(
+      5, [timer_ptr](time_t, const short_pooled_timer_t::timer_t &) noexcept { timer_ptr->clear(); }, nullptr);
+  short_timer.add_timer(5, pooled_jiffies_timer_fn{&count}, nullptr, &pending_handle);
+  short_timer.add_timer(100, pooled_jiffies_timer_fn{&count}, nullptr);
+
+  CASE_EXPECT_EQ(1, short_timer.tick(200));
+  CASE_EXPECT_EQ(0, count);
+  CASE_EXPECT_EQ(0, static_cast<int>(short_timer.size()));
+  CASE_EXPECT_TRUE(nullptr == short_timer.find_timer(pending_handle));
+  CASE_EXPECT_FALSE(short_timer.cancel_timer(pending_handle));
+
+  // All nodes are back to the pool
+  size_t capacity = short_timer.get_capacity();
+  for (size_t i = 0; i < capacity; ++i) {
+    short_timer.add_timer(1, pooled_jiffies_timer_fn{&count}, nullptr);
+  }
+  CASE_EXPECT_EQ(capacity, short_timer.get_capacity());
+  short_timer.tick(201);
+  CASE_EXPECT_EQ(static_cast<int>(capacity), count);
+}
+
+#if defined(ATFRAMEWORK_UTILS_ENABLE_EXCEPTION) && ATFRAMEWORK_UTILS_ENABLE_EXCEPTION
+CASE_TEST(pooled_jiffies_timer, throw_in_callback) {
+  short_pooled_timer_t short_timer;
+  int count = 0;
+  short_timer.init(0);
+
+  short_pooled_timer_t::timer_handle_t throw_handle;
+  short_pooled_timer_t::timer_handle_t pending_handle;
+  short_timer.add_timer(
+      5, [](time_t, const short_pooled_timer_t::timer_t &) { throw std::runtime_error("callback failed"); }, nullptr,
+      &throw_handle);
+  short_timer.add_timer(5, pooled_jiffies_timer_fn{&count}, nullptr, &pending_handle);
+  short_timer.add_timer(5, pooled_jiffies_timer_fn{&count}, nullptr);
+
+  bool caught = false;
+  try {
+    short_timer.tick(5);
+  } catch (const std::runtime_error &) {
+    caught = true;
+  }
+  CASE_EXPECT_TRUE(caught);
+  CASE_EXPECT_EQ(0, count);
+  CASE_EXPECT_TRUE(nullptr == short_timer.find_timer(throw_handle));
+
+  // The timers not fired are kept in the wheel and fired by the next tick
+  CASE_EXPECT_EQ(2, static_cast<int>(short_timer.size()));
+  CASE_EXPECT_TRUE(short_timer.cancel_timer(pending_handle));
+  CASE_EXPECT_EQ(1, static_cast<int>(short_timer.size()));
+
+  CASE_EXPECT_EQ(5, short_timer.next_expire_tick());
+  CASE_EXPECT_EQ(1, short_timer.tick(5));
+  CASE_EXPECT_EQ(1, count);
+  CASE_EXPECT_EQ(0, static_cast<int>(short_timer.size()));
+}
+#endif
+
+CASE_TEST(pooled_jiffies_timer, same_as_jiffies_timer) {
+  using jiffies_timer_t = atfw::util::time::jiffies_timer<6, 3, 4>;
+  jiffies_timer_t origin_timer;
+  short_pooled_timer_t pooled_timer;
+  origin_timer.init(1000);
+  pooled_timer.init(1000);
+
+  std::map<uint32_t, time_t> origin_fired;
+  std::map<uint32_t, time_t> pooled_fired;
+  uint64_t seed = 20261016;
+  for (time_t tick = 1001; tick < 50000; tick += 17) {
+    for (int i = 0; i < 4; ++i) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      time_t delta = static_cast<time_t>((seed >> 33) % 20000);
+      origin_timer.add_timer(
+          delta,
+          [&origin_fired](time_t fired_tick, const jiffies_timer_t::timer_t &timer) {
+            origin_fired[jiffies_timer_t::get_timer_sequence(timer)] = fired_tick;
+          },
+          nullptr);
+      std::map<uint32_t, time_t> *pooled_fired_ptr = &pooled_fired;
+      pooled_timer.add_timer(
+          delta,
+          [pooled_fired_ptr](time_t fired_tick, const short_pooled_timer_t::timer_t &timer) noexcept {
+            (*pooled_fired_ptr)[short_pooled_timer_t::get_timer_sequence(timer)] = fired_tick;
+          },
+          nullptr);
+    }
+
+    CASE_EXPECT_EQ(origin_timer.next_expire_tick(), pooled_timer.next_expire_tick());
+    CASE_EXPECT_EQ(origin_timer.tick(tick), pooled_timer.tick(tick));
+  }
+  CASE_EXPECT_EQ(origin_timer.next_expire_tick(), pooled_timer.next_expire_tick());
+  origin_timer.tick(100000);
+  pooled_timer.tick(100000);
+
+  CASE_EXPECT_EQ(origin_fired.size(), pooled_fired.size());
+  CASE_EXPECT_TRUE(origin_fired == pooled_fired);
+}
@@ -0,0 +1,196 @@
+// Copyright 2026 atframework
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#ifdef max
+#  undef max
+#endif
+
+#include "memory/lru_map.h"
+#include "memory/pooled_lru_map.h"
+
+CASE_TEST(pooled_lru_map_test, basic_container) {
+  using lru_t = atfw::util::memory::pooled_lru_map<int, long>;
+  lru_t lru;
+  lru.reserve(128);
+
+  using insert_pair_t = std::pair<lru_t::iterator, bool>;
+
+  CASE_EXPECT_TRUE(lru.empty());
+  CASE_EXPECT_EQ(0, lru.size());
+
+  insert_pair_t res = lru.insert_key_value(1, 101);
+  CASE_EXPECT_TRUE(res.second);
+  CASE_EXPECT_EQ(1, (*res.first).first);
+  CASE_EXPECT_EQ(101, *(*res.first).second);
+
+  std::vector<std::pair<int, std::shared_ptr<long> > > vec;
+  vec.push_back(std::pair<int, std::shared_ptr<long> >(2, std::make_shared<long>(102)));
+  vec.push_back(std::pair<int, std::shared_ptr<long> >(3, std::make_shared<long>(103)));
+  lru.insert(vec.begin(), vec.end());
+  CASE_EXPECT_EQ(3, lru.size());
+
+  lru[4] = 104;
+  CASE_EXPECT_EQ(4, lru.size());
+
+  CASE_EXPECT_EQ(1, lru.front().first);
+  CASE_EXPECT_EQ(101, *lru.front().second);
+  CASE_EXPECT_EQ(4, lru.back().first);
+  CASE_EXPECT_EQ(104, *lru.back().second);
+
+  // insert invalid
+  res = lru.insert_key_value(1, 1001);
+  CASE_EXPECT_FALSE(res.second);
+  res = lru.insert_key_value(2, std::make_shared<long>(1002));
+  CASE_EXPECT_FALSE(res.second);
+  std::shared_ptr<long> value_1003 = std::make_shared<long>(1003);
+  res = lru.insert_key_value(3, value_1003);
+  CASE_EXPECT_FALSE(res.second);
+  res = lru.insert_key_value(4, 1004);
+  CASE_EXPECT_FALSE(res.second);
+
+  // pop
+  lru.pop_front();
+  lru.pop_back();
+  CASE_EXPECT_EQ(2, lru.size());
+
+  CASE_EXPECT_EQ(2, lru.front().first);
+  CASE_EXPECT_EQ(3, lru.back().first);
+  CASE_EXPECT_EQ(2, (*lru.cbegin()).first);
+  CASE_EXPECT_EQ(3, (*lru.crbegin()).first);
+  CASE_EXPECT_FALSE(lru.cbegin() == lru.cend());
+
+  // swap
+  lru_t lru2;
+  lru2.swap(lru);
+  CASE_EXPECT_TRUE(lru.empty());
+  CASE_EXPECT_TRUE(lru.begin() == lru.end());
+  CASE_EXPECT_EQ(2, lru2.size());
+  CASE_EXPECT_EQ(2, lru2.front().first);
+  CASE_EXPECT_EQ(3, lru2.back().first);
+
+  // copy and move
+  lru_t lru3(lru2);
+  CASE_EXPECT_EQ(2, lru3.size());
+  lru_t lru4(std::move(lru3));
+  CASE_EXPECT_TRUE(lru3.empty());
+  CASE_EXPECT_EQ(2, lru4.size());
+  CASE_EXPECT_EQ(103, *lru4.find(3, false)->second);
+
+  // find - erase(iterator)
+  res.first = lru2.find(3);
+  CASE_EXPECT_FALSE(lru2.end() == res.first);
+  CASE_EXPECT_TRUE(lru2.end() == lru2.erase(res.first));
+
+  CASE_EXPECT_EQ(1, lru2.erase(2));
+  CASE_EXPECT_EQ(0, lru2.erase(2));
+
+  CASE_EXPECT_TRUE(lru2.empty());
+}
+
+CASE_TEST(pooled_lru_map_test, lru_reorder) {
+  using lru_t = atfw::util::memory::pooled_lru_map<int, long>;
+  lru_t lru;
+
+  for (int i = 1; i <= 60; ++i) {
+    lru[i] = 100 + i;
+  }
+
+  lru_t::iterator iter = lru.find(1);
+  CASE_EXPECT_FALSE(iter == lru.end());
+
+  CASE_EXPECT_EQ(2, lru.front().first);
+  CASE_EXPECT_EQ(1, lru.back().first);
+
+  int range_idx = 2;
+  for (lru_t::iterator it = lru.begin(); it != lru.end(); ++it) {
+    CASE_EXPECT_EQ(range_idx, (*it).first);
+    CASE_EXPECT_EQ(range_idx + 100, *(*it).second);
+
+    if (range_idx == 60) {
+      range_idx = 1;
+    } else {
+      ++range_idx;
+    }
+  }
+
+  // Do not update visit history
+  lru.find(30, false);
+  CASE_EXPECT_EQ(1, lru.back().first);
+
+  CASE_EXPECT_TRUE(lru.end() == lru.erase(lru.begin(), lru.end()));
+  CASE_EXPECT_TRUE(lru.empty());
+}
+
+CASE_TEST(pooled_lru_map_test, reuse_pooled_nodes) {
+  using lru_t = atfw::util::memory::pooled_lru_map<int, long>;
+  lru_t lru;
+  lru.reserve(1000);
+  lru_t::size_type capacity = lru.capacity();
+  CASE_EXPECT_GE(capacity, 1000);
+
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      lru.insert_key_value(round * 1000 + i, static_cast<long>(i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+      lru.find(round * 1000 + i, true);
+    }
+    CASE_EXPECT_EQ(1000, lru.size());
+    lru.clear();
+  }
+
+  // Nodes are reused from the free list
+  CASE_EXPECT_EQ(capacity, lru.capacity());
+}
+
+CASE_TEST(pooled_lru_map_test, same_as_lru_map) {
+  // Keys with the same low bits make long probe sequences, check backward shift deletion with lru_map
+  using pooled_lru_t = atfw::util::memory::pooled_lru_map<int, int>;
+  using lru_t = atfw::util::memory::lru_map<int, int>;
+  pooled_lru_t pooled_lru;
+  lru_t lru;
+
+  uint32_t seed = 20261016;
+  for (int i = 0; i < 20000; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int key = static_cast<int>((seed >> 8) % 512) * 1024;
+    switch ((seed >> 4) % 4) {
+      case 0:
+      case 1: {
+        bool pooled_res = pooled_lru.insert_key_value(key, i).second;
+        bool res = lru.insert_key_value(key, i).second;
+        CASE_EXPECT_EQ(res, pooled_res);
+        break;
+      }
+      case 2: {
+        CASE_EXPECT_EQ(lru.erase(key), pooled_lru.erase(key));
+        break;
+      }
+      default: {
+        bool pooled_found = pooled_lru.find(key) != pooled_lru.end();
+        bool found = lru.find(key) != lru.end();
+        CASE_EXPECT_EQ(found, pooled_found);
+        if (lru.size() > 300) {
+          lru.pop_front();
+          pooled_lru.pop_front();
+        }
+        break;
+      }
+    }
+  }
+
+  CASE_EXPECT_EQ(lru.size(), pooled_lru.size());
+  lru_t::iterator it = lru.begin();
+  pooled_lru_t::const_iterator pooled_it = pooled_lru.cbegin();
+  for (; it != lru.end() && pooled_it != pooled_lru.cend(); ++it, ++pooled_it) {
+    CASE_EXPECT_EQ(it->first, pooled_it->first);
+    CASE_EXPECT_EQ(*it->second, *pooled_it->second);
+  }
+  CASE_EXPECT_TRUE(it == lru.end());
+  CASE_EXPECT_TRUE(pooled_it == pooled_lru.cend());
+}
@@ -0,0 +1,216 @@
+// Copyright 2026 atframework
+
+#include <list>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "frame/test_macros.h"
+
+#include "memory/lru_map.h"
+#include "memory/rc_ptr.h"
+#include "memory/slab_allocator.h"
+
+namespace {
+struct test_slab_allocator_large {
+  char data[512];
+};
+
+struct alignas(64) test_slab_allocator_over_aligned {
+  char data[32];
+};
+
+static int g_test_slab_backend_allocate_count = 0;
+static int g_test_slab_backend_deallocate_count = 0;
+
+template <class T>
+struct test_slab_counting_backend : public std::allocator<T> {
+  template <class U>
+  struct rebind {
+    using other = test_slab_counting_backend<U>;
+  };
+
+  test_slab_counting_backend() noexcept {}
+
+  template <class U>
+  test_slab_counting_backend(const test_slab_counting_backend<U> &) noexcept {}  // NOLINT: runtime/explicit
+
+  T *allocate(size_t n) {
+    ++g_test_slab_backend_allocate_count;
+    return std::allocator<T>::allocate(n);
+  }
+
+  void deallocate(T *p, size_t n) {
+    ++g_test_slab_backend_deallocate_count;
+    std::allocator<T>::deallocate(p, n);
+  }
+};
+}  // namespace
+
+CASE_TEST(slab_allocator_test, resource_reuse_blocks) {
+  atfw::util::memory::slab_resource::options_t options;
+  options.slab_size = 4096;
+  options.thread_safe = false;
+  atfw::util::memory::slab_resource::ptr_t resource = atfw::util::memory::slab_resource::create(options);
+  CASE_EXPECT_EQ(0, resource->get_options().thread_cache_size);
+
+  CASE_EXPECT_EQ(nullptr, resource->allocate(0, 8));
+  CASE_EXPECT_EQ(nullptr, resource->allocate(atfw::util::memory::slab_resource::kMaxBlockSize + 1, 8));
+  CASE_EXPECT_FALSE(resource->deallocate(nullptr, atfw::util::memory::slab_resource::kMaxBlockSize + 1, 8));
+
+  void *p1 = resource->allocate(24, 8);
+  void *p2 = resource->allocate(32, 8);
+  CASE_EXPECT_TRUE(nullptr != p1);
+  CASE_EXPECT_TRUE(nullptr != p2);
+  CASE_EXPECT_NE(p1, p2);
+  CASE_EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p1) % 16);
+  CASE_EXPECT_EQ(1, resource->get_slab_count());
+
+  // 24 and 32 bytes share the same size class
+  CASE_EXPECT_TRUE(resource->deallocate(p1, 24, 8));
+  CASE_EXPECT_EQ(1, resource->get_free_block_count());
+  CASE_EXPECT_EQ(p1, resource->allocate(32, 8));
+  CASE_EXPECT_EQ(0, resource->get_free_block_count());
+
+  // Blocks of other size classes are carved from another slab
+  void *p3 = resource->allocate(100, 8);
+  CASE_EXPECT_TRUE(nullptr != p3);
+  CASE_EXPECT_EQ(2, resource->get_slab_count());
+
+  CASE_EXPECT_TRUE(resource->deallocate(p1, 32, 8));
+  CASE_EXPECT_TRUE(resource->deallocate(p2, 32, 8));
+  CASE_EXPECT_TRUE(resource->deallocate(p3, 100, 8));
+  CASE_EXPECT_EQ(3, resource->get_free_block_count());
+}
+
+CASE_TEST(slab_allocator_test, thread_cache) {
+  atfw::util::memory::slab_resource::options_t options;
+  options.thread_cache_size = 8;
+  atfw::util::memory::slab_resource::ptr_t resource = atfw::util::memory::slab_resource::create(options);
+
+  std::vector<void *> blocks;
+  for (int i = 0; i < 32; ++i) {
+    blocks.push_back(resource->allocate(64, 8));
+    CASE_EXPECT_TRUE(nullptr != blocks.back());
+  }
+  for (auto &block : blocks) {
+    CASE_EXPECT_TRUE(resource->deallocate(block, 64, 8));
+  }
+
+  // At most thread_cache_size blocks are kept by this thread
+  CASE_EXPECT_GE(resource->get_free_block_count(), 32 - options.thread_cache_size);
+  CASE_EXPECT_LT(resource->get_free_block_count(), 32);
+
+  // Blocks in cache of an exited thread are given back
+  std::thread([resource]() {
+    void *p = resource->allocate(200, 8);
+    CASE_EXPECT_TRUE(nullptr != p);
+    resource->deallocate(p, 200, 8);
+  }).join();
+  CASE_EXPECT_GE(resource->get_free_block_count(), 32 - options.thread_cache_size + 1);
+}
+
+CASE_TEST(slab_allocator_test, multi_thread) {
+  atfw::util::memory::slab_resource::ptr_t resource = atfw::util::memory::slab_resource::create();
+  using allocator_t = atfw::util::memory::slab_allocator<int64_t>;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([resource, i]() {
+      std::list<int64_t, allocator_t> ls{allocator_t(resource)};
+      for (int j = 0; j < 10000; ++j) {
+        ls.push_back(static_cast<int64_t>(i) * 10000 + j);
+        if (ls.size() > 100) {
+          ls.pop_front();
+        }
+      }
+      CASE_EXPECT_EQ(100, ls.size());
+      CASE_EXPECT_EQ(static_cast<int64_t>(i) * 10000 + 9999, ls.back());
+    });
+  }
+  for (auto &thd : threads) {
+    thd.join();
+  }
+}
+
+CASE_TEST(slab_allocator_test, allocator_traits) {
+  atfw::util::memory::slab_resource::ptr_t resource = atfw::util::memory::slab_resource::create();
+  using allocator_t = atfw::util::memory::slab_allocator<int>;
+  using traits_t = std::allocator_traits<allocator_t>;
+
+  allocator_t alloc1(resource);
+  allocator_t alloc2;
+  traits_t::rebind_alloc<test_slab_allocator_large> alloc3(alloc1);
+  CASE_EXPECT_TRUE(alloc1 != alloc2);
+  CASE_EXPECT_TRUE(alloc1 == alloc3);
+  CASE_EXPECT_TRUE(alloc2.resource() == atfw::util::memory::slab_resource::default_resource());
+
+  int *p = traits_t::allocate(alloc1, 4);
+  traits_t::construct(alloc1, p, 42);
+  CASE_EXPECT_EQ(42, *p);
+  traits_t::destroy(alloc1, p);
+  traits_t::deallocate(alloc1, p, 4);
+
+  // Large blocks are allocated by backend allocator
+  size_t free_blocks = resource->get_free_block_count();
+  test_slab_allocator_large *large = alloc3.allocate(1);
+  CASE_EXPECT_TRUE(nullptr != large);
+  alloc3.deallocate(large, 1);
+  CASE_EXPECT_EQ(free_blocks, resource->get_free_block_count());
+}
+
+CASE_TEST(slab_allocator_test, containers) {
+  using lru_alloc_t = atfw::util::memory::slab_allocator<
+      std::pair<const int, atfw::util::memory::lru_map_type_traits<int, int>::iterator>>;
+  using lru_t =
+      atfw::util::memory::lru_map<int, int, std::hash<int>, std::equal_to<int>,
+                                  atfw::util::memory::lru_map_option<atfw::util::memory::compat_strong_ptr_mode::kStl>,
+                                  lru_alloc_t>;
+  lru_t lru;
+  for (int i = 0; i < 64; ++i) {
+    lru.insert_key_value(i, i * 2);
+  }
+  CASE_EXPECT_EQ(64, lru.size());
+  CASE_EXPECT_EQ(20, *lru.find(10)->second);
+  lru.clear();
+
+  atfw::util::memory::slab_resource::ptr_t resource = atfw::util::memory::slab_resource::create();
+  atfw::util::memory::strong_rc_ptr<int> rc = atfw::util::memory::allocate_strong_rc<int>(
+      atfw::util::memory::slab_allocator<int>(resource), 123);
+  CASE_EXPECT_EQ(123, *rc);
+
+  // Blocks are still valid after the last external reference of slab_resource is dropped
+  resource.reset();
+  CASE_EXPECT_EQ(123, *rc);
+  rc.reset();
+}
+
+CASE_TEST(slab_allocator_test, backend_routing) {
+  atfw::util::memory::slab_resource::ptr_t resource = atfw::util::memory::slab_resource::create();
+  g_test_slab_backend_allocate_count = 0;
+  g_test_slab_backend_deallocate_count = 0;
+
+  // Slab sized blocks never touch the backend allocator
+  atfw::util::memory::slab_allocator<int, test_slab_counting_backend<int>> small_alloc(resource);
+  int *small = small_alloc.allocate(4);
+  small_alloc.deallocate(small, 4);
+  CASE_EXPECT_EQ(0, g_test_slab_backend_allocate_count);
+  CASE_EXPECT_EQ(0, g_test_slab_backend_deallocate_count);
+
+  // Large and over-aligned blocks are always allocated and deallocated by the backend allocator
+  size_t free_blocks = resource->get_free_block_count();
+  atfw::util::memory::slab_allocator<test_slab_allocator_over_aligned,
+                                     test_slab_counting_backend<test_slab_allocator_over_aligned>>
+      aligned_alloc(resource);
+  test_slab_allocator_over_aligned *aligned = aligned_alloc.allocate(1);
+  CASE_EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % alignof(test_slab_allocator_over_aligned));
+  aligned_alloc.deallocate(aligned, 1);
+
+  int *large = small_alloc.allocate(1024);
+  small_alloc.deallocate(large, 1024);
+
+  CASE_EXPECT_EQ(2, g_test_slab_backend_allocate_count);
+  CASE_EXPECT_EQ(2, g_test_slab_backend_deallocate_count);
+  CASE_EXPECT_EQ(free_blocks, resource->get_free_block_count());
+}
@@ -1,8 +1,14 @@
 // Copyright 2026 atframework
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
 #include <ctime>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include <time/jiffies_timer.h>
 #include "frame/test_macros.h"
@@ -869,6 +875,74 @@ CASE_TEST(time_test, reinsert_lower_wheel) {
   CASE_EXPECT_EQ(wheel_idx2, 133);
 }
 
+CASE_TEST(time_test, jiffies_timer_next_expire_tick) {
+  short_timer_t short_timer;
+  int count = 0;
+  CASE_EXPECT_EQ(short_timer_t::error_type_t::EN_JTET_SUCCESS, short_timer.init(0));
+  CASE_EXPECT_EQ(short_timer.get_max_tick_distance() + 1, short_timer.next_expire_tick());
+
+  short_timer.add_timer(30, jiffies_timer_fn(nullptr), &count);
+  CASE_EXPECT_EQ(30, short_timer.next_expire_tick());
+
+  // Level 2, the slot is checked at 960 and the timer is moved to level 0
+  short_timer.add_timer(1000, jiffies_timer_fn(nullptr), &count);
+  CASE_EXPECT_EQ(30, short_timer.next_expire_tick());
+
+  CASE_EXPECT_EQ(1, short_timer.tick(100));
+  CASE_EXPECT_EQ(960, short_timer.next_expire_tick());
+  CASE_EXPECT_EQ(0, short_timer.tick(960));
+  CASE_EXPECT_EQ(1000, short_timer.next_expire_tick());
+  CASE_EXPECT_EQ(1, short_timer.tick(1000));
+  CASE_EXPECT_EQ(2, count);
+  CASE_EXPECT_EQ(1000 + short_timer.get_max_tick_distance() + 1, short_timer.next_expire_tick());
+
+  // Skip empty slots in bulk
+  CASE_EXPECT_EQ(0, short_timer.tick(1000000));
+  CASE_EXPECT_EQ(1000000, short_timer.get_last_tick());
+}
+
+CASE_TEST(time_test, jiffies_timer_next_expire_tick_random) {
+  short_timer_t short_timer;
+  short_timer.init(0);
+
+  std::multiset<time_t> pending_timeouts;
+  int fired = 0;
+  int wrong_tick = 0;
+  uint64_t seed = 20261016;
+  for (int i = 0; i < 2000; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    time_t delta = static_cast<time_t>((seed >> 33) % static_cast<uint64_t>(short_timer.get_max_tick_distance())) + 1;
+    pending_timeouts.insert(delta);
+    short_timer.add_timer(
+        delta,
+        [&fired, &wrong_tick](time_t tick_time, const short_timer_t::timer_t &timer) {
+          if (tick_time != short_timer_t::get_timer_timeout(timer)) {
+            ++wrong_tick;
+          }
+          ++fired;
+        },
+        nullptr);
+  }
+
+  // Sleep until next_expire_tick() every time, it must never be later than the first pending timer
+  while (!pending_timeouts.empty()) {
+    time_t next_tick = short_timer.next_expire_tick();
+    CASE_EXPECT_LE(next_tick, *pending_timeouts.begin());
+    if (next_tick > *pending_timeouts.begin()) {
+      break;
+    }
+
+    int fired_before = fired;
+    short_timer.tick(next_tick);
+    CASE_EXPECT_EQ(static_cast<size_t>(fired - fired_before), pending_timeouts.count(next_tick));
+    pending_timeouts.erase(next_tick);
+  }
+
+  CASE_EXPECT_EQ(2000, fired);
+  CASE_EXPECT_EQ(0, wrong_tick);
+  CASE_EXPECT_EQ(0, static_cast<int>(short_timer.size()));
+}
+
 CASE_TEST(time_test, is_leap_year) {
   // Common years
   CASE_EXPECT_FALSE(atfw::util::time::time_utility::is_leap_year(2023));
@@ -944,6 +1018,146 @@ CASE_TEST(time_test, get_now_nanos) {
   CASE_EXPECT_GE(nanos, 0);
 }
 
+CASE_TEST(time_test, fast_sys_now) {
+  time_t sys_now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  time_t fast_now = std::chrono::system_clock::to_time_t(atfw::util::time::time_utility::fast_sys_now());
+  CASE_EXPECT_LE(sys_now - 1, fast_now);
+  CASE_EXPECT_GE(sys_now + 1, fast_now);
+
+  std::chrono::steady_clock::time_point prev = atfw::util::time::time_utility::fast_steady_now();
+  std::chrono::steady_clock::time_point next = atfw::util::time::time_utility::fast_steady_now();
+  CASE_EXPECT_TRUE(prev <= next);
+  CASE_EXPECT_TRUE(next <= std::chrono::steady_clock::now());
+}
+
+CASE_TEST(time_test, coarse_clock) {
+  CASE_EXPECT_TRUE(atfw::util::time::time_utility::start_coarse_clock(std::chrono::microseconds{200}));
+  CASE_EXPECT_FALSE(atfw::util::time::time_utility::start_coarse_clock(std::chrono::microseconds{200}));
+  CASE_EXPECT_TRUE(atfw::util::time::time_utility::is_coarse_clock_running());
+
+  time_t sys_now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  CASE_EXPECT_LE(sys_now - 1, atfw::util::time::time_utility::get_coarse_now());
+  CASE_EXPECT_GE(sys_now + 1, atfw::util::time::time_utility::get_coarse_now());
+  CASE_EXPECT_GE(atfw::util::time::time_utility::get_coarse_now_usec(), 0);
+  CASE_EXPECT_LT(atfw::util::time::time_utility::get_coarse_now_usec(), 1000000);
+
+  // Readers on other threads never see time going backwards
+  std::atomic<int> error_count{0};
+  std::atomic<int> changed_count{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&error_count, &changed_count]() {
+      std::chrono::steady_clock::time_point begin = atfw::util::time::time_utility::coarse_steady_now();
+      std::chrono::steady_clock::time_point prev = begin;
+      atfw::util::time::time_utility::raw_time_t prev_sys = atfw::util::time::time_utility::coarse_now();
+      std::chrono::steady_clock::time_point end_of_test =
+          std::chrono::steady_clock::now() + std::chrono::milliseconds{20};
+      while (std::chrono::steady_clock::now() < end_of_test) {
+        std::chrono::steady_clock::time_point curr = atfw::util::time::time_utility::coarse_steady_now();
+        atfw::util::time::time_utility::raw_time_t curr_sys = atfw::util::time::time_utility::coarse_now();
+        if (curr < prev || curr > std::chrono::steady_clock::now() || curr_sys < prev_sys) {
+          error_count.fetch_add(1);
+        }
+        prev = curr;
+        prev_sys = curr_sys;
+      }
+
+      if (prev != begin) {
+        changed_count.fetch_add(1);
+      }
+    });
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  CASE_EXPECT_EQ(0, error_count.load());
+  CASE_EXPECT_EQ(4, changed_count.load());
+
+  // Global offset is applied to coarse time
+  atfw::util::time::time_utility::set_global_now_offset(std::chrono::hours{1});
+  CASE_EXPECT_LE(sys_now + 3600 - 1, atfw::util::time::time_utility::get_coarse_now());
+  CASE_EXPECT_GE(sys_now + 3600 + 2, atfw::util::time::time_utility::get_coarse_now());
+  atfw::util::time::time_utility::reset_global_now_offset();
+
+  atfw::util::time::time_utility::stop_coarse_clock();
+  CASE_EXPECT_FALSE(atfw::util::time::time_utility::is_coarse_clock_running());
+
+  // Fallback to the system coarse clock after stopped
+  sys_now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  CASE_EXPECT_LE(sys_now - 1, atfw::util::time::time_utility::get_coarse_now());
+  CASE_EXPECT_GE(sys_now + 1, atfw::util::time::time_utility::get_coarse_now());
+}
+
+CASE_TEST(time_test, batch_calendar) {
+  time_t origin_zone_offset = atfw::util::time::time_utility::get_zone_offset();
+  std::vector<time_t> timestamps;
+  // Around days, months, leap days and years between 1970 and 2200
+  uint64_t seed = 20261016;
+  for (int i = 0; i < 20000; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    timestamps.push_back(static_cast<time_t>(86400 + (seed >> 24) % 7258118400ULL));
+  }
+  for (time_t t = 951696000 - 86400; t < 951696000 + 86400 * 3; t += 1800) {  // 2000-02-28 - 2000-03-02
+    timestamps.push_back(t);
+  }
+  timestamps.push_back(4107542399);  // 2100-02-28 23:59:59
+  timestamps.push_back(4107542400);  // 2100-03-01
+
+  time_t zone_offsets[] = {origin_zone_offset, -8 * 3600, 5 * 3600, -8 * 3600 + 5 * 3600};
+  for (auto zone_offset : zone_offsets) {
+    atfw::util::time::time_utility::set_zone_offset(zone_offset);
+
+    std::unique_ptr<bool[]> same_day(new bool[timestamps.size()]);
+    std::vector<time_t> week_start;
+    std::vector<time_t> month_start;
+    std::vector<std::tm> local_tm;
+    week_start.resize(timestamps.size());
+    month_start.resize(timestamps.size());
+    local_tm.resize(timestamps.size());
+
+    time_t right = timestamps[0];
+    atfw::util::time::time_utility::batch_is_same_day(timestamps.data(), timestamps.size(), right, same_day.get(),
+                                                      3600);
+    atfw::util::time::time_utility::batch_get_week_start_time(timestamps.data(), timestamps.size(), week_start.data(),
+                                                              1);
+    atfw::util::time::time_utility::batch_get_month_start_time(timestamps.data(), timestamps.size(),
+                                                               month_start.data());
+    atfw::util::time::time_utility::batch_get_local_tm(timestamps.data(), timestamps.size(), local_tm.data());
+
+    int same_day_error = 0;
+    int week_start_error = 0;
+    int month_start_error = 0;
+    int local_tm_error = 0;
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+      time_t t = timestamps[i];
+      if (same_day[i] != atfw::util::time::time_utility::is_same_day(t, right, 3600)) {
+        ++same_day_error;
+      }
+      if (week_start[i] != atfw::util::time::time_utility::get_week_start_time(t, 1)) {
+        ++week_start_error;
+      }
+      if (month_start[i] != atfw::util::time::time_utility::get_month_start_time(t)) {
+        ++month_start_error;
+      }
+
+      std::tm expect_tm = atfw::util::time::time_utility::get_local_tm(t);
+      if (expect_tm.tm_sec != local_tm[i].tm_sec || expect_tm.tm_min != local_tm[i].tm_min ||
+          expect_tm.tm_hour != local_tm[i].tm_hour || expect_tm.tm_mday != local_tm[i].tm_mday ||
+          expect_tm.tm_mon != local_tm[i].tm_mon || expect_tm.tm_year != local_tm[i].tm_year ||
+          expect_tm.tm_wday != local_tm[i].tm_wday || expect_tm.tm_yday != local_tm[i].tm_yday) {
+        ++local_tm_error;
+      }
+    }
+
+    CASE_EXPECT_EQ(0, same_day_error);
+    CASE_EXPECT_EQ(0, week_start_error);
+    CASE_EXPECT_EQ(0, month_start_error);
+    CASE_EXPECT_EQ(0, local_tm_error);
+  }
+
+  atfw::util::time::time_utility::set_zone_offset(origin_zone_offset);
+}
+
 CASE_TEST(time_test, is_same_week_point) {
   atfw::util::time::time_utility::update();
 